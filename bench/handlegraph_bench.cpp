@@ -0,0 +1,236 @@
+/** \file handlegraph_bench.cpp
+ *
+ * Benchmark the handle graph interfaces and the shipped algorithms over
+ * synthetic graphs, so that interface-level regressions show up and backends
+ * can be compared on equal terms.
+ *
+ * The microbenchmarks drive each primitive (follow_edges, for_each_handle
+ * serial and parallel, get_sequence, path step iteration) through the
+ * abstract interface, so they measure what a generic algorithm pays,
+ * including virtual dispatch. The macrobenchmarks run the shipped algorithms
+ * end to end over the same graph.
+ *
+ * Usage: handlegraph_bench [nodes] [extra edges per node] [node length] [paths]
+ *
+ * Output is CSV on stdout, one row per benchmark:
+ *   benchmark,unit,nodes,edges,ops,ns_per_op,bytes_per_op
+ * where ops counts the benchmark's unit (edge visits, handles, bases, steps,
+ * or nodes processed) and bytes_per_op is the payload each op moves.
+ */
+
+#include "handlegraph/simple_graph.hpp"
+#include "handlegraph/util.hpp"
+#include "handlegraph/algorithms/dijkstra.hpp"
+#include "handlegraph/algorithms/find_tips.hpp"
+#include "handlegraph/algorithms/is_acyclic.hpp"
+#include "handlegraph/algorithms/strongly_connected_components.hpp"
+#include "handlegraph/algorithms/topological_sort.hpp"
+#include "handlegraph/algorithms/weakly_connected_components.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace handlegraph;
+using namespace std;
+
+/// Somewhere to deposit results so the compiler can't delete the work
+volatile uint64_t sink = 0;
+
+/// How long to keep re-running each benchmark body, in nanoseconds
+const double target_ns = 2e8;
+
+/// Time the given body, which does one pass of work and returns how many of
+/// the benchmark's units it processed, and print one CSV row. The body is run
+/// once to warm up and then repeatedly until enough wall-clock time has been
+/// spent to trust the average.
+template<typename Body>
+void run_benchmark(const string& name, const string& unit,
+                   size_t node_count, size_t edge_count, double bytes_per_op,
+                   const Body& body) {
+    body();
+    size_t ops = 0;
+    double elapsed_ns = 0;
+    do {
+        auto start = chrono::steady_clock::now();
+        size_t done = body();
+        auto stop = chrono::steady_clock::now();
+        elapsed_ns += chrono::duration_cast<chrono::nanoseconds>(stop - start).count();
+        ops += done;
+    } while (elapsed_ns < target_ns);
+    cout << name << ',' << unit << ',' << node_count << ',' << edge_count << ','
+         << ops << ',' << (elapsed_ns / ops) << ',' << bytes_per_op << endl;
+}
+
+/// Build a reproducible synthetic graph into the given (empty) graph: a
+/// backbone chain of nodes with random sequences of the given length, extra
+/// random edges to reach the requested density, and paths walking the
+/// backbone. Returns the edge count through the out parameter.
+void build_graph(SimpleGraph& graph, size_t node_count, double extra_edges_per_node,
+                 size_t node_length, size_t path_count, size_t& edge_count) {
+    mt19937_64 rng(4357);
+    const char* bases = "ACGT";
+    graph.reserve(node_count, node_count * (1 + extra_edges_per_node), node_count * node_length);
+
+    vector<handle_t> handles;
+    handles.reserve(node_count);
+    string sequence(node_length, 'A');
+    for (size_t i = 0; i < node_count; i++) {
+        for (size_t j = 0; j < node_length; j++) {
+            sequence[j] = bases[rng() % 4];
+        }
+        handles.push_back(graph.create_handle(sequence));
+    }
+
+    edge_count = 0;
+    for (size_t i = 0; i + 1 < node_count; i++) {
+        graph.create_edge(handles[i], handles[i + 1]);
+        edge_count++;
+    }
+    size_t extra = node_count * extra_edges_per_node;
+    for (size_t i = 0; i < extra; i++) {
+        handle_t from = handles[rng() % node_count];
+        handle_t to = handles[rng() % node_count];
+        if (rng() % 4 == 0) {
+            to = graph.flip(to);
+        }
+        graph.create_edge(from, to);
+        edge_count++;
+    }
+
+    for (size_t p = 0; p < path_count; p++) {
+        path_handle_t path = graph.create_path_handle("path" + to_string(p));
+        for (size_t i = 0; i < node_count; i++) {
+            graph.append_step(path, handles[i]);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t node_count = argc > 1 ? atol(argv[1]) : 20000;
+    double extra_edges_per_node = argc > 2 ? atof(argv[2]) : 1.0;
+    size_t node_length = argc > 3 ? atol(argv[3]) : 32;
+    size_t path_count = argc > 4 ? atol(argv[4]) : 4;
+
+    size_t edge_count = 0;
+    SimpleGraph backing;
+    build_graph(backing, node_count, extra_edges_per_node, node_length,
+                path_count, edge_count);
+    // everything below measures through the abstract interfaces
+    const PathHandleGraph& graph = backing;
+
+    cout << "benchmark,unit,nodes,edges,ops,ns_per_op,bytes_per_op" << endl;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Microbenchmarks: one primitive each
+    ////////////////////////////////////////////////////////////////////////////
+
+    run_benchmark("follow_edges", "edge_visit", node_count, edge_count, sizeof(handle_t), [&]() {
+        size_t visited = 0;
+        uint64_t total = 0;
+        graph.for_each_handle([&](const handle_t& handle) {
+            for (bool go_left : {false, true}) {
+                graph.follow_edges(handle, go_left, [&](const handle_t& next) {
+                    total += as_integer(next);
+                    visited++;
+                });
+            }
+        });
+        sink += total;
+        return visited;
+    });
+
+    run_benchmark("for_each_handle", "handle", node_count, edge_count, sizeof(handle_t), [&]() {
+        uint64_t total = 0;
+        graph.for_each_handle([&](const handle_t& handle) {
+            total += as_integer(handle);
+        });
+        sink += total;
+        return node_count;
+    });
+
+    run_benchmark("for_each_handle_parallel", "handle", node_count, edge_count, sizeof(handle_t), [&]() {
+        graph.for_each_handle([&](const handle_t& handle) {
+            sink += as_integer(handle);
+        }, true);
+        return node_count;
+    });
+
+    run_benchmark("for_each_edge", "edge", node_count, edge_count, sizeof(edge_t), [&]() {
+        size_t seen = 0;
+        graph.for_each_edge([&](const edge_t& edge) {
+            seen++;
+        });
+        sink += seen;
+        return seen;
+    });
+
+    run_benchmark("get_sequence", "base", node_count, edge_count, 1, [&]() {
+        size_t bases_read = 0;
+        uint64_t total = 0;
+        graph.for_each_handle([&](const handle_t& handle) {
+            string sequence = graph.get_sequence(handle);
+            total += sequence[0];
+            bases_read += sequence.size();
+        });
+        sink += total;
+        return bases_read;
+    });
+
+    run_benchmark("path_steps", "step", node_count, edge_count, sizeof(step_handle_t), [&]() {
+        size_t steps = 0;
+        uint64_t total = 0;
+        graph.for_each_path_handle([&](const path_handle_t& path) {
+            graph.for_each_step_in_path(path, [&](const step_handle_t& step) {
+                total += as_integer(graph.get_handle_of_step(step));
+                steps++;
+            });
+        });
+        sink += total;
+        return steps;
+    });
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Macrobenchmarks: one shipped algorithm each, end to end
+    ////////////////////////////////////////////////////////////////////////////
+
+    run_benchmark("algo_topological_order", "node", node_count, edge_count, sizeof(handle_t), [&]() {
+        sink += algorithms::topological_order(&graph).size();
+        return node_count;
+    });
+
+    run_benchmark("algo_weakly_connected_components", "node", node_count, edge_count, sizeof(nid_t), [&]() {
+        sink += algorithms::weakly_connected_components(&graph).size();
+        return node_count;
+    });
+
+    run_benchmark("algo_strongly_connected_components", "node", node_count, edge_count, sizeof(nid_t), [&]() {
+        sink += algorithms::strongly_connected_components(&graph).size();
+        return node_count;
+    });
+
+    run_benchmark("algo_is_directed_acyclic", "node", node_count, edge_count, sizeof(handle_t), [&]() {
+        sink += algorithms::is_directed_acyclic(&graph);
+        return node_count;
+    });
+
+    run_benchmark("algo_find_tips", "node", node_count, edge_count, sizeof(handle_t), [&]() {
+        sink += algorithms::find_tips(&graph).size();
+        return node_count;
+    });
+
+    run_benchmark("algo_dijkstra", "node", node_count, edge_count, sizeof(handle_t), [&]() {
+        size_t reached = 0;
+        algorithms::dijkstra(&graph, graph.get_handle(graph.min_node_id()),
+                             [&](const handle_t& handle, size_t distance) {
+            reached++;
+            return true;
+        });
+        sink += reached;
+        return node_count;
+    });
+
+    return 0;
+}
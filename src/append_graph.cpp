@@ -2,6 +2,8 @@
 #include "handlegraph/algorithms/find_tips.hpp"
 #include "handlegraph/algorithms/copy_graph.hpp"
 
+#include "handlegraph/parallel.hpp"
+
 namespace handlegraph {
 namespace algorithms {
 
@@ -25,7 +27,33 @@ void append_handle_graph(const HandleGraph* from, MutableHandleGraph* into) {
         }
     }
 }
-    
+
+void append_handle_graph(const HandleGraph* from, MutableHandleGraph* into, size_t thread_count) {
+
+    // get the heads and tails before copying
+    vector<handle_t> heads = algorithms::head_nodes(from, thread_count);
+    vector<handle_t> tails = algorithms::tail_nodes(into, thread_count);
+
+    // let the destination lay out the incoming ID range ahead of time
+    // (this is only a hint; it may be a no-op)
+    into->set_id_increment(from->min_node_id());
+
+    // copy over the nodes and edges
+    // beware: no checking duplicates
+    copy_handle_graph(from, into, thread_count);
+
+    // connect all the tips in one batch
+    vector<edge_t> linking_edges;
+    linking_edges.reserve(heads.size() * tails.size());
+    for (handle_t head : heads) {
+        handle_t into_head = into->get_handle(from->get_id(head), from->get_is_reverse(head));
+        for (handle_t tail : tails) {
+            linking_edges.emplace_back(tail, into_head);
+        }
+    }
+    into->create_edges(linking_edges);
+}
+
 void append_path_handle_graph(const PathHandleGraph* from, MutablePathMutableHandleGraph* into,
                               bool only_connect_path_tips) {
 
@@ -72,9 +100,111 @@ void append_path_handle_graph(const PathHandleGraph* from, MutablePathMutableHan
                         handle_t into_handle = into->get_handle(from->get_id(handle), from->get_is_reverse(handle));
                         into->append_step(into_path_handle, into_handle);
                     });
-            }                    
+            }
         });
-    
+
+}
+
+void append_path_handle_graph(const PathHandleGraph* from, MutablePathMutableHandleGraph* into,
+                              bool only_connect_path_tips, size_t thread_count) {
+
+    // get the heads and tails before copying
+    vector<handle_t> heads;
+    vector<handle_t> tails;
+    if (!only_connect_path_tips) {
+        heads = algorithms::head_nodes(from, thread_count);
+        tails = algorithms::tail_nodes(into, thread_count);
+    }
+
+    // let the destination lay out the incoming ID range ahead of time
+    // (this is only a hint; it may be a no-op)
+    into->set_id_increment(from->min_node_id());
+
+    // copy over the nodes and edges
+    // beware: no checking duplicates
+    copy_handle_graph(from, into, thread_count);
+
+    // connect all the tips in one batch
+    vector<edge_t> linking_edges;
+    linking_edges.reserve(heads.size() * tails.size());
+    for (handle_t head : heads) {
+        handle_t into_head = into->get_handle(from->get_id(head), from->get_is_reverse(head));
+        for (handle_t tail : tails) {
+            linking_edges.emplace_back(tail, into_head);
+        }
+    }
+    into->create_edges(linking_edges);
+
+    // snapshot the paths, in the order the serial version visits them
+    vector<path_handle_t> paths;
+    from->for_each_path_handle([&](const path_handle_t& path_handle) {
+        paths.push_back(path_handle);
+    });
+
+    // the parts of a path we can read without touching the destination
+    struct PathAppend {
+        string name;
+        PathSense sense;
+        string sample;
+        string locus;
+        size_t haplotype;
+        size_t phase_block;
+        subrange_t subrange;
+        bool is_circular;
+        vector<handle_t> steps;
+    };
+
+    // read the paths' names, metadata, and steps across threads
+    vector<PathAppend> appends(paths.size());
+    parallel_for(paths.size(), [&](size_t i) {
+        const path_handle_t& path_handle = paths[i];
+        auto& append = appends[i];
+        append.name = from->get_path_name(path_handle);
+        append.sense = from->get_sense(path_handle);
+        append.sample = from->get_sample_name(path_handle);
+        append.locus = from->get_locus_name(path_handle);
+        append.haplotype = from->get_haplotype(path_handle);
+        append.phase_block = from->get_phase_block(path_handle);
+        append.subrange = from->get_subrange(path_handle);
+        append.is_circular = from->get_is_circular(path_handle);
+        append.steps.reserve(from->get_step_count(path_handle));
+        for (handle_t handle : from->scan_path(path_handle)) {
+            append.steps.push_back(handle);
+        }
+    }, thread_count);
+
+    // write the paths into the destination serially, adding linking edges
+    for (const auto& append : appends) {
+        path_handle_t into_path_handle;
+        if (!into->has_path(append.name)) {
+            // just copy it over if it's not there
+            into_path_handle = into->create_path(append.sense, append.sample, append.locus,
+                                                 append.haplotype, append.phase_block,
+                                                 append.subrange, append.is_circular);
+        }
+        else {
+            // else we append it
+            into_path_handle = into->get_path_handle(append.name);
+
+            if (!append.steps.empty()) {
+                // add the missing edge
+                handle_t tail = into->get_handle_of_step(into->path_back(into_path_handle));
+                handle_t head = into->get_handle(from->get_id(append.steps.front()),
+                                                 from->get_is_reverse(append.steps.front()));
+                if (!into->has_edge(tail, head)) {
+                    into->create_edge(tail, head);
+                }
+            }
+        }
+
+        // append the steps, a whole path's worth at a time
+        vector<handle_t> into_steps(append.steps.size());
+        for (size_t i = 0; i < append.steps.size(); i++) {
+            into_steps[i] = into->get_handle(from->get_id(append.steps[i]),
+                                             from->get_is_reverse(append.steps[i]));
+        }
+        into->append_steps(into_path_handle, into_steps);
+    }
 }
 }
 }
@@ -9,14 +9,20 @@ unordered_set<nid_t> apply_orientations(MutableHandleGraph* graph, const vector<
     
     // Track what we flip
     unordered_set<nid_t> flipped;
+
+    // Collect everything that needs to be flipped
+    vector<handle_t> to_flip;
     for (const auto& handle : orientations) {
         if (graph->get_is_reverse(handle)) {
             // This needs to be flipped
             flipped.insert(graph->get_id(handle));
-            // Flip it
-            graph->apply_orientation(handle);
+            to_flip.push_back(handle);
         }
     }
+
+    // Flip it all in one call, so the backend can batch its edge rewrites
+    graph->apply_orientations(to_flip);
+
     return flipped;
 }
 }
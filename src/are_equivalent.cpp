@@ -1,7 +1,10 @@
 #include "handlegraph/algorithms/are_equivalent.hpp"
 
+#include "handlegraph/parallel.hpp"
+
 #include <iostream>
 #include <algorithm>
+#include <atomic>
 #include <vector>
 #include <cassert>
 
@@ -10,84 +13,220 @@ namespace algorithms {
 
 using namespace std;
 
-bool are_equivalent(const HandleGraph* graph_1,
-                    const HandleGraph* graph_2, bool verbose) {
-    
-    
-    if (graph_1->get_node_count() != graph_2->get_node_count()) {
+/// Check one of graph 1's nodes for equivalence: presence, sequence, and
+/// edges must all match in graph 2.
+static bool node_is_equivalent(const HandleGraph* graph_1, const HandleGraph* graph_2,
+                               const handle_t& handle_1, bool verbose) {
+
+    if (!graph_2->has_node(graph_1->get_id(handle_1))) {
         if (verbose) {
-            cerr << "graphs have different numbers of nodes: " << graph_1->get_node_count() << " and " << graph_2->get_node_count() << endl;
+            cerr << "node " << graph_1->get_id(handle_1) << " from graph 1 was not found in graph 2" << endl;
         }
         return false;
     }
-    
-    bool equivalent = true;
-    graph_1->for_each_handle([&](const handle_t& handle_1) {
-        
-        if (!graph_2->has_node(graph_1->get_id(handle_1))) {
-            if (verbose) {
-                cerr << "node " << graph_1->get_id(handle_1) << " from graph 1 was not found in graph 2" << endl;
-            }
-            equivalent = false;
-            return false;
+
+    handle_t handle_2 = graph_2->get_handle(graph_1->get_id(handle_1),
+                                            graph_1->get_is_reverse(handle_1));
+
+    if (graph_1->get_sequence(handle_1) != graph_2->get_sequence(handle_2)) {
+        if (verbose) {
+            cerr << "node " << graph_1->get_id(handle_1) << " has different sequence in the two graphs: " << graph_1->get_sequence(handle_1) << " and " << graph_2->get_sequence(handle_2) << endl;
         }
-        
-        handle_t handle_2 = graph_2->get_handle(graph_1->get_id(handle_1),
-                                                graph_1->get_is_reverse(handle_1));
-        
-        if (graph_1->get_sequence(handle_1) != graph_2->get_sequence(handle_2)) {
+        return false;
+    }
+
+    for (bool direction : {true, false}) {
+        vector<handle_t> nexts_1, nexts_2;
+        graph_1->follow_edges(handle_1, direction, [&](const handle_t& next) {
+            nexts_1.push_back(next);
+        });
+        graph_2->follow_edges(handle_2, direction, [&](const handle_t& next) {
+            nexts_2.push_back(next);
+        });
+
+        if (nexts_1.size() != nexts_2.size()) {
             if (verbose) {
-                cerr << "node " << graph_1->get_id(handle_1) << " has different sequence in the two graphs: " << graph_1->get_sequence(handle_1) << " and " << graph_2->get_sequence(handle_2) << endl;
+                cerr << "node " << graph_1->get_id(handle_1) << " has a different number of edges on the " << (direction ? "left" : "right") << " side in the two graphs: " << nexts_1.size() << " and " << nexts_2.size() << endl;
             }
-            equivalent = false;
             return false;
         }
-        
-        for (bool direction : {true, false}) {
-            vector<handle_t> nexts_1, nexts_2;
-            graph_1->follow_edges(handle_1, direction, [&](const handle_t& next) {
-                nexts_1.push_back(next);
-            });
-            graph_2->follow_edges(handle_2, direction, [&](const handle_t& next) {
-                nexts_2.push_back(next);
-            });
-            
-            if (nexts_1.size() != nexts_2.size()) {
+
+        sort(nexts_1.begin(), nexts_1.end(), [&](const handle_t& a, const handle_t& b) {
+            return (graph_1->get_id(a) < graph_1->get_id(b) ||
+                    (graph_1->get_id(a) == graph_1->get_id(b) &&
+                     graph_1->get_is_reverse(a) < graph_1->get_is_reverse(b)));
+        });
+        sort(nexts_2.begin(), nexts_2.end(), [&](const handle_t& a, const handle_t& b) {
+            return (graph_2->get_id(a) < graph_2->get_id(b) ||
+                    (graph_2->get_id(a) == graph_2->get_id(b) &&
+                     graph_2->get_is_reverse(a) < graph_2->get_is_reverse(b)));
+        });
+
+        for (size_t i = 0; i < nexts_1.size(); i++) {
+            if (graph_1->get_id(nexts_1[i]) != graph_2->get_id(nexts_2[i]) ||
+                graph_1->get_is_reverse(nexts_1[i]) != graph_2->get_is_reverse(nexts_2[i])) {
                 if (verbose) {
-                    cerr << "node " << graph_1->get_id(handle_1) << " has a different number of edges on the " << (direction ? "left" : "right") << " side in the two graphs: " << nexts_1.size() << " and " << nexts_2.size() << endl;
+                    cerr << "node " << graph_1->get_id(handle_1) << " has edges to different nodes on the " << (direction ? "left" : "right") << " side in the two graphs" << endl;
                 }
-                equivalent = false;
                 return false;
             }
-            
-            sort(nexts_1.begin(), nexts_1.end(), [&](const handle_t& a, const handle_t& b) {
-                return (graph_1->get_id(a) < graph_1->get_id(b) ||
-                        (graph_1->get_id(a) == graph_1->get_id(b) &&
-                         graph_1->get_is_reverse(a) < graph_1->get_is_reverse(b)));
-            });
-            sort(nexts_2.begin(), nexts_2.end(), [&](const handle_t& a, const handle_t& b) {
-                return (graph_2->get_id(a) < graph_2->get_id(b) ||
-                        (graph_2->get_id(a) == graph_2->get_id(b) &&
-                         graph_2->get_is_reverse(a) < graph_2->get_is_reverse(b)));
-            });
-            
-            for (size_t i = 0; i < nexts_1.size(); i++) {
-                if (graph_1->get_id(nexts_1[i]) != graph_2->get_id(nexts_2[i]) ||
-                    graph_1->get_is_reverse(nexts_1[i]) != graph_2->get_is_reverse(nexts_2[i])) {
-                    if (verbose) {
-                        cerr << "node " << graph_1->get_id(handle_1) << " has edges to different nodes on the " << (direction ? "left" : "right") << " side in the two graphs" << endl;
-                    }
-                    equivalent = false;
-                    return false;
-                }
+        }
+    }
+    return true;
+}
+
+bool are_equivalent(const HandleGraph* graph_1,
+                    const HandleGraph* graph_2, bool verbose, ControlToken* token) {
+
+
+    if (graph_1->get_node_count() != graph_2->get_node_count()) {
+        if (verbose) {
+            cerr << "graphs have different numbers of nodes: " << graph_1->get_node_count() << " and " << graph_2->get_node_count() << endl;
+        }
+        return false;
+    }
+
+    if (token) {
+        token->begin_phase("comparing nodes", graph_1->get_node_count());
+    }
+
+    bool equivalent = true;
+    size_t checked = 0;
+    graph_1->for_each_handle([&](const handle_t& handle_1) {
+        if (token) {
+            token->advance();
+            if (checked++ % ControlToken::CHECK_INTERVAL == 0) {
+                token->check();
             }
         }
-        return true;
+        equivalent = node_is_equivalent(graph_1, graph_2, handle_1, verbose);
+        return equivalent;
     });
-    
+
     return equivalent;
 }
 
+bool are_equivalent_parallel(const HandleGraph* graph_1,
+                             const HandleGraph* graph_2,
+                             bool verbose, size_t thread_count, ControlToken* token) {
+
+    if (graph_1->get_node_count() != graph_2->get_node_count()) {
+        if (verbose) {
+            cerr << "graphs have different numbers of nodes: " << graph_1->get_node_count() << " and " << graph_2->get_node_count() << endl;
+        }
+        return false;
+    }
+
+    // snapshot graph 1's nodes so they can be partitioned across threads
+    vector<handle_t> handles;
+    handles.reserve(graph_1->get_node_count());
+    graph_1->for_each_handle([&](const handle_t& handle_1) {
+        handles.push_back(handle_1);
+    });
+
+    if (token) {
+        token->begin_phase("comparing nodes", handles.size());
+    }
+
+    atomic<bool> equivalent(true);
+    parallel_for(handles.size(), [&](size_t i) -> bool {
+        if (token) {
+            if (token->is_cancelled()) {
+                // Don't throw across the worker threads; stop them all and
+                // let the check after the parallel region throw.
+                return false;
+            }
+            token->advance();
+        }
+        if (!node_is_equivalent(graph_1, graph_2, handles[i], verbose)) {
+            equivalent.store(false, memory_order_relaxed);
+        }
+        // stop every thread as soon as any difference is found
+        return equivalent.load(memory_order_relaxed);
+    }, thread_count);
+
+    if (token) {
+        token->check();
+    }
+
+    return equivalent.load();
+}
+
+/// Finalizer-style mixer, to spread each element's fields over all 64 bits.
+static inline uint64_t mix_bits(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+/// FNV-1a over a sequence's characters.
+static uint64_t sequence_hash(const string& sequence) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const char& c : sequence) {
+        hash = (hash ^ (unsigned char) c) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+uint64_t graph_content_hash(const HandleGraph* graph, size_t thread_count) {
+
+    // snapshot the nodes
+    vector<handle_t> handles;
+    handles.reserve(graph->get_node_count());
+    graph->for_each_handle([&](const handle_t& handle) {
+        handles.push_back(handle);
+    });
+
+    // hash an oriented traversal by its ID and strand, never by the
+    // backend-specific handle value
+    auto traversal_term = [&](const handle_t& handle) -> uint64_t {
+        return 2 * (uint64_t) graph->get_id(handle) + graph->get_is_reverse(handle);
+    };
+
+    // hash an edge in a reading-independent form: of the two readings of the
+    // edge, use the lexicographically smaller by (ID, strand)
+    auto edge_term = [&](const handle_t& left, const handle_t& right) -> uint64_t {
+        uint64_t fwd_1 = traversal_term(left);
+        uint64_t fwd_2 = traversal_term(right);
+        uint64_t rev_1 = traversal_term(graph->flip(right));
+        uint64_t rev_2 = traversal_term(graph->flip(left));
+        if (rev_1 < fwd_1 || (rev_1 == fwd_1 && rev_2 < fwd_2)) {
+            fwd_1 = rev_1;
+            fwd_2 = rev_2;
+        }
+        return mix_bits(mix_bits(fwd_1) ^ (0x9e3779b97f4a7c15ull * fwd_2));
+    };
+
+    // sum the elements' terms; addition commutes, so the total doesn't
+    // depend on iteration order or threading
+    atomic<uint64_t> total(0);
+    parallel_for(handles.size(), [&](size_t i) {
+        const handle_t& handle = handles[i];
+
+        // a term for the node itself
+        uint64_t local = mix_bits(traversal_term(handle) ^ sequence_hash(graph->get_sequence(handle)));
+
+        // a term per edge, counted from its lower-ID endpoint so each edge
+        // contributes exactly once
+        graph->follow_edges(handle, false, [&](const handle_t& next) {
+            if (graph->get_id(handle) <= graph->get_id(next)) {
+                local += edge_term(handle, next);
+            }
+        });
+        graph->follow_edges(handle, true, [&](const handle_t& prev) {
+            if (graph->get_id(handle) < graph->get_id(prev) ||
+                (graph->get_id(handle) == graph->get_id(prev) && graph->get_is_reverse(prev))) {
+                local += edge_term(prev, handle);
+            }
+        });
+
+        total.fetch_add(local, memory_order_relaxed);
+    }, thread_count);
+
+    return total.load();
+}
+
 bool are_equivalent_with_paths(const PathHandleGraph* graph_1,
                                const PathHandleGraph* graph_2, bool verbose) {
     
@@ -0,0 +1,237 @@
+#include "handlegraph/algorithms/bfs.hpp"
+#include "handlegraph/algorithms/internal/bfs.hpp"
+
+#include "handlegraph/parallel.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+/** \file bfs.cpp
+ * Implement the breadth-first traversal engine.
+ */
+
+namespace handlegraph {
+namespace algorithms {
+namespace internal {
+
+BFSRankSpace::BFSRankSpace(const HandleGraph* graph)
+    : graph(graph), ranked(dynamic_cast<const RankedHandleGraph*>(graph)) {
+    if (ranked == nullptr) {
+        // Build the dense rank space ourselves from the sorted node IDs
+        node_ids.reserve(graph->get_node_count());
+        graph->for_each_handle([&](const handle_t& handle) {
+            node_ids.push_back(graph->get_id(handle));
+        });
+        std::sort(node_ids.begin(), node_ids.end());
+    }
+}
+
+size_t BFSRankSpace::size() const {
+    return graph->get_node_count() * 2;
+}
+
+size_t BFSRankSpace::rank_of(const handle_t& handle) const {
+    if (ranked != nullptr) {
+        // The graph's handle ranks are 1-based and dense over orientations
+        return ranked->handle_to_rank(handle) - 1;
+    }
+    size_t node_rank = std::lower_bound(node_ids.begin(), node_ids.end(),
+                                        graph->get_id(handle)) - node_ids.begin();
+    return node_rank * 2 + (size_t) graph->get_is_reverse(handle);
+}
+
+handle_t BFSRankSpace::handle_at(size_t rank) const {
+    if (ranked != nullptr) {
+        return ranked->rank_to_handle(rank + 1);
+    }
+    return graph->get_handle(node_ids[rank / 2], rank % 2 == 1);
+}
+
+BFSVisited::BFSVisited(size_t bits) : words(new std::atomic<uint64_t>[(bits + 63) / 64]) {
+    for (size_t i = 0; i < (bits + 63) / 64; i++) {
+        words[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+bool BFSVisited::test_and_set(size_t rank) {
+    // Relaxed is enough: we only need each bit claimed exactly once, not
+    // any ordering against other memory.
+    uint64_t mask = (uint64_t) 1 << (rank % 64);
+    return words[rank / 64].fetch_or(mask, std::memory_order_relaxed) & mask;
+}
+
+bool BFSVisited::test(size_t rank) const {
+    return words[rank / 64].load(std::memory_order_relaxed) & ((uint64_t) 1 << (rank % 64));
+}
+
+/// How many items one worker claims at a time when a layer is expanded
+/// across threads, amortizing the lock on the shared next frontier.
+static const size_t BFS_CHUNK_ITEMS = 1024;
+
+/// Expand bottom-up once the frontier is this fraction of the unvisited
+/// remainder; scanning the unvisited handles for a frontier parent then
+/// touches fewer edges than pushing the whole frontier forward.
+static const size_t BFS_BOTTOM_UP_DENOMINATOR = 4;
+
+void bfs_engine(const HandleGraph* graph,
+                const std::vector<handle_t>& sources,
+                const std::function<bool(const handle_t&, size_t)>& iteratee,
+                size_t thread_count,
+                bool direction_optimizing) {
+
+    if (graph == nullptr) {
+        throw std::runtime_error("error:[bfs] must supply graph to search");
+    }
+
+    BFSRankSpace ranks(graph);
+    BFSVisited visited(ranks.size());
+
+    // set when the iteratee asks to stop; workers already in flight may
+    // deliver a few more calls
+    std::atomic<bool> stopped(false);
+
+    std::vector<handle_t> current, next;
+    std::mutex next_mutex;
+
+    // The sources are depth 0
+    for (const handle_t& source : sources) {
+        if (!visited.test_and_set(ranks.rank_of(source))) {
+            if (!iteratee(source, 0)) {
+                stopped.store(true);
+                break;
+            }
+            current.push_back(source);
+        }
+    }
+    size_t visited_count = current.size();
+    size_t depth = 0;
+
+    bool parallel = (thread_count != 1);
+
+    while (!current.empty() && !stopped.load()) {
+        depth++;
+        next.clear();
+        size_t unvisited = ranks.size() - visited_count;
+
+        if (direction_optimizing && current.size() > unvisited / BFS_BOTTOM_UP_DENOMINATOR) {
+            // Bottom-up: scan the unvisited handles for a parent in the
+            // frontier instead of pushing the whole frontier forward.
+            std::vector<uint64_t> in_frontier((ranks.size() + 63) / 64, 0);
+            for (const handle_t& handle : current) {
+                size_t rank = ranks.rank_of(handle);
+                in_frontier[rank / 64] |= (uint64_t) 1 << (rank % 64);
+            }
+
+            auto scan_ranks = [&](size_t begin, size_t end) {
+                std::vector<handle_t> found;
+                for (size_t rank = begin; rank < end && !stopped.load(); rank++) {
+                    if (visited.test(rank)) {
+                        continue;
+                    }
+                    handle_t handle = ranks.handle_at(rank);
+                    bool discovered = false;
+                    graph->follow_edges(handle, true, [&](const handle_t& pred) {
+                        size_t pred_rank = ranks.rank_of(pred);
+                        if (in_frontier[pred_rank / 64] & ((uint64_t) 1 << (pred_rank % 64))) {
+                            discovered = true;
+                            // one parent in the frontier is all we need
+                            return false;
+                        }
+                        return true;
+                    });
+                    if (discovered && !visited.test_and_set(rank)) {
+                        if (!parallel && !iteratee(handle, depth)) {
+                            stopped.store(true);
+                            return;
+                        }
+                        found.push_back(handle);
+                    }
+                }
+                std::lock_guard<std::mutex> guard(next_mutex);
+                next.insert(next.end(), found.begin(), found.end());
+            };
+
+            if (parallel) {
+                size_t chunks = (ranks.size() + BFS_CHUNK_ITEMS - 1) / BFS_CHUNK_ITEMS;
+                parallel_for(chunks, [&](size_t chunk) {
+                    scan_ranks(chunk * BFS_CHUNK_ITEMS,
+                               std::min((chunk + 1) * BFS_CHUNK_ITEMS, ranks.size()));
+                }, thread_count);
+            }
+            else {
+                scan_ranks(0, ranks.size());
+            }
+        }
+        else {
+            // Top-down: push the frontier forward along its out-edges
+            auto expand_frontier = [&](size_t begin, size_t end) {
+                std::vector<handle_t> found;
+                for (size_t i = begin; i < end && !stopped.load(); i++) {
+                    graph->follow_edges(current[i], false, [&](const handle_t& neighbor) {
+                        if (!visited.test_and_set(ranks.rank_of(neighbor))) {
+                            if (!parallel && !iteratee(neighbor, depth)) {
+                                stopped.store(true);
+                                return false;
+                            }
+                            found.push_back(neighbor);
+                        }
+                        return true;
+                    });
+                }
+                std::lock_guard<std::mutex> guard(next_mutex);
+                next.insert(next.end(), found.begin(), found.end());
+            };
+
+            if (parallel) {
+                size_t chunks = (current.size() + BFS_CHUNK_ITEMS - 1) / BFS_CHUNK_ITEMS;
+                parallel_for(chunks, [&](size_t chunk) {
+                    expand_frontier(chunk * BFS_CHUNK_ITEMS,
+                                    std::min((chunk + 1) * BFS_CHUNK_ITEMS, current.size()));
+                }, thread_count);
+            }
+            else {
+                expand_frontier(0, current.size());
+            }
+        }
+
+        if (parallel) {
+            // Deterministic reduction: which worker claims a handle races,
+            // but each layer's membership does not, so delivering the layer
+            // in rank order from this thread makes reruns bit-identical.
+            std::sort(next.begin(), next.end(), [&](const handle_t& a, const handle_t& b) {
+                return ranks.rank_of(a) < ranks.rank_of(b);
+            });
+            for (const handle_t& handle : next) {
+                if (!iteratee(handle, depth)) {
+                    stopped.store(true);
+                    break;
+                }
+            }
+        }
+
+        visited_count += next.size();
+        std::swap(current, next);
+    }
+}
+
+}
+
+void bfs(const HandleGraph* graph,
+         const std::vector<handle_t>& sources,
+         const std::function<bool(const handle_t&, size_t)>& iteratee,
+         bool direction_optimizing) {
+    internal::bfs_engine(graph, sources, iteratee, 1, direction_optimizing);
+}
+
+void bfs_parallel(const HandleGraph* graph,
+                  const std::vector<handle_t>& sources,
+                  const std::function<bool(const handle_t&, size_t)>& iteratee,
+                  size_t thread_count,
+                  bool direction_optimizing) {
+    internal::bfs_engine(graph, sources, iteratee,
+                         thread_count == 1 ? 1 : thread_count, direction_optimizing);
+}
+
+}
+}
@@ -0,0 +1,100 @@
+#include "handlegraph/buildable_snarl_decomposition.hpp"
+
+#include "handlegraph/parallel.hpp"
+
+/** \file buildable_snarl_decomposition.cpp
+ * Implement the bulk snarl decomposition construction path.
+ */
+
+namespace handlegraph {
+
+void SnarlDecompositionBuffer::begin_chain(const handle_t& handle) {
+    events.push_back({handle, BEGIN_CHAIN});
+    chains++;
+}
+
+void SnarlDecompositionBuffer::end_chain(const handle_t& handle) {
+    events.push_back({handle, END_CHAIN});
+}
+
+void SnarlDecompositionBuffer::begin_snarl(const handle_t& handle) {
+    events.push_back({handle, BEGIN_SNARL});
+    snarls++;
+}
+
+void SnarlDecompositionBuffer::end_snarl(const handle_t& handle) {
+    events.push_back({handle, END_SNARL});
+}
+
+void SnarlDecompositionBuffer::reserve(size_t call_count) {
+    events.reserve(call_count);
+}
+
+size_t SnarlDecompositionBuffer::chain_count() const {
+    return chains;
+}
+
+size_t SnarlDecompositionBuffer::snarl_count() const {
+    return snarls;
+}
+
+void SnarlDecompositionBuffer::replay(const std::function<void(const handle_t&)>& begin_chain,
+                                      const std::function<void(const handle_t&)>& end_chain,
+                                      const std::function<void(const handle_t&)>& begin_snarl,
+                                      const std::function<void(const handle_t&)>& end_snarl) const {
+    for (auto& event : events) {
+        switch (event.kind) {
+        case BEGIN_CHAIN:
+            begin_chain(event.handle);
+            break;
+        case END_CHAIN:
+            end_chain(event.handle);
+            break;
+        case BEGIN_SNARL:
+            begin_snarl(event.handle);
+            break;
+        case END_SNARL:
+            end_snarl(event.handle);
+            break;
+        }
+    }
+}
+
+void BuildableSnarlDecomposition::reserve_decomposition(size_t chain_count, size_t snarl_count) {
+    // By default there is nothing to preallocate
+}
+
+void BuildableSnarlDecomposition::build_snarl_decomposition(const std::vector<SnarlDecompositionBuffer>& components) {
+    // Tell the implementation how big this is all going to be
+    size_t total_chains = 0;
+    size_t total_snarls = 0;
+    for (auto& component : components) {
+        total_chains += component.chain_count();
+        total_snarls += component.snarl_count();
+    }
+    reserve_decomposition(total_chains, total_snarls);
+
+    // Replay all the components as one linearized decomposition
+    build_snarl_decomposition([&](const std::function<void(const handle_t&)>& begin_chain,
+                                  const std::function<void(const handle_t&)>& end_chain,
+                                  const std::function<void(const handle_t&)>& begin_snarl,
+                                  const std::function<void(const handle_t&)>& end_snarl) {
+        for (auto& component : components) {
+            component.replay(begin_chain, end_chain, begin_snarl, end_snarl);
+        }
+    });
+}
+
+std::vector<SnarlDecompositionBuffer> BuildableSnarlDecomposition::record_decomposition_components(
+    size_t component_count,
+    const std::function<void(size_t, SnarlDecompositionBuffer&)>& recorder,
+    size_t thread_count) {
+
+    std::vector<SnarlDecompositionBuffer> components(component_count);
+    parallel_for(component_count, [&](size_t component) {
+        recorder(component, components[component]);
+    }, thread_count);
+    return components;
+}
+
+}
@@ -6,6 +6,7 @@
 
 #include "handlegraph/algorithms/chop.hpp"
 #include "handlegraph/util.hpp"
+#include "handlegraph/parallel.hpp"
 
 #include <unordered_set>
 #include <unordered_map>
@@ -503,6 +504,105 @@ vector<deque<handle_t>> simple_components(const PathHandleGraph& graph, int min_
     return components;
 }
 
+/// A non-owning view of a contiguous run of handles in a flat run buffer, so
+/// runs can be passed around without a container per run.
+struct HandleRunView {
+    const handle_t* data;
+    size_t count;
+    bool empty() const { return count == 0; }
+    const handle_t& front() const { return data[0]; }
+    const handle_t& back() const { return data[count - 1]; }
+    const handle_t* begin() const { return data; }
+    const handle_t* end() const { return data + count; }
+    size_t size() const { return count; }
+};
+
+/// Find all the maximal runs of nodes that can be merged (as in
+/// simple_components), but write them into one flat buffer: run i occupies
+/// run_handles[run_offsets[i]..run_offsets[i + 1]). Runs shorter than
+/// min_size are dropped. One pass, two flat allocations, no per-run
+/// containers.
+static void flat_simple_components(const PathHandleGraph& graph, size_t min_size,
+                                   vector<handle_t>& run_handles, vector<size_t>& run_offsets) {
+
+    unordered_set<nid_t> seen;
+    run_handles.clear();
+    run_offsets.clear();
+    run_offsets.push_back(0);
+
+    // Scratch space reused across nodes
+    vector<handle_t> leftward;
+    vector<handle_t> adjacent;
+
+    graph.for_each_handle([&](const handle_t& n) {
+        if (seen.count(graph.get_id(n))) {
+            // We already found this node in a previous run
+            return;
+        }
+        seen.insert(graph.get_id(n));
+
+        // Walk left while the linkage stays single and the paths allow merging.
+        leftward.clear();
+        handle_t l = n;
+        adjacent.clear();
+        graph.follow_edges(l, true, [&](const handle_t& h) {
+            adjacent.push_back(h);
+        });
+        while (adjacent.size() == 1 && graph.get_degree(adjacent.front(), false) == 1) {
+            auto last = l;
+            l = adjacent.front();
+            if (!nodes_are_perfect_path_neighbors(graph, l, last)) {
+                break;
+            }
+            if (seen.count(graph.get_id(l))) {
+                // Already in this or another run (catches self loops)
+                break;
+            }
+            leftward.push_back(l);
+            seen.insert(graph.get_id(l));
+            adjacent.clear();
+            graph.follow_edges(l, true, [&](const handle_t& h) {
+                adjacent.push_back(h);
+            });
+        }
+
+        // Emit the leftward extension (found inside-out), then the seed.
+        size_t run_start = run_handles.size();
+        run_handles.insert(run_handles.end(), leftward.rbegin(), leftward.rend());
+        run_handles.push_back(n);
+
+        // Walk right the same way, emitting as we go.
+        handle_t r = n;
+        adjacent.clear();
+        graph.follow_edges(r, false, [&](const handle_t& h) {
+            adjacent.push_back(h);
+        });
+        while (adjacent.size() == 1 && graph.get_degree(adjacent.front(), true) == 1) {
+            auto last = r;
+            r = adjacent.front();
+            if (!nodes_are_perfect_path_neighbors(graph, last, r)) {
+                break;
+            }
+            if (seen.count(graph.get_id(r))) {
+                break;
+            }
+            run_handles.push_back(r);
+            seen.insert(graph.get_id(r));
+            adjacent.clear();
+            graph.follow_edges(r, false, [&](const handle_t& h) {
+                adjacent.push_back(h);
+            });
+        }
+
+        if (run_handles.size() - run_start >= min_size) {
+            run_offsets.push_back(run_handles.size());
+        } else {
+            // Too short to care about; give the space back.
+            run_handles.resize(run_start);
+        }
+    });
+}
+
 /// Concatenates the nodes into a new node with the same external linkage as
 /// the provided component. All handles must be in left to right order and a
 /// consistent orientation. All paths present must run all the way through the
@@ -512,7 +612,8 @@ vector<deque<handle_t>> simple_components(const PathHandleGraph& graph, int min_
 ///
 /// After calling this on a vg::VG, paths will be invalid until
 /// Paths::compact_ranks() is called.
-static handle_t concat_nodes(MutablePathDeletableHandleGraph& graph, const deque<handle_t>& nodes) {
+template<typename HandleRun>
+static handle_t concat_nodes(MutablePathDeletableHandleGraph& graph, const HandleRun& nodes) {
     
     // Make sure we have at least 2 nodes
     assert(!nodes.empty() && nodes.front() != nodes.back());
@@ -676,79 +777,78 @@ static handle_t concat_nodes(MutablePathDeletableHandleGraph& graph, const deque
     return new_node;
 }
 
-void unchop(MutablePathDeletableHandleGraph& graph) {
+void unchop(MutablePathDeletableHandleGraph& graph, MemoryResource* resource, ControlToken* token) {
 #ifdef debug
     std::cerr << "Running unchop" << std::endl;
 #endif
-    
-    std::unordered_map<nid_t, uint64_t> node_rank;
+
+    if (token) {
+        token->begin_phase("ranking nodes", graph.get_node_count());
+    }
+    resource_unordered_map<nid_t, uint64_t> node_rank{ResourceAllocator<std::pair<const nid_t, uint64_t>>(resource)};
     uint64_t rank = 0;
     graph.for_each_handle([&](const handle_t& h) {
+        if (token) {
+            token->advance();
+            if (rank % ControlToken::CHECK_INTERVAL == 0) {
+                token->check();
+            }
+        }
         node_rank[graph.get_id(h)] = rank++;
     });
-    
-    // if possible, don't hold these in memory
-    // meanwhile, we exploit the it for parallelizing the paths' validation
-    std::vector<std::string> path_names;
-    path_names.resize(graph.get_path_count());
-    
-    std::vector<std::string> path_sequences;
-    path_sequences.resize(graph.get_path_count());
-    
-    rank = 0;
-    graph.for_each_path_handle([&](const path_handle_t& p) {
-        path_names[rank] = graph.get_path_name(p);
-        
-        auto& seq = path_sequences[rank];
-        graph.for_each_step_in_path(p, [&](const step_handle_t& s) {
-            seq.append(graph.get_sequence(graph.get_handle_of_step(s)));
-        });
-        
-        ++rank;
-    });
-    
-    auto components = simple_components(graph, 2);
-    std::unordered_set<nid_t> to_merge;
-    for (auto& comp : components) {
-        for (auto& handle : comp) {
-            to_merge.insert(graph.get_id(handle));
-        }
+
+    // Find all the maximal mergeable runs in one pass over the graph, into
+    // one flat buffer instead of a container per run.
+    if (token) {
+        token->begin_phase("finding mergeable runs");
+    }
+    std::vector<handle_t> run_handles;
+    std::vector<size_t> run_offsets;
+    flat_simple_components(graph, 2, run_handles, run_offsets);
+
+    resource_unordered_set<nid_t> to_merge{ResourceAllocator<nid_t>(resource)};
+    for (auto& handle : run_handles) {
+        to_merge.insert(graph.get_id(handle));
     }
-    std::vector<std::pair<double, handle_t>> ordered_handles;
+    resource_vector<std::pair<double, handle_t>> ordered_handles{ResourceAllocator<std::pair<double, handle_t>>(resource)};
     graph.for_each_handle([&](const handle_t& handle) {
         if (!to_merge.count(graph.get_id(handle))) {
             ordered_handles.push_back(std::make_pair(node_rank[graph.get_id(handle)],
                                                      handle));
         }
     });
-    
-    uint64_t num_node_unchopped = 0;
-    uint64_t num_new_nodes = 0;
-    for (auto& comp : components) {
+
+    // Merge the runs in the order they were discovered, which follows the
+    // graph's storage (rank) order.
+    if (token) {
+        token->begin_phase("merging runs", run_offsets.size() - 1);
+    }
+    for (size_t i = 0; i + 1 < run_offsets.size(); i++) {
+        if (token) {
+            token->advance();
+            if (i % ControlToken::CHECK_INTERVAL == 0) {
+                token->check();
+            }
+        }
+        HandleRunView run{run_handles.data() + run_offsets[i], run_offsets[i + 1] - run_offsets[i]};
 #ifdef debug
-        std::cerr << "Unchop " << comp.size() << " nodes together" << std::endl;
+        std::cerr << "Unchop " << run.size() << " nodes together" << std::endl;
 #endif
-        if (comp.size() >= 2) {
-            // sort by lowest rank to maintain order
-            double rank_sum = 0;
-            for (auto& handle : comp) {
-                rank_sum += node_rank[graph.get_id(handle)];
-            }
-            double rank_v = rank_sum / comp.size();
-            handle_t n = concat_nodes(graph, comp);
-            ordered_handles.push_back(std::make_pair(rank_v, n));
-            //node_order.push_back(graph.get_id(n));
-            num_node_unchopped += comp.size();
-            num_new_nodes++;
-        } else {
-            for (auto& c : comp) {
-                ordered_handles.push_back(std::make_pair(node_rank[graph.get_id(c)], c));
-            }
+        // sort by lowest rank to maintain order
+        double rank_sum = 0;
+        for (auto& handle : run) {
+            rank_sum += node_rank[graph.get_id(handle)];
         }
+        double rank_v = rank_sum / run.size();
+        handle_t n = concat_nodes(graph, run);
+        ordered_handles.push_back(std::make_pair(rank_v, n));
     }
-    
+
     assert(graph.get_node_count() == ordered_handles.size());
-    
+
+    if (token) {
+        token->begin_phase("applying new order");
+    }
     sort(ordered_handles.begin(), ordered_handles.end(),
          [](const pair<double, handle_t>& a, const pair<double, handle_t>& b) {
         return a.first < b.first || (a.first == b.first && as_integer(a.second) < as_integer(b.second));
@@ -762,14 +862,32 @@ void unchop(MutablePathDeletableHandleGraph& graph) {
     graph.apply_ordering(handle_order, true);
 }
 
-static void chop(MutablePathDeletableHandleGraph& graph, size_t max_node_length, const std::function<void(nid_t, size_t, size_t, handle_t)>* record_change) {
+std::pair<size_t, size_t> unchop_dry_run(const PathHandleGraph& graph) {
+    // Just find the runs, without touching anything.
+    std::vector<handle_t> run_handles;
+    std::vector<size_t> run_offsets;
+    flat_simple_components(graph, 2, run_handles, run_offsets);
+    return std::make_pair(run_handles.size(), run_offsets.size() - 1);
+}
+
+static void chop(MutablePathDeletableHandleGraph& graph, size_t max_node_length, const std::function<void(nid_t, size_t, size_t, handle_t)>* record_change, size_t thread_count = 1, MemoryResource* resource = nullptr, ControlToken* token = nullptr) {
     // borrowed from https://github.com/vgteam/odgi/blob/master/src/subcommand/chop_main.cpp
-    
-    std::vector<std::tuple<uint64_t, uint64_t, handle_t>> originalRank_inChoppedNodeRank_handle;
-    std::vector<std::pair<uint64_t, handle_t>> originalRank_handleToChop;
-    std::vector<nid_t> originalId;
+
+    if (token) {
+        token->begin_phase("scanning nodes", graph.get_node_count());
+    }
+
+    resource_vector<std::tuple<uint64_t, uint64_t, handle_t>> originalRank_inChoppedNodeRank_handle{ResourceAllocator<std::tuple<uint64_t, uint64_t, handle_t>>(resource)};
+    resource_vector<std::pair<uint64_t, handle_t>> originalRank_handleToChop{ResourceAllocator<std::pair<uint64_t, handle_t>>(resource)};
+    resource_vector<nid_t> originalId{ResourceAllocator<nid_t>(resource)};
     uint64_t rank = 0;
     graph.for_each_handle([&](const handle_t& handle) {
+        if (token) {
+            token->advance();
+            if (rank % ControlToken::CHECK_INTERVAL == 0) {
+                token->check();
+            }
+        }
         if (graph.get_length(handle) > max_node_length) {
             originalRank_handleToChop.push_back(std::make_pair(rank, handle));
         } else {
@@ -789,24 +907,55 @@ static void chop(MutablePathDeletableHandleGraph& graph, size_t max_node_length,
         return;
     }
     
-    for (auto rank_handle : originalRank_handleToChop) {
-        // get divide points
-        uint64_t length = graph.get_length(rank_handle.second);
-        std::vector<size_t> offsets;
-        for (uint64_t i = max_node_length; i < length; i += max_node_length) {
-            offsets.push_back(i);
+    // Plan all the divide points up front. The planning only reads the graph,
+    // so it can go wide even though the divisions themselves can't.
+    if (token) {
+        token->begin_phase("planning cut points", originalRank_handleToChop.size());
+    }
+    resource_vector<std::vector<size_t>> planned_offsets(originalRank_handleToChop.size(),
+                                                         ResourceAllocator<std::vector<size_t>>(resource));
+    parallel_for(originalRank_handleToChop.size(), [&](size_t i) {
+        if (token) {
+            if (token->is_cancelled()) {
+                // Don't throw across the worker threads; the check after the
+                // parallel region will.
+                return;
+            }
+            token->advance();
         }
-        
+        uint64_t length = graph.get_length(originalRank_handleToChop[i].second);
+        auto& offsets = planned_offsets[i];
+        offsets.reserve(length / max_node_length);
+        for (uint64_t j = max_node_length; j < length; j += max_node_length) {
+            offsets.push_back(j);
+        }
+    }, thread_count);
+
+    if (token) {
+        token->begin_phase("dividing nodes", originalRank_handleToChop.size());
+    }
+    for (size_t i = 0; i < originalRank_handleToChop.size(); i++) {
+        if (token) {
+            token->advance();
+            if (i % ControlToken::CHECK_INTERVAL == 0) {
+                token->check();
+            }
+        }
+        auto& rank_handle = originalRank_handleToChop[i];
+
         rank = 0;
-        for (auto chopped_handle : graph.divide_handle(rank_handle.second, offsets)) {
+        for (auto chopped_handle : graph.divide_handle(rank_handle.second, planned_offsets[i])) {
             originalRank_inChoppedNodeRank_handle.emplace_back(rank_handle.first, rank, chopped_handle);
-            
+
             rank++;
         }
     }
     
+    if (token) {
+        token->begin_phase("applying new order");
+    }
     sort(originalRank_inChoppedNodeRank_handle.begin(), originalRank_inChoppedNodeRank_handle.end());
-    
+
     std::vector<handle_t> new_handles;
     for (auto x_y_z : originalRank_inChoppedNodeRank_handle) {
         new_handles.push_back(std::get<2>(x_y_z));
@@ -826,6 +975,9 @@ static void chop(MutablePathDeletableHandleGraph& graph, size_t max_node_length,
     };
     
     if (record_change) {
+        if (token) {
+            token->begin_phase("recording changes", originalRank_inChoppedNodeRank_handle.size());
+        }
         // We need to announce our changes
         // Nodes are now numbered 1 to n in correspondence with
         // originalRank_inChoppedNodeRank_handle.
@@ -844,6 +996,12 @@ static void chop(MutablePathDeletableHandleGraph& graph, size_t max_node_length,
         // We set this to the rank of the original node we are at.
         size_t originalRank = 0;
         for (size_t newRank = 0; newRank < originalRank_inChoppedNodeRank_handle.size(); newRank++) {
+            if (token) {
+                token->advance();
+                if (newRank % ControlToken::CHECK_INTERVAL == 0) {
+                    token->check();
+                }
+            }
             if (pieces.empty()) {
                 // We have started a new original node.
                 // Grab its rank
@@ -902,6 +1060,38 @@ void chop(MutablePathDeletableHandleGraph& graph, size_t max_node_length) {
     chop(graph, max_node_length, nullptr);
 }
 
+void chop(MutablePathDeletableHandleGraph& graph, size_t max_node_length, size_t thread_count,
+          MemoryResource* resource, ControlToken* token) {
+    chop(graph, max_node_length, nullptr, thread_count, resource, token);
+}
+
+void chop(MutablePathDeletableHandleGraph& graph, size_t max_node_length, size_t thread_count,
+          const std::function<void(const std::vector<chop_change_t>&)>& record_changes,
+          MemoryResource* resource, ControlToken* token) {
+    // Collect the per-fragment records and hand them over in one call.
+    std::vector<chop_change_t> changes;
+    std::function<void(nid_t, size_t, size_t, handle_t)> collect =
+        [&](nid_t old_id, size_t offset, size_t rev_offset, handle_t new_handle) {
+        changes.emplace_back(old_id, offset, rev_offset, new_handle);
+    };
+    chop(graph, max_node_length, &collect, thread_count, resource, token);
+    record_changes(changes);
+}
+
+NodeTranslation chop_and_translate(MutablePathDeletableHandleGraph& graph, size_t max_node_length,
+                                   size_t thread_count, ControlToken* token) {
+    // Collect the change records straight into the flat translation; the new
+    // pieces keep the local forward orientation of the original nodes.
+    NodeTranslation translation;
+    std::function<void(nid_t, size_t, size_t, handle_t)> collect =
+        [&](nid_t old_id, size_t offset, size_t rev_offset, handle_t new_handle) {
+        translation.add_translation(graph.get_id(new_handle), old_id, offset, rev_offset, false);
+    };
+    chop(graph, max_node_length, &collect, thread_count, nullptr, token);
+    translation.index();
+    return translation;
+}
+
 
 }
 }
@@ -0,0 +1,301 @@
+#include "handlegraph/compressed_serialization.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+/** \file compressed_serialization.cpp
+ * Implement the framed-chunk compressed container streams
+ */
+
+namespace handlegraph {
+
+namespace {
+
+// The chunk payload is a byte-oriented LZ format. A chunk is a series of
+// sequences: a token byte whose high nibble is the literal count and whose
+// low nibble is the match length minus MIN_MATCH (a nibble of 15 means more
+// length follows in 255-continued bytes), then the literals, then a 2-byte
+// little-endian match offset. The final sequence of a chunk is literals only.
+// Matches never reach outside their own chunk, so chunks stand alone.
+
+/// Matches shorter than this don't pay for their token
+const size_t MIN_MATCH = 4;
+
+/// log2 of the match-finder hash table size
+const size_t HASH_BITS = 13;
+
+inline uint32_t read32(const uint8_t* at) {
+    uint32_t value;
+    std::memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+inline size_t hash32(uint32_t value) {
+    // Knuth's multiplicative hash
+    return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/// append a 255-continued length extension
+void put_length(std::vector<uint8_t>& out, size_t extra) {
+    while (extra >= 255) {
+        out.push_back(255);
+        extra -= 255;
+    }
+    out.push_back(extra);
+}
+
+/// parse a 255-continued length extension
+size_t take_length(const uint8_t* in, size_t in_size, size_t& cursor) {
+    size_t extra = 0;
+    uint8_t piece;
+    do {
+        if (cursor >= in_size) {
+            throw std::runtime_error("error:[CompressedIstream] truncated length in compressed chunk");
+        }
+        piece = in[cursor++];
+        extra += piece;
+    } while (piece == 255);
+    return extra;
+}
+
+/// append one sequence: the literals in [literal_start, literal_end) and, if
+/// offset is nonzero, a match of match_length bytes at that offset back
+void put_sequence(std::vector<uint8_t>& out, const uint8_t* in,
+                  size_t literal_start, size_t literal_end,
+                  size_t match_length, size_t offset) {
+    size_t literal_count = literal_end - literal_start;
+    size_t match_extra = offset != 0 ? match_length - MIN_MATCH : 0;
+    uint8_t token = (literal_count < 15 ? literal_count : 15) << 4;
+    token |= match_extra < 15 ? match_extra : 15;
+    out.push_back(token);
+    if (literal_count >= 15) {
+        put_length(out, literal_count - 15);
+    }
+    out.insert(out.end(), in + literal_start, in + literal_end);
+    if (offset != 0) {
+        out.push_back(offset & 0xFF);
+        out.push_back(offset >> 8);
+        if (match_extra >= 15) {
+            put_length(out, match_extra - 15);
+        }
+    }
+}
+
+/// compress one chunk into out, which is cleared first
+void compress_chunk(const uint8_t* in, size_t in_size, std::vector<uint8_t>& out) {
+    out.clear();
+    std::vector<int64_t> last_seen(1 << HASH_BITS, -1);
+    size_t literal_start = 0;
+    size_t at = 0;
+    while (at + MIN_MATCH <= in_size) {
+        uint32_t here = read32(in + at);
+        size_t bucket = hash32(here);
+        int64_t candidate = last_seen[bucket];
+        last_seen[bucket] = at;
+        if (candidate >= 0 && at - candidate <= 0xFFFF && read32(in + candidate) == here) {
+            size_t match_length = MIN_MATCH;
+            while (at + match_length < in_size && in[candidate + match_length] == in[at + match_length]) {
+                match_length++;
+            }
+            put_sequence(out, in, literal_start, at, match_length, at - candidate);
+            at += match_length;
+            literal_start = at;
+        }
+        else {
+            at++;
+        }
+    }
+    if (literal_start < in_size) {
+        put_sequence(out, in, literal_start, in_size, 0, 0);
+    }
+}
+
+/// decompress one chunk; throws if it doesn't decode to exactly out_size bytes
+void decompress_chunk(const uint8_t* in, size_t in_size, uint8_t* out, size_t out_size) {
+    size_t cursor = 0;
+    size_t made = 0;
+    while (made < out_size) {
+        if (cursor >= in_size) {
+            throw std::runtime_error("error:[CompressedIstream] truncated compressed chunk");
+        }
+        uint8_t token = in[cursor++];
+        size_t literal_count = token >> 4;
+        if (literal_count == 15) {
+            literal_count += take_length(in, in_size, cursor);
+        }
+        if (cursor + literal_count > in_size || made + literal_count > out_size) {
+            throw std::runtime_error("error:[CompressedIstream] corrupt literal run in compressed chunk");
+        }
+        std::memcpy(out + made, in + cursor, literal_count);
+        cursor += literal_count;
+        made += literal_count;
+        if (made == out_size) {
+            // the final sequence carries no match
+            break;
+        }
+        if (cursor + 2 > in_size) {
+            throw std::runtime_error("error:[CompressedIstream] truncated match in compressed chunk");
+        }
+        size_t offset = in[cursor] | ((size_t) in[cursor + 1] << 8);
+        cursor += 2;
+        size_t match_extra = token & 15;
+        if (match_extra == 15) {
+            match_extra += take_length(in, in_size, cursor);
+        }
+        size_t match_length = match_extra + MIN_MATCH;
+        if (offset == 0 || offset > made || made + match_length > out_size) {
+            throw std::runtime_error("error:[CompressedIstream] corrupt match in compressed chunk");
+        }
+        // copy byte by byte; the match may overlap its own output
+        for (size_t i = 0; i < match_length; i++) {
+            out[made + i] = out[made - offset + i];
+        }
+        made += match_length;
+    }
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Compressing output stream
+////////////////////////////////////////////////////////////////////////////
+
+class CompressedOstream::Buf : public std::streambuf {
+
+public:
+
+    Buf(std::ostream& backing) : backing(backing), buffer(CHUNK_SIZE) {
+        setp((char*) buffer.data(), (char*) buffer.data() + buffer.size());
+    }
+
+    /// Flush the last chunk and write the empty terminator frame.
+    void finish() {
+        if (finished) {
+            return;
+        }
+        flush_chunk();
+        uint64_t frame[2] = {0, 0};
+        backing.write((char*) frame, sizeof(frame));
+        backing.flush();
+        finished = true;
+    }
+
+protected:
+
+    int overflow(int c) {
+        flush_chunk();
+        if (c != traits_type::eof()) {
+            return sputc(c);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() {
+        flush_chunk();
+        backing.flush();
+        return backing ? 0 : -1;
+    }
+
+private:
+
+    /// Compress and frame whatever is buffered. Chunks that don't shrink are
+    /// stored raw, flagged by an on-disk size equal to the data size.
+    void flush_chunk() {
+        size_t have = pptr() - pbase();
+        if (have == 0) {
+            return;
+        }
+        compress_chunk(buffer.data(), have, scratch);
+        uint64_t frame[2] = {have, scratch.size() < have ? scratch.size() : have};
+        backing.write((char*) frame, sizeof(frame));
+        if (scratch.size() < have) {
+            backing.write((char*) scratch.data(), scratch.size());
+        }
+        else {
+            backing.write((char*) buffer.data(), have);
+        }
+        setp((char*) buffer.data(), (char*) buffer.data() + buffer.size());
+    }
+
+    std::ostream& backing;
+    std::vector<uint8_t> buffer;
+    std::vector<uint8_t> scratch;
+    bool finished = false;
+
+    friend class CompressedOstream;
+};
+
+CompressedOstream::CompressedOstream(std::ostream& backing)
+    : std::ostream(nullptr), buf(new Buf(backing)) {
+    rdbuf(buf.get());
+}
+
+CompressedOstream::~CompressedOstream() {
+    buf->finish();
+}
+
+void CompressedOstream::finish() {
+    buf->finish();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Decompressing input stream
+////////////////////////////////////////////////////////////////////////////
+
+class CompressedIstream::Buf : public std::streambuf {
+
+public:
+
+    Buf(std::istream& backing) : backing(backing) {
+        // nothing buffered until the first read
+    }
+
+protected:
+
+    int underflow() {
+        if (gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
+        // pull the next frame
+        uint64_t frame[2];
+        backing.read((char*) frame, sizeof(frame));
+        if (!backing) {
+            throw std::runtime_error("error:[CompressedIstream] compressed container is missing its end marker");
+        }
+        if (frame[0] == 0) {
+            // the terminator: the container is over
+            return traits_type::eof();
+        }
+        scratch.resize(frame[1]);
+        backing.read((char*) scratch.data(), scratch.size());
+        if (!backing) {
+            throw std::runtime_error("error:[CompressedIstream] truncated compressed container");
+        }
+        buffer.resize(frame[0]);
+        if (frame[1] == frame[0]) {
+            // the chunk was stored raw
+            std::memcpy(buffer.data(), scratch.data(), frame[0]);
+        }
+        else {
+            decompress_chunk(scratch.data(), scratch.size(), buffer.data(), buffer.size());
+        }
+        setg((char*) buffer.data(), (char*) buffer.data(), (char*) buffer.data() + buffer.size());
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+
+    std::istream& backing;
+    std::vector<uint8_t> buffer;
+    std::vector<uint8_t> scratch;
+};
+
+CompressedIstream::CompressedIstream(std::istream& backing)
+    : std::istream(nullptr), buf(new Buf(backing)) {
+    rdbuf(buf.get());
+}
+
+CompressedIstream::~CompressedIstream() = default;
+
+}
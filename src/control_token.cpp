@@ -0,0 +1,60 @@
+#include "handlegraph/control_token.hpp"
+
+/** \file control_token.cpp
+ * Implement the cancellation and progress token.
+ */
+
+namespace handlegraph {
+
+CancelledError::CancelledError(const std::string& phase) :
+    std::runtime_error("error:[ControlToken] cancelled during " + phase) {
+    // Nothing to do
+}
+
+void ControlToken::cancel() {
+    cancel_flag.store(true);
+}
+
+bool ControlToken::is_cancelled() const {
+    return cancel_flag.load();
+}
+
+double ControlToken::get_progress() const {
+    size_t total = total_items.load();
+    if (total == 0) {
+        return 0.0;
+    }
+    size_t done = done_items.load();
+    if (done > total) {
+        // An estimate undershot; don't report more than complete.
+        done = total;
+    }
+    return (double)done / (double)total;
+}
+
+std::string ControlToken::get_phase() const {
+    std::lock_guard<std::mutex> guard(phase_mutex);
+    return phase_name;
+}
+
+void ControlToken::begin_phase(const std::string& name, size_t total) {
+    {
+        std::lock_guard<std::mutex> guard(phase_mutex);
+        phase_name = name;
+    }
+    done_items.store(0);
+    total_items.store(total);
+    check();
+}
+
+void ControlToken::advance(size_t items) {
+    done_items.fetch_add(items, std::memory_order_relaxed);
+}
+
+void ControlToken::check() const {
+    if (cancel_flag.load()) {
+        throw CancelledError(get_phase());
+    }
+}
+
+}
@@ -1,6 +1,10 @@
 #include "handlegraph/algorithms/copy_graph.hpp"
 
+#include "handlegraph/parallel.hpp"
+
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 namespace handlegraph {
 namespace algorithms {
@@ -34,6 +38,90 @@ void copy_handle_graph(const HandleGraph* from, MutableHandleGraph* into) {
     });
 }
 
+void copy_handle_graph(const HandleGraph* from, MutableHandleGraph* into, size_t thread_count,
+                       ControlToken* token) {
+
+    if (from == nullptr) {
+        throw std::runtime_error("error:[copy_handle_graph] must supply graph to copy from");
+    }
+    if (into == nullptr) {
+        throw std::runtime_error("error:[copy_handle_graph] must supply graph to copy into");
+    }
+
+    // snapshot the nodes so we can read them by index
+    if (token) {
+        token->begin_phase("snapshotting nodes");
+    }
+    std::vector<handle_t> handles;
+    handles.reserve(from->get_node_count());
+    from->for_each_handle([&](const handle_t& handle) {
+        handles.push_back(handle);
+    });
+
+    // read the sequences, IDs, and edges across threads; each edge is
+    // collected from its lower-ID endpoint so we see it exactly once
+    if (token) {
+        token->begin_phase("reading source graph", handles.size());
+    }
+    std::vector<std::string> sequences(handles.size());
+    std::vector<nid_t> ids(handles.size());
+    std::vector<std::vector<edge_t>> node_edges(handles.size());
+    parallel_for(handles.size(), [&](size_t i) {
+        if (token) {
+            if (token->is_cancelled()) {
+                // Don't throw across the worker threads; the check after the
+                // parallel region will.
+                return;
+            }
+            token->advance();
+        }
+        const handle_t& handle = handles[i];
+        sequences[i] = from->get_sequence(handle);
+        ids[i] = from->get_id(handle);
+        auto& edges_here = node_edges[i];
+        from->follow_edges(handle, false, [&](const handle_t& next) {
+            if (from->get_id(handle) <= from->get_id(next)) {
+                edges_here.emplace_back(handle, next);
+            }
+        });
+        from->follow_edges(handle, true, [&](const handle_t& prev) {
+            if (from->get_id(handle) < from->get_id(prev) ||
+                (from->get_id(handle) == from->get_id(prev) && from->get_is_reverse(prev))) {
+                edges_here.emplace_back(prev, handle);
+            }
+        });
+    }, thread_count);
+
+    if (token) {
+        token->begin_phase("writing nodes and edges");
+    }
+
+    // let the destination preallocate
+    size_t total_edges = 0;
+    size_t total_bp = 0;
+    for (size_t i = 0; i < handles.size(); i++) {
+        total_edges += node_edges[i].size();
+        total_bp += sequences[i].size();
+    }
+    into->reserve(handles.size(), total_edges, total_bp);
+
+    // copy nodes
+    into->create_handles(sequences, ids);
+
+    // translate the edges onto the destination's handles and copy them
+    std::vector<edge_t> edges;
+    edges.reserve(total_edges);
+    for (const auto& edges_here : node_edges) {
+        for (const edge_t& edge : edges_here) {
+            edges.emplace_back(into->get_handle(from->get_id(edge.first),
+                                                from->get_is_reverse(edge.first)),
+                               into->get_handle(from->get_id(edge.second),
+                                                from->get_is_reverse(edge.second)));
+        }
+    }
+    into->create_edges(edges);
+}
+
 void copy_path_handle_graph(const PathHandleGraph* from, MutablePathMutableHandleGraph* into) {
     
     // copy topology
@@ -53,6 +141,84 @@ void copy_path_handle_graph(const PathHandleGraph* from, MutablePathMutableHandl
     }
 }
 
+void copy_path_handle_graph(const PathHandleGraph* from, MutablePathMutableHandleGraph* into,
+                            size_t thread_count, ControlToken* token) {
+
+    // copy topology
+    copy_handle_graph(from, into, thread_count, token);
+
+    // snapshot the paths, in the order the serial version visits them
+    std::vector<path_handle_t> paths;
+    for (auto& sense : {PathSense::REFERENCE, PathSense::GENERIC, PathSense::HAPLOTYPE}) {
+        from->for_each_path_of_sense(sense, [&](const path_handle_t& path_handle) {
+            paths.push_back(path_handle);
+        });
+    }
+
+    // the parts of a path we can read without touching the destination
+    struct PathCopy {
+        PathSense sense;
+        std::string sample;
+        std::string locus;
+        size_t haplotype;
+        size_t phase_block;
+        subrange_t subrange;
+        bool is_circular;
+        std::vector<handle_t> steps;
+    };
+
+    // read the paths' metadata and steps across threads
+    if (token) {
+        token->begin_phase("reading paths", paths.size());
+    }
+    std::vector<PathCopy> copies(paths.size());
+    parallel_for(paths.size(), [&](size_t i) {
+        if (token) {
+            if (token->is_cancelled()) {
+                return;
+            }
+            token->advance();
+        }
+        const path_handle_t& path_handle = paths[i];
+        auto& copy = copies[i];
+        copy.sense = from->get_sense(path_handle);
+        copy.sample = from->get_sample_name(path_handle);
+        copy.locus = from->get_locus_name(path_handle);
+        copy.haplotype = from->get_haplotype(path_handle);
+        copy.phase_block = from->get_phase_block(path_handle);
+        copy.subrange = from->get_subrange(path_handle);
+        copy.is_circular = from->get_is_circular(path_handle);
+        copy.steps.reserve(from->get_step_count(path_handle));
+        for (handle_t handle : from->scan_path(path_handle)) {
+            copy.steps.push_back(handle);
+        }
+    }, thread_count);
+
+    // write the paths into the destination serially, a whole path's steps
+    // at a time
+    if (token) {
+        token->begin_phase("writing paths", copies.size());
+    }
+    size_t paths_written = 0;
+    for (const auto& copy : copies) {
+        if (token) {
+            token->advance();
+            if (paths_written++ % ControlToken::CHECK_INTERVAL == 0) {
+                token->check();
+            }
+        }
+        path_handle_t into_path = into->create_path(copy.sense, copy.sample, copy.locus,
+                                                    copy.haplotype, copy.phase_block,
+                                                    copy.subrange, copy.is_circular);
+        std::vector<handle_t> into_steps(copy.steps.size());
+        for (size_t i = 0; i < copy.steps.size(); i++) {
+            into_steps[i] = into->get_handle(from->get_id(copy.steps[i]),
+                                             from->get_is_reverse(copy.steps[i]));
+        }
+        into->append_steps(into_path, into_steps);
+    }
+}
+
 void copy_path(const PathHandleGraph* from, const path_handle_t& from_path,
                MutablePathHandleGraph* into) {
     
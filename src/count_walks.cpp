@@ -1,11 +1,124 @@
 #include "handlegraph/algorithms/count_walks.hpp"
 #include "handlegraph/algorithms/topological_sort.hpp"
+#include "handlegraph/parallel.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
 
 namespace handlegraph {
 namespace algorithms {
 
 using namespace std;
 
+/**
+ * Shared engine for the parallel counting modes. Processes the DAG level by
+ * level: a node is claimed when the last of its predecessors is processed,
+ * and computes its own count by pulling the predecessors' finalized counts,
+ * so no count is ever written by more than one thread. Num is the count
+ * representation; add combines two counts and may flag overflow.
+ */
+template<typename Num, typename Add>
+tuple<vector<handle_t>, unordered_map<handle_t, Num>, bool>
+count_walks_engine(const HandleGraph* graph, size_t thread_count,
+                   const Num zero, const Num one, const Add& add) {
+
+    tuple<vector<handle_t>, unordered_map<handle_t, Num>, bool> to_return;
+
+    vector<handle_t>& sinks = get<0>(to_return);
+    unordered_map<handle_t, Num>& count = get<1>(to_return);
+    bool& overflowed = get<2>(to_return);
+    overflowed = false;
+
+    // snapshot and index the nodes
+    vector<handle_t> handles;
+    handles.reserve(graph->get_node_count());
+    graph->for_each_handle([&](const handle_t& handle) {
+        handles.push_back(handle);
+    });
+    unordered_map<handle_t, size_t> index_of;
+    index_of.reserve(handles.size());
+    for (size_t i = 0; i < handles.size(); i++) {
+        index_of[handles[i]] = i;
+    }
+
+    // count the unprocessed predecessors of each node and find the sinks
+    unique_ptr<atomic<uint64_t>[]> in_degree(new atomic<uint64_t>[handles.size()]);
+    vector<uint8_t> is_sink(handles.size(), 0);
+    parallel_for(handles.size(), [&](size_t i) {
+        in_degree[i].store(graph->get_degree(handles[i], true), memory_order_relaxed);
+        if (graph->get_degree(handles[i], false) == 0) {
+            is_sink[i] = 1;
+        }
+    }, thread_count);
+
+    // the sources make up the first level
+    vector<size_t> frontier;
+    for (size_t i = 0; i < handles.size(); i++) {
+        if (in_degree[i].load(memory_order_relaxed) == 0) {
+            frontier.push_back(i);
+        }
+    }
+
+    vector<Num> value(handles.size(), zero);
+    atomic<bool> overflow_flag(false);
+
+    // the nodes each frontier slot releases for the next level
+    vector<vector<size_t>> produced;
+
+    while (!frontier.empty()) {
+        produced.assign(frontier.size(), vector<size_t>());
+
+        parallel_for(frontier.size(), [&](size_t slot) {
+            size_t i = frontier[slot];
+            const handle_t& handle = handles[i];
+
+            // pull the finalized counts from the predecessors; a node with
+            // none is a source and counts one walk
+            bool any_predecessor = false;
+            Num here = zero;
+            bool over = false;
+            graph->follow_edges(handle, true, [&](const handle_t& prev) {
+                any_predecessor = true;
+                here = add(here, value[index_of.at(prev)], over);
+            });
+            value[i] = any_predecessor ? here : one;
+            if (over) {
+                overflow_flag.store(true, memory_order_relaxed);
+            }
+
+            // release the successors whose last predecessor this was
+            auto& bucket = produced[slot];
+            graph->follow_edges(handle, false, [&](const handle_t& next) {
+                size_t j = index_of.at(next);
+                if (in_degree[j].fetch_sub(1, memory_order_acq_rel) == 1) {
+                    bucket.push_back(j);
+                }
+            });
+        }, thread_count);
+
+        // assemble the next level
+        vector<size_t> next_frontier;
+        for (const auto& bucket : produced) {
+            next_frontier.insert(next_frontier.end(), bucket.begin(), bucket.end());
+        }
+        frontier = std::move(next_frontier);
+    }
+
+    overflowed = overflow_flag.load();
+
+    // deliver the results in the expected shape
+    count.reserve(handles.size());
+    for (size_t i = 0; i < handles.size(); i++) {
+        count[handles[i]] = value[i];
+        if (is_sink[i]) {
+            sinks.push_back(handles[i]);
+        }
+    }
+    return to_return;
+}
+
 tuple<vector<handle_t>, unordered_map<handle_t, size_t>, bool> count_walks_through_nodes(const HandleGraph* graph) {
     
     
@@ -51,6 +164,38 @@ tuple<vector<handle_t>, unordered_map<handle_t, size_t>, bool> count_walks_throu
     return to_return;
 }
 
+tuple<vector<handle_t>, unordered_map<handle_t, size_t>, bool> count_walks_through_nodes(const HandleGraph* graph, size_t thread_count) {
+    return count_walks_engine<size_t>(graph, thread_count, 0, 1,
+                                      [](size_t a, size_t b, bool& overflow) -> size_t {
+        if (numeric_limits<size_t>::max() - a < b) {
+            overflow = true;
+            return numeric_limits<size_t>::max();
+        }
+        return a + b;
+    });
+}
+
+/// Add two natural-log-space counts: ln(e^a + e^b), stably.
+static double log_space_add(double a, double b) {
+    if (a == -numeric_limits<double>::infinity()) {
+        return b;
+    }
+    if (b == -numeric_limits<double>::infinity()) {
+        return a;
+    }
+    double larger = max(a, b);
+    return larger + log1p(exp(min(a, b) - larger));
+}
+
+pair<vector<handle_t>, unordered_map<handle_t, double>> count_walks_through_nodes_log(const HandleGraph* graph, size_t thread_count) {
+    auto result = count_walks_engine<double>(graph, thread_count,
+                                             -numeric_limits<double>::infinity(), 0.0,
+                                             [](double a, double b, bool& overflow) -> double {
+        return log_space_add(a, b);
+    });
+    return make_pair(std::move(get<0>(result)), std::move(get<1>(result)));
+}
+
 size_t count_walks(const HandleGraph* graph){
     
     tuple<vector<handle_t>, unordered_map<handle_t, size_t>, bool>  to_receive = count_walks_through_nodes(graph);
@@ -73,5 +218,20 @@ size_t count_walks(const HandleGraph* graph){
     }
     return total_count;
 }
+
+double count_walks_log(const HandleGraph* graph, size_t thread_count) {
+
+    auto to_receive = count_walks_through_nodes_log(graph, thread_count);
+
+    vector<handle_t>& sinks = to_receive.first;
+    unordered_map<handle_t, double>& count = to_receive.second;
+
+    // total up the walks at the sinks, in log space
+    double total_count = -numeric_limits<double>::infinity();
+    for (handle_t& sink : sinks) {
+        total_count = log_space_add(total_count, count[sink]);
+    }
+    return total_count;
+}
 }
 }
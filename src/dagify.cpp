@@ -6,8 +6,10 @@
 
 //#define debug_dagify
 #include <vector>
+#include <algorithm>
 #include <unordered_set>
 #include <atomic>
+#include <functional>
 
 #include "handlegraph/expanding_overlay_graph.hpp"
 #include "handlegraph/algorithms/dagify.hpp"
@@ -15,6 +17,7 @@
 #include "handlegraph/algorithms/strongly_connected_components.hpp"
 #include "handlegraph/algorithms/eades_algorithm.hpp"
 #include "handlegraph/algorithms/internal/dfs.hpp"
+#include "handlegraph/parallel.hpp"
 
 namespace handlegraph {
 namespace algorithms {
@@ -63,14 +66,14 @@ public:
     /// Loop over all the handles to next/previous (right/left) nodes. Passes
     /// them to a callback which returns false to stop iterating and true to
     /// continue. Returns true if we finished and false if we stopped early.
-    bool follow_edges_impl(const handle_t& handle, bool go_left, const function<bool(const handle_t&)>& iteratee) const;
+    bool follow_edges_impl(const handle_t& handle, bool go_left, function_ref<bool(const handle_t&)> iteratee) const;
     
     /// Loop over all the nodes in the graph in their local forward
     /// orientations, in their internal stored order. Stop if the iteratee
     /// returns false. Can be told to run in parallel, in which case stopping
     /// after a false return value is on a best-effort basis and iteration
     /// order is not defined.
-    bool for_each_handle_impl(const function<bool(const handle_t&)>& iteratee, bool parallel = false) const;
+    bool for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee, bool parallel = false) const;
     
     /// Return the number of nodes in the graph
     size_t get_node_count() const;
@@ -150,7 +153,7 @@ string SubHandleGraph::get_sequence(const handle_t& handle) const {
     return super->get_sequence(handle);
 }
 
-bool SubHandleGraph::follow_edges_impl(const handle_t& handle, bool go_left, const function<bool(const handle_t&)>& iteratee) const {
+bool SubHandleGraph::follow_edges_impl(const handle_t& handle, bool go_left, function_ref<bool(const handle_t&)> iteratee) const {
     // only let it travel along edges whose endpoints are in the subgraph
     bool keep_going = true;
     super->follow_edges(handle, go_left, [&](const handle_t& handle) {
@@ -162,7 +165,7 @@ bool SubHandleGraph::follow_edges_impl(const handle_t& handle, bool go_left, con
     return keep_going;
 }
 
-bool SubHandleGraph::for_each_handle_impl(const function<bool(const handle_t&)>& iteratee, bool parallel) const {
+bool SubHandleGraph::for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee, bool parallel) const {
     // non-parallel so we don't pull in any dependencies
     for (nid_t node_id : contents) {
         if (!iteratee(super->get_handle(node_id))) {
@@ -191,13 +194,32 @@ handle_t SubHandleGraph::get_underlying_handle(const handle_t& handle) const {
 
 // TODO: SubHandleGraph port over
 
-unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph, MutableHandleGraph* into,
-                                   size_t min_preserved_path_length) {
-    
-    // initialize the translator from the dagified graph back to the original graph
-    unordered_map<nid_t, nid_t> translator;
-    
+/// The per-SCC unrolling decisions, which can be made without touching the
+/// graph we are building into
+struct SCCUnrollingPlan {
+    /// the component's layout, in the graph's canonical orientation
+    vector<handle_t> layout;
+    /// for each layout index, the layout indices its forward edges lead to
+    vector<vector<size_t>> forward_edges;
+    /// the backward edges, as pairs of layout indices
+    vector<pair<size_t, size_t>> backward_edges;
+    /// how many copies of the component we will make
+    size_t copies = 0;
+};
+
+static void dagify_internal(const HandleGraph* graph, MutableHandleGraph* into,
+                            size_t min_preserved_path_length,
+                            const function<size_t(size_t, size_t)>& copies_policy,
+                            size_t max_output_nodes,
+                            size_t thread_count,
+                            MemoryResource* resource,
+                            ControlToken* token,
+                            const function<void(const nid_t&, const nid_t&)>& record_translation) {
+
     // generate a canonical orientation across the graph
+    if (token) {
+        token->begin_phase("finding canonical orientation");
+    }
     vector<handle_t> orientation = single_stranded_orientation(graph);
     
     if (orientation.size() < graph->get_node_count()) {
@@ -213,7 +235,7 @@ unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph, MutableHandleGraph*
 #endif
     
     // mark the ones that whose canonical orientation is reversed
-    unordered_set<nid_t> reversed_nodes;
+    resource_unordered_set<nid_t> reversed_nodes{ResourceAllocator<nid_t>(resource)};
     for (size_t i = 0; i < orientation.size(); i++) {
         if (graph->get_is_reverse(orientation[i])) {
             reversed_nodes.insert(graph->get_id(orientation[i]));
@@ -221,6 +243,9 @@ unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph, MutableHandleGraph*
     }
     
     // find the strongly connected components of the original graph
+    if (token) {
+        token->begin_phase("finding strongly connected components");
+    }
     vector<unordered_set<nid_t>> strong_components = strongly_connected_components(graph);
     
 #ifdef debug_dagify
@@ -235,26 +260,42 @@ unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph, MutableHandleGraph*
     
     // duplicate strongly connected components into the dagified graph in such a way
     // that paths are preserved
-    
+
     // a tracker for which SCC a node belongs to
-    unordered_map<nid_t, size_t> component_of;
-    // a map from a node in the original graph to all its copies (in order) in the
-    // dagified graph
-    unordered_map<handle_t, vector<handle_t>> injector;
+    resource_unordered_map<nid_t, size_t> component_of{ResourceAllocator<pair<const nid_t, size_t>>(resource)};
     for (size_t i = 0; i < strong_components.size(); i++) {
-        
+        for (nid_t node_id : strong_components[i]) {
+            component_of[node_id] = i;
+        }
+    }
+
+    // decide how each SCC will be unrolled; the unrollings of distinct SCCs
+    // don't interact, and this phase only reads the original graph, so the
+    // components can be planned in parallel
+    if (token) {
+        token->begin_phase("planning component unrollings", strong_components.size());
+    }
+    vector<SCCUnrollingPlan> plans(strong_components.size());
+    parallel_for(strong_components.size(), [&](size_t i) {
+
+        if (token) {
+            if (token->is_cancelled()) {
+                // Don't throw across the worker threads; the check after the
+                // parallel region will.
+                return;
+            }
+            token->advance();
+        }
+
 #ifdef debug_dagify
-        cerr << "handling component " << i << endl;
+        cerr << "planning component " << i << endl;
 #endif
-        
-        // keep track of which nodes are in which component (for later)
+
         auto& component = strong_components[i];
-        for (nid_t node_id : component) {
-            component_of[node_id] = i;
-        }
-        
+        auto& plan = plans[i];
+
         // figure out how many times we need to copy this SCC
-        
+
         // wrap the SCC in a handle graph
         SubHandleGraph subgraph(graph);
         for (const nid_t& node_id : component) {
@@ -290,8 +331,9 @@ unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph, MutableHandleGraph*
         }
         
         // mark the edges as either forward or backward relative to the layout
-        vector<vector<size_t>> forward_edges(layout.size());
-        vector<pair<size_t, size_t>> backward_edges;
+        vector<vector<size_t>>& forward_edges = plan.forward_edges;
+        vector<pair<size_t, size_t>>& backward_edges = plan.backward_edges;
+        forward_edges.resize(layout.size());
         subgraph.for_each_edge([&](const edge_t& edge) {
             // get the indices of the edge in the layout, making sure to match
             // the canonical orientation
@@ -318,6 +360,18 @@ unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph, MutableHandleGraph*
             return true;
         });
         
+        // ask the policy how far this particular component may be unrolled;
+        // components with no backward edges only ever get one copy, so the
+        // policy doesn't hear about them
+        size_t max_copies_per_component = 0;
+        if (!backward_edges.empty()) {
+            size_t edge_count = backward_edges.size();
+            for (const vector<size_t>& adjacent : forward_edges) {
+                edge_count += adjacent.size();
+            }
+            max_copies_per_component = copies_policy(component.size(), edge_count);
+        }
+
         // check for each node whether we've duplicated the component enough times
         // to preserve its cycles
         
@@ -335,68 +389,22 @@ unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph, MutableHandleGraph*
         
         // init the tracker that we use for the bail-out condition
         int64_t min_relaxed_dist = -1;
-        
-        // add copies until the minimum distance to the new copy is longer than the distance we're
-        // trying to preserve
-        for (size_t copy_num = 0; min_relaxed_dist < int64_t(min_preserved_path_length); copy_num++) {
-            
-#ifdef debug_dagify
-            cerr << "copy number " << copy_num << endl;
-#endif
-            
-            // do we need a new copy of this SCC to preserve paths?
-            if (copy_num == injector[layout.front()].size()) {
-                // we haven't added this copy of the connected component yet
-                
-#ifdef debug_dagify
-                cerr << "adding nodes for this copy" << endl;
-#endif
-                
-                // add the nodes
-                for (const handle_t& original_handle : layout) {
-                    // create the node in the same foward orientation as the original
-                    handle_t new_handle = into->create_handle(graph->get_sequence(graph->forward(original_handle)));
-                    // use the handle locally in the same orientation as it is in the layout
-                    if (graph->get_is_reverse(original_handle)) {
-                        new_handle = into->flip(new_handle);
-                    }
-#ifdef debug_dagify
-                    cerr << "\t" << graph->get_id(original_handle) << " duplicated to " << into->get_id(new_handle) << endl;
-#endif
-                    
-                    // record the translation between the graphs
-                    translator[into->get_id(new_handle)] = graph->get_id(original_handle);
-                    injector[original_handle].push_back(new_handle);
-                }
-                
-                // add the forward edges within this copy
-                for (size_t i = 0; i < forward_edges.size(); i++) {
-                    handle_t from = injector[layout[i]].back();
-                    for (const size_t& j : forward_edges[i]) {
-                        into->create_edge(from, injector[layout[j]].back());
-#ifdef debug_dagify
-                        cerr << "\t\tfwd edge " << into->get_id(from) << (into->get_is_reverse(from) ? "-" : "+") << " -> " << into->get_id(injector[layout[j]].back()) << (into->get_is_reverse(injector[layout[j]].back()) ? "-" : "+") << endl;
-#endif
-                    }
-                }
-                
-                // is there a previous copy?
-                if (copy_num > 0) {
-                    // add the backward edges between the copies
-                    for (const pair<size_t, size_t>& bwd_edge : backward_edges) {
-                        const auto& from_copies = injector[layout[bwd_edge.first]];
-                        into->create_edge(from_copies[from_copies.size() - 2],
-                                          injector[layout[bwd_edge.second]].back());
+
+        // count copies until the minimum distance to the next copy is longer than the
+        // distance we're trying to preserve, or until we hit the copy cap (a cap of 0
+        // means no cap)
+        while (min_relaxed_dist < int64_t(min_preserved_path_length) &&
+               (max_copies_per_component == 0 || plan.copies < max_copies_per_component)) {
+
+            // this iteration corresponds to one more copy of the SCC
+            plan.copies++;
+
 #ifdef debug_dagify
-                        cerr << "\t\tbwd edge " << into->get_id(from_copies[from_copies.size() - 2]) << (into->get_is_reverse(from_copies[from_copies.size() - 2]) ? "-" : "+") << " -> " << into->get_id(injector[layout[bwd_edge.second]].back()) << (into->get_is_reverse(injector[layout[bwd_edge.second]].back()) ? "-" : "+") << endl;
+            cerr << "copy number " << (plan.copies - 1) << endl;
 #endif
-                    }
-                }
-            }
-            
-            // we've finished adding the copy of the SCC that corresponds to this iteration
-            // now we will do the dynamic programming to bound the distance to the next SCC
-            
+
+            // do the dynamic programming to bound the distance to the next copy
+
             // find the shortest path to the nodes, staying within this copy of the SCC
             for (size_t i = 0; i < distances.size(); i++) {
                 // skip infinity to avoid overflow
@@ -442,14 +450,132 @@ unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph, MutableHandleGraph*
             distances = std::move(next_distances);
             next_distances.assign(distances.size(), numeric_limits<int64_t>::max());
         }
+
+        // hang onto the layout for the building phase
+        plan.layout = std::move(layout);
+    }, thread_count);
+
+    if (token) {
+        token->check();
     }
-    
+
+    if (max_output_nodes > 0) {
+        // enforce the hard cap on the output size by taking copies away from
+        // the components with the largest footprints first; every component
+        // keeps at least one copy, so the cap cannot shrink the output below
+        // one copy of the input
+        size_t total_nodes = 0;
+        for (const SCCUnrollingPlan& plan : plans) {
+            total_nodes += plan.copies * plan.layout.size();
+        }
+        if (total_nodes > max_output_nodes) {
+            vector<size_t> by_footprint(plans.size());
+            for (size_t i = 0; i < plans.size(); i++) {
+                by_footprint[i] = i;
+            }
+            sort(by_footprint.begin(), by_footprint.end(), [&](size_t a, size_t b) {
+                return plans[a].copies * plans[a].layout.size() > plans[b].copies * plans[b].layout.size();
+            });
+            size_t excess = total_nodes - max_output_nodes;
+            for (size_t i = 0; i < by_footprint.size() && excess > 0; i++) {
+                SCCUnrollingPlan& plan = plans[by_footprint[i]];
+                if (plan.copies <= 1 || plan.layout.empty()) {
+                    continue;
+                }
+                size_t droppable = plan.copies - 1;
+                size_t wanted = (excess + plan.layout.size() - 1) / plan.layout.size();
+                size_t dropped = min(droppable, wanted);
+                plan.copies -= dropped;
+                excess -= min(excess, dropped * plan.layout.size());
+            }
+        }
+    }
+
+    // now build the unrolled components, serially, since mutation through the
+    // interface is not thread-safe
+
+    // a map from a node in the original graph to all its copies (in order) in the
+    // dagified graph
+    if (token) {
+        token->begin_phase("building unrolled components", plans.size());
+    }
+    resource_unordered_map<handle_t, vector<handle_t>> injector{ResourceAllocator<pair<const handle_t, vector<handle_t>>>(resource)};
+    for (size_t i = 0; i < plans.size(); i++) {
+
+        if (token) {
+            token->advance();
+            if (i % ControlToken::CHECK_INTERVAL == 0) {
+                token->check();
+            }
+        }
+
+#ifdef debug_dagify
+        cerr << "building component " << i << endl;
+#endif
+
+        auto& plan = plans[i];
+        for (size_t copy_num = 0; copy_num < plan.copies; copy_num++) {
+
+#ifdef debug_dagify
+            cerr << "adding nodes for copy " << copy_num << endl;
+#endif
+
+            // add the nodes
+            for (const handle_t& original_handle : plan.layout) {
+                // create the node in the same foward orientation as the original
+                handle_t new_handle = into->create_handle(graph->get_sequence(graph->forward(original_handle)));
+                // use the handle locally in the same orientation as it is in the layout
+                if (graph->get_is_reverse(original_handle)) {
+                    new_handle = into->flip(new_handle);
+                }
+#ifdef debug_dagify
+                cerr << "\t" << graph->get_id(original_handle) << " duplicated to " << into->get_id(new_handle) << endl;
+#endif
+
+                // record the translation between the graphs
+                record_translation(into->get_id(new_handle), graph->get_id(original_handle));
+                injector[original_handle].push_back(new_handle);
+            }
+
+            // add the forward edges within this copy
+            for (size_t j = 0; j < plan.forward_edges.size(); j++) {
+                handle_t from = injector[plan.layout[j]].back();
+                for (const size_t& k : plan.forward_edges[j]) {
+                    into->create_edge(from, injector[plan.layout[k]].back());
+#ifdef debug_dagify
+                    cerr << "\t\tfwd edge " << into->get_id(from) << (into->get_is_reverse(from) ? "-" : "+") << " -> " << into->get_id(injector[plan.layout[k]].back()) << (into->get_is_reverse(injector[plan.layout[k]].back()) ? "-" : "+") << endl;
+#endif
+                }
+            }
+
+            // is there a previous copy?
+            if (copy_num > 0) {
+                // add the backward edges between the copies
+                for (const pair<size_t, size_t>& bwd_edge : plan.backward_edges) {
+                    const auto& from_copies = injector[plan.layout[bwd_edge.first]];
+                    into->create_edge(from_copies[from_copies.size() - 2],
+                                      injector[plan.layout[bwd_edge.second]].back());
+#ifdef debug_dagify
+                    cerr << "\t\tbwd edge " << into->get_id(from_copies[from_copies.size() - 2]) << (into->get_is_reverse(from_copies[from_copies.size() - 2]) ? "-" : "+") << " -> " << into->get_id(injector[plan.layout[bwd_edge.second]].back()) << (into->get_is_reverse(injector[plan.layout[bwd_edge.second]].back()) ? "-" : "+") << endl;
+#endif
+                }
+            }
+        }
+    }
+
 #ifdef debug_dagify
     cerr << "adding edges between SCCs" << endl;
 #endif
     
     // add edges between the strongly connected components
+    if (token) {
+        token->begin_phase("connecting components");
+    }
+    size_t edges_seen = 0;
     graph->for_each_edge([&](const edge_t& canonical_edge) {
+        if (token && edges_seen++ % ControlToken::CHECK_INTERVAL == 0) {
+            token->check();
+        }
         if (component_of[graph->get_id(canonical_edge.first)] != component_of[graph->get_id(canonical_edge.second)]) {
             // this edge is between SCCs
             
@@ -472,11 +598,88 @@ unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph, MutableHandleGraph*
         // always keep going
         return true;
     });
-    
-    // return the ID translator
+}
+
+/// Wrap a single global copy cap as a per-component policy
+static function<size_t(size_t, size_t)> constant_policy(size_t max_copies_per_component) {
+    return [max_copies_per_component](size_t, size_t) {
+        return max_copies_per_component;
+    };
+}
+
+unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph, MutableHandleGraph* into,
+                                   size_t min_preserved_path_length) {
+    // no copy cap, and plan on one thread
+    unordered_map<nid_t, nid_t> translator;
+    dagify_internal(graph, into, min_preserved_path_length, constant_policy(0), 0, 1, nullptr, nullptr,
+                    [&](const nid_t& new_id, const nid_t& old_id) {
+        translator[new_id] = old_id;
+    });
     return translator;
 }
 
+unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph, MutableHandleGraph* into,
+                                   size_t min_preserved_path_length,
+                                   size_t max_copies_per_component,
+                                   size_t thread_count) {
+    unordered_map<nid_t, nid_t> translator;
+    dagify_internal(graph, into, min_preserved_path_length,
+                    constant_policy(max_copies_per_component), 0, thread_count, nullptr, nullptr,
+                    [&](const nid_t& new_id, const nid_t& old_id) {
+        translator[new_id] = old_id;
+    });
+    return translator;
+}
+
+NodeTranslation dagify_and_translate(const HandleGraph* graph, MutableHandleGraph* into,
+                                     size_t min_preserved_path_length,
+                                     size_t max_copies_per_component,
+                                     size_t thread_count) {
+    // the duplicated nodes are whole copies in the original forward
+    // orientation, so the offsets are zero and nothing reads in reverse
+    NodeTranslation translation;
+    dagify_internal(graph, into, min_preserved_path_length,
+                    constant_policy(max_copies_per_component), 0, thread_count, nullptr, nullptr,
+                    [&](const nid_t& new_id, const nid_t& old_id) {
+        translation.add_translation(new_id, old_id, 0, 0, false);
+    });
+    translation.index();
+    return translation;
+}
+
+unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph, MutableHandleGraph* into,
+                                   size_t min_preserved_path_length,
+                                   const dagify_policy_t& copies_policy,
+                                   size_t max_output_nodes,
+                                   size_t thread_count,
+                                   MemoryResource* resource,
+                                   ControlToken* token) {
+    unordered_map<nid_t, nid_t> translator;
+    dagify_internal(graph, into, min_preserved_path_length,
+                    copies_policy, max_output_nodes, thread_count, resource, token,
+                    [&](const nid_t& new_id, const nid_t& old_id) {
+        translator[new_id] = old_id;
+    });
+    return translator;
+}
+
+NodeTranslation dagify_and_translate(const HandleGraph* graph, MutableHandleGraph* into,
+                                     size_t min_preserved_path_length,
+                                     const dagify_policy_t& copies_policy,
+                                     size_t max_output_nodes,
+                                     size_t thread_count,
+                                     MemoryResource* resource,
+                                     ControlToken* token) {
+    NodeTranslation translation;
+    dagify_internal(graph, into, min_preserved_path_length,
+                    copies_policy, max_output_nodes, thread_count, resource, token,
+                    [&](const nid_t& new_id, const nid_t& old_id) {
+        translation.add_translation(new_id, old_id, 0, 0, false);
+    });
+    translation.index();
+    return translation;
+}
+
 std::unordered_map<nid_t, nid_t> dagify_from(const HandleGraph* graph,
                                              std::vector<handle_t> start_handles,
                                              DeletableHandleGraph* into,
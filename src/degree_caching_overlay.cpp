@@ -0,0 +1,137 @@
+#include "handlegraph/degree_caching_overlay.hpp"
+
+#include "handlegraph/parallel.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+/** \file degree_caching_overlay.cpp
+ * Implement the DegreeCachingOverlay cache.
+ */
+
+namespace handlegraph {
+
+DegreeCachingOverlay::DegreeCachingOverlay(const HandleGraph* graph, size_t thread_count)
+    : graph(graph) {
+    build_cache(thread_count);
+}
+
+void DegreeCachingOverlay::invalidate(size_t thread_count) {
+    node_ids.clear();
+    left_degrees.clear();
+    right_degrees.clear();
+    edge_count = 0;
+    build_cache(thread_count);
+}
+
+void DegreeCachingOverlay::build_cache(size_t thread_count) {
+    // Collect the node IDs serially; iteration order is backend-defined, so
+    // sort them for binary search.
+    node_ids.reserve(graph->get_node_count());
+    graph->for_each_handle([&](const handle_t& handle) {
+        node_ids.push_back(graph->get_id(handle));
+    });
+    std::sort(node_ids.begin(), node_ids.end());
+
+    // Count each node's edges in parallel. Each slot is written by exactly
+    // one worker, so no synchronization is needed.
+    left_degrees.resize(node_ids.size());
+    right_degrees.resize(node_ids.size());
+    parallel_for(node_ids.size(), [&](size_t i) {
+        handle_t handle = graph->get_handle(node_ids[i]);
+        left_degrees[i] = graph->get_degree(handle, true);
+        right_degrees[i] = graph->get_degree(handle, false);
+    }, thread_count);
+
+    // Self-loops keep the edge count from being half the degree sum, so pay
+    // for the backing graph's scan once here instead of per query.
+    edge_count = graph->get_edge_count();
+}
+
+size_t DegreeCachingOverlay::get_degree(const handle_t& handle, bool go_left) const {
+    nid_t node_id = graph->get_id(handle);
+    auto found = std::lower_bound(node_ids.begin(), node_ids.end(), node_id);
+    if (found == node_ids.end() || *found != node_id) {
+        throw std::runtime_error("error:[DegreeCachingOverlay] node " + std::to_string(node_id) +
+                                 " is not in the cache; was the graph modified without invalidate()?");
+    }
+    size_t slot = found - node_ids.begin();
+    // A reverse handle's left side is the forward node's right side.
+    return (go_left != graph->get_is_reverse(handle)) ? left_degrees[slot] : right_degrees[slot];
+}
+
+size_t DegreeCachingOverlay::get_edge_count() const {
+    return edge_count;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Everything else forwards to the backing graph
+////////////////////////////////////////////////////////////////////////////
+
+bool DegreeCachingOverlay::has_node(nid_t node_id) const {
+    return graph->has_node(node_id);
+}
+
+handle_t DegreeCachingOverlay::get_handle(const nid_t& node_id, bool is_reverse) const {
+    return graph->get_handle(node_id, is_reverse);
+}
+
+nid_t DegreeCachingOverlay::get_id(const handle_t& handle) const {
+    return graph->get_id(handle);
+}
+
+bool DegreeCachingOverlay::get_is_reverse(const handle_t& handle) const {
+    return graph->get_is_reverse(handle);
+}
+
+handle_t DegreeCachingOverlay::flip(const handle_t& handle) const {
+    return graph->flip(handle);
+}
+
+size_t DegreeCachingOverlay::get_length(const handle_t& handle) const {
+    return graph->get_length(handle);
+}
+
+std::string DegreeCachingOverlay::get_sequence(const handle_t& handle) const {
+    return graph->get_sequence(handle);
+}
+
+size_t DegreeCachingOverlay::get_node_count() const {
+    return graph->get_node_count();
+}
+
+nid_t DegreeCachingOverlay::min_node_id() const {
+    return graph->min_node_id();
+}
+
+nid_t DegreeCachingOverlay::max_node_id() const {
+    return graph->max_node_id();
+}
+
+size_t DegreeCachingOverlay::get_total_length() const {
+    return graph->get_total_length();
+}
+
+char DegreeCachingOverlay::get_base(const handle_t& handle, size_t index) const {
+    return graph->get_base(handle, index);
+}
+
+std::string DegreeCachingOverlay::get_subsequence(const handle_t& handle, size_t index, size_t size) const {
+    return graph->get_subsequence(handle, index, size);
+}
+
+bool DegreeCachingOverlay::follow_edges_impl(const handle_t& handle, bool go_left,
+                                             function_ref<bool(const handle_t&)> iteratee) const {
+    return graph->follow_edges(handle, go_left, [&](const handle_t& next) {
+        return iteratee(next);
+    });
+}
+
+bool DegreeCachingOverlay::for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee,
+                                                bool parallel) const {
+    return graph->for_each_handle([&](const handle_t& handle) {
+        return iteratee(handle);
+    }, parallel);
+}
+
+}
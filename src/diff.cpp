@@ -0,0 +1,204 @@
+#include "handlegraph/algorithms/diff.hpp"
+
+#include <stdexcept>
+#include <unordered_set>
+
+/** \file diff.cpp
+ * Implement graph diffing and patching.
+ */
+
+namespace handlegraph {
+namespace algorithms {
+
+bool GraphDiff::empty() const {
+    return removed_nodes.empty() && added_nodes.empty() &&
+           removed_edges.empty() && added_edges.empty() &&
+           removed_paths.empty() && added_paths.empty();
+}
+
+/// Record one graph's canonical view of an edge by ID and orientation.
+static GraphDiff::Edge record_edge(const HandleGraph* graph, const edge_t& edge) {
+    GraphDiff::Edge recorded;
+    recorded.from_id = graph->get_id(edge.first);
+    recorded.from_rev = graph->get_is_reverse(edge.first);
+    recorded.to_id = graph->get_id(edge.second);
+    recorded.to_rev = graph->get_is_reverse(edge.second);
+    return recorded;
+}
+
+/// Check whether the other graph has this graph's edge. Both endpoints must
+/// exist in the other graph.
+static bool other_has_edge(const HandleGraph* graph, const edge_t& edge, const HandleGraph* other) {
+    return other->has_edge(other->get_handle(graph->get_id(edge.first),
+                                             graph->get_is_reverse(edge.first)),
+                           other->get_handle(graph->get_id(edge.second),
+                                             graph->get_is_reverse(edge.second)));
+}
+
+GraphDiff diff_graphs(const HandleGraph* from, const HandleGraph* to) {
+
+    if (from == nullptr || to == nullptr) {
+        throw std::runtime_error("error:[diff_graphs] must supply two graphs to compare");
+    }
+
+    GraphDiff diff;
+
+    // Nodes of 'from' that will not survive: deleted outright, or replaced
+    // because their sequence changed. Either way their edges go with them,
+    // so edges touching them need no removal records.
+    std::unordered_set<nid_t> unstable_in_from;
+    // Nodes of 'to' that the applier will create, so every edge touching
+    // them needs an addition record.
+    std::unordered_set<nid_t> unstable_in_to;
+
+    from->for_each_handle([&](const handle_t& handle) {
+        nid_t node_id = from->get_id(handle);
+        if (!to->has_node(node_id)) {
+            diff.removed_nodes.push_back(node_id);
+            unstable_in_from.insert(node_id);
+        }
+        else if (from->get_sequence(from->forward(handle)) !=
+                 to->get_sequence(to->get_handle(node_id))) {
+            // Replace the node: destroy the old one and recreate it with
+            // the new sequence
+            diff.removed_nodes.push_back(node_id);
+            diff.added_nodes.emplace_back(node_id, to->get_sequence(to->get_handle(node_id)));
+            unstable_in_from.insert(node_id);
+            unstable_in_to.insert(node_id);
+        }
+    });
+
+    to->for_each_handle([&](const handle_t& handle) {
+        nid_t node_id = to->get_id(handle);
+        if (!from->has_node(node_id)) {
+            diff.added_nodes.emplace_back(node_id, to->get_sequence(to->forward(handle)));
+            unstable_in_to.insert(node_id);
+        }
+    });
+
+    from->for_each_edge([&](const edge_t& edge) {
+        if (unstable_in_from.count(from->get_id(edge.first)) ||
+            unstable_in_from.count(from->get_id(edge.second))) {
+            // Destroying the endpoint destroys the edge
+            return;
+        }
+        if (!other_has_edge(from, edge, to)) {
+            diff.removed_edges.push_back(record_edge(from, edge));
+        }
+    });
+
+    to->for_each_edge([&](const edge_t& edge) {
+        if (unstable_in_to.count(to->get_id(edge.first)) ||
+            unstable_in_to.count(to->get_id(edge.second))) {
+            // The applier creates the endpoint fresh, so it must recreate
+            // the edge whether or not 'from' had it
+            diff.added_edges.push_back(record_edge(to, edge));
+        }
+        else if (!other_has_edge(to, edge, from)) {
+            diff.added_edges.push_back(record_edge(to, edge));
+        }
+    });
+
+    return diff;
+}
+
+/// Read out a path's steps as (node ID, is_reverse) pairs.
+static std::vector<std::pair<nid_t, bool>> path_steps(const PathHandleGraph* graph,
+                                                      const path_handle_t& path) {
+    std::vector<std::pair<nid_t, bool>> steps;
+    steps.reserve(graph->get_step_count(path));
+    graph->for_each_step_in_path(path, [&](const step_handle_t& step) {
+        handle_t handle = graph->get_handle_of_step(step);
+        steps.emplace_back(graph->get_id(handle), graph->get_is_reverse(handle));
+    });
+    return steps;
+}
+
+GraphDiff diff_graphs_with_paths(const PathHandleGraph* from, const PathHandleGraph* to) {
+
+    GraphDiff diff = diff_graphs(from, to);
+
+    // Destroying a node destroys the paths over it, so a path that steps
+    // on any removed or replaced node has to be rebuilt even if its step
+    // list is unchanged.
+    std::unordered_set<nid_t> doomed_nodes(diff.removed_nodes.begin(), diff.removed_nodes.end());
+
+    // Paths whose name survives but that have to be rebuilt; they get
+    // removed and re-added.
+    std::unordered_set<std::string> changed_paths;
+
+    from->for_each_path_handle([&](const path_handle_t& from_path) {
+        std::string name = from->get_path_name(from_path);
+        if (!to->has_path(name)) {
+            diff.removed_paths.push_back(name);
+            return;
+        }
+        std::vector<std::pair<nid_t, bool>> from_steps = path_steps(from, from_path);
+        bool rebuild = false;
+        for (const std::pair<nid_t, bool>& step : from_steps) {
+            if (doomed_nodes.count(step.first)) {
+                rebuild = true;
+                break;
+            }
+        }
+        path_handle_t to_path = to->get_path_handle(name);
+        if (rebuild ||
+            from->get_is_circular(from_path) != to->get_is_circular(to_path) ||
+            from_steps != path_steps(to, to_path)) {
+            diff.removed_paths.push_back(name);
+            changed_paths.insert(name);
+        }
+    });
+
+    to->for_each_path_handle([&](const path_handle_t& to_path) {
+        std::string name = to->get_path_name(to_path);
+        if (from->has_path(name) && !changed_paths.count(name)) {
+            return;
+        }
+        GraphDiff::Path recreated;
+        recreated.name = name;
+        recreated.is_circular = to->get_is_circular(to_path);
+        recreated.steps = path_steps(to, to_path);
+        diff.added_paths.push_back(std::move(recreated));
+    });
+
+    return diff;
+}
+
+void apply_diff(const GraphDiff& diff, MutablePathDeletableHandleGraph* graph) {
+
+    if (graph == nullptr) {
+        throw std::runtime_error("error:[apply_diff] must supply graph to patch");
+    }
+
+    // Removals come first, paths before the nodes they walk through, and
+    // nodes take their own edges with them.
+    for (const std::string& name : diff.removed_paths) {
+        graph->destroy_path(graph->get_path_handle(name));
+    }
+    for (const GraphDiff::Edge& edge : diff.removed_edges) {
+        graph->destroy_edge(graph->get_handle(edge.from_id, edge.from_rev),
+                            graph->get_handle(edge.to_id, edge.to_rev));
+    }
+    for (const nid_t& node_id : diff.removed_nodes) {
+        graph->destroy_handle(graph->get_handle(node_id));
+    }
+
+    // Then the additions, each once its dependencies exist
+    for (const std::pair<nid_t, std::string>& node : diff.added_nodes) {
+        graph->create_handle(node.second, node.first);
+    }
+    for (const GraphDiff::Edge& edge : diff.added_edges) {
+        graph->create_edge(graph->get_handle(edge.from_id, edge.from_rev),
+                           graph->get_handle(edge.to_id, edge.to_rev));
+    }
+    for (const GraphDiff::Path& path : diff.added_paths) {
+        path_handle_t created = graph->create_path_handle(path.name, path.is_circular);
+        for (const std::pair<nid_t, bool>& step : path.steps) {
+            graph->append_step(created, graph->get_handle(step.first, step.second));
+        }
+    }
+}
+
+}
+}
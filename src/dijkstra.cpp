@@ -5,6 +5,7 @@
  */
 
 #include "handlegraph/algorithms/dijkstra.hpp"
+#include "handlegraph/algorithms/static/dijkstra.hpp"
 
 #include <queue>
 
@@ -27,133 +28,219 @@ bool dijkstra(const HandleGraph* g, handle_t start,
               
 }
 
+void DijkstraState::begin_query(const HandleGraph* g) {
+    const RankedHandleGraph* now_ranked = dynamic_cast<const RankedHandleGraph*>(g);
+    if (now_ranked != ranked) {
+        // New graph; drop marks that belong to the old one.
+        ranked = now_ranked;
+        visit_epochs.clear();
+        visit_epoch_map.clear();
+        epoch = 0;
+    }
+    if (ranked != nullptr) {
+        // Handle ranks are dense and 1-based, one per orientation.
+        size_t needed = g->get_node_count() * 2 + 1;
+        if (visit_epochs.size() < needed) {
+            visit_epochs.resize(needed, 0);
+        }
+    }
+    // Invalidate all old marks at once.
+    epoch++;
+}
+
+bool DijkstraState::check_and_mark_visited(const handle_t& handle) {
+    if (ranked != nullptr) {
+        uint64_t& mark = visit_epochs[ranked->handle_to_rank(handle)];
+        if (mark == epoch) {
+            return true;
+        }
+        mark = epoch;
+        return false;
+    }
+    auto emplaced = visit_epoch_map.emplace(handle, epoch);
+    if (!emplaced.second) {
+        if (emplaced.first->second == epoch) {
+            return true;
+        }
+        emplaced.first->second = epoch;
+    }
+    return false;
+}
+
+bool DijkstraState::is_visited(const handle_t& handle) const {
+    if (ranked != nullptr) {
+        return visit_epochs[ranked->handle_to_rank(handle)] == epoch;
+    }
+    auto found = visit_epoch_map.find(handle);
+    return found != visit_epoch_map.end() && found->second == epoch;
+}
+
+/// Shared entry into the engine for the bounded, unbounded, and
+/// state-reusing searches. The engine itself lives in static/dijkstra.hpp,
+/// templated on the graph type; instantiating it over the abstract interface
+/// gives the classic virtual-dispatch entry points.
+static bool dijkstra_internal(const HandleGraph* g, const unordered_set<handle_t>& starts,
+                              DijkstraState& state,
+                              function<bool(const handle_t&, size_t)> reached_callback,
+                              bool traverse_leftward, bool prune, bool cycle_to_start,
+                              size_t max_distance) {
+    return dijkstra<HandleGraph>(g, starts, state, reached_callback, traverse_leftward, prune,
+                                 cycle_to_start, max_distance);
+}
+
 bool dijkstra(const HandleGraph* g, const unordered_set<handle_t>& starts,
               function<bool(const handle_t&, size_t)> reached_callback,
               bool traverse_leftward, bool prune, bool cycle_to_start) {
+    // Nobody wants to reuse the search state, so make a throwaway one.
+    DijkstraState state;
+    return dijkstra_internal(g, starts, state, reached_callback, traverse_leftward, prune, cycle_to_start,
+                             numeric_limits<size_t>::max());
+}
 
-#ifdef debug_vg_algorithms
-    cerr << "Doing Dijkstra traversal from " << starts.size() << " start points, "
-        << (traverse_leftward ? "left" : "right")
-        << ", with pruning " << (prune ? "on" : "off")
-        << " and cycle visits to starts " << (cycle_to_start ? "on" : "off") << endl;
-#endif
+bool dijkstra(const HandleGraph* g, handle_t start, DijkstraState& state,
+              function<bool(const handle_t&, size_t)> reached_callback,
+              bool traverse_leftward, bool prune, bool cycle_to_start) {
+    unordered_set<handle_t> starts;
+    starts.insert(start);
+    return dijkstra(g, starts, state, reached_callback, traverse_leftward, prune, cycle_to_start);
+}
 
-    // We keep a priority queue so we can visit the handle with the shortest
-    // distance next. We put handles in here whenever we see them with shorter
-    // distances (since STL priority queue can't update), so we also need to
-    // make sure nodes coming out haven't been visited already.
-    using Record = pair<size_t, handle_t>;
-    
-    // We filter out handles that have already been visited.
-    unordered_set<handle_t> visited;
-    
-    // We need to know if we stopped early
-    bool stopped_early = false;
-    
-    // And for allowing visiting the starts by cycle, we need to discount the first time we see them, at distance 0
-    unordered_set<handle_t> unseen_starts;
-    if (cycle_to_start) {
-        unseen_starts = starts;
-    }
-    
-    // We need a custom ordering for the queue
-    struct IsFirstGreater {
-        IsFirstGreater() = default;
-        ~IsFirstGreater() = default;
-        inline bool operator()(const Record& a, const Record& b) {
-            return a.first > b.first;
+bool dijkstra(const HandleGraph* g, const unordered_set<handle_t>& starts, DijkstraState& state,
+              function<bool(const handle_t&, size_t)> reached_callback,
+              bool traverse_leftward, bool prune, bool cycle_to_start) {
+    return dijkstra_internal(g, starts, state, reached_callback, traverse_leftward, prune, cycle_to_start,
+                             numeric_limits<size_t>::max());
+}
+
+bool bounded_dijkstra(const HandleGraph* g, handle_t start, size_t max_distance,
+                      function<bool(const handle_t&, size_t)> reached_callback,
+                      bool traverse_leftward, bool prune, bool cycle_to_start) {
+    unordered_set<handle_t> starts;
+    starts.insert(start);
+    return bounded_dijkstra(g, starts, max_distance, reached_callback, traverse_leftward, prune, cycle_to_start);
+}
+
+bool bounded_dijkstra(const HandleGraph* g, const unordered_set<handle_t>& starts, size_t max_distance,
+                      function<bool(const handle_t&, size_t)> reached_callback,
+                      bool traverse_leftward, bool prune, bool cycle_to_start) {
+    DijkstraState state;
+    return dijkstra_internal(g, starts, state, reached_callback, traverse_leftward, prune, cycle_to_start, max_distance);
+}
+
+bool bidirectional_dijkstra(const HandleGraph* g, handle_t start, handle_t end, size_t& distance_out,
+                            size_t max_distance) {
+
+    // One half-search: its frontier, its settled distances, and the distance
+    // of the closest unsettled handle.
+    struct Search {
+        using Record = pair<size_t, handle_t>;
+        struct IsFirstGreater {
+            inline bool operator()(const Record& a, const Record& b) {
+                return a.first > b.first;
+            }
+        };
+        priority_queue<Record, vector<Record>, IsFirstGreater> queue;
+        unordered_map<handle_t, size_t> settled;
+        handle_t origin;
+        bool leftward;
+
+        size_t frontier_distance() const {
+            return queue.empty() ? numeric_limits<size_t>::max() : queue.top().first;
         }
     };
-    
-    priority_queue<Record, vector<Record>, IsFirstGreater> queue;
-    
-    // We keep a current handle
-    handle_t current;
-    size_t distance = 0;
-    for (auto& start : starts) {
-        queue.push(make_pair(distance, start));
-    }
-    
-    while (!queue.empty()) {
-        // While there are things in the queue, get the first.
-        tie(distance, current) = queue.top();
-        queue.pop();
-        
-        if (cycle_to_start && unseen_starts.count(current)) {
-            // This is the very first visit to this start, so don't count it as
-            // visited.
-#ifdef debug_vg_algorithms
-            cerr << "Expand start " << g->get_id(current) << " " << g->get_is_reverse(current) << " at distance " << distance << endl;
-#endif
-            unseen_starts.erase(current); 
-        } else {
-            if (visited.count(current)) {
-                continue;
-            } else {
-                visited.insert(current);
-            }
-            
-#ifdef debug_vg_algorithms
-            cerr << "Visit " << g->get_id(current) << " " << g->get_is_reverse(current) << " at distance " << distance << endl;
-#endif    
 
-            // Emit the handle as being at the given distance
-            if (!reached_callback(current, distance)) {
-                // The user told us to stop.
-                
-                if (prune) {
-                    // Just continue with whatever is next, and don't expand this
-                    // node.
-#ifdef debug_vg_algorithms
-                    cerr << "\tPrune search" << endl;
-#endif
-                    stopped_early = true;
-                    continue;
-                } else {
-                    // Stop right away.
-                
-                    // Return that we stopped early.
-                
-#ifdef debug_vg_algorithms
-                    cerr << "\tAbort search" << endl;
-#endif  
-                
-                    return false;
-                }
-            }
+    Search forward;
+    forward.origin = start;
+    forward.leftward = false;
+    forward.queue.push(make_pair(0, start));
+
+    Search backward;
+    backward.origin = end;
+    backward.leftward = true;
+    backward.queue.push(make_pair(0, end));
+
+    // The best full start-to-end distance proven so far.
+    size_t best = numeric_limits<size_t>::max();
+
+    // Score a handle both searches have settled. The forward search reaches
+    // the incoming side of a handle and the backward search its outgoing
+    // side, so a meeting in the middle pays the handle's own length, except
+    // at the endpoints, whose lengths are outside the measured interval.
+    auto consider_meeting = [&](const handle_t& meeting, size_t forward_distance, size_t backward_distance) {
+        size_t total = forward_distance + backward_distance;
+        if (meeting != start && meeting != end) {
+            total += g->get_length(meeting);
         }
-        
-        if (!starts.count(current)) {
-            // Up the distance with the node's length. We don't do this for the
-            // start handles because we want to count distance from the *end* of
-            // the start handles unless directed otherwise.
+        best = min(best, total);
+    };
+
+    vector<handle_t> neighbors;
+
+    // Expand one handle of one search, Dijkstra-style.
+    auto expand = [&](Search& self, Search& other) {
+        size_t distance = self.queue.top().first;
+        handle_t current = self.queue.top().second;
+        self.queue.pop();
+        if (self.settled.count(current)) {
+            return;
+        }
+        self.settled[current] = distance;
+
+        auto found = other.settled.find(current);
+        if (found != other.settled.end()) {
+            // The searches have met here; maybe through the best path.
+            consider_meeting(current, self.leftward ? found->second : distance,
+                             self.leftward ? distance : found->second);
+        }
+
+        if (current != self.origin) {
+            // As in dijkstra, distance is measured from the far side of the
+            // origin, so the origin's own length doesn't count.
             distance += g->get_length(current);
         }
-            
-        g->follow_edges(current, traverse_leftward, [&](const handle_t& next) {
-            // For each handle to the right of here
-            
-            if (!visited.count(next)) {
-                // New shortest distance. Will never happen after the handle comes out of the queue because of Dijkstra.
-                queue.push(make_pair(distance, next));
-                
-#ifdef debug_vg_algorithms
-                cerr << "\tNew best path to " << g->get_id(next) << " " << g->get_is_reverse(next)
-                    << " at distance " << distance << endl;
-#endif
-                
-            } else {
-#ifdef debug_vg_algorithms
-                cerr << "\tDisregard path to " << g->get_id(next) << " " << g->get_is_reverse(next)
-                    << " at distance " << distance << endl;
-#endif
+
+        neighbors.clear();
+        g->get_neighbors(current, self.leftward, neighbors);
+        for (auto& next : neighbors) {
+            if (!self.settled.count(next) && distance <= max_distance) {
+                self.queue.push(make_pair(distance, next));
             }
-        });
+        }
+    };
+
+    // Special case: a degenerate interval.
+    if (start == end) {
+        distance_out = 0;
+        return true;
     }
 
-    // Return whether we avoided needing to prune.
-    return !stopped_early;
+    while (!forward.queue.empty() || !backward.queue.empty()) {
+        size_t forward_frontier = forward.frontier_distance();
+        size_t backward_frontier = backward.frontier_distance();
+        size_t closest = min(forward_frontier, backward_frontier);
+        if (closest > max_distance) {
+            break;
+        }
+        if (best != numeric_limits<size_t>::max() &&
+            forward_frontier != numeric_limits<size_t>::max() &&
+            backward_frontier != numeric_limits<size_t>::max() &&
+            forward_frontier + backward_frontier >= best) {
+            // Neither frontier can improve on the meeting we already found.
+            break;
+        }
+        // Advance the search with the nearer frontier.
+        if (forward_frontier <= backward_frontier) {
+            expand(forward, backward);
+        } else {
+            expand(backward, forward);
+        }
+    }
 
+    if (best > max_distance) {
+        return false;
+    }
+    distance_out = best;
+    return true;
 }
 
 void for_each_handle_in_shortest_path(const HandleGraph* g, handle_t start, handle_t end, std::function<bool(const handle_t&, size_t)> iteratee) {
@@ -0,0 +1,66 @@
+#include "handlegraph/expanding_overlay_graph.hpp"
+
+#include "handlegraph/util.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+/** \file expanding_overlay_graph.cpp
+ * Implement ExpandingOverlayGraph methods and FlattenedOverlay.
+ */
+
+namespace handlegraph {
+
+void ExpandingOverlayGraph::get_underlying_handles(const std::vector<handle_t>& overlay_handles,
+                                                   std::vector<handle_t>& underlying_handles) const {
+    // By default, translate the handles one at a time
+    underlying_handles.clear();
+    underlying_handles.reserve(overlay_handles.size());
+    for (const handle_t& handle : overlay_handles) {
+        underlying_handles.push_back(get_underlying_handle(handle));
+    }
+}
+
+FlattenedOverlay::FlattenedOverlay(const std::vector<const ExpandingOverlayGraph*>& layers) {
+    if (layers.empty()) {
+        throw std::runtime_error("error:[FlattenedOverlay] no overlay layers given");
+    }
+    const ExpandingOverlayGraph* top = layers.front();
+    translation.reserve(top->get_node_count() * 2);
+    top->for_each_handle([&](const handle_t& handle) {
+        // Compose the stack's translations for both orientations, so a
+        // lookup never needs to know any layer's orientation encoding.
+        for (handle_t oriented : {handle, top->flip(handle)}) {
+            handle_t under = oriented;
+            for (const ExpandingOverlayGraph* layer : layers) {
+                under = layer->get_underlying_handle(under);
+            }
+            translation.emplace_back(as_integer(oriented), under);
+        }
+    });
+    std::sort(translation.begin(), translation.end());
+}
+
+handle_t FlattenedOverlay::get_underlying_handle(const handle_t& handle) const {
+    auto found = std::lower_bound(translation.begin(), translation.end(),
+                                  std::make_pair(as_integer(handle), handle_t()),
+                                  [](const std::pair<uint64_t, handle_t>& a,
+                                     const std::pair<uint64_t, handle_t>& b) {
+        return a.first < b.first;
+    });
+    if (found == translation.end() || found->first != as_integer(handle)) {
+        throw std::runtime_error("error:[FlattenedOverlay] handle is not in the outermost overlay");
+    }
+    return found->second;
+}
+
+void FlattenedOverlay::get_underlying_handles(const std::vector<handle_t>& overlay_handles,
+                                              std::vector<handle_t>& underlying_handles) const {
+    underlying_handles.clear();
+    underlying_handles.reserve(overlay_handles.size());
+    for (const handle_t& handle : overlay_handles) {
+        underlying_handles.push_back(get_underlying_handle(handle));
+    }
+}
+
+}
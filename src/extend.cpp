@@ -1,5 +1,9 @@
 #include "handlegraph/algorithms/extend.hpp"
 
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+
 namespace handlegraph {
 namespace algorithms {
 
@@ -27,5 +31,93 @@ void extend(const HandleGraph* source, MutableHandleGraph* into) {
         return true;
     });
 }
+
+IncrementalExtender::IncrementalExtender(const HandleGraph* source, MutableHandleGraph* into)
+    : source(source), into(into), ranked(dynamic_cast<const RankedHandleGraph*>(source)) {
+
+    size_t node_count = source->get_node_count();
+    if (ranked == nullptr) {
+        // fall back on ID-sorted order and binary search for lookups
+        index_to_id.reserve(node_count);
+        source->for_each_handle([&](const handle_t& handle) {
+            index_to_id.push_back(source->get_id(handle));
+        });
+        sort(index_to_id.begin(), index_to_id.end());
+    }
+    copied.resize((node_count + 63) / 64, 0);
+}
+
+size_t IncrementalExtender::index_of(const nid_t& node_id) const {
+    if (ranked != nullptr) {
+        // ranks start at 1
+        return ranked->id_to_rank(node_id) - 1;
+    }
+    return lower_bound(index_to_id.begin(), index_to_id.end(), node_id) - index_to_id.begin();
+}
+
+bool IncrementalExtender::is_copied(const handle_t& handle) const {
+    size_t i = index_of(source->get_id(handle));
+    return (copied[i / 64] >> (i % 64)) & 1;
+}
+
+void IncrementalExtender::extend(const vector<handle_t>& handles) {
+
+    // find the nodes we haven't copied yet and mark them off
+    vector<handle_t> newly_copied;
+    unordered_set<nid_t> newly_copied_ids;
+    for (const handle_t& handle : handles) {
+        size_t i = index_of(source->get_id(handle));
+        uint64_t mask = uint64_t(1) << (i % 64);
+        if (copied[i / 64] & mask) {
+            // we've copied this node on an earlier call
+            continue;
+        }
+        copied[i / 64] |= mask;
+        newly_copied.push_back(source->forward(handle));
+        newly_copied_ids.insert(source->get_id(handle));
+    }
+
+    // gather the new nodes' sequences, unless the target got them elsewhere
+    vector<string> sequences;
+    vector<nid_t> ids;
+    for (const handle_t& handle : newly_copied) {
+        if (!into->has_node(source->get_id(handle))) {
+            sequences.push_back(source->get_sequence(handle));
+            ids.push_back(source->get_id(handle));
+        }
+    }
+    into->create_handles(sequences, ids);
+
+    // gather the edges between the new nodes and everything copied so far;
+    // edges to uncopied nodes are picked up by the call that copies them
+    vector<edge_t> edges;
+    for (const handle_t& handle : newly_copied) {
+        source->follow_edges(handle, false, [&](const handle_t& next) {
+            if (is_copied(next) &&
+                (!newly_copied_ids.count(source->get_id(next)) ||
+                 source->get_id(handle) <= source->get_id(next))) {
+                // the other side is in the working graph, and if it is also
+                // new, only the lower-ID endpoint records the edge
+                edges.emplace_back(handle, next);
+            }
+        });
+        source->follow_edges(handle, true, [&](const handle_t& prev) {
+            if (is_copied(prev) &&
+                (!newly_copied_ids.count(source->get_id(prev)) ||
+                 source->get_id(handle) < source->get_id(prev) ||
+                 (source->get_id(handle) == source->get_id(prev) && source->get_is_reverse(prev)))) {
+                edges.emplace_back(prev, handle);
+            }
+        });
+    }
+
+    // translate onto the target's handles and create them all at once;
+    // create_edge ignores edges the target already has
+    for (edge_t& edge : edges) {
+        edge = edge_t(into->get_handle(source->get_id(edge.first), source->get_is_reverse(edge.first)),
+                      into->get_handle(source->get_id(edge.second), source->get_is_reverse(edge.second)));
+    }
+    into->create_edges(edges);
+}
 }
 }
@@ -21,15 +21,34 @@ unordered_map<handle_t, size_t>  find_shortest_paths(const HandleGraph* g, handl
     dijkstra(g, start, [&](const handle_t& current, size_t distance) {
         // Record handle's distance
         distances[current] = distance;
-        
+
         // Always keep going
         return true;
     }, traverse_leftward);
-    
+
     return distances;
 
 }
 
-    
+unordered_map<handle_t, size_t>  find_shortest_paths(const HandleGraph* g, handle_t start,
+                                                     DijkstraState& state,
+                                                     bool traverse_leftward) {
+
+    // This is the minimum distance to each handle
+    unordered_map<handle_t, size_t> distances;
+
+    dijkstra(g, start, state, [&](const handle_t& current, size_t distance) {
+        // Record handle's distance
+        distances[current] = distance;
+
+        // Always keep going
+        return true;
+    }, traverse_leftward);
+
+    return distances;
+
+}
+
+
 }
 }
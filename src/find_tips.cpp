@@ -1,58 +1,69 @@
 #include "handlegraph/algorithms/find_tips.hpp"
 
+#include "handlegraph/parallel.hpp"
+
+#include <cstdint>
+
 namespace handlegraph {
 namespace algorithms {
 
 using namespace std;
 
-vector<handle_t> head_nodes(const HandleGraph* g) {
-    vector<handle_t> to_return;
+/// Find all of the nodes with degree 0 on one side, checking the nodes
+/// across threads. Tips are returned in the graph's iteration order, so the
+/// result doesn't depend on thread interleaving.
+static vector<handle_t> tip_nodes(const HandleGraph* g, bool left_side, size_t thread_count) {
+
+    // snapshot the (locally forward) nodes in iteration order
+    vector<handle_t> handles;
+    handles.reserve(g->get_node_count());
     g->for_each_handle([&](const handle_t& found) {
-        // For each (locally forward) node
-        
-        bool no_left_edges = true;
-        g->follow_edges(found, true, [&](const handle_t& ignored) {
-            // We found a left edge!
-            no_left_edges = false;
-            // We only need one
-            return false;
-        });
-        
-        if (no_left_edges) {
-            to_return.push_back(found);
-        }
+        handles.push_back(found);
     });
-    
-    return to_return;
-    
-}
 
-vector<handle_t> tail_nodes(const HandleGraph* g) {
+    // check the degrees by index; backends may answer get_degree without
+    // enumerating any edges
+    vector<uint8_t> is_tip(handles.size(), 0);
+    parallel_for(handles.size(), [&](size_t i) {
+        if (g->get_degree(handles[i], left_side) == 0) {
+            is_tip[i] = 1;
+        }
+    }, thread_count);
+
+    // collect the tips in iteration order
     vector<handle_t> to_return;
-    g->for_each_handle([&](const handle_t& found) {
-        // For each (locally forward) node
-        
-        bool no_right_edges = true;
-        g->follow_edges(found, false, [&](const handle_t& ignored) {
-            // We found a right edge!
-            no_right_edges = false;
-            // We only need one
-            return false;
-        });
-        
-        if (no_right_edges) {
-            to_return.push_back(found);
+    for (size_t i = 0; i < handles.size(); i++) {
+        if (is_tip[i]) {
+            to_return.push_back(handles[i]);
         }
-    });
-    
+    }
     return to_return;
-    
+}
+
+vector<handle_t> head_nodes(const HandleGraph* g) {
+    return tip_nodes(g, true, 1);
+}
+
+vector<handle_t> head_nodes(const HandleGraph* g, size_t thread_count) {
+    return tip_nodes(g, true, thread_count);
+}
+
+vector<handle_t> tail_nodes(const HandleGraph* g) {
+    return tip_nodes(g, false, 1);
+}
+
+vector<handle_t> tail_nodes(const HandleGraph* g, size_t thread_count) {
+    return tip_nodes(g, false, thread_count);
 }
 
 vector<handle_t> find_tips(const HandleGraph* g) {
+    return find_tips(g, 1);
+}
+
+vector<handle_t> find_tips(const HandleGraph* g, size_t thread_count) {
     // Start with the heads
-    vector<handle_t> tips = head_nodes(g);
-    vector<handle_t> tails = tail_nodes(g);
+    vector<handle_t> tips = head_nodes(g, thread_count);
+    vector<handle_t> tails = tail_nodes(g, thread_count);
     tips.reserve(tips.size() + tails.size());
     for (auto tip : tails) {
         // And add all the tails backward
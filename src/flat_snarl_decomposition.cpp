@@ -0,0 +1,751 @@
+#include "handlegraph/flat_snarl_decomposition.hpp"
+
+#include "handlegraph/util.hpp"
+
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+
+/** \file flat_snarl_decomposition.cpp
+ * Implement FlatSnarlDecomposition.
+ */
+
+namespace handlegraph {
+
+const uint64_t FlatSnarlDecomposition::NO_RECORD = std::numeric_limits<uint64_t>::max();
+
+namespace {
+
+// Record flags: kind in the low bits, then orientation in the parent, then
+// one realizable-traversal bit per (start endpoint, end endpoint) pair.
+const uint64_t KIND_SNARL = 0;
+const uint64_t KIND_CHAIN = 1;
+const uint64_t KIND_NODE = 2;
+const uint64_t KIND_MASK = 3;
+const uint64_t REVERSED_FLAG = 1 << 2;
+const size_t CONNECTIVITY_SHIFT = 3;
+
+// Endpoint codes, matching SnarlDecomposition::endpoint_t
+const uint64_t EP_START = 0;
+const uint64_t EP_END = 1;
+const uint64_t EP_TIP = 2;
+
+/// The realizable-traversal flag bit for a traversal with the given endpoints
+uint64_t connectivity_flag(uint64_t starts, uint64_t ends) {
+    return (uint64_t) 1 << (CONNECTIVITY_SHIFT + starts * 3 + ends);
+}
+
+// Net handle encoding: start endpoint in bits 0-1, end endpoint in bits 2-3,
+// then the sentinel flags, then the record number.
+const size_t NET_ENDS_SHIFT = 2;
+const uint64_t NET_ENDPOINT_MASK = 3;
+const uint64_t NET_SENTINEL_FLAG = 1 << 4;
+const uint64_t NET_SENTINEL_END_FLAG = 1 << 5;
+const uint64_t NET_SENTINEL_IN_FLAG = 1 << 6;
+const size_t NET_RECORD_SHIFT = 7;
+
+net_handle_t make_net(uint64_t record, uint64_t starts, uint64_t ends) {
+    uint64_t bits = (record << NET_RECORD_SHIFT) | (ends << NET_ENDS_SHIFT) | starts;
+    return as_net_handle(bits);
+}
+
+/// Make a net handle to a traversal of the given record crossed in the given
+/// direction: start-to-end normally, end-to-start if reversed.
+net_handle_t make_directed_net(uint64_t record, bool reversed) {
+    return make_net(record, reversed ? EP_END : EP_START, reversed ? EP_START : EP_END);
+}
+
+net_handle_t make_sentinel(uint64_t record, bool get_end, bool face_in) {
+    uint64_t bits = (record << NET_RECORD_SHIFT) | NET_SENTINEL_FLAG;
+    if (get_end) {
+        bits |= NET_SENTINEL_END_FLAG;
+    }
+    if (face_in) {
+        bits |= NET_SENTINEL_IN_FLAG;
+    }
+    return as_net_handle(bits);
+}
+
+uint64_t net_starts(const net_handle_t& net) {
+    return as_integer(net) & NET_ENDPOINT_MASK;
+}
+
+uint64_t net_ends(const net_handle_t& net) {
+    return (as_integer(net) >> NET_ENDS_SHIFT) & NET_ENDPOINT_MASK;
+}
+
+bool net_is_sentinel(const net_handle_t& net) {
+    return as_integer(net) & NET_SENTINEL_FLAG;
+}
+
+// The buffer is the 4-byte magic number, 4 bytes of padding so everything
+// after is 8-byte aligned, the three array lengths, and then the records,
+// the child index, and the node ID index back to back.
+const size_t HEADER_SIZE = 4 + 4 + 3 * sizeof(uint64_t);
+
+}
+
+FlatSnarlDecomposition::FlatSnarlDecomposition(const SnarlDecomposition& source, const HandleGraph& graph) {
+    std::vector<Record> built_records;
+    std::vector<uint64_t> built_children;
+    std::vector<NodeIndexEntry> built_nodes;
+
+    // Flatten the tree in rank order: parents get their record numbers before
+    // their children, and siblings are contiguous in the child index.
+    // Carries the source's handle for each of our records still to expand.
+    std::deque<std::pair<net_handle_t, uint64_t>> queue;
+
+    // The root snarl is record 0. Its canonical traversal is tip-to-tip.
+    built_records.push_back({NO_RECORD, 0, 0, 0, 0,
+                             KIND_SNARL | connectivity_flag(EP_TIP, EP_TIP)});
+    queue.push_back(std::make_pair(source.get_root(), (uint64_t) 0));
+
+    while (!queue.empty()) {
+        net_handle_t parent_net = queue.front().first;
+        uint64_t parent_record = queue.front().second;
+        queue.pop_front();
+        bool parent_is_chain = (built_records[parent_record].flags & KIND_MASK) == KIND_CHAIN;
+
+        // Collect the children first so their slots stay contiguous.
+        // Chains arrive start-to-end, so their children come in chain order.
+        std::vector<net_handle_t> child_handles;
+        source.for_each_child(parent_net, [&](const net_handle_t& child) {
+            child_handles.push_back(child);
+        });
+
+        built_records[parent_record].child_start = built_children.size();
+        built_records[parent_record].child_count = child_handles.size();
+        built_children.resize(built_children.size() + child_handles.size());
+
+        for (size_t rank = 0; rank < child_handles.size(); rank++) {
+            const net_handle_t& child = child_handles[rank];
+            uint64_t kind = source.is_node(child) ? KIND_NODE :
+                            source.is_chain(child) ? KIND_CHAIN : KIND_SNARL;
+            bool reversed = false;
+            nid_t node_id = 0;
+            if (kind == KIND_NODE) {
+                // A node start-to-end is the node forward, so the chain
+                // crosses it backward exactly when its handle is backward.
+                handle_t graph_handle = source.get_handle(child, &graph);
+                node_id = graph.get_id(graph_handle);
+                reversed = graph.get_is_reverse(graph_handle);
+            }
+            else if (parent_is_chain) {
+                // Snarls in a chain arrive oriented the way the chain
+                // crosses them.
+                reversed = source.starts_at(child) == SnarlDecomposition::END;
+            }
+
+            uint64_t flags = kind | (reversed ? REVERSED_FLAG : 0);
+            source.for_each_traversal(child, [&](const net_handle_t& traversal) {
+                flags |= connectivity_flag(source.starts_at(traversal),
+                                           source.ends_at(traversal));
+            });
+
+            uint64_t record_number = built_records.size();
+            built_records.push_back({parent_record, 0, 0, rank, node_id, flags});
+            built_children[built_records[parent_record].child_start + rank] = record_number;
+            if (kind == KIND_NODE) {
+                built_nodes.push_back({node_id, record_number});
+            }
+            else {
+                queue.push_back(std::make_pair(child, record_number));
+            }
+        }
+    }
+
+    std::sort(built_nodes.begin(), built_nodes.end(),
+              [](const NodeIndexEntry& a, const NodeIndexEntry& b) {
+        return a.node_id < b.node_id;
+    });
+
+    // Pack everything into the one buffer that is also the serialized form
+    owned.resize(HEADER_SIZE
+                 + built_records.size() * sizeof(Record)
+                 + built_children.size() * sizeof(uint64_t)
+                 + built_nodes.size() * sizeof(NodeIndexEntry), 0);
+    char* cursor = owned.data();
+    uint32_t magic_number = htonl(get_magic_number());
+    memcpy(cursor, &magic_number, sizeof(magic_number));
+    uint64_t counts[3] = {built_records.size(), built_children.size(), built_nodes.size()};
+    memcpy(cursor + 8, counts, sizeof(counts));
+    cursor += HEADER_SIZE;
+    memcpy(cursor, built_records.data(), built_records.size() * sizeof(Record));
+    cursor += built_records.size() * sizeof(Record);
+    memcpy(cursor, built_children.data(), built_children.size() * sizeof(uint64_t));
+    cursor += built_children.size() * sizeof(uint64_t);
+    memcpy(cursor, built_nodes.data(), built_nodes.size() * sizeof(NodeIndexEntry));
+
+    set_views(owned.data(), owned.size());
+}
+
+FlatSnarlDecomposition::~FlatSnarlDecomposition() {
+    if (mapped != nullptr) {
+        ::munmap(mapped, mapped_length);
+    }
+    if (mapped_fd != -1) {
+        ::close(mapped_fd);
+    }
+}
+
+void FlatSnarlDecomposition::set_views(const char* data, size_t length) {
+    if (length < HEADER_SIZE) {
+        throw std::runtime_error("error:[FlatSnarlDecomposition] serialized data is truncated");
+    }
+    uint32_t magic_number = ntohl(*((const uint32_t*) data));
+    if (magic_number != get_magic_number()) {
+        throw std::runtime_error("error:[FlatSnarlDecomposition] serialized data is not a snarl decomposition");
+    }
+    uint64_t counts[3];
+    memcpy(counts, data + 8, sizeof(counts));
+    size_t expected = HEADER_SIZE
+        + counts[0] * sizeof(Record)
+        + counts[1] * sizeof(uint64_t)
+        + counts[2] * sizeof(NodeIndexEntry);
+    if (length != expected) {
+        throw std::runtime_error("error:[FlatSnarlDecomposition] serialized data has the wrong length");
+    }
+
+    data_start = data;
+    data_length = length;
+    record_count = counts[0];
+    child_list_length = counts[1];
+    node_index_length = counts[2];
+    const char* cursor = data + HEADER_SIZE;
+    records = (const Record*) cursor;
+    cursor += record_count * sizeof(Record);
+    child_list = (const uint64_t*) cursor;
+    cursor += child_list_length * sizeof(uint64_t);
+    node_index = (const NodeIndexEntry*) cursor;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Decoding helpers
+////////////////////////////////////////////////////////////////////////////
+
+auto FlatSnarlDecomposition::record_at(uint64_t number) const -> const Record& {
+    return records[number];
+}
+
+uint64_t FlatSnarlDecomposition::record_of(const net_handle_t& net) const {
+    return as_integer(net) >> NET_RECORD_SHIFT;
+}
+
+uint64_t FlatSnarlDecomposition::find_node_record(const nid_t& node_id) const {
+    const NodeIndexEntry* end = node_index + node_index_length;
+    const NodeIndexEntry* found = std::lower_bound(node_index, end, node_id,
+        [](const NodeIndexEntry& entry, const nid_t& query) {
+        return entry.node_id < query;
+    });
+    if (found == end || found->node_id != node_id) {
+        return NO_RECORD;
+    }
+    return found->record;
+}
+
+handle_t FlatSnarlDecomposition::node_graph_handle(uint64_t record, bool reversed, const HandleGraph* graph) const {
+    return graph->get_handle(record_at(record).node_id, reversed);
+}
+
+void FlatSnarlDecomposition::child_entry_handles(uint64_t child, const HandleGraph* graph,
+                                                 handle_t& start_in, handle_t& end_in) const {
+    const Record& record = record_at(child);
+    if ((record.flags & KIND_MASK) == KIND_NODE) {
+        // Entering a node at its start is crossing it forward
+        start_in = node_graph_handle(child, false, graph);
+        end_in = node_graph_handle(child, true, graph);
+        return;
+    }
+    // For a chain, the entry handles are the bounding nodes facing in
+    uint64_t first = child_list[record.child_start];
+    uint64_t last = child_list[record.child_start + record.child_count - 1];
+    start_in = node_graph_handle(first, record_at(first).flags & REVERSED_FLAG, graph);
+    end_in = node_graph_handle(last, !(record_at(last).flags & REVERSED_FLAG), graph);
+}
+
+bool FlatSnarlDecomposition::snarl_boundary_handles(uint64_t snarl, const HandleGraph* graph,
+                                                    handle_t& start_in, handle_t& end_exit,
+                                                    uint64_t& start_record, uint64_t& end_record) const {
+    const Record& record = record_at(snarl);
+    if (record.parent == NO_RECORD) {
+        // The root snarl has no bounding nodes
+        return false;
+    }
+    const Record& parent = record_at(record.parent);
+    if ((parent.flags & KIND_MASK) != KIND_CHAIN
+        || record.parent_rank == 0
+        || record.parent_rank + 1 >= parent.child_count) {
+        // Snarls live between the nodes of a chain
+        return false;
+    }
+    uint64_t before = child_list[parent.child_start + record.parent_rank - 1];
+    uint64_t after = child_list[parent.child_start + record.parent_rank + 1];
+    if (record.flags & REVERSED_FLAG) {
+        // The chain crosses this snarl end to start, so its own start is on
+        // the downstream side.
+        start_record = after;
+        end_record = before;
+        start_in = node_graph_handle(after, !(record_at(after).flags & REVERSED_FLAG), graph);
+        end_exit = node_graph_handle(before, !(record_at(before).flags & REVERSED_FLAG), graph);
+    }
+    else {
+        start_record = before;
+        end_record = after;
+        start_in = node_graph_handle(before, record_at(before).flags & REVERSED_FLAG, graph);
+        end_exit = node_graph_handle(after, record_at(after).flags & REVERSED_FLAG, graph);
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// SnarlDecomposition interface
+////////////////////////////////////////////////////////////////////////////
+
+net_handle_t FlatSnarlDecomposition::get_root() const {
+    return make_net(0, EP_TIP, EP_TIP);
+}
+
+bool FlatSnarlDecomposition::is_root(const net_handle_t& net) const {
+    return !net_is_sentinel(net) && record_of(net) == 0;
+}
+
+bool FlatSnarlDecomposition::is_snarl(const net_handle_t& net) const {
+    return !net_is_sentinel(net) && (record_at(record_of(net)).flags & KIND_MASK) == KIND_SNARL;
+}
+
+bool FlatSnarlDecomposition::is_chain(const net_handle_t& net) const {
+    return !net_is_sentinel(net) && (record_at(record_of(net)).flags & KIND_MASK) == KIND_CHAIN;
+}
+
+bool FlatSnarlDecomposition::is_node(const net_handle_t& net) const {
+    return !net_is_sentinel(net) && (record_at(record_of(net)).flags & KIND_MASK) == KIND_NODE;
+}
+
+bool FlatSnarlDecomposition::is_sentinel(const net_handle_t& net) const {
+    return net_is_sentinel(net);
+}
+
+net_handle_t FlatSnarlDecomposition::get_net(const handle_t& handle, const HandleGraph* graph) const {
+    uint64_t record = find_node_record(graph->get_id(handle));
+    if (record == NO_RECORD) {
+        throw std::runtime_error("error:[FlatSnarlDecomposition] node "
+                                 + std::to_string(graph->get_id(handle))
+                                 + " is not in the decomposition");
+    }
+    return make_directed_net(record, graph->get_is_reverse(handle));
+}
+
+handle_t FlatSnarlDecomposition::get_handle(const net_handle_t& net, const HandleGraph* graph) const {
+    return node_graph_handle(record_of(net), net_starts(net) == EP_END, graph);
+}
+
+net_handle_t FlatSnarlDecomposition::get_parent(const net_handle_t& child) const {
+    if (net_is_sentinel(child)) {
+        // A sentinel's parent is its own snarl
+        return make_directed_net(record_of(child), false);
+    }
+    const Record& record = record_at(record_of(child));
+    const Record& parent = record_at(record.parent);
+    uint64_t starts = net_starts(child);
+    uint64_t ends = net_ends(child);
+    if ((parent.flags & KIND_MASK) == KIND_CHAIN
+        && ((starts == EP_START && ends == EP_END) || (starts == EP_END && ends == EP_START))) {
+        // The chain comes out facing the way the child does, accounting for
+        // how the chain crosses the child.
+        bool child_reversed = starts == EP_END;
+        return make_directed_net(record.parent,
+                                 child_reversed != bool(record.flags & REVERSED_FLAG));
+    }
+    return make_directed_net(record.parent, false);
+}
+
+net_handle_t FlatSnarlDecomposition::get_bound(const net_handle_t& net, bool get_end, bool face_in) const {
+    uint64_t number = record_of(net);
+    const Record& record = record_at(number);
+    if ((record.flags & KIND_MASK) == KIND_SNARL) {
+        return make_sentinel(number, get_end, face_in);
+    }
+    // Facing in at the start and out at the end both point along the chain
+    bool against = get_end == face_in;
+    uint64_t bound = number;
+    if ((record.flags & KIND_MASK) == KIND_CHAIN) {
+        bound = child_list[record.child_start + (get_end ? record.child_count - 1 : 0)];
+    }
+    return make_directed_net(bound, bool(record_at(bound).flags & REVERSED_FLAG) != against);
+}
+
+net_handle_t FlatSnarlDecomposition::flip(const net_handle_t& net) const {
+    uint64_t bits = as_integer(net);
+    if (net_is_sentinel(net)) {
+        return as_net_handle(bits ^= NET_SENTINEL_IN_FLAG);
+    }
+    return make_net(record_of(net), net_ends(net), net_starts(net));
+}
+
+net_handle_t FlatSnarlDecomposition::canonical(const net_handle_t& net) const {
+    uint64_t number = record_of(net);
+    uint64_t connectivity = record_at(number).flags >> CONNECTIVITY_SHIFT;
+    for (uint64_t starts = 0; starts < 3; starts++) {
+        for (uint64_t ends = 0; ends < 3; ends++) {
+            if (connectivity & ((uint64_t) 1 << (starts * 3 + ends))) {
+                return make_net(number, starts, ends);
+            }
+        }
+    }
+    return make_directed_net(number, false);
+}
+
+SnarlDecomposition::endpoint_t FlatSnarlDecomposition::starts_at(const net_handle_t& traversal) const {
+    return (endpoint_t) net_starts(traversal);
+}
+
+SnarlDecomposition::endpoint_t FlatSnarlDecomposition::ends_at(const net_handle_t& traversal) const {
+    return (endpoint_t) net_ends(traversal);
+}
+
+SnarlDecomposition::net_traits_t FlatSnarlDecomposition::get_net_traits(const net_handle_t& net) const {
+    net_traits_t traits;
+    traits.start = (endpoint_t) net_starts(net);
+    traits.end = (endpoint_t) net_ends(net);
+    if (net_is_sentinel(net)) {
+        traits.type = SENTINEL;
+        return traits;
+    }
+    uint64_t number = record_of(net);
+    if (number == 0) {
+        traits.type = ROOT;
+        return traits;
+    }
+    switch (record_at(number).flags & KIND_MASK) {
+    case KIND_SNARL:
+        traits.type = SNARL;
+        break;
+    case KIND_CHAIN:
+        traits.type = CHAIN;
+        break;
+    default:
+        traits.type = NODE;
+        break;
+    }
+    return traits;
+}
+
+bool FlatSnarlDecomposition::for_each_child_impl(const net_handle_t& traversal, const std::function<bool(const net_handle_t&)>& iteratee) const {
+    const Record& record = record_at(record_of(traversal));
+    uint64_t starts = net_starts(traversal);
+    uint64_t ends = net_ends(traversal);
+    if ((record.flags & KIND_MASK) == KIND_CHAIN
+        && ((starts == EP_START && ends == EP_END) || (starts == EP_END && ends == EP_START))) {
+        // Produce the children in the order and orientation the chain
+        // crosses them when viewed this way
+        bool backward = starts == EP_END;
+        for (uint64_t i = 0; i < record.child_count; i++) {
+            uint64_t rank = backward ? record.child_count - 1 - i : i;
+            uint64_t child = child_list[record.child_start + rank];
+            if (!iteratee(make_directed_net(child,
+                                            bool(record_at(child).flags & REVERSED_FLAG) != backward))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    // Otherwise children come in stored order, start-to-end
+    for (uint64_t i = 0; i < record.child_count; i++) {
+        if (!iteratee(make_directed_net(child_list[record.child_start + i], false))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FlatSnarlDecomposition::get_children(const net_handle_t& parent, std::vector<net_handle_t>& out) const {
+    const Record& record = record_at(record_of(parent));
+    out.reserve(out.size() + record.child_count);
+    for_each_child_impl(parent, [&](const net_handle_t& child) {
+        out.push_back(child);
+        return true;
+    });
+}
+
+bool FlatSnarlDecomposition::for_each_traversal_impl(const net_handle_t& item, const std::function<bool(const net_handle_t&)>& iteratee) const {
+    uint64_t number = record_of(item);
+    uint64_t connectivity = record_at(number).flags >> CONNECTIVITY_SHIFT;
+    for (uint64_t starts = 0; starts < 3; starts++) {
+        for (uint64_t ends = 0; ends < 3; ends++) {
+            if (connectivity & ((uint64_t) 1 << (starts * 3 + ends))) {
+                if (!iteratee(make_net(number, starts, ends))) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool FlatSnarlDecomposition::follow_net_edges_impl(const net_handle_t& here, const HandleGraph* graph, bool go_left, const std::function<bool(const net_handle_t&)>& iteratee) const {
+    // Work out the snarl we are inside and a graph handle pointing the way
+    // we are probing, then classify each graph neighbor back into a net
+    // handle.
+    uint64_t snarl;
+    // The graph handle at our trailing end, pointing along our traversal
+    handle_t at_start;
+    // The graph handle at our leading end, pointing along our traversal
+    handle_t at_end;
+
+    if (net_is_sentinel(here)) {
+        snarl = record_of(here);
+        handle_t start_in, end_exit;
+        uint64_t start_record, end_record;
+        if (!snarl_boundary_handles(snarl, graph, start_in, end_exit, start_record, end_record)) {
+            return true;
+        }
+        uint64_t bits = as_integer(here);
+        bool at_the_end = bits & NET_SENTINEL_END_FLAG;
+        bool facing_in = bits & NET_SENTINEL_IN_FLAG;
+        // A sentinel is a zero-length traversal of its boundary node,
+        // pointing the way it faces
+        handle_t oriented = at_the_end
+            ? (facing_in ? graph->flip(end_exit) : end_exit)
+            : (facing_in ? start_in : graph->flip(start_in));
+        at_start = oriented;
+        at_end = oriented;
+    }
+    else {
+        uint64_t number = record_of(here);
+        const Record& record = record_at(number);
+        if (record.parent == NO_RECORD) {
+            // The root has no siblings
+            return true;
+        }
+        uint64_t starts = net_starts(here);
+        uint64_t ends = net_ends(here);
+        if (!((starts == EP_START && ends == EP_END) || (starts == EP_END && ends == EP_START))) {
+            // Only directed traversals have well-defined neighbors
+            return true;
+        }
+        bool here_reversed = starts == EP_END;
+        const Record& parent = record_at(record.parent);
+        if ((parent.flags & KIND_MASK) == KIND_CHAIN) {
+            // Inside a chain, the neighbors are structural: the adjacent
+            // sibling in the direction of travel, oriented to keep going.
+            // We never leave the chain.
+            bool downstream = here_reversed == bool(record.flags & REVERSED_FLAG);
+            bool increasing = go_left ? !downstream : downstream;
+            if (increasing ? record.parent_rank + 1 >= parent.child_count
+                           : record.parent_rank == 0) {
+                return true;
+            }
+            uint64_t next = child_list[parent.child_start + record.parent_rank
+                                       + (increasing ? 1 : -1)];
+            return iteratee(make_directed_net(next,
+                                              bool(record_at(next).flags & REVERSED_FLAG) == downstream));
+        }
+        // Inside a snarl, the neighbors come from the graph
+        snarl = record.parent;
+        handle_t start_in, end_in;
+        child_entry_handles(number, graph, start_in, end_in);
+        at_start = here_reversed ? end_in : start_in;
+        at_end = graph->flip(here_reversed ? start_in : end_in);
+    }
+
+    handle_t start_in, end_exit;
+    uint64_t start_record = NO_RECORD, end_record = NO_RECORD;
+    bool has_bounds = snarl_boundary_handles(snarl, graph, start_in, end_exit,
+                                             start_record, end_record);
+
+    return graph->follow_edges(go_left ? at_start : at_end, go_left, [&](const handle_t& next) {
+        uint64_t node_record = find_node_record(graph->get_id(next));
+        if (node_record == NO_RECORD) {
+            // Not part of the decomposition
+            return true;
+        }
+        if (has_bounds && node_record == start_record) {
+            return iteratee(make_sentinel(snarl, false, next == start_in));
+        }
+        if (has_bounds && node_record == end_record) {
+            return iteratee(make_sentinel(snarl, true, next == graph->flip(end_exit)));
+        }
+        // Climb from the node to the sibling child of our snarl holding it
+        uint64_t child = node_record;
+        while (child != NO_RECORD && record_at(child).parent != snarl) {
+            child = record_at(child).parent;
+        }
+        if (child == NO_RECORD) {
+            return true;
+        }
+        handle_t child_start_in, child_end_in;
+        child_entry_handles(child, graph, child_start_in, child_end_in);
+        if (!go_left) {
+            // next points into the neighbor
+            if (next == child_start_in) {
+                return iteratee(make_directed_net(child, false));
+            }
+            if (next == child_end_in) {
+                return iteratee(make_directed_net(child, true));
+            }
+        }
+        else {
+            // next points out of the neighbor, toward us
+            if (next == graph->flip(child_end_in)) {
+                return iteratee(make_directed_net(child, false));
+            }
+            if (next == graph->flip(child_start_in)) {
+                return iteratee(make_directed_net(child, true));
+            }
+        }
+        return true;
+    });
+}
+
+net_handle_t FlatSnarlDecomposition::get_parent_traversal(const net_handle_t& traversal_start, const net_handle_t& traversal_end) const {
+    // Work out the shared parent and which of its endpoints each bound is
+    uint64_t parent;
+    uint64_t starts;
+    if (net_is_sentinel(traversal_start)) {
+        parent = record_of(traversal_start);
+        starts = (as_integer(traversal_start) & NET_SENTINEL_END_FLAG) ? EP_END : EP_START;
+    }
+    else {
+        parent = record_at(record_of(traversal_start)).parent;
+        net_handle_t parent_net = make_directed_net(parent, false);
+        starts = traversal_start == get_bound(parent_net, false, true) ? EP_START
+               : traversal_start == get_bound(parent_net, true, true) ? EP_END : EP_TIP;
+    }
+    uint64_t ends;
+    if (net_is_sentinel(traversal_end)) {
+        ends = (as_integer(traversal_end) & NET_SENTINEL_END_FLAG) ? EP_END : EP_START;
+    }
+    else {
+        net_handle_t parent_net = make_directed_net(parent, false);
+        ends = traversal_end == get_bound(parent_net, false, false) ? EP_START
+             : traversal_end == get_bound(parent_net, true, false) ? EP_END : EP_TIP;
+    }
+    return make_net(parent, starts, ends);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// (Trivially)Serializable interface
+////////////////////////////////////////////////////////////////////////////
+
+uint32_t FlatSnarlDecomposition::get_magic_number() const {
+    // Spells "SNRL"
+    return 0x534E524C;
+}
+
+void FlatSnarlDecomposition::serialize(const std::function<void(const void*, size_t)>& iteratee) const {
+    if (data_start == nullptr) {
+        throw std::runtime_error("error:[FlatSnarlDecomposition] cannot serialize an empty decomposition");
+    }
+    iteratee(data_start, data_length);
+}
+
+void FlatSnarlDecomposition::serialize(int fd) {
+    // The object is immutable once built, so there is no write-back link to
+    // make; the const path does everything we need.
+    const TriviallySerializable& as_const = *this;
+    as_const.serialize(fd);
+}
+
+void FlatSnarlDecomposition::deserialize(int fd) {
+    if (data_start != nullptr) {
+        throw std::runtime_error("error:[FlatSnarlDecomposition] deserialize can only be called on an empty object");
+    }
+    struct stat file_info;
+    if (::fstat(fd, &file_info) != 0) {
+        throw std::runtime_error(std::string("Could not stat file: ") + ::strerror(errno));
+    }
+    void* mapping = MAP_FAILED;
+    if (S_ISREG(file_info.st_mode) && file_info.st_size > 0) {
+        mapping = ::mmap(nullptr, file_info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    if (mapping != MAP_FAILED) {
+        mapped = mapping;
+        mapped_length = file_info.st_size;
+        // Keep our own descriptor so dissociate() can remap later
+        mapped_fd = ::dup(fd);
+        set_views((const char*) mapped, mapped_length);
+    }
+    else {
+        // Not a mappable file; read it all into memory instead
+        char buffer[65536];
+        while (true) {
+            auto got = ::read(fd, buffer, sizeof(buffer));
+            if (got == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string("Could not read: ") + ::strerror(errno));
+            }
+            if (got == 0) {
+                break;
+            }
+            owned.insert(owned.end(), buffer, buffer + got);
+        }
+        set_views(owned.data(), owned.size());
+    }
+    clear_dirty();
+}
+
+void FlatSnarlDecomposition::dissociate() {
+    if (mapped != nullptr && mapped_fd != -1) {
+        if (!remap_copy_on_write(mapped, mapped_length, mapped_fd, 0)) {
+            // The kernel wouldn't give us a copy-on-write view; fall back to
+            // an actual copy.
+            owned.assign((const char*) mapped, (const char*) mapped + mapped_length);
+            ::munmap(mapped, mapped_length);
+            mapped = nullptr;
+            mapped_length = 0;
+            set_views(owned.data(), owned.size());
+        }
+        ::close(mapped_fd);
+        mapped_fd = -1;
+    }
+}
+
+void FlatSnarlDecomposition::serialize_members(std::ostream& out) const {
+    if (data_start == nullptr) {
+        throw std::runtime_error("error:[FlatSnarlDecomposition] cannot serialize an empty decomposition");
+    }
+    // The magic number was already written; emit the rest of the buffer so
+    // the stream format matches the file descriptor format byte for byte
+    out.write(data_start + sizeof(uint32_t), data_length - sizeof(uint32_t));
+}
+
+void FlatSnarlDecomposition::deserialize_members(std::istream& in) {
+    if (data_start != nullptr) {
+        throw std::runtime_error("error:[FlatSnarlDecomposition] deserialize can only be called on an empty object");
+    }
+    // The magic number was already consumed; put it back at the front of the
+    // buffer and read everything else behind it
+    owned.resize(sizeof(uint32_t));
+    uint32_t magic_number = htonl(get_magic_number());
+    memcpy(owned.data(), &magic_number, sizeof(magic_number));
+    char buffer[65536];
+    while (in) {
+        in.read(buffer, sizeof(buffer));
+        owned.insert(owned.end(), buffer, buffer + in.gcount());
+    }
+    set_views(owned.data(), owned.size());
+}
+
+std::pair<const void*, size_t> FlatSnarlDecomposition::get_mapping() const {
+    return std::make_pair((const void*) data_start, data_length);
+}
+
+std::vector<std::pair<std::string, size_t>> FlatSnarlDecomposition::memory_usage() const {
+    return {
+        {"records", record_count * sizeof(Record)},
+        {"child index", child_list_length * sizeof(uint64_t)},
+        {"node index", node_index_length * sizeof(NodeIndexEntry)}
+    };
+}
+
+}
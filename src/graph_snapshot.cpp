@@ -0,0 +1,148 @@
+#include "handlegraph/graph_snapshot.hpp"
+
+#include "handlegraph/parallel.hpp"
+#include "handlegraph/util.hpp"
+
+#include <algorithm>
+
+/** \file graph_snapshot.cpp
+ * Implement the GraphSnapshot CSR extraction and queries
+ */
+
+namespace handlegraph {
+
+GraphSnapshot::GraphSnapshot(const HandleGraph* graph, size_t thread_count) : backing(graph) {
+
+    // lay the nodes out in ID-sorted order, so lookups by ID are a binary
+    // search and need nothing from the backing graph
+    index_to_id.reserve(graph->get_node_count());
+    graph->for_each_handle([&](const handle_t& handle) {
+        index_to_id.push_back(graph->get_id(handle));
+    });
+    std::sort(index_to_id.begin(), index_to_id.end());
+
+    size_t node_count = index_to_id.size();
+
+    // read the node lengths across threads
+    lengths.resize(node_count);
+    parallel_for(node_count, [&](size_t i) {
+        lengths[i] = graph->get_length(graph->get_handle(index_to_id[i]));
+    }, thread_count);
+
+    // count each oriented handle's rightward neighbors across threads
+    edge_offsets.resize(2 * node_count + 1);
+    edge_offsets[0] = 0;
+    parallel_for(2 * node_count, [&](size_t slot) {
+        handle_t here = graph->get_handle(index_to_id[slot / 2], slot % 2);
+        edge_offsets[slot + 1] = graph->get_degree(here, false);
+    }, thread_count);
+
+    // sum the counts into each slot's start offset, with the total at the end
+    for (size_t slot = 0; slot < 2 * node_count; slot++) {
+        edge_offsets[slot + 1] += edge_offsets[slot];
+    }
+
+    // fill in the adjacency runs across threads; the runs are disjoint, so
+    // the writes don't race
+    adjacency.resize(edge_offsets.back());
+    parallel_for(2 * node_count, [&](size_t slot) {
+        handle_t here = graph->get_handle(index_to_id[slot / 2], slot % 2);
+        size_t cursor = edge_offsets[slot];
+        graph->follow_edges(here, false, [&](const handle_t& next) {
+            adjacency[cursor++] = number_bool_packing::pack(index_of(graph->get_id(next)),
+                                                            graph->get_is_reverse(next));
+        });
+    }, thread_count);
+}
+
+size_t GraphSnapshot::index_of(const nid_t& node_id) const {
+    return std::lower_bound(index_to_id.begin(), index_to_id.end(), node_id) - index_to_id.begin();
+}
+
+size_t GraphSnapshot::slot_of(const handle_t& handle) const {
+    return 2 * number_bool_packing::unpack_number(handle) + number_bool_packing::unpack_bit(handle);
+}
+
+bool GraphSnapshot::has_node(nid_t node_id) const {
+    size_t index = index_of(node_id);
+    return index < index_to_id.size() && index_to_id[index] == node_id;
+}
+
+handle_t GraphSnapshot::get_handle(const nid_t& node_id, bool is_reverse) const {
+    return number_bool_packing::pack(index_of(node_id), is_reverse);
+}
+
+nid_t GraphSnapshot::get_id(const handle_t& handle) const {
+    return index_to_id[number_bool_packing::unpack_number(handle)];
+}
+
+bool GraphSnapshot::get_is_reverse(const handle_t& handle) const {
+    return number_bool_packing::unpack_bit(handle);
+}
+
+handle_t GraphSnapshot::flip(const handle_t& handle) const {
+    return number_bool_packing::toggle_bit(handle);
+}
+
+size_t GraphSnapshot::get_length(const handle_t& handle) const {
+    return lengths[number_bool_packing::unpack_number(handle)];
+}
+
+std::string GraphSnapshot::get_sequence(const handle_t& handle) const {
+    // the sequences aren't materialized; pass the query through
+    return backing->get_sequence(backing->get_handle(get_id(handle), get_is_reverse(handle)));
+}
+
+size_t GraphSnapshot::get_node_count() const {
+    return index_to_id.size();
+}
+
+nid_t GraphSnapshot::min_node_id() const {
+    return index_to_id.empty() ? 0 : index_to_id.front();
+}
+
+nid_t GraphSnapshot::max_node_id() const {
+    return index_to_id.empty() ? 0 : index_to_id.back();
+}
+
+size_t GraphSnapshot::get_degree(const handle_t& handle, bool go_left) const {
+    // the left-side neighbors of a handle are the right-side neighbors of its flip
+    size_t slot = slot_of(go_left ? flip(handle) : handle);
+    return edge_offsets[slot + 1] - edge_offsets[slot];
+}
+
+void GraphSnapshot::get_neighbors(const handle_t& handle, bool go_left, std::vector<handle_t>& out) const {
+    size_t slot = slot_of(go_left ? flip(handle) : handle);
+    for (size_t i = edge_offsets[slot]; i < edge_offsets[slot + 1]; i++) {
+        // going left, the neighbors come back facing the wrong way
+        out.push_back(go_left ? flip(adjacency[i]) : adjacency[i]);
+    }
+}
+
+bool GraphSnapshot::follow_edges_impl(const handle_t& handle, bool go_left,
+                                      function_ref<bool(const handle_t&)> iteratee) const {
+    size_t slot = slot_of(go_left ? flip(handle) : handle);
+    for (size_t i = edge_offsets[slot]; i < edge_offsets[slot + 1]; i++) {
+        if (!iteratee(go_left ? flip(adjacency[i]) : adjacency[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GraphSnapshot::for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee,
+                                         bool parallel) const {
+    if (parallel) {
+        return parallel_for(index_to_id.size(), [&](size_t i) {
+            return iteratee(number_bool_packing::pack(i, false));
+        });
+    }
+    for (size_t i = 0; i < index_to_id.size(); i++) {
+        if (!iteratee(number_bool_packing::pack(i, false))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
@@ -1,6 +1,10 @@
 #include "handlegraph/handle_graph.hpp"
 
 #include "handlegraph/util.hpp"
+#include "handlegraph/parallel.hpp"
+
+#include <atomic>
+#include <limits>
 
 /** \file handle_graphs.cpp
  * Implement handle graph methods.
@@ -17,6 +21,12 @@ size_t HandleGraph::get_degree(const handle_t& handle, bool go_left) const {
     return count;
 }
 
+void HandleGraph::get_neighbors(const handle_t& handle, bool go_left, std::vector<handle_t>& out) const {
+    follow_edges(handle, go_left, [&](const handle_t& next) {
+        out.push_back(next);
+    });
+}
+
 handle_t HandleGraph::forward(const handle_t& handle) const {
     return this->get_is_reverse(handle) ? this->flip(handle) : handle;
 }
@@ -70,6 +80,48 @@ bool HandleGraph::has_edge(const handle_t& left, const handle_t& right) const {
     return !not_seen;
 }
 
+bool HandleGraph::for_each_edge_parallel_internal(function_ref<bool(const edge_t&)> iteratee, size_t thread_count) const {
+    // Snapshot the handles so we can hand out independent ranges of them,
+    // instead of delegating load balancing to for_each_handle_impl.
+    std::vector<handle_t> handles;
+    handles.reserve(get_node_count());
+    for_each_handle([&](const handle_t& handle) {
+        handles.push_back(handle);
+    });
+
+    // We want the shared scheduler to see the cancellation from inside the
+    // follow_edges loops, so we track it ourselves too.
+    std::atomic<bool> keep_going(true);
+
+    parallel_for_range(handles.size(), [&](size_t i) {
+        auto& handle = handles[i];
+        // Apply the same canonical-edge filtering as for_each_edge, so each
+        // edge is visited by exactly one thread.
+        follow_edges(handle, false, [&](const handle_t& next) {
+            if (get_id(handle) <= get_id(next)) {
+                if (!iteratee(edge_handle(handle, next))) {
+                    keep_going.store(false, std::memory_order_relaxed);
+                }
+            }
+            return keep_going.load(std::memory_order_relaxed);
+        });
+        if (keep_going.load(std::memory_order_relaxed)) {
+            follow_edges(handle, true, [&](const handle_t& prev) {
+                if (get_id(handle) < get_id(prev) ||
+                    (get_id(handle) == get_id(prev) && get_is_reverse(prev))) {
+                    if (!iteratee(edge_handle(prev, handle))) {
+                        keep_going.store(false, std::memory_order_relaxed);
+                    }
+                }
+                return keep_going.load(std::memory_order_relaxed);
+            });
+        }
+        return keep_going.load(std::memory_order_relaxed);
+    }, thread_count);
+
+    return keep_going.load();
+}
+
 size_t HandleGraph::get_edge_count() const {
     size_t total = 0;
     for_each_edge([&](const edge_t& ignored) {
@@ -94,6 +146,35 @@ std::string HandleGraph::get_subsequence(const handle_t& handle, size_t index, s
     return get_sequence(handle).substr(index, size);
 }
 
+size_t HandleGraph::get_sequence_into(const handle_t& handle, char* buffer, size_t index, size_t length) const {
+    // Without better access to the backing storage, we have to materialize the
+    // substring and copy it over.
+    std::string piece = get_subsequence(handle, index, length);
+    piece.copy(buffer, piece.size());
+    return piece.size();
+}
+
+size_t HandleGraph::get_sequences_into(const std::vector<handle_t>& handles, char* buffer) const {
+    size_t copied = 0;
+    for (auto& handle : handles) {
+        copied += get_sequence_into(handle, buffer + copied, 0, std::numeric_limits<size_t>::max());
+    }
+    return copied;
+}
+
+bool HandleGraph::supports_packed_sequence() const {
+    // By default we have to go through ASCII
+    return false;
+}
+
+PackedSequence HandleGraph::get_packed_sequence(const handle_t& handle) const {
+    return pack_sequence(get_sequence(handle));
+}
+
+PackedSequence HandleGraph::get_packed_subsequence(const handle_t& handle, size_t index, size_t size) const {
+    return pack_sequence(get_subsequence(handle, index, size));
+}
+
 }
 
 
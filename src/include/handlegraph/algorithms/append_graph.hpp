@@ -14,7 +14,14 @@ namespace algorithms {
 
 /// Append the heads of from to the tails of into
 void append_handle_graph(const HandleGraph* from, MutableHandleGraph* into);
-    
+
+/// Same, but hint the appended ID range to the destination through
+/// set_id_increment before copying, copy the topology with the parallel
+/// copy_handle_graph on the given number of threads (0 means hardware
+/// concurrency), and batch the linking edges. Writing to the destination
+/// stays serial, since mutation is not thread-safe.
+void append_handle_graph(const HandleGraph* from, MutableHandleGraph* into, size_t thread_count);
+
 /// Append the heads of from to the tails of into
 /// Append all (shared) paths of from to into, copy the rest.
 /// If only_connect_path_tips is true, then only edges linking appended paths will be added
@@ -22,6 +29,14 @@ void append_handle_graph(const HandleGraph* from, MutableHandleGraph* into);
 void append_path_handle_graph(const PathHandleGraph* from, MutablePathMutableHandleGraph* into,
                               bool only_connect_path_tips = false);
 
+/// Same, but hint the appended ID range to the destination through
+/// set_id_increment, copy the topology with the parallel copy_handle_graph
+/// on the given number of threads (0 means hardware concurrency), and read
+/// each path's metadata and steps on its own thread before appending them
+/// to the destination serially, since mutation is not thread-safe.
+void append_path_handle_graph(const PathHandleGraph* from, MutablePathMutableHandleGraph* into,
+                              bool only_connect_path_tips, size_t thread_count);
+
 }
 }
 
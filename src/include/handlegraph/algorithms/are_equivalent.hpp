@@ -7,15 +7,38 @@
  * Defines an algorithm for determining whether two graphs are identical
  */
 
+#include "handlegraph/control_token.hpp"
 #include "handlegraph/path_handle_graph.hpp"
 
+#include <cstdint>
+
 namespace handlegraph {
 namespace algorithms {
 
 /// Checks whether two graphs are identical in their IDs, sequences, and edges.
-/// Optionally reports why graphs are found non-equivalent to stderr.
+/// Optionally reports why graphs are found non-equivalent to stderr. The
+/// optional token lets another thread watch the comparison's progress and
+/// cancel it, which throws CancelledError.
 bool are_equivalent(const HandleGraph* graph_1,
-                    const HandleGraph* graph_2, bool verbose = false);
+                    const HandleGraph* graph_2, bool verbose = false,
+                    ControlToken* token = nullptr);
+
+/// Same check, but with the nodes partitioned across the given number of
+/// threads (0 means hardware concurrency), and all threads stopping as soon
+/// as any difference is found. Verbose messages from different threads may
+/// interleave.
+bool are_equivalent_parallel(const HandleGraph* graph_1,
+                             const HandleGraph* graph_2,
+                             bool verbose = false, size_t thread_count = 0,
+                             ControlToken* token = nullptr);
+
+/// Computes an order-independent fingerprint of a graph's IDs, sequences,
+/// and edges: two graphs that are_equivalent always hash equal, regardless
+/// of iteration order or backend, and differing graphs collide with
+/// negligible probability. The hash can be computed once per artifact and
+/// compared in O(1) in place of a full equivalence check. Runs across
+/// threads; a thread_count of 0 means hardware concurrency.
+uint64_t graph_content_hash(const HandleGraph* graph, size_t thread_count = 0);
 
 /// Checks whether two graphs are identical in their IDs, sequences, edges, and paths.
 /// Optionally reports why graphs are found non-equivalent to stderr.
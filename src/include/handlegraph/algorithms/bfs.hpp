@@ -0,0 +1,54 @@
+#ifndef HANDLEGRAPH_ALGORITHMS_BFS_HPP_INCLUDED
+#define HANDLEGRAPH_ALGORITHMS_BFS_HPP_INCLUDED
+
+/**
+ * \file bfs.hpp
+ *
+ * Defines a breadth-first traversal engine.
+ *
+ * Where the DFS engine serves tree-shaped exploration, this engine serves
+ * distance layers: it expands one depth at a time with two swapped frontier
+ * vectors and marks visits in a dense bitset over handle ranks, instead of
+ * the hash-set frontiers downstream BFS loops tend to improvise. The engine
+ * itself lives in algorithms/internal/bfs.hpp.
+ */
+
+#include "handlegraph/handle_graph.hpp"
+
+#include <functional>
+#include <vector>
+
+namespace handlegraph {
+namespace algorithms {
+
+/// Breadth-first search onward from the given oriented source handles,
+/// following edges forward out of each visited orientation. (Seed both
+/// orientations of a node to expand a neighborhood in all directions.) The
+/// iteratee is called exactly once per reachable oriented handle, in
+/// nondecreasing depth order, with the handle and its depth in edges from
+/// the nearest source; returning false stops the search. When
+/// direction_optimizing is set, levels whose frontier dwarfs the unvisited
+/// remainder are expanded bottom-up, by scanning the unvisited handles for
+/// a parent in the frontier, which is much cheaper on low-diameter
+/// components.
+void bfs(const HandleGraph* graph,
+         const std::vector<handle_t>& sources,
+         const std::function<bool(const handle_t& handle, size_t depth)>& iteratee,
+         bool direction_optimizing = true);
+
+/// Same, but each depth layer is expanded across the given number of
+/// threads (0 means hardware concurrency). The expansion runs in parallel,
+/// but each layer's discoveries are then delivered to the iteratee from the
+/// calling thread, in handle rank order, so the sequence of calls is
+/// deterministic and reruns are bit-identical. Returning false stops the
+/// search; the rest of the current layer is not delivered.
+void bfs_parallel(const HandleGraph* graph,
+                  const std::vector<handle_t>& sources,
+                  const std::function<bool(const handle_t& handle, size_t depth)>& iteratee,
+                  size_t thread_count = 0,
+                  bool direction_optimizing = true);
+
+}
+}
+
+#endif
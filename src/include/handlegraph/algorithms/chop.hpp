@@ -1,7 +1,14 @@
 #ifndef HANDLEGRAPH_ALGORITHMS_CHOP_HPP_INCLUDED
 #define HANDLEGRAPH_ALGORITHMS_CHOP_HPP_INCLUDED
 
+#include "handlegraph/control_token.hpp"
+#include "handlegraph/memory_resource.hpp"
 #include "handlegraph/mutable_path_deletable_handle_graph.hpp"
+#include "handlegraph/node_translation.hpp"
+
+#include <functional>
+#include <tuple>
+#include <vector>
 
 namespace handlegraph {
 namespace algorithms {
@@ -32,14 +39,66 @@ void chop(MutablePathDeletableHandleGraph& graph, size_t max_node_length);
  */
 void chop(MutablePathDeletableHandleGraph& graph, size_t max_node_length, const std::function<void(nid_t, size_t, size_t, handle_t)>& record_change);
 
+/// One chop change record: old node ID, start offset along the old node's
+/// forward strand, start offset along its reverse strand, and the new handle.
+using chop_change_t = std::tuple<nid_t, size_t, size_t, handle_t>;
+
+/**
+ * Chop the graph so nodes are at most max_node_length, planning the cut
+ * points for all over-long nodes in parallel on the given number of threads
+ * (0 means hardware concurrency) before applying the divisions in one batch.
+ * The applying pass stays single-threaded, since mutation through the
+ * interface is not thread-safe.
+ *
+ * Invalidates handles into the graph.
+ *
+ * The optional resource supplies the planning pass's transient allocations,
+ * so a caller can point it at a per-invocation arena. The optional token
+ * lets another thread watch the phases go by and cancel the run, which
+ * throws CancelledError and may leave the graph partially chopped.
+ */
+void chop(MutablePathDeletableHandleGraph& graph, size_t max_node_length, size_t thread_count,
+          MemoryResource* resource = nullptr, ControlToken* token = nullptr);
+
+/**
+ * Same, but delivers all the change records in one call to the given
+ * callback instead of one virtual call per fragment. The records are in new
+ * node rank order, and all the new nodes exist in the graph when the callback
+ * runs.
+ */
+void chop(MutablePathDeletableHandleGraph& graph, size_t max_node_length, size_t thread_count,
+          const std::function<void(const std::vector<chop_change_t>&)>& record_changes,
+          MemoryResource* resource = nullptr, ControlToken* token = nullptr);
+
+/**
+ * Same, but returns the change records as a NodeTranslation: a flat,
+ * serializable mapping from the new nodes back to offsets on the nodes they
+ * were chopped from, which can be saved next to the chopped graph for later
+ * coordinate lift-over.
+ */
+NodeTranslation chop_and_translate(MutablePathDeletableHandleGraph& graph, size_t max_node_length,
+                                   size_t thread_count = 0, ControlToken* token = nullptr);
+
 /**
  * Unchop by gluing abutting handles with just a single edge between them and
  * compatible path steps together. Broadly preserves relative ordering of
  * nodes.
  *
- * Invalidates handles into the graph.
+ * Invalidates handles into the graph. The run-finding bookkeeping can draw
+ * from the given resource. The optional token lets another thread watch the
+ * phases go by and cancel the run, which throws CancelledError and may
+ * leave only some of the runs merged.
+ */
+void unchop(MutablePathDeletableHandleGraph& graph, MemoryResource* resource = nullptr,
+            ControlToken* token = nullptr);
+
+/**
+ * Report what unchop would do, without modifying the graph: returns the
+ * number of nodes that would merge away and the number of merged nodes they
+ * would be replaced by. Costs one pass over the graph, so pipelines can
+ * decide whether a full unchop is worth running.
  */
-void unchop(MutablePathDeletableHandleGraph& graph);
+std::pair<size_t, size_t> unchop_dry_run(const PathHandleGraph& graph);
 
 }
 }
@@ -7,6 +7,7 @@
  * Defines algorithms for copying data between handle graphs
  */
 
+#include "handlegraph/control_token.hpp"
 #include "handlegraph/mutable_path_mutable_handle_graph.hpp"
 
 namespace handlegraph {
@@ -17,11 +18,27 @@ namespace algorithms {
 /// ID.
 void copy_handle_graph(const HandleGraph* from, MutableHandleGraph* into);
 
+/// Same, but reads the source graph's sequences and edges on the given
+/// number of threads (0 means hardware concurrency) and adds them to the
+/// destination through the bulk construction methods, after a reserve hint.
+/// Writing to the destination stays serial, since mutation is not
+/// thread-safe. The optional token lets another thread watch the phases go
+/// by and cancel the copy, which throws CancelledError and may leave the
+/// destination partially filled.
+void copy_handle_graph(const HandleGraph* from, MutableHandleGraph* into, size_t thread_count,
+                       ControlToken* token = nullptr);
+
 /// Copies the nodes, edges, and paths from one graph into another.If 'into'
 /// is non-empty, nodes and paths in 'from' will replace nodes that have the same
 /// ID and paths that have the same name.
 void copy_path_handle_graph(const PathHandleGraph* from, MutablePathMutableHandleGraph* into);
 
+/// Same, but copies the topology with the parallel copy_handle_graph and
+/// reads the paths' steps and metadata across threads before appending them
+/// to the destination serially.
+void copy_path_handle_graph(const PathHandleGraph* from, MutablePathMutableHandleGraph* into,
+                            size_t thread_count, ControlToken* token = nullptr);
+
 /// Copies a path from one graph to another. Nodes and edges to support
 /// the path must already exist.
 void copy_path(const PathHandleGraph* from, const path_handle_t& from_path,
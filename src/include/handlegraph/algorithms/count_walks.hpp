@@ -22,13 +22,34 @@ namespace algorithms {
 /// algorithms::is_single_stranded and algorithms::is_directed_acyclic for safety.
 std::tuple<std::vector<handle_t>, std::unordered_map<handle_t, size_t>, bool> count_walks_through_nodes(const HandleGraph* graph);
 
+/// Same, but runs the dynamic programming level by level across the given
+/// number of threads (0 means hardware concurrency): each node pulls the
+/// finalized counts of its predecessors once they have all been processed.
+/// Counts saturate at numeric_limits<size_t>::max() with the flag set, as in
+/// the serial version.
+std::tuple<std::vector<handle_t>, std::unordered_map<handle_t, size_t>, bool> count_walks_through_nodes(const HandleGraph* graph, size_t thread_count);
+
+/// Log-space counting mode for graphs whose walk counts overflow any integer
+/// width: returns the sinks and the natural log of the walk count through
+/// each node (sources have log count 0). Cannot overflow. Runs the dynamic
+/// programming across threads; a thread_count of 0 means hardware
+/// concurrency. Assumes the same single-stranded DAG properties.
+std::pair<std::vector<handle_t>, std::unordered_map<handle_t, double>> count_walks_through_nodes_log(const HandleGraph* graph, size_t thread_count = 0);
+
 /// Returns the number of source-to-sink walks through the graph
 /// Returns numeric_limits<size_t>::max() if the actual number of walks is larger
 /// than this.
 /// Assumes that input is a single-stranded DAG. Consider checking these properties with
 /// algorithms::is_single_stranded and algorithms::is_directed_acyclic for safety.
 size_t count_walks(const HandleGraph* graph);
-    
+
+/// Returns the natural log of the number of source-to-sink walks through the
+/// graph, or -inf if there are none, without any possibility of overflow, so
+/// walk counts can serve as a routine complexity metric on real graphs.
+/// Runs across threads; a thread_count of 0 means hardware concurrency.
+/// Assumes that input is a single-stranded DAG, as above.
+double count_walks_log(const HandleGraph* graph, size_t thread_count = 0);
+
 
 }
 }
@@ -4,8 +4,11 @@
 
 #include <unordered_map>
 
+#include "handlegraph/control_token.hpp"
+#include "handlegraph/memory_resource.hpp"
 #include "handlegraph/mutable_handle_graph.hpp"
 #include "handlegraph/deletable_handle_graph.hpp"
+#include "handlegraph/node_translation.hpp"
 
 #include "handlegraph/algorithms/dagify.hpp"
 
@@ -24,7 +27,73 @@ namespace algorithms {
 std::unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph,
                                         MutableHandleGraph* into,
                                         size_t min_preserved_path_length);
-                                        
+
+/// Like dagify, but plans the unrolling of all the strongly connected
+/// components in parallel (the unrollings of distinct components don't
+/// interact; a thread_count of 0 means hardware concurrency), and caps the
+/// number of copies any single component may be unrolled into (0 means no
+/// cap), so one
+/// pathological component degrades gracefully instead of exhausting memory.
+/// When the cap bites, paths through that component longer than the cap
+/// allows are not preserved. Writing into the target graph stays serial,
+/// since mutation is not thread-safe.
+std::unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph,
+                                        MutableHandleGraph* into,
+                                        size_t min_preserved_path_length,
+                                        size_t max_copies_per_component,
+                                        size_t thread_count = 0);
+
+/// Same, but returns the mapping from the node IDs of into to the node IDs
+/// in graph as a NodeTranslation: a flat, serializable structure that is far
+/// cheaper than a hash table for large graphs and can be saved next to the
+/// dagified graph for later coordinate lift-over.
+NodeTranslation dagify_and_translate(const HandleGraph* graph,
+                                     MutableHandleGraph* into,
+                                     size_t min_preserved_path_length,
+                                     size_t max_copies_per_component = 0,
+                                     size_t thread_count = 0);
+
+/// A per-component unrolling policy: given a strongly connected component's
+/// node count and edge count, return the most copies it may be unrolled
+/// into (0 means unlimited). Called once per nontrivial component, possibly
+/// from several planning threads at once, so it must be thread-safe.
+using dagify_policy_t = std::function<size_t(size_t node_count, size_t edge_count)>;
+
+/// Like dagify with a copy cap, but the cap is decided per component by the
+/// given policy, so a small tangle can be unrolled faithfully while a huge
+/// one is held back, instead of one global bound serving both. In addition,
+/// max_output_nodes (0 means unlimited) caps the total node count of the
+/// dagified graph: if the planned unrollings exceed it, the components with
+/// the largest footprints lose copies first until the plan fits, though
+/// never below one copy of every node. Wherever fewer copies are made than
+/// the minimum preserved path length demands, paths through that component
+/// are preserved only as far as the copies allow. The optional resource
+/// supplies the planning pass's internal hash tables, so a long-running
+/// caller can point their churn at a per-invocation arena. The optional
+/// token lets another thread watch the phases go by and cancel the run,
+/// which throws CancelledError and may leave the target graph partially
+/// built.
+std::unordered_map<nid_t, nid_t> dagify(const HandleGraph* graph,
+                                        MutableHandleGraph* into,
+                                        size_t min_preserved_path_length,
+                                        const dagify_policy_t& copies_policy,
+                                        size_t max_output_nodes = 0,
+                                        size_t thread_count = 0,
+                                        MemoryResource* resource = nullptr,
+                                        ControlToken* token = nullptr);
+
+/// Same, but returns the mapping as a flat NodeTranslation, as
+/// dagify_and_translate does.
+NodeTranslation dagify_and_translate(const HandleGraph* graph,
+                                     MutableHandleGraph* into,
+                                     size_t min_preserved_path_length,
+                                     const dagify_policy_t& copies_policy,
+                                     size_t max_output_nodes = 0,
+                                     size_t thread_count = 0,
+                                     MemoryResource* resource = nullptr,
+                                     ControlToken* token = nullptr);
+
+
 /// Fill an empty MutableHandleGraph with a copy of graph where nodes and edges have
 /// been duplicated in such a way as to eliminate cycles while preserving all paths
 /// up to a given minimum length that start at the starts of the selected start
@@ -0,0 +1,17 @@
+#ifndef HANDLEGRAPH_ALGORITHMS_DFS_HPP_INCLUDED
+#define HANDLEGRAPH_ALGORITHMS_DFS_HPP_INCLUDED
+
+/**
+ * \file dfs.hpp
+ *
+ * Public, iterative depth-first traversal engine with reusable state.
+ *
+ * The engine now lives in algorithms/static/dfs.hpp, where it is templated
+ * on the graph type as well as its callbacks; this header remains so that
+ * existing includes keep working. Passing a HandleGraph reference gives the
+ * classic virtual-dispatch behavior.
+ */
+
+#include "handlegraph/algorithms/static/dfs.hpp"
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef HANDLEGRAPH_ALGORITHMS_DIFF_HPP_INCLUDED
+#define HANDLEGRAPH_ALGORITHMS_DIFF_HPP_INCLUDED
+
+/**
+ * \file diff.hpp
+ *
+ * Defines algorithms for diffing two handle graphs and patching one into
+ * the other
+ */
+
+#include "handlegraph/mutable_path_deletable_handle_graph.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace handlegraph {
+namespace algorithms {
+
+/**
+ * A compact mutation script turning one graph into another. When releases
+ * differ by a small fraction of their content, computing a diff once and
+ * replaying it against each downstream copy replaces rebuilding those
+ * copies from scratch.
+ *
+ * Everything is recorded by node ID, path name, and orientation, never by
+ * handle, so a script can be applied to any backend holding the old graph.
+ * A node whose sequence changed appears as a removal and an addition of
+ * the same ID, with the edges it keeps listed under added_edges.
+ */
+struct GraphDiff {
+
+    /// One edge, endpoint node IDs and orientations, independent of any
+    /// backend's handle encoding.
+    struct Edge {
+        nid_t from_id;
+        bool from_rev;
+        nid_t to_id;
+        bool to_rev;
+    };
+
+    /// One path to recreate: its name, circularity, and steps as (node ID,
+    /// is_reverse) pairs.
+    struct Path {
+        std::string name;
+        bool is_circular;
+        std::vector<std::pair<nid_t, bool>> steps;
+    };
+
+    /// IDs of nodes to destroy, along with their edges
+    std::vector<nid_t> removed_nodes;
+    /// nodes to create, as (ID, sequence)
+    std::vector<std::pair<nid_t, std::string>> added_nodes;
+    /// edges between surviving nodes to destroy
+    std::vector<Edge> removed_edges;
+    /// edges to create, once their endpoints exist
+    std::vector<Edge> added_edges;
+    /// names of paths to destroy; a changed path is removed and re-added
+    std::vector<std::string> removed_paths;
+    /// paths to create, once their nodes exist
+    std::vector<Path> added_paths;
+
+    /// Returns true if applying the diff would change nothing.
+    bool empty() const;
+};
+
+/// Compares the nodes and edges of two graphs, as are_equivalent does, and
+/// returns the script that turns 'from' into 'to'.
+GraphDiff diff_graphs(const HandleGraph* from, const HandleGraph* to);
+
+/// Same, but also compares paths by name, circularity, and steps, and
+/// records the path removals and additions that reconcile them.
+GraphDiff diff_graphs_with_paths(const PathHandleGraph* from, const PathHandleGraph* to);
+
+/// Replays a diff against a graph holding the diff's 'from' content,
+/// leaving it with the 'to' content. A script produced without paths
+/// leaves the graph's paths alone, except that paths over removed nodes
+/// must have been recorded in the script or removed beforehand.
+void apply_diff(const GraphDiff& diff, MutablePathDeletableHandleGraph* graph);
+
+}
+}
+
+#endif
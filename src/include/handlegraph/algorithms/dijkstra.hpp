@@ -7,6 +7,7 @@
  * Definitions of Dijkstra's Algorithm utilities for traversing the graph closest-first.
  */
 
+#include <limits>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -15,6 +16,44 @@
 namespace handlegraph {
 namespace algorithms {
 
+/**
+ * Reusable search state for Dijkstra-family queries, for callers that issue
+ * many queries against one graph. Owns the visited bookkeeping and scratch
+ * buffers, so repeated queries stop paying for allocation and rehashing.
+ *
+ * Resetting between queries is O(1): marks are stamped with an epoch counter
+ * and begin_query just advances the epoch, invalidating all old marks at
+ * once. On a RankedHandleGraph the marks live in a dense array indexed by
+ * handle rank; otherwise a hash map whose capacity persists across queries is
+ * used.
+ */
+class DijkstraState {
+public:
+    /// Make the state ready for a new query on the given graph. Cheap except
+    /// the first time a graph (or a grown graph) is seen.
+    void begin_query(const HandleGraph* g);
+
+    /// Return whether the handle was already visited this query, and mark it
+    /// visited if it was not.
+    bool check_and_mark_visited(const handle_t& handle);
+
+    /// Return whether the handle was visited this query.
+    bool is_visited(const handle_t& handle) const;
+
+    /// Scratch neighbor buffer for batched adjacency calls.
+    std::vector<handle_t> neighbors;
+
+private:
+    /// Set when the current graph can give us dense handle ranks
+    const RankedHandleGraph* ranked = nullptr;
+    /// Epoch at which each handle rank was last visited, for ranked graphs
+    std::vector<uint64_t> visit_epochs;
+    /// Epoch at which each handle was last visited, for unranked graphs
+    std::unordered_map<handle_t, uint64_t> visit_epoch_map;
+    /// The current query's epoch; marks from older epochs don't count
+    uint64_t epoch = 0;
+};
+
 /// Walk out from the given handle and visit all reachable handles
 /// (including the start) in the graph once, in closest-first order,
 /// accounting for sequence lengths. Walks right unless traverse_leftward
@@ -47,7 +86,45 @@ bool dijkstra(const HandleGraph* g, const std::unordered_set<handle_t>& starts,
               std::function<bool(const handle_t&, size_t)> reached_callback,
               bool traverse_leftward = false, bool prune = false, bool cycle_to_start = false);
                                                       
-/// Run iteratee on each handle and distance in the shortest path from start to end. 
+/// Same as dijkstra, but reuses the given DijkstraState's bookkeeping, so a
+/// query costs no allocation beyond what the frontier itself needs.
+bool dijkstra(const HandleGraph* g, handle_t start, DijkstraState& state,
+              std::function<bool(const handle_t&, size_t)> reached_callback,
+              bool traverse_leftward = false, bool prune = false, bool cycle_to_start = false);
+
+/// Multi-start version of the state-reusing dijkstra.
+bool dijkstra(const HandleGraph* g, const std::unordered_set<handle_t>& starts, DijkstraState& state,
+              std::function<bool(const handle_t&, size_t)> reached_callback,
+              bool traverse_leftward = false, bool prune = false, bool cycle_to_start = false);
+
+/// Like dijkstra, but abandons the search once the closest unvisited handle
+/// is further than max_distance away, so query cost is proportional to the
+/// size of the neighborhood within the bound rather than to graph radius.
+/// Handles past the bound are never passed to the callback. Returns true if
+/// the search ran to completion (including running out of in-bound handles)
+/// and false if the callback aborted it.
+bool bounded_dijkstra(const HandleGraph* g, handle_t start, size_t max_distance,
+                      std::function<bool(const handle_t&, size_t)> reached_callback,
+                      bool traverse_leftward = false, bool prune = false, bool cycle_to_start = false);
+
+/// Same as the single-start version, except allows starting from multiple
+/// handles, all at distance 0.
+bool bounded_dijkstra(const HandleGraph* g, const std::unordered_set<handle_t>& starts, size_t max_distance,
+                      std::function<bool(const handle_t&, size_t)> reached_callback,
+                      bool traverse_leftward = false, bool prune = false, bool cycle_to_start = false);
+
+/// Point-to-point shortest distance by bidirectional Dijkstra: expands a
+/// rightward search from start and a leftward search from end alternately,
+/// and stops as soon as the two frontiers prove the best meeting point, so
+/// work scales with the answer rather than with graph radius. Distance is
+/// measured between the outgoing side of start and the incoming side of end,
+/// as in dijkstra. Searches no further than max_distance. Returns true and
+/// fills in distance_out if end is reachable within the bound, and false
+/// otherwise.
+bool bidirectional_dijkstra(const HandleGraph* g, handle_t start, handle_t end, size_t& distance_out,
+                            size_t max_distance = std::numeric_limits<size_t>::max());
+
+/// Run iteratee on each handle and distance in the shortest path from start to end.
 /// The iteratee function must return true to continue the search, and
 /// false to abort it early.
 void for_each_handle_in_shortest_path(const HandleGraph* g, handle_t start, handle_t end, std::function<bool(const handle_t&, size_t)> iteratee);
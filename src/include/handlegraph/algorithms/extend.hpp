@@ -9,6 +9,9 @@
 
 #include "handlegraph/mutable_handle_graph.hpp"
 
+#include <cstdint>
+#include <vector>
+
 namespace handlegraph {
 namespace algorithms {
 
@@ -16,6 +19,53 @@ namespace algorithms {
 /// both graphs use the same ID space.
 void extend(const HandleGraph* source, MutableHandleGraph* into);
 
+/**
+ * Persistent state for repeatedly extending a working graph with material
+ * from the same backing graph, as when growing a subgraph around alignment
+ * seeds. Remembers which of the backing graph's nodes have been copied in a
+ * dense bitset keyed by node rank (for RankedHandleGraphs; ID-sorted
+ * position otherwise), so each call costs time proportional to the new
+ * material: already-copied nodes are skipped with one bit test instead of a
+ * has_node lookup, edges are only enumerated around newly copied nodes, and
+ * the creations are batched through create_handles/create_edges.
+ *
+ * The backing graph must not change for the lifetime of the extender. The
+ * target may contain other material, but, as with extend, both graphs must
+ * use the same ID space.
+ */
+class IncrementalExtender {
+public:
+
+    /// Set up to extend the given target graph from the given backing graph.
+    IncrementalExtender(const HandleGraph* source, MutableHandleGraph* into);
+
+    IncrementalExtender() = default;
+
+    /// Copy any of the given backing graph nodes that haven't been copied
+    /// yet, along with the backing graph's edges between them and all
+    /// previously copied material.
+    void extend(const std::vector<handle_t>& handles);
+
+    /// Returns true if the given backing graph node has been copied already.
+    bool is_copied(const handle_t& handle) const;
+
+private:
+
+    /// the dense index of a node in the bitset
+    size_t index_of(const nid_t& node_id) const;
+
+    /// the backing graph being copied from
+    const HandleGraph* source = nullptr;
+    /// the working graph being extended
+    MutableHandleGraph* into = nullptr;
+    /// the backing graph again, if it can provide node ranks
+    const RankedHandleGraph* ranked = nullptr;
+    /// the node ID at each dense index, when ranks aren't available
+    std::vector<nid_t> index_to_id;
+    /// one bit per backing graph node: has it been copied?
+    std::vector<uint64_t> copied;
+};
+
 }
 }
 
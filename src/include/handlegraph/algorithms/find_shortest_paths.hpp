@@ -10,16 +10,22 @@
 #include <unordered_map>
 
 #include "handlegraph/handle_graph.hpp"
+#include "handlegraph/algorithms/dijkstra.hpp"
 
 namespace handlegraph {
 namespace algorithms {
-    
+
 /// Finds the length of the shortest oriented path from the given handle
 /// in a given direction to all reachable oriented nodes on a directed walk.
 /// Uses Dijkstra's Algorithm. Distances are measured between the outgoing
 /// side of the start node and the incoming side of the target.
 std::unordered_map<handle_t, size_t>  find_shortest_paths(const HandleGraph* g, handle_t start,
                                                           bool traverse_leftward = false);
+
+/// Same, but reuses the given DijkstraState's bookkeeping across queries.
+std::unordered_map<handle_t, size_t>  find_shortest_paths(const HandleGraph* g, handle_t start,
+                                                          DijkstraState& state,
+                                                          bool traverse_leftward = false);
                                                       
 }
 }
@@ -18,13 +18,28 @@ namespace algorithms {
 /// Find all of the nodes with no edges on their left sides.
 std::vector<handle_t> head_nodes(const HandleGraph* g);
 
+/// Same, but check the nodes' degrees across the given number of threads
+/// (0 means hardware concurrency). The results come back in the graph's
+/// iteration order regardless of thread interleaving.
+std::vector<handle_t> head_nodes(const HandleGraph* g, size_t thread_count);
+
 /// Find all of the nodes with no edges on their right sides.
 std::vector<handle_t> tail_nodes(const HandleGraph* g);
 
+/// Same, but check the nodes' degrees across the given number of threads
+/// (0 means hardware concurrency). The results come back in the graph's
+/// iteration order regardless of thread interleaving.
+std::vector<handle_t> tail_nodes(const HandleGraph* g, size_t thread_count);
+
 /// Find all of the tips in the graph, facing inward.
 /// Nodes with no edges will appear once in each orientation.
 std::vector<handle_t> find_tips(const HandleGraph* g);
 
+/// Same, but check the nodes' degrees across the given number of threads
+/// (0 means hardware concurrency). The results come back in the graph's
+/// iteration order regardless of thread interleaving.
+std::vector<handle_t> find_tips(const HandleGraph* g, size_t thread_count);
+
 }
 }
 
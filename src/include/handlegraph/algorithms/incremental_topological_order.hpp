@@ -0,0 +1,100 @@
+#ifndef HANDLEGRAPH_ALGORITHMS_INCREMENTAL_TOPOLOGICAL_ORDER_HPP_INCLUDED
+#define HANDLEGRAPH_ALGORITHMS_INCREMENTAL_TOPOLOGICAL_ORDER_HPP_INCLUDED
+
+/**
+ * \file incremental_topological_order.hpp
+ *
+ * Defines a structure that maintains a topological order of a graph under
+ * edge insertions, for pipelines that must keep a graph directed acyclic
+ * while editing it.
+ */
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "handlegraph/handle_graph.hpp"
+
+namespace handlegraph {
+namespace algorithms {
+
+/**
+ * Maintains a topological order of a graph's oriented traversals across edge
+ * insertions, so that repeated would-this-edge-create-a-directed-cycle
+ * queries don't each recompute is_directed_acyclic from scratch. Based on
+ * the Pearce-Kelly incremental topological ordering algorithm: an insertion
+ * only does work when it violates the current order, and then only within
+ * the region of the order it disturbs, which is amortized small over an
+ * editing session.
+ *
+ * The intended protocol is to check would_create_cycle before adding an
+ * edge, and to notify the structure with created_edge after adding it (and
+ * created_handle after adding a node). Edge and node deletions never create
+ * cycles and don't invalidate the order, so they need no notification;
+ * destroyed_edge is provided for symmetry. The structure reads the graph's
+ * edges live and only stores the order, so it must be told about every
+ * insertion to stay correct.
+ */
+class IncrementalTopologicalOrder {
+public:
+
+    /// Construct over the graph's current edges. If the graph is not
+    /// directed acyclic to begin with, no order exists and valid() will
+    /// return false.
+    IncrementalTopologicalOrder(const HandleGraph* graph);
+
+    IncrementalTopologicalOrder() = default;
+
+    /// Returns true if the graph was directed acyclic at construction, and
+    /// hence an order is being maintained.
+    bool valid() const;
+
+    /// Returns true if creating an edge connecting the given handles in the
+    /// given order and orientations would create a directed cycle. Does not
+    /// change the maintained order, and the edge must not exist yet.
+    bool would_create_cycle(const handle_t& left, const handle_t& right);
+
+    /// Notify the structure that an edge connecting the given handles was
+    /// just created, and repair the order. Returns false if the edge
+    /// created a directed cycle, in which case the caller should remove it
+    /// again; the order remains valid for the graph without that edge.
+    bool created_edge(const handle_t& left, const handle_t& right);
+
+    /// Notify the structure that the given node was just created. It must
+    /// not have any edges yet.
+    void created_handle(const handle_t& handle);
+
+    /// Notify the structure that an edge was destroyed. Deletions can't
+    /// create cycles, so this is a no-op, but it is provided so callers can
+    /// mirror every edit with a notification.
+    void destroyed_edge(const handle_t& left, const handle_t& right);
+
+private:
+
+    /// Returns true if a directed path leads from one traversal to another
+    /// through the current graph, searching only traversals whose order
+    /// positions lie in [position(from), ceiling].
+    bool can_reach(const handle_t& from, const handle_t& to, int64_t ceiling);
+
+    /// Repair the order after the directed arc from one traversal to
+    /// another was inserted. Returns false on a directed cycle.
+    bool insert_arc(const handle_t& from, const handle_t& to);
+
+    /// the graph whose order is being maintained
+    const HandleGraph* graph = nullptr;
+
+    /// each oriented traversal's position in the maintained order
+    std::unordered_map<handle_t, int64_t> position;
+
+    /// the next unused order position, for newly created nodes
+    int64_t next_position = 0;
+
+    /// whether the graph had an order to maintain at construction
+    bool is_valid = false;
+};
+
+}
+}
+
+#endif
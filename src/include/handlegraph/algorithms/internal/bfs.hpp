@@ -0,0 +1,79 @@
+#ifndef HANDLEGRAPH_ALGORITHMS_INTERNAL_BFS_HPP_INCLUDED
+#define HANDLEGRAPH_ALGORITHMS_INTERNAL_BFS_HPP_INCLUDED
+
+#include "handlegraph/handle_graph.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace handlegraph {
+namespace algorithms {
+namespace internal {
+
+/**
+ * A dense rank space over a graph's oriented handles, for BFS bookkeeping.
+ * On a RankedHandleGraph the graph's own handle ranks are used; otherwise a
+ * sorted table of node IDs is built once and ranks come from binary search.
+ * Ranks are 0-based and cover [0, 2 * node count).
+ */
+class BFSRankSpace {
+public:
+
+    BFSRankSpace(const HandleGraph* graph);
+
+    /// How many oriented handle ranks there are
+    size_t size() const;
+
+    /// The rank of an oriented handle
+    size_t rank_of(const handle_t& handle) const;
+
+    /// The oriented handle with the given rank
+    handle_t handle_at(size_t rank) const;
+
+private:
+
+    const HandleGraph* graph;
+    /// set when the graph hands out dense ranks itself
+    const RankedHandleGraph* ranked;
+    /// sorted node IDs, when it does not
+    std::vector<nid_t> node_ids;
+};
+
+/**
+ * A bitset over handle ranks with atomic test-and-set, so parallel frontier
+ * expansions can claim discoveries without locks.
+ */
+class BFSVisited {
+public:
+
+    BFSVisited(size_t bits);
+
+    /// Set the bit and return whether it was already set. Safe to call
+    /// concurrently; exactly one caller per bit sees false.
+    bool test_and_set(size_t rank);
+
+    /// Return whether the bit is set
+    bool test(size_t rank) const;
+
+private:
+
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+};
+
+/// The BFS engine behind algorithms/bfs.hpp: dense visited bitset,
+/// two-vector frontier swap, and optional direction-optimizing expansion. A
+/// thread_count of 1 runs serially; 0 means hardware concurrency.
+void bfs_engine(const HandleGraph* graph,
+                const std::vector<handle_t>& sources,
+                const std::function<bool(const handle_t&, size_t)>& iteratee,
+                size_t thread_count,
+                bool direction_optimizing);
+
+}
+}
+}
+
+#endif
@@ -29,6 +29,22 @@ bool is_single_stranded(const HandleGraph* graph);
 /// if there is no such combination of node orientations (also if graph has no nodes).
 std::vector<handle_t> single_stranded_orientation(const HandleGraph* graph);
 
+/// Parallel version of is_single_stranded: checks every node's edges across
+/// threads, stopping all threads as soon as any reversing edge is found. A
+/// thread_count of 0 means use the hardware concurrency.
+bool is_single_stranded_parallel(const HandleGraph* graph, size_t thread_count = 0);
+
+/// Parallel version of single_stranded_orientation. The weakly connected
+/// components are labeled with the concurrent union-find and then 2-colored
+/// concurrently, one component per task, over a dense orientation array
+/// keyed by the same indexing; all threads bail out as soon as any component
+/// proves contradictory. Returns the orientations in dense index order
+/// (node rank order for RankedHandleGraphs, ID-sorted order otherwise), or
+/// an empty vector if there is no consistent orientation. A thread_count of
+/// 0 means use the hardware concurrency.
+std::vector<handle_t> single_stranded_orientation_parallel(const HandleGraph* graph,
+                                                           size_t thread_count = 0);
+
 /// Finds a set of node orientations that can be applied so that there are no
 /// reversing edges (i.e. every edge connects a locally forward node traversal
 /// to another locally forward orientation). If no such combination of orientations
@@ -0,0 +1,98 @@
+#ifndef HANDLEGRAPH_ALGORITHMS_LANDMARK_DISTANCE_ORACLE_HPP_INCLUDED
+#define HANDLEGRAPH_ALGORITHMS_LANDMARK_DISTANCE_ORACLE_HPP_INCLUDED
+
+/**
+ * \file landmark_distance_oracle.hpp
+ *
+ * Defines a precomputable landmark (ALT) distance oracle.
+ *
+ * Workloads that re-answer distance queries against a graph that never
+ * changes waste the graph's staticness on plain Dijkstra. The oracle runs
+ * shortest-path searches from (and to) a set of landmark handles once at
+ * build time, stores the distances as compact rank-indexed arrays, and
+ * then answers queries with triangle-inequality bounds: cheap lower and
+ * upper bounds directly, and exact distances by a Dijkstra that prunes
+ * every node the bounds prove cannot lie on a shorter path. The oracle is
+ * Serializable, so the build cost is paid once per graph release.
+ */
+
+#include "handlegraph/handle_graph.hpp"
+#include "handlegraph/serializable.hpp"
+
+#include <limits>
+#include <vector>
+
+namespace handlegraph {
+namespace algorithms {
+
+class LandmarkDistanceOracle : public Serializable {
+public:
+
+    /// The distance reported when no path, or no bound, is known
+    static const size_t UNREACHABLE;
+
+    /// Build an oracle over the given graph, which must outlive the oracle.
+    /// Selects num_landmarks nodes spread evenly over the node ID space and
+    /// runs the landmark searches in parallel on the given number of threads
+    /// (0 means hardware concurrency).
+    LandmarkDistanceOracle(const HandleGraph* graph, size_t num_landmarks = 16,
+                           size_t thread_count = 0);
+
+    /// Make an empty oracle, to deserialize into.
+    LandmarkDistanceOracle() = default;
+
+    /// Point a deserialized oracle back at the graph it was built from. The
+    /// graph must have the same nodes it had at build time.
+    void attach(const HandleGraph* graph);
+
+    /// How many landmarks the oracle holds distances for.
+    size_t get_landmark_count() const;
+
+    /// A lower bound on the directed distance from the outgoing side of one
+    /// handle to the incoming side of another, by triangle inequality over
+    /// the landmarks. Returns 0 when the landmarks prove nothing.
+    size_t lower_bound_distance(const handle_t& from, const handle_t& to) const;
+
+    /// An upper bound on the same distance, by routing through the best
+    /// landmark. Returns UNREACHABLE when no landmark connects the handles.
+    size_t upper_bound_distance(const handle_t& from, const handle_t& to) const;
+
+    /// The exact distance, by Dijkstra with landmark pruning: nodes whose
+    /// bounds prove they cannot be on a path shorter than the best upper
+    /// bound are cut out of the search. Returns UNREACHABLE if there is no
+    /// path.
+    size_t distance(const handle_t& from, const handle_t& to) const;
+
+    uint32_t get_magic_number() const;
+
+protected:
+
+    void serialize_members(std::ostream& out) const;
+    void deserialize_members(std::istream& in);
+
+private:
+
+    /// Dense rank of an oriented handle, over the sorted node IDs
+    size_t rank_of(const handle_t& handle) const;
+
+    /// Complain if no graph is attached
+    void check_attached() const;
+
+    /// The graph we answer queries about; not owned and not serialized
+    const HandleGraph* graph = nullptr;
+    /// All the graph's node IDs, sorted, defining the rank space
+    std::vector<nid_t> node_ids;
+    /// The landmark node IDs (the landmark is the node's forward handle)
+    std::vector<nid_t> landmark_ids;
+    /// Per landmark, the distance from the landmark to every oriented
+    /// handle, indexed by rank; UNREACHABLE where there is no path
+    std::vector<std::vector<uint64_t>> from_landmark;
+    /// Per landmark, the distance from every oriented handle to the
+    /// landmark, indexed by rank
+    std::vector<std::vector<uint64_t>> to_landmark;
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef HANDLEGRAPH_ALGORITHMS_PREFETCH_HPP_INCLUDED
+#define HANDLEGRAPH_ALGORITHMS_PREFETCH_HPP_INCLUDED
+
+/**
+ * \file prefetch.hpp
+ *
+ * Defines an iteration driver that cooperates with memory-mapped storage.
+ *
+ * A cold scan of a TriviallySerializable-backed graph faults one page at a
+ * time, leaving the device queue nearly empty; prefetching the whole
+ * mapping up front instead risks evicting everything else. This driver
+ * pipelines the two: a helper thread issues asynchronous readahead over
+ * the backing mapping a bounded distance ahead of wherever the iteratee
+ * has gotten to.
+ */
+
+#include "handlegraph/handle_graph.hpp"
+
+#include <functional>
+
+namespace handlegraph {
+namespace algorithms {
+
+/// Iterate over all the handles like HandleGraph::for_each_handle, in
+/// internal stored order, stopping early if the iteratee returns false;
+/// returns true if iteration finished. When the graph is
+/// TriviallySerializable and currently has a backing mapping, a helper
+/// thread walks the mapping issuing asynchronous readahead, keeping about
+/// readahead_bytes of not-yet-consumed data in flight, so cold scans keep
+/// the device busy instead of paying one synchronous fault at a time. The
+/// iteratee's progress through the mapping is estimated from the fraction
+/// of handles delivered, which is accurate in proportion to how evenly
+/// the serialized layout spreads the nodes. For other graphs this is just
+/// for_each_handle.
+bool for_each_handle_prefetching(const HandleGraph* graph,
+                                 const std::function<bool(const handle_t&)>& iteratee,
+                                 size_t readahead_bytes = 64 * 1024 * 1024);
+
+}
+}
+
+#endif
@@ -19,6 +19,11 @@ namespace algorithms {
 void reverse_complement_graph(const HandleGraph* source,
                               MutableHandleGraph* into);
 
+/// Flips the forward strand of every node in a MutableHandleGraph to the
+/// reverse strand, in place, without copying the graph. Node IDs may change,
+/// per the apply_orientation contract.
+void reverse_complement_graph_in_place(MutableHandleGraph* graph);
+
 }
 }
 
@@ -8,8 +8,12 @@
  */
 
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "handlegraph/mutable_handle_graph.hpp"
+#include "handlegraph/deletable_handle_graph.hpp"
+#include "handlegraph/node_translation.hpp"
 
 namespace handlegraph {
 namespace algorithms {
@@ -23,6 +27,32 @@ namespace algorithms {
 std::unordered_map<handle_t, handle_t> split_strands(const HandleGraph* source,
                                                      MutableHandleGraph* into);
 
+/// Same, but returns the mapping from the nodes of 'into' back to the
+/// oriented nodes of 'source' as a NodeTranslation: a flat, serializable
+/// structure that is far cheaper than a hash table for large graphs and can
+/// be saved next to the strand-split graph for later coordinate lift-over.
+NodeTranslation split_strands_and_translate(const HandleGraph* source,
+                                            MutableHandleGraph* into);
+
+/// One translation record from split_strands_in_place: a handle in the
+/// strand-split graph paired with the handle in the pre-split graph that its
+/// forward orientation now represents.
+using strand_split_record_t = std::pair<handle_t, handle_t>;
+
+/// Makes a graph single stranded in place, so that no edge connects opposite
+/// strands. Unlike split_strands, this does not require a second graph to
+/// copy into: each node is assigned a canonical orientation by traversal,
+/// nodes whose canonical orientation is reverse are flipped in place, and
+/// only the nodes actually visited in both orientations are duplicated with
+/// a reverse complement copy. Each original edge is preserved by exactly one
+/// edge in the result, so every walk's sequence remains spellable, though a
+/// walk may now read some nodes as reverse traversals of their copies.
+/// Returns records only for the nodes whose forward orientation no longer
+/// matches the pre-split graph: the reverse complement copies, and the nodes
+/// that were flipped (which may have changed ID). All other nodes translate
+/// to themselves.
+std::vector<strand_split_record_t> split_strands_in_place(DeletableHandleGraph* graph);
+
 }
 }
 
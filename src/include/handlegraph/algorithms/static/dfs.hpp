@@ -0,0 +1,191 @@
+#ifndef HANDLEGRAPH_ALGORITHMS_STATIC_DFS_HPP_INCLUDED
+#define HANDLEGRAPH_ALGORITHMS_STATIC_DFS_HPP_INCLUDED
+
+/**
+ * \file static/dfs.hpp
+ *
+ * Defines a public, iterative depth-first traversal engine with reusable
+ * state.
+ *
+ * Unlike the internal DFS (algorithms/internal/dfs.hpp), this engine is
+ * templated on its callbacks, so they are not type-erased through
+ * std::function in the per-edge loop, and its bookkeeping lives in a DFSState
+ * that callers can keep across traversals so repeated searches stop paying
+ * setup cost. It is also templated on the graph type, so when the concrete
+ * type is known at compile time the graph primitives can be inlined into the
+ * traversal loop; passing a HandleGraph reference gives the classic
+ * virtual-dispatch behavior.
+ */
+
+#include "handlegraph/handle_graph.hpp"
+#include "handlegraph/memory_resource.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace handlegraph {
+namespace algorithms {
+
+/**
+ * Reusable bookkeeping for dfs(). Holds the visited marks, the frame stack,
+ * and an arena for adjacency snapshots. Resetting between traversals is O(1):
+ * marks are stamped with an epoch that each traversal advances. On a
+ * RankedHandleGraph the marks live in a dense array indexed by handle rank;
+ * otherwise a hash map whose capacity persists across traversals is used.
+ */
+class DFSState {
+public:
+
+    /// Make a state whose bookkeeping containers draw from the given
+    /// resource, or from the global heap when none is given. A long-running
+    /// caller can pass a per-invocation arena so the traversal's transient
+    /// allocations never fragment the main heap.
+    explicit DFSState(MemoryResource* resource = nullptr)
+        : frames(ResourceAllocator<Frame>(resource)),
+          visit_epochs(ResourceAllocator<uint64_t>(resource)),
+          visit_epoch_map(0, std::hash<handle_t>(), std::equal_to<handle_t>(),
+                          ResourceAllocator<std::pair<const handle_t, uint64_t>>(resource)) {
+    }
+
+    /// Make the state ready for a new traversal of the given graph. Cheap
+    /// except the first time a graph (or a grown graph) is seen.
+    void begin_traversal(const HandleGraph* g) {
+        const RankedHandleGraph* now_ranked = dynamic_cast<const RankedHandleGraph*>(g);
+        if (now_ranked != ranked) {
+            ranked = now_ranked;
+            visit_epochs.clear();
+            visit_epoch_map.clear();
+            epoch = 0;
+        }
+        if (ranked != nullptr) {
+            // Handle ranks are dense and 1-based, one per orientation.
+            size_t needed = g->get_node_count() * 2 + 1;
+            if (visit_epochs.size() < needed) {
+                visit_epochs.resize(needed, 0);
+            }
+        }
+        epoch++;
+        frames.clear();
+        adjacency.clear();
+    }
+
+    /// Return whether the handle was already visited this traversal, and mark
+    /// it visited if it was not.
+    bool check_and_mark_visited(const handle_t& handle) {
+        if (ranked != nullptr) {
+            uint64_t& mark = visit_epochs[ranked->handle_to_rank(handle)];
+            if (mark == epoch) {
+                return true;
+            }
+            mark = epoch;
+            return false;
+        }
+        auto emplaced = visit_epoch_map.emplace(handle, epoch);
+        if (!emplaced.second) {
+            if (emplaced.first->second == epoch) {
+                return true;
+            }
+            emplaced.first->second = epoch;
+        }
+        return false;
+    }
+
+    /// One in-progress node: its handle and the still-unexplored slice of its
+    /// adjacency snapshot in the shared arena.
+    struct Frame {
+        handle_t handle;
+        size_t next_child;
+        size_t end_child;
+    };
+
+    /// The explicit recursion stack
+    resource_vector<Frame> frames;
+    /// Arena holding the adjacency snapshots of the frames on the stack; each
+    /// frame's slice is reclaimed when it pops. Stays on the global heap
+    /// because get_neighbors fills a plain std::vector.
+    std::vector<handle_t> adjacency;
+
+private:
+    /// Set when the current graph can give us dense handle ranks
+    const RankedHandleGraph* ranked = nullptr;
+    /// Epoch at which each handle rank was last visited, for ranked graphs
+    resource_vector<uint64_t> visit_epochs;
+    /// Epoch at which each handle was last visited, for unranked graphs
+    resource_unordered_map<handle_t, uint64_t> visit_epoch_map;
+    /// The current traversal's epoch; marks from older epochs don't count
+    uint64_t epoch = 0;
+};
+
+/**
+ * Iterative depth-first traversal from the given roots, in order, visiting
+ * each handle (as an oriented traversal) at most once and reading rightward.
+ *
+ * Calls enter_fn(handle) when a handle is first reached, edge_fn(edge) for
+ * every edge examined, and exit_fn(handle) when a handle's subtree is done.
+ * The callbacks can be any callables; they are invoked directly, with no
+ * std::function in the loop.
+ */
+template<typename Graph, typename EnterFn, typename ExitFn, typename EdgeFn>
+void dfs(const Graph& graph, DFSState& state, const std::vector<handle_t>& roots,
+         const EnterFn& enter_fn, const ExitFn& exit_fn, const EdgeFn& edge_fn) {
+
+    state.begin_traversal(&graph);
+
+    for (auto& root : roots) {
+        if (state.check_and_mark_visited(root)) {
+            continue;
+        }
+
+        // Open a frame for a newly-visited handle, snapshotting its adjacency
+        // into the arena with one batched call.
+        auto open = [&](const handle_t& handle) {
+            enter_fn(handle);
+            DFSState::Frame frame;
+            frame.handle = handle;
+            frame.next_child = state.adjacency.size();
+            graph.get_neighbors(handle, false, state.adjacency);
+            frame.end_child = state.adjacency.size();
+            state.frames.push_back(frame);
+        };
+
+        open(root);
+
+        while (!state.frames.empty()) {
+            auto& frame = state.frames.back();
+            if (frame.next_child < frame.end_child) {
+                handle_t next = state.adjacency[frame.next_child++];
+                edge_fn(graph.edge_handle(frame.handle, next));
+                if (!state.check_and_mark_visited(next)) {
+                    open(next);
+                }
+            } else {
+                // Subtree done; reclaim the frame's arena slice, which runs
+                // from the end of the parent's slice to end_child.
+                handle_t done = frame.handle;
+                state.frames.pop_back();
+                state.adjacency.resize(state.frames.empty() ? 0 : state.frames.back().end_child);
+                exit_fn(done);
+            }
+        }
+    }
+}
+
+/**
+ * Depth-first traversal over the whole graph: every handle is tried as a root
+ * in its forward orientation, so all components are covered.
+ */
+template<typename Graph, typename EnterFn, typename ExitFn, typename EdgeFn>
+void dfs(const Graph& graph, DFSState& state,
+         const EnterFn& enter_fn, const ExitFn& exit_fn, const EdgeFn& edge_fn) {
+    std::vector<handle_t> roots;
+    roots.reserve(graph.get_node_count());
+    graph.for_each_handle([&](const handle_t& handle) {
+        roots.push_back(handle);
+    });
+    dfs(graph, state, roots, enter_fn, exit_fn, edge_fn);
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef HANDLEGRAPH_ALGORITHMS_STATIC_DIJKSTRA_HPP_INCLUDED
+#define HANDLEGRAPH_ALGORITHMS_STATIC_DIJKSTRA_HPP_INCLUDED
+
+/**
+ * \file static/dijkstra.hpp
+ *
+ * Graph-type-templated Dijkstra search engine. The template is also
+ * parameterized on the callback type, so when the concrete graph type is
+ * known at compile time both the graph primitives and the per-visit callback
+ * can be inlined into the search loop. The HandleGraph* entry points in
+ * algorithms/dijkstra.hpp all funnel into this engine instantiated over the
+ * abstract interface, so there is one copy of the logic.
+ */
+
+#include <limits>
+#include <queue>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "handlegraph/handle_graph.hpp"
+#include "handlegraph/algorithms/dijkstra.hpp"
+
+namespace handlegraph {
+namespace algorithms {
+
+/**
+ * Dijkstra search engine behind the dijkstra, bounded_dijkstra, and
+ * state-reusing entry points, with every graph primitive dispatched
+ * statically against the given graph type. Semantics are exactly those of
+ * the state-reusing dijkstra: visits all handles reachable from the starts
+ * in closest-first order, calling reached_callback with each handle and its
+ * distance, and stops cleanly once the closest unvisited handle is past
+ * max_distance. Returns true if the search terminated normally, and false
+ * if it was aborted.
+ */
+template<typename Graph, typename ReachedFn>
+bool dijkstra(const Graph* g, const std::unordered_set<handle_t>& starts,
+              DijkstraState& state, const ReachedFn& reached_callback,
+              bool traverse_leftward = false, bool prune = false, bool cycle_to_start = false,
+              size_t max_distance = std::numeric_limits<size_t>::max()) {
+
+#ifdef debug_vg_algorithms
+    std::cerr << "Doing Dijkstra traversal from " << starts.size() << " start points, "
+        << (traverse_leftward ? "left" : "right")
+        << ", with pruning " << (prune ? "on" : "off")
+        << " and cycle visits to starts " << (cycle_to_start ? "on" : "off") << std::endl;
+#endif
+
+    // We keep a priority queue so we can visit the handle with the shortest
+    // distance next. We put handles in here whenever we see them with shorter
+    // distances (since STL priority queue can't update), so we also need to
+    // make sure nodes coming out haven't been visited already.
+    using Record = std::pair<size_t, handle_t>;
+
+    // The state filters out handles that have already been visited, and keeps
+    // its allocations warm across queries.
+    state.begin_query(g);
+
+    // We need to know if we stopped early
+    bool stopped_early = false;
+
+    // And for allowing visiting the starts by cycle, we need to discount the first time we see them, at distance 0
+    std::unordered_set<handle_t> unseen_starts;
+    if (cycle_to_start) {
+        unseen_starts = starts;
+    }
+
+    // We need a custom ordering for the queue
+    struct IsFirstGreater {
+        IsFirstGreater() = default;
+        ~IsFirstGreater() = default;
+        inline bool operator()(const Record& a, const Record& b) {
+            return a.first > b.first;
+        }
+    };
+
+    std::priority_queue<Record, std::vector<Record>, IsFirstGreater> queue;
+
+    // We keep one neighbor buffer for the whole search so expansion costs one
+    // adjacency call per node instead of one per edge.
+    auto& neighbors = state.neighbors;
+
+    // We keep a current handle
+    handle_t current;
+    size_t distance = 0;
+    for (auto& start : starts) {
+        queue.push(std::make_pair(distance, start));
+    }
+
+    while (!queue.empty()) {
+        // While there are things in the queue, get the first.
+        std::tie(distance, current) = queue.top();
+        queue.pop();
+
+        if (distance > max_distance) {
+            // Everything left in the queue is at least this far away, so the
+            // in-bound part of the search is done.
+            break;
+        }
+
+        if (cycle_to_start && unseen_starts.count(current)) {
+            // This is the very first visit to this start, so don't count it as
+            // visited.
+#ifdef debug_vg_algorithms
+            std::cerr << "Expand start " << g->get_id(current) << " " << g->get_is_reverse(current) << " at distance " << distance << std::endl;
+#endif
+            unseen_starts.erase(current);
+        } else {
+            if (state.check_and_mark_visited(current)) {
+                continue;
+            }
+
+#ifdef debug_vg_algorithms
+            std::cerr << "Visit " << g->get_id(current) << " " << g->get_is_reverse(current) << " at distance " << distance << std::endl;
+#endif
+
+            // Emit the handle as being at the given distance
+            if (!reached_callback(current, distance)) {
+                // The user told us to stop.
+
+                if (prune) {
+                    // Just continue with whatever is next, and don't expand this
+                    // node.
+#ifdef debug_vg_algorithms
+                    std::cerr << "\tPrune search" << std::endl;
+#endif
+                    stopped_early = true;
+                    continue;
+                } else {
+                    // Stop right away.
+
+                    // Return that we stopped early.
+
+#ifdef debug_vg_algorithms
+                    std::cerr << "\tAbort search" << std::endl;
+#endif
+
+                    return false;
+                }
+            }
+        }
+
+        if (!starts.count(current)) {
+            // Up the distance with the node's length. We don't do this for the
+            // start handles because we want to count distance from the *end* of
+            // the start handles unless directed otherwise.
+            distance += g->get_length(current);
+        }
+
+        neighbors.clear();
+        g->get_neighbors(current, traverse_leftward, neighbors);
+        for (auto& next : neighbors) {
+            // For each handle to the right of here
+
+            if (!state.is_visited(next)) {
+                // New shortest distance. Will never happen after the handle comes out of the queue because of Dijkstra.
+                queue.push(std::make_pair(distance, next));
+
+#ifdef debug_vg_algorithms
+                std::cerr << "\tNew best path to " << g->get_id(next) << " " << g->get_is_reverse(next)
+                    << " at distance " << distance << std::endl;
+#endif
+
+            } else {
+#ifdef debug_vg_algorithms
+                std::cerr << "\tDisregard path to " << g->get_id(next) << " " << g->get_is_reverse(next)
+                    << " at distance " << distance << std::endl;
+#endif
+            }
+        }
+    }
+
+    // Return whether we avoided needing to prune.
+    return !stopped_early;
+
+}
+
+/**
+ * Single-start version of the static-dispatch engine: makes a throwaway
+ * start set and a throwaway DijkstraState.
+ */
+template<typename Graph, typename ReachedFn>
+bool dijkstra(const Graph* g, handle_t start, const ReachedFn& reached_callback,
+              bool traverse_leftward = false, bool prune = false, bool cycle_to_start = false,
+              size_t max_distance = std::numeric_limits<size_t>::max()) {
+    std::unordered_set<handle_t> starts;
+    starts.insert(start);
+    DijkstraState state;
+    return dijkstra(g, starts, state, reached_callback, traverse_leftward, prune, cycle_to_start, max_distance);
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,235 @@
+#ifndef HANDLEGRAPH_ALGORITHMS_STATIC_TOPOLOGICAL_SORT_HPP_INCLUDED
+#define HANDLEGRAPH_ALGORITHMS_STATIC_TOPOLOGICAL_SORT_HPP_INCLUDED
+
+/**
+ * \file static/topological_sort.hpp
+ *
+ * Graph-type-templated topological sort. When the concrete graph type is
+ * known at compile time, instantiating the template over it lets the
+ * compiler devirtualize and inline get_id/follow_edges/edge_handle into the
+ * sort loops. The HandleGraph* entry point in algorithms/topological_sort.hpp
+ * is this template instantiated over the abstract interface, so there is one
+ * copy of the logic.
+ */
+
+#include <map>
+#include <unordered_set>
+#include <vector>
+
+#include "handlegraph/handle_graph.hpp"
+#include "handlegraph/algorithms/find_tips.hpp"
+
+namespace handlegraph {
+namespace algorithms {
+
+/**
+ * Order and the nodes in the graph using a topological sort, as
+ * topological_order(const HandleGraph*), but with every graph primitive
+ * dispatched statically against the given graph type. The sort is guaranteed
+ * to be machine-independent (at the cost of O(n log n) run time). The
+ * algorithm is well-defined on non-DAG graphs, but the order is not a
+ * topological order on these graphs.
+ */
+template<typename Graph>
+std::vector<handle_t> topological_order(const Graph* g) {
+
+    // Make a vector to hold the ordered and oriented nodes.
+    std::vector<handle_t> sorted;
+    sorted.reserve(g->get_node_count());
+
+    // Instead of actually removing edges, we add them to this set of masked edges.
+    std::unordered_set<std::pair<handle_t, handle_t>> masked_edges;
+
+    // This (s) is our set of oriented nodes.
+    // using a map instead of a set ensures a stable sort across different systems
+    std::map<nid_t, handle_t> s;
+
+    // We find the head and tails, if there are any
+    std::vector<handle_t> heads{head_nodes(g)};
+    // No need to fetch the tails since we don't use them
+
+
+    // Maps from node ID to first orientation we suggested for it.
+    std::map<nid_t, handle_t> seeds;
+
+
+    for(handle_t& head : heads) {
+        // Dump all the heads into the oriented set, rather than having them as
+        // seeds. We will only go for cycle-breaking seeds when we run out of
+        // heads. This is bad for contiguity/ordering consistency in cyclic
+        // graphs and reversing graphs, but makes sure we work out to just
+        // topological sort on DAGs. It mimics the effect we used to get when we
+        // joined all the head nodes to a new root head node and seeded that. We
+        // ignore tails since we only orient right from nodes we pick.
+        s[g->get_id(head)] = head;
+    }
+
+    // We will use an ordered map handles by ID for nodes we have not visited
+    // yet. This ensures a consistent sort order across systems.
+    std::map<nid_t, handle_t> unvisited;
+    g->for_each_handle([&](const handle_t& found) {
+        if (!s.count(g->get_id(found))) {
+            // Only nodes that aren't yet in s are unvisited.
+            // Nodes in s are visited but just need to be added tot he ordering.
+            unvisited.emplace(g->get_id(found), found);
+        }
+    });
+
+    while(!unvisited.empty() || !s.empty()) {
+
+        // Put something in s. First go through seeds until we can find one
+        // that's not already oriented.
+        while(s.empty() && !seeds.empty()) {
+            // Look at the first seed
+            auto first_seed = (*seeds.begin()).second;
+
+            if(unvisited.count(g->get_id(first_seed))) {
+                // We have an unvisited seed. Use it
+#ifdef debug
+                std::cerr << "Starting from seed " << g->get_id(first_seed) << " orientation " << g->get_is_reverse(first_seed) << std::endl;
+#endif
+
+                s[g->get_id(first_seed)] = first_seed;
+                unvisited.erase(g->get_id(first_seed));
+            }
+            // Whether we used the seed or not, don't keep it around
+            seeds.erase(seeds.begin());
+        }
+
+        if(s.empty()) {
+            // If we couldn't find a seed, just grab any old node.
+            // Since map order is stable across systems, we can take the first node by id and put it locally forward.
+#ifdef debug
+            std::cerr << "Starting from arbitrary node " << unvisited.begin()->first << " locally forward" << std::endl;
+#endif
+
+            s[unvisited.begin()->first] = unvisited.begin()->second;
+            unvisited.erase(unvisited.begin()->first);
+        }
+
+        while (!s.empty()) {
+            // Grab an oriented node
+            auto n = s.begin()->second;
+            s.erase(g->get_id(n));
+            // Emit it
+            sorted.push_back(n);
+#ifdef debug
+            std::cerr << "Using oriented node " << g->get_id(n) << " orientation " << g->get_is_reverse(n) << std::endl;
+#endif
+
+            // See if it has an edge from its start to the start of some node
+            // where both were picked as places to break into cycles. A
+            // reversing self loop on a cycle entry point is a special case of
+            // this.
+            g->follow_edges(n, true, [&](const handle_t& prev_node) {
+                if(!unvisited.count(g->get_id(prev_node))) {
+                    // Look at the edge
+                    auto edge = g->edge_handle(prev_node, n);
+                    if (masked_edges.count(edge)) {
+                        // We removed this edge, so skip it.
+                        return;
+                    }
+
+#ifdef debug
+                    std::cerr << "\tHas left-side edge to cycle entry point " << g->get_id(prev_node)
+                         << " orientation " << g->get_is_reverse(prev_node) << std::endl;
+#endif
+
+                    // Mask the edge
+                    masked_edges.insert(edge);
+
+#ifdef debug
+                    std::cerr << "\t\tEdge: " << g->get_id(edge.first) << " " << g->get_is_reverse(edge.first)
+                        << " -> " << g->get_id(edge.second) << " " << g->get_is_reverse(edge.second) << std::endl;
+#endif
+                }
+            });
+
+            // All other connections and self loops are handled by looking off the right side.
+
+            // See what all comes next, minus deleted edges.
+            g->follow_edges(n, false, [&](const handle_t& next_node) {
+
+                // Look at the edge
+                auto edge = g->edge_handle(n, next_node);
+                if (masked_edges.count(edge)) {
+                    // We removed this edge, so skip it.
+                    return;
+                }
+
+#ifdef debug
+                std::cerr << "\tHas edge to " << g->get_id(next_node) << " orientation " << g->get_is_reverse(next_node) << std::endl;
+#endif
+
+                // Mask the edge connecting these nodes in this order and
+                // relative orientation, so we can't traverse it again
+
+#ifdef debug
+                std::cerr << "\t\tEdge: " << g->get_id(edge.first) << " " << g->get_is_reverse(edge.first)
+                    << " -> " << g->get_id(edge.second) << " " << g->get_is_reverse(edge.second) << std::endl;
+#endif
+
+                // Mask the edge
+                masked_edges.insert(edge);
+
+                if(unvisited.count(g->get_id(next_node))) {
+                    // We haven't already started here as an arbitrary cycle entry point
+
+#ifdef debug
+                    std::cerr << "\t\tAnd node hasn't been visited yet" << std::endl;
+#endif
+
+                    bool unmasked_incoming_edge = false;
+                    g->follow_edges(next_node, true, [&](const handle_t& prev_node) {
+                        // Get a handle for each incoming edge
+                        auto prev_edge = g->edge_handle(prev_node, next_node);
+
+                        if (!masked_edges.count(prev_edge)) {
+                            // We found such an edghe and can stop looking
+                            unmasked_incoming_edge = true;
+                            return false;
+                        }
+                        // Otherwise check all the edges on the left of this handle
+                        return true;
+                    });
+
+                    if(!unmasked_incoming_edge) {
+
+#ifdef debug
+                        std::cerr << "\t\t\tIs last incoming edge" << std::endl;
+#endif
+                        // Keep this orientation and put it here
+                        s[g->get_id(next_node)] = next_node;
+                        // Remember that we've visited and oriented this node, so we
+                        // don't need to use it as a seed.
+                        unvisited.erase(g->get_id(next_node));
+
+                    } else if(!seeds.count(g->get_id(next_node))) {
+                        // We came to this node in this orientation; when we need a
+                        // new node and orientation to start from (i.e. an entry
+                        // point to the node's cycle), we might as well pick this
+                        // one.
+                        // Only take it if we don't already know of an orientation for this node.
+                        seeds[g->get_id(next_node)] = next_node;
+
+#ifdef debug
+                        std::cerr << "\t\t\tSuggests seed " << g->get_id(next_node) << " orientation " << g->get_is_reverse(next_node) << std::endl;
+#endif
+                    }
+                } else {
+#ifdef debug
+                    std::cerr << "\t\tAnd node was already visited (to break a cycle)" << std::endl;
+#endif
+                }
+            });
+        }
+    }
+
+    // Send away our sorted ordering.
+    return sorted;
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef HANDLEGRAPH_ALGORITHMS_STATIC_WEAKLY_CONNECTED_COMPONENTS_HPP_INCLUDED
+#define HANDLEGRAPH_ALGORITHMS_STATIC_WEAKLY_CONNECTED_COMPONENTS_HPP_INCLUDED
+
+/**
+ * \file static/weakly_connected_components.hpp
+ *
+ * Graph-type-templated weakly connected components. When the concrete graph
+ * type is known at compile time, instantiating the template over it lets the
+ * compiler inline forward/get_id/follow_edges into the component search. The
+ * HandleGraph* entry point in algorithms/weakly_connected_components.hpp is
+ * this template instantiated over the abstract interface, so there is one
+ * copy of the logic.
+ */
+
+#include <unordered_set>
+#include <vector>
+
+#include "handlegraph/handle_graph.hpp"
+
+namespace handlegraph {
+namespace algorithms {
+
+/// Returns sets of IDs defining components that are connected by any series
+/// of nodes and edges, even if it is not a valid bidirected walk, as
+/// weakly_connected_components(const HandleGraph*), but with every graph
+/// primitive dispatched statically against the given graph type.
+template<typename Graph>
+std::vector<std::unordered_set<nid_t>> weakly_connected_components(const Graph* graph) {
+    std::vector<std::unordered_set<nid_t>> to_return;
+
+    // This only holds locally forward handles
+    std::unordered_set<handle_t> traversed;
+
+    graph->for_each_handle([&](const handle_t& handle) {
+
+        // Only think about it in the forward orientation
+        auto forward = graph->forward(handle);
+
+        if (traversed.count(forward)) {
+            // Already have this node, so don't start a search from it.
+            return;
+        }
+
+        // The stack only holds locally forward handles
+        std::vector<handle_t> stack{forward};
+        to_return.emplace_back();
+        while (!stack.empty()) {
+            handle_t here = stack.back();
+            stack.pop_back();
+
+            traversed.insert(here);
+            to_return.back().insert(graph->get_id(here));
+
+            // We have a function to handle all connected handles
+            auto handle_other = [&](const handle_t& other) {
+                // Again, make it forward
+                auto other_forward = graph->forward(other);
+
+                if (!traversed.count(other_forward)) {
+                    stack.push_back(other_forward);
+                }
+            };
+
+            // Look at edges in both directions
+            graph->follow_edges(here, false, handle_other);
+            graph->follow_edges(here, true, handle_other);
+
+        }
+    });
+    return to_return;
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef HANDLEGRAPH_ALGORITHMS_STATISTICS_HPP_INCLUDED
+#define HANDLEGRAPH_ALGORITHMS_STATISTICS_HPP_INCLUDED
+
+/**
+ * \file statistics.hpp
+ *
+ * Defines a single-pass engine for collecting graph topology statistics.
+ */
+
+#include "handlegraph/control_token.hpp"
+#include "handlegraph/path_handle_graph.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace handlegraph {
+namespace algorithms {
+
+/**
+ * Which optional metric families collect_statistics() should spend time and
+ * memory on. The scalar counts and totals in the report are always cheap to
+ * carry and are always collected.
+ */
+struct statistics_config_t {
+    /// histogram the nodes' total degrees
+    bool degree_histogram = true;
+    /// histogram the nodes' sequence lengths
+    bool node_length_histogram = true;
+    /// label the weakly connected components and summarize their sizes
+    bool component_summary = true;
+    /// walk the paths and summarize their coverage of the nodes
+    bool path_coverage = true;
+};
+
+/**
+ * A structured report of a graph's topology statistics. Histograms over
+ * unbounded quantities (lengths, component sizes) are bucketed by power of
+ * two: bucket i counts values in [2^i, 2^(i+1)). Degree is bounded in
+ * practice, so its histogram is exact: entry d counts the nodes with d edge
+ * attachments over both sides.
+ */
+struct graph_statistics_t {
+
+    /// how many nodes the graph has
+    size_t node_count = 0;
+    /// total bases of node sequence
+    size_t total_node_length = 0;
+    /// shortest node's length (0 for an empty graph)
+    size_t min_node_length = 0;
+    /// longest node's length
+    size_t max_node_length = 0;
+    /// power-of-two node length histogram, if requested
+    std::vector<size_t> node_length_log2_histogram;
+
+    /// how many edges the graph has
+    size_t edge_count = 0;
+    /// exact total-degree histogram, if requested
+    std::vector<size_t> degree_histogram;
+
+    /// how many weakly connected components the graph has, if requested
+    size_t component_count = 0;
+    /// the largest component's node count, if requested
+    size_t largest_component_node_count = 0;
+    /// power-of-two component node count histogram, if requested
+    std::vector<size_t> component_size_log2_histogram;
+
+    /// how many paths the graph has, if requested and available
+    size_t path_count = 0;
+    /// total steps over all paths
+    size_t step_count = 0;
+    /// total bases along all paths
+    size_t total_path_length = 0;
+    /// how many nodes at least one path visits
+    size_t nodes_on_paths = 0;
+    /// mean path visits per base of node sequence (total path length over
+    /// total node length; 0 for an empty graph)
+    double mean_path_depth = 0;
+};
+
+/// Collect the requested statistics in one parallel pass over the nodes and
+/// their edges: the node snapshot is split into stripes, each worker
+/// accumulates its stripe into a private sketch, and the sketches are merged
+/// at the end, so a release-QC report costs one sweep of the graph instead
+/// of one per metric. The component summary, when requested, reuses the
+/// concurrent union-find labeling from weakly_connected_component_ids, which
+/// adds one edge sweep and a few words per node. A thread_count of 0 means
+/// use the hardware concurrency. The optional token can cancel the
+/// collection and reports progress through it.
+graph_statistics_t collect_statistics(const HandleGraph* graph,
+                                      const statistics_config_t& config = statistics_config_t(),
+                                      size_t thread_count = 0, ControlToken* token = nullptr);
+
+/// Same, but also walks the paths (in parallel, a stripe of paths per
+/// worker) for the path coverage statistics when the config requests them.
+graph_statistics_t collect_statistics(const PathHandleGraph* graph,
+                                      const statistics_config_t& config = statistics_config_t(),
+                                      size_t thread_count = 0, ControlToken* token = nullptr);
+
+}
+}
+
+#endif
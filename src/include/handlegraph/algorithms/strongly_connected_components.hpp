@@ -2,6 +2,7 @@
 #define HANDLEGRAPH_ALGORITHMS_STRONGLY_CONNECTED_COMPONENTS_HPP_INCLUDED
 
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "handlegraph/handle_graph.hpp"
@@ -9,8 +10,65 @@
 namespace handlegraph {
 namespace algorithms {
 
+/**
+ * Reusable scratch state for strongly_connected_components. The algorithm's
+ * bookkeeping tables are the dominant allocation cost for repeated runs; a
+ * caller that keeps one of these across calls pays for them once, since
+ * reset() clears contents but keeps capacity.
+ */
+struct SCCState {
+    /// The search root from which each traversal was reached
+    std::unordered_map<handle_t, handle_t> roots;
+    /// The index step at which each traversal was discovered
+    std::unordered_map<handle_t, int64_t> discover_idx;
+    /// Our own copy of the DFS stack
+    std::vector<handle_t> stack;
+    /// The traversals currently on the stack
+    std::unordered_set<handle_t> on_stack;
+    /// One node ID from each component already emitted, for deduplication
+    std::unordered_set<nid_t> already_used;
+
+    /// Make the state ready for a fresh run, without giving back the
+    /// allocations from the last one.
+    void reset();
+};
+
 /// Identify strongly connected components
 std::vector<std::unordered_set<nid_t>> strongly_connected_components(const HandleGraph* g);
+
+/// Identify strongly connected components, using (and keeping warm) the given
+/// reusable scratch state.
+std::vector<std::unordered_set<nid_t>> strongly_connected_components(const HandleGraph* g, SCCState& state);
+
+/**
+ * The condensation of a graph: its strongly connected components plus the
+ * DAG of traversals between them, so pipelines that need both don't have to
+ * recompute the components to get the component graph.
+ */
+struct SCCCondensation {
+    /// The components, as in strongly_connected_components
+    std::vector<std::unordered_set<nid_t>> components;
+    /// For each component, the distinct components reachable by reading
+    /// across one edge out of it, in sorted order
+    std::vector<std::vector<size_t>> successors;
+    /// Which component each node belongs to (the first one, if a node of a
+    /// bidirected graph manages to be in several)
+    std::unordered_map<nid_t, size_t> component_of;
+};
+
+/// Compute the strongly connected components and their condensation DAG in
+/// one pass over the edges. Optionally reuses the given scratch state.
+SCCCondensation strongly_connected_components_condensation(const HandleGraph* g);
+SCCCondensation strongly_connected_components_condensation(const HandleGraph* g, SCCState& state);
+
+/// Identify strongly connected components as a dense labeling instead of a
+/// hash set per component. Fills index_to_id with the graph's node IDs in
+/// sorted order and component_ids with a component number per position in
+/// index_to_id, and returns the number of components. In a bidirected graph a
+/// node can fall in more than one component; such a node is labeled with the
+/// first component (in discovery order) that contains it.
+size_t strongly_connected_component_ids(const HandleGraph* g, std::vector<nid_t>& index_to_id,
+                                        std::vector<uint32_t>& component_ids);
     
 }
 }
@@ -30,6 +30,18 @@ std::vector<handle_t> topological_order(const HandleGraph* g);
  */
 std::vector<handle_t> lazy_topological_order(const HandleGraph* g);
     
+/**
+ * Order the nodes in a graph using a parallel Kahn's algorithm: in-degrees
+ * are computed concurrently into atomic counters, and each zero-in-degree
+ * frontier is expanded across threads level by level. Like
+ * lazier_topological_order, this assumes the graph is a DAG in its locally
+ * forward orientation; if that turns out not to hold, it falls back on
+ * topological_order, which is defined on any graph. Frontier levels are
+ * emitted in a deterministic order regardless of thread interleaving. A
+ * thread_count of 0 means use the hardware concurrency.
+ */
+std::vector<handle_t> parallel_topological_order(const HandleGraph* g, size_t thread_count = 0);
+
 /**
  * Order the nodes in a graph using a topological sort. Similar to lazy_topological_order
  * but somewhat faster. The algorithm is invalid in a graph that has any cycles or
@@ -8,6 +8,7 @@
  */
 
 #include "handlegraph/handle_graph.hpp"
+#include "handlegraph/memory_resource.hpp"
 
 #include <unordered_set>
 #include <vector>
@@ -23,14 +24,50 @@ namespace algorithms {
 /// connected component is orientation-independent.
 std::vector<std::unordered_set<nid_t>> weakly_connected_components(const HandleGraph* graph);
 
+/// Parallel version of weakly_connected_components, for graphs where the
+/// serial search is too slow. Instead of a BFS per component, it runs a
+/// concurrent union-find over a dense indexing of the nodes (node ranks when
+/// the graph is a RankedHandleGraph, ID-sorted order otherwise), visiting
+/// edges with for_each_edge_parallel. A thread_count of 0 means use the
+/// hardware concurrency. The components are returned in a deterministic
+/// order: by each component's first node in the dense indexing. The optional
+/// resource supplies the algorithm's internal transient allocations, so a
+/// caller can point it at a per-invocation arena.
+std::vector<std::unordered_set<nid_t>> weakly_connected_components_parallel(const HandleGraph* graph, size_t thread_count = 0,
+                                                                            MemoryResource* resource = nullptr);
+
+/// Compute weakly connected components as a dense labeling instead of
+/// materializing a hash set per component, so labeling a whole graph costs a
+/// few words per node. Fills index_to_id with the node ID at each dense index
+/// (node ranks when the graph is a RankedHandleGraph, ID-sorted order
+/// otherwise) and component_ids with a component number per dense index.
+/// Component numbers count up from 0 in order of each component's first dense
+/// index. Returns the number of components. Runs in parallel; a thread_count
+/// of 0 means use the hardware concurrency.
+size_t weakly_connected_component_ids(const HandleGraph* graph, std::vector<nid_t>& index_to_id,
+                                      std::vector<uint32_t>& component_ids, size_t thread_count = 0,
+                                      MemoryResource* resource = nullptr);
+
+/// Streaming version: visit each weakly connected component as a vector of
+/// node IDs, one component at a time, without ever holding more than the
+/// dense labeling plus one component's worth of IDs. The iteratee can return
+/// false to stop early; returns true if all components were visited.
+bool for_each_weakly_connected_component(const HandleGraph* graph,
+                                         const std::function<bool(const std::vector<nid_t>&)>& iteratee,
+                                         size_t thread_count = 0,
+                                         MemoryResource* resource = nullptr);
+
 /// Return pairs of weakly connected component ID sets and the handles that are
 /// their tips, oriented inward. If a node is both a head and a tail, it will
-/// appear in tips in both orientations.
-std::vector<std::pair<std::unordered_set<nid_t>, std::vector<handle_t>>> weakly_connected_components_with_tips(const HandleGraph* graph);
+/// appear in tips in both orientations. The traversal's bookkeeping can draw
+/// from the given resource.
+std::vector<std::pair<std::unordered_set<nid_t>, std::vector<handle_t>>> weakly_connected_components_with_tips(const HandleGraph* graph,
+                                                                                                               MemoryResource* resource = nullptr);
 
 /// Returns true if graph is a single weakly connected component. Graphs with
-/// no nodes are considered connected.
-bool is_weakly_connected(const HandleGraph* graph);
+/// no nodes are considered connected. The search's bookkeeping can draw from
+/// the given resource.
+bool is_weakly_connected(const HandleGraph* graph, MemoryResource* resource = nullptr);
 
 }
 }
@@ -7,8 +7,71 @@
 
 #include "handlegraph/snarl_decomposition.hpp"
 
+#include <vector>
+
 namespace handlegraph {
 
+/**
+ * A recorded linearization of snarl decomposition structure: the stream of
+ * begin/end chain and snarl calls for one weakly connected component (or any
+ * other self-contained subtree of the decomposition).
+ *
+ * Buffers don't touch the decomposition being built, so independent
+ * components can be recorded on different threads and handed to
+ * BuildableSnarlDecomposition::build_snarl_decomposition() together, which
+ * merges and replays them.
+ */
+class SnarlDecompositionBuffer {
+
+public:
+
+    /// Record entering a chain whose first visit is the given handle.
+    void begin_chain(const handle_t& handle);
+    /// Record leaving a chain whose final visit is the given handle.
+    void end_chain(const handle_t& handle);
+    /// Record entering a snarl whose start bound is the given handle.
+    void begin_snarl(const handle_t& handle);
+    /// Record leaving a snarl whose end bound is the given handle.
+    void end_snarl(const handle_t& handle);
+
+    /// Pre-size the event storage for about this many recorded calls.
+    void reserve(size_t call_count);
+
+    /// How many chains were recorded.
+    size_t chain_count() const;
+    /// How many snarls were recorded.
+    size_t snarl_count() const;
+
+    /// Play the recorded calls back, in order, against the given callbacks.
+    void replay(const std::function<void(const handle_t&)>& begin_chain,
+                const std::function<void(const handle_t&)>& end_chain,
+                const std::function<void(const handle_t&)>& begin_snarl,
+                const std::function<void(const handle_t&)>& end_snarl) const;
+
+private:
+
+    /// The kinds of recorded calls
+    enum event_kind_t : char {
+        BEGIN_CHAIN,
+        END_CHAIN,
+        BEGIN_SNARL,
+        END_SNARL
+    };
+
+    /// One recorded call
+    struct Event {
+        handle_t handle;
+        event_kind_t kind;
+    };
+
+    /// The recorded calls, in order
+    std::vector<Event> events;
+    /// How many BEGIN_CHAIN events are recorded
+    size_t chains = 0;
+    /// How many BEGIN_SNARL events are recorded
+    size_t snarls = 0;
+};
+
 /*
  * Defines an interface for storing a decomposition of a graph into snarls.
  */
@@ -57,7 +120,38 @@ public:
      * it.
      */
     virtual void build_snarl_decomposition(const decomposition_source_t& traverse_decomposition) = 0;
-   
+
+    /**
+     * Hint at the shape of the decomposition about to be built, so storage
+     * can be allocated once instead of grown per element. Pass 0 for
+     * anything unknown. The default implementation ignores the hints.
+     */
+    virtual void reserve_decomposition(size_t chain_count, size_t snarl_count);
+
+    /**
+     * Fill in this SnarlDecomposition from recorded components: replays the
+     * given buffers in order as one decomposition, with all of their
+     * top-level chains in the root snarl. Recording the buffers is the
+     * parallel part — use record_decomposition_components(), or fill them on
+     * the caller's own threads — and this call does the serial merge. The
+     * default implementation forwards the hints to reserve_decomposition()
+     * and makes a single build_snarl_decomposition() call over the
+     * concatenated streams; implementations whose storage supports it can
+     * override this to consume whole components concurrently.
+     */
+    virtual void build_snarl_decomposition(const std::vector<SnarlDecompositionBuffer>& components);
+
+    /**
+     * Record the decomposition of the given number of independent components
+     * across threads (0 means hardware concurrency): the recorder is called
+     * with each component number and a buffer to fill with that component's
+     * begin/end calls. Feed the result to build_snarl_decomposition().
+     */
+    static std::vector<SnarlDecompositionBuffer> record_decomposition_components(
+        size_t component_count,
+        const std::function<void(size_t, SnarlDecompositionBuffer&)>& recorder,
+        size_t thread_count = 0);
+
 };
 
 }
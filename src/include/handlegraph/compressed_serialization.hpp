@@ -0,0 +1,78 @@
+#ifndef HANDLEGRAPH_COMPRESSED_SERIALIZATION_HPP_INCLUDED
+#define HANDLEGRAPH_COMPRESSED_SERIALIZATION_HPP_INCLUDED
+
+/** \file
+ * Defines the framed-chunk compressed container streams used by
+ * Serializable::serialize_compressed() and detected by deserialize().
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+namespace handlegraph {
+
+/// Leading magic number for the compressed container format ("HGZC"). The
+/// compressed payload's own magic number follows inside the container.
+const uint32_t COMPRESSED_CONTAINER_MAGIC = 0x48475A43;
+
+/**
+ * An ostream that compresses everything written to it onto a backing stream
+ * as framed chunks. Each chunk is compressed independently with a small
+ * in-library LZ codec (no external dependencies), so a reader can decompress
+ * chunks in parallel, and chunks that don't shrink are stored raw. The
+ * container is terminated by an empty frame, so it can sit inside a longer
+ * stream.
+ *
+ * Call finish() (or let the destructor do it) to flush the last chunk and
+ * write the terminator.
+ */
+class CompressedOstream : public std::ostream {
+
+public:
+
+    /// Compress onto the given backing stream, which must outlive this one.
+    explicit CompressedOstream(std::ostream& backing);
+
+    /// Finishes the container if finish() was not called.
+    ~CompressedOstream();
+
+    /// Flush any buffered data as a final chunk and write the end-of-container
+    /// marker. The stream must not be written after this.
+    void finish();
+
+    /// How much uncompressed data goes in each chunk
+    static const size_t CHUNK_SIZE = 1024 * 1024;
+
+private:
+
+    class Buf;
+    std::unique_ptr<Buf> buf;
+};
+
+/**
+ * An istream that decompresses a framed-chunk container from a backing
+ * stream, as written by CompressedOstream. Reading stops at the container's
+ * end marker, leaving the backing stream positioned just past it. Throws
+ * std::runtime_error if the container is truncated or corrupt.
+ */
+class CompressedIstream : public std::istream {
+
+public:
+
+    /// Decompress from the given backing stream, which must be positioned at
+    /// the start of the framed chunks (after any leading magic number) and
+    /// must outlive this stream.
+    explicit CompressedIstream(std::istream& backing);
+
+    ~CompressedIstream();
+
+private:
+
+    class Buf;
+    std::unique_ptr<Buf> buf;
+};
+
+}
+
+#endif
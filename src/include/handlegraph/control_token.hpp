@@ -0,0 +1,108 @@
+#ifndef HANDLEGRAPH_CONTROL_TOKEN_HPP_INCLUDED
+#define HANDLEGRAPH_CONTROL_TOKEN_HPP_INCLUDED
+
+/** \file
+ * Defines a cancellation and progress token for long-running algorithms.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace handlegraph {
+
+/**
+ * Thrown out of an algorithm when its ControlToken is cancelled. Derives
+ * from std::runtime_error, so code that doesn't care still sees an
+ * ordinary error, while code that does can catch the cancellation
+ * specifically and keep its process (and its loaded graphs) alive.
+ */
+class CancelledError : public std::runtime_error {
+public:
+    /// Make an error recording the phase the algorithm was in when the
+    /// cancellation took effect.
+    explicit CancelledError(const std::string& phase);
+};
+
+/**
+ * A token for watching and aborting a long-running algorithm from another
+ * thread. The caller makes one, hands a pointer to the algorithm, and can
+ * then poll get_phase()/get_progress() or call cancel() while the
+ * algorithm runs. Algorithms notice the cancellation at phase boundaries
+ * and every few thousand items and throw CancelledError, unwinding
+ * without killing the process.
+ *
+ * Cancelling an algorithm that mutates its graph leaves the graph valid
+ * but possibly partially transformed, so a cancelled run's graph should
+ * be reloaded or discarded, not reused.
+ *
+ * All the methods are thread-safe. A token is single-use: make a fresh
+ * one for each run.
+ */
+class ControlToken {
+public:
+
+    ControlToken() = default;
+
+    // Tokens are shared by pointer between the controlling thread and the
+    // algorithm, never copied.
+    ControlToken(const ControlToken& other) = delete;
+    ControlToken& operator=(const ControlToken& other) = delete;
+
+    ///////////////////////////////////////////////////////////////////////
+    // For the controlling thread
+    ///////////////////////////////////////////////////////////////////////
+
+    /// Ask the algorithm to stop at its next check.
+    void cancel();
+
+    /// Has cancel() been called?
+    bool is_cancelled() const;
+
+    /// The fraction of the current phase completed, in [0, 1]; 0 when the
+    /// phase's total isn't known.
+    double get_progress() const;
+
+    /// The name of the phase the algorithm is currently in.
+    std::string get_phase() const;
+
+    ///////////////////////////////////////////////////////////////////////
+    // For the algorithm
+    ///////////////////////////////////////////////////////////////////////
+
+    /// Enter a named phase expecting the given number of items (0 if not
+    /// known), resetting the progress. Throws CancelledError if cancelled.
+    void begin_phase(const std::string& name, size_t total_items = 0);
+
+    /// Record that some items of the current phase finished. Never throws,
+    /// so it is safe inside parallel workers, which should poll
+    /// is_cancelled() and bail out instead; the coordinating thread turns
+    /// the cancellation into a throw at its next check().
+    void advance(size_t items = 1);
+
+    /// Throw CancelledError if cancelled. Algorithms call this at phase
+    /// boundaries and every CHECK_INTERVAL items of serial loops.
+    void check() const;
+
+    /// How many items serial loops process between check() calls.
+    static const size_t CHECK_INTERVAL = 4096;
+
+private:
+
+    /// has cancel() been called?
+    std::atomic<bool> cancel_flag{false};
+    /// items finished in the current phase
+    std::atomic<size_t> done_items{0};
+    /// items expected in the current phase, or 0 if not known
+    std::atomic<size_t> total_items{0};
+    /// guards phase_name, which atomics can't carry
+    mutable std::mutex phase_mutex;
+    /// the name of the current phase
+    std::string phase_name;
+};
+
+}
+
+#endif
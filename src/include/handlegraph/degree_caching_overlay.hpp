@@ -0,0 +1,92 @@
+#ifndef HANDLEGRAPH_DEGREE_CACHING_OVERLAY_HPP_INCLUDED
+#define HANDLEGRAPH_DEGREE_CACHING_OVERLAY_HPP_INCLUDED
+
+/** \file
+ * Defines an overlay that caches node degrees and the edge count for any
+ * HandleGraph.
+ */
+
+#include "handlegraph/handle_graph.hpp"
+
+#include <vector>
+
+namespace handlegraph {
+
+/**
+ * An overlay that answers get_degree and get_edge_count from a precomputed
+ * cache, and forwards everything else to the backing graph.
+ *
+ * The default get_degree walks a node's edges on every call and the default
+ * get_edge_count scans the whole graph, so algorithms that query degrees
+ * repeatedly (layout heuristics, Eades-style orderings) go quadratic on
+ * backends without fast overrides. The cache stores both sides' degrees of
+ * every node, built in one parallel pass at construction, so each query is
+ * a binary search on the node ID and a load.
+ *
+ * The backing graph must outlive the overlay. If the backing graph's
+ * topology changes, call invalidate() to rebuild the cache; until then the
+ * cached answers are stale.
+ */
+class DegreeCachingOverlay : public HandleGraph {
+
+public:
+
+    /// Build the degree cache over the given graph, using the given number
+    /// of threads (0 means hardware concurrency).
+    DegreeCachingOverlay(const HandleGraph* graph, size_t thread_count = 0);
+
+    ~DegreeCachingOverlay() = default;
+
+    /// Throw away the cached degrees and rebuild them from the backing
+    /// graph, using the given number of threads (0 means hardware
+    /// concurrency). Call this after the backing graph's topology changes.
+    void invalidate(size_t thread_count = 0);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // HandleGraph interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    bool has_node(nid_t node_id) const;
+    handle_t get_handle(const nid_t& node_id, bool is_reverse = false) const;
+    nid_t get_id(const handle_t& handle) const;
+    bool get_is_reverse(const handle_t& handle) const;
+    handle_t flip(const handle_t& handle) const;
+    size_t get_length(const handle_t& handle) const;
+    std::string get_sequence(const handle_t& handle) const;
+    size_t get_node_count() const;
+    nid_t min_node_id() const;
+    nid_t max_node_id() const;
+    size_t get_degree(const handle_t& handle, bool go_left) const;
+    size_t get_edge_count() const;
+    size_t get_total_length() const;
+    char get_base(const handle_t& handle, size_t index) const;
+    std::string get_subsequence(const handle_t& handle, size_t index, size_t size) const;
+
+protected:
+
+    bool follow_edges_impl(const handle_t& handle, bool go_left,
+                           function_ref<bool(const handle_t&)> iteratee) const;
+    bool for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee,
+                              bool parallel = false) const;
+
+private:
+
+    /// Fill in the cache from the backing graph.
+    void build_cache(size_t thread_count);
+
+    /// the backing graph
+    const HandleGraph* graph = nullptr;
+
+    /// node IDs with cached degrees, sorted for binary search
+    std::vector<nid_t> node_ids;
+    /// degree of each node's left (start) side, parallel to node_ids
+    std::vector<size_t> left_degrees;
+    /// degree of each node's right (end) side, parallel to node_ids
+    std::vector<size_t> right_degrees;
+    /// total number of edges in the backing graph
+    size_t edge_count = 0;
+};
+
+}
+
+#endif
@@ -7,6 +7,8 @@
  
 #include "handlegraph/handle_graph.hpp"
 
+#include <vector>
+
 namespace handlegraph {
 
 /**
@@ -25,6 +27,55 @@ public:
      * overlay
      */
     virtual handle_t get_underlying_handle(const handle_t& handle) const = 0;
+
+    /**
+     * Translate each of the given overlay handles to the underlying graph,
+     * as get_underlying_handle would, filling the results vector in the
+     * order of the queries. The default implementation translates the
+     * handles one at a time; overlays that keep their translation in a
+     * table can override it to avoid a virtual call per handle.
+     */
+    virtual void get_underlying_handles(const std::vector<handle_t>& overlay_handles,
+                                        std::vector<handle_t>& underlying_handles) const;
+};
+
+/**
+ * A precomputed translation across a stack of ExpandingOverlayGraphs.
+ *
+ * Each lookup through a stack of overlays costs one virtual call per layer;
+ * code that projects many handles (read projection, annotation lift-over)
+ * pays that per handle. This helper walks the outermost overlay once at
+ * construction, composes the per-layer translations, and stores the result
+ * in one flat sorted array, so later lookups are a binary search with no
+ * virtual dispatch.
+ *
+ * The layers are given outermost first, and each layer's
+ * get_underlying_handle must map into the graph the next layer overlays.
+ * The overlays must not change while the translation is in use, and lookups
+ * are only defined for handles of the outermost overlay.
+ */
+class FlattenedOverlay {
+
+public:
+
+    /// Bake the translation of the given overlay stack, outermost first.
+    /// The list must not be empty.
+    FlattenedOverlay(const std::vector<const ExpandingOverlayGraph*>& layers);
+
+    /// Translate a handle of the outermost overlay all the way to the graph
+    /// under the innermost layer.
+    handle_t get_underlying_handle(const handle_t& handle) const;
+
+    /// Translate a batch of handles of the outermost overlay, filling the
+    /// results vector in the order of the queries.
+    void get_underlying_handles(const std::vector<handle_t>& overlay_handles,
+                                std::vector<handle_t>& underlying_handles) const;
+
+private:
+
+    /// Overlay handles (as integers, both orientations) paired with their
+    /// fully translated underlying handles, sorted for binary search.
+    std::vector<std::pair<uint64_t, handle_t>> translation;
 };
 
 }
@@ -0,0 +1,161 @@
+#ifndef HANDLEGRAPH_FLAT_SNARL_DECOMPOSITION_HPP_INCLUDED
+#define HANDLEGRAPH_FLAT_SNARL_DECOMPOSITION_HPP_INCLUDED
+
+/** \file
+ * Defines FlatSnarlDecomposition, a concrete serialized snarl decomposition.
+ */
+
+#include "handlegraph/snarl_decomposition.hpp"
+#include "handlegraph/trivially_serializable.hpp"
+
+#include <string>
+#include <vector>
+
+namespace handlegraph {
+
+/**
+ * A concrete SnarlDecomposition that stores the snarl tree flattened into one
+ * contiguous buffer: fixed-size records in rank order, a child index, and a
+ * node ID index. Because the in-memory form is the serialized form, it is
+ * TriviallySerializable: a precomputed decomposition can be memory-mapped
+ * straight off disk instead of being rebuilt at startup.
+ *
+ * Build one by converting any existing SnarlDecomposition (over its graph),
+ * save it, and load it with deserialize(). The object is immutable once
+ * built or loaded.
+ *
+ * Net handles are not interchangeable with those of the source
+ * decomposition; they encode positions in the flattened tree.
+ */
+class FlatSnarlDecomposition : public SnarlDecomposition, public TriviallySerializable {
+
+public:
+
+    /// Make an empty decomposition, ready to deserialize into.
+    FlatSnarlDecomposition() = default;
+
+    /// Flatten the given decomposition, which must describe the given graph.
+    FlatSnarlDecomposition(const SnarlDecomposition& source, const HandleGraph& graph);
+
+    virtual ~FlatSnarlDecomposition();
+
+    // The object holds one buffer (owned or mapped); it can't be copied.
+    FlatSnarlDecomposition(const FlatSnarlDecomposition&) = delete;
+    FlatSnarlDecomposition& operator=(const FlatSnarlDecomposition&) = delete;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // SnarlDecomposition interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    net_handle_t get_root() const;
+    bool is_root(const net_handle_t& net) const;
+    bool is_snarl(const net_handle_t& net) const;
+    bool is_chain(const net_handle_t& net) const;
+    bool is_node(const net_handle_t& net) const;
+    bool is_sentinel(const net_handle_t& net) const;
+    net_handle_t get_net(const handle_t& handle, const HandleGraph* graph) const;
+    handle_t get_handle(const net_handle_t& net, const HandleGraph* graph) const;
+    net_handle_t get_parent(const net_handle_t& child) const;
+    net_handle_t get_bound(const net_handle_t& snarl, bool get_end, bool face_in) const;
+    net_handle_t flip(const net_handle_t& net) const;
+    net_handle_t canonical(const net_handle_t& net) const;
+    endpoint_t starts_at(const net_handle_t& traversal) const;
+    endpoint_t ends_at(const net_handle_t& traversal) const;
+    net_traits_t get_net_traits(const net_handle_t& net) const;
+    net_handle_t get_parent_traversal(const net_handle_t& traversal_start, const net_handle_t& traversal_end) const;
+    void get_children(const net_handle_t& parent, std::vector<net_handle_t>& out) const;
+
+protected:
+
+    bool for_each_child_impl(const net_handle_t& traversal, const std::function<bool(const net_handle_t&)>& iteratee) const;
+    bool for_each_traversal_impl(const net_handle_t& item, const std::function<bool(const net_handle_t&)>& iteratee) const;
+    bool follow_net_edges_impl(const net_handle_t& here, const HandleGraph* graph, bool go_left, const std::function<bool(const net_handle_t&)>& iteratee) const;
+
+public:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // (Trivially)Serializable interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    uint32_t get_magic_number() const;
+    void dissociate();
+    void serialize(const std::function<void(const void*, size_t)>& iteratee) const;
+    void serialize(int fd);
+    void deserialize(int fd);
+    using TriviallySerializable::serialize;
+    using TriviallySerializable::deserialize;
+
+    std::vector<std::pair<std::string, size_t>> memory_usage() const;
+
+protected:
+
+    void serialize_members(std::ostream& out) const;
+    void deserialize_members(std::istream& in);
+    std::pair<const void*, size_t> get_mapping() const;
+
+private:
+
+    /// One flattened snarl, chain, or node.
+    struct Record {
+        /// Parent record number, or NO_RECORD for the root snarl
+        uint64_t parent;
+        /// First slot of our children in the child index
+        uint64_t child_start;
+        /// How many children we have
+        uint64_t child_count;
+        /// Our position in the parent's child list
+        uint64_t parent_rank;
+        /// The graph node we stand for, if we are a node
+        nid_t node_id;
+        /// Kind, orientation in parent, and realizable traversal bits
+        uint64_t flags;
+    };
+
+    /// One entry of the node ID index, sorted by ID for binary search.
+    struct NodeIndexEntry {
+        nid_t node_id;
+        uint64_t record;
+    };
+
+    /// Marks the root's lack of a parent
+    static const uint64_t NO_RECORD;
+
+    // Whichever of these is non-empty backs the views below. Exactly one is
+    // in use after construction or loading.
+
+    /// The buffer when built by conversion or loaded from a stream
+    std::vector<char> owned;
+    /// The buffer when memory-mapped from a file descriptor
+    void* mapped = nullptr;
+    /// How long the memory-mapped buffer is
+    size_t mapped_length = 0;
+    /// Our duplicate of the mapped file descriptor, for dissociate()
+    int mapped_fd = -1;
+
+    // Views into the buffer, set up by set_views()
+
+    const char* data_start = nullptr;
+    size_t data_length = 0;
+    const Record* records = nullptr;
+    size_t record_count = 0;
+    const uint64_t* child_list = nullptr;
+    size_t child_list_length = 0;
+    const NodeIndexEntry* node_index = nullptr;
+    size_t node_index_length = 0;
+
+    /// Point the view members into the given buffer, checking that the
+    /// lengths all make sense.
+    void set_views(const char* data, size_t length);
+
+    // Small decoding helpers, defined in the implementation file
+    const Record& record_at(uint64_t number) const;
+    uint64_t record_of(const net_handle_t& net) const;
+    uint64_t find_node_record(const nid_t& node_id) const;
+    handle_t node_graph_handle(uint64_t record, bool reversed, const HandleGraph* graph) const;
+    void child_entry_handles(uint64_t child, const HandleGraph* graph, handle_t& start_in, handle_t& end_in) const;
+    bool snarl_boundary_handles(uint64_t snarl, const HandleGraph* graph, handle_t& start_in, handle_t& end_exit, uint64_t& start_record, uint64_t& end_record) const;
+};
+
+}
+
+#endif
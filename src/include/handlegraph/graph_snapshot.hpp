@@ -0,0 +1,124 @@
+#ifndef HANDLEGRAPH_GRAPH_SNAPSHOT_HPP_INCLUDED
+#define HANDLEGRAPH_GRAPH_SNAPSHOT_HPP_INCLUDED
+
+/** \file
+ * Defines a flat, read-only copy of a graph's topology for multi-pass
+ * algorithms.
+ */
+
+#include "handlegraph/handle_graph.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace handlegraph {
+
+/**
+ * A read-only copy of another graph's topology in flat CSR-style arrays:
+ * the nodes get dense indexes (in ID-sorted order), and each oriented handle
+ * gets a contiguous run of its rightward neighbors, stored as dense handles
+ * with the orientation packed in. Algorithms that traverse the edges many
+ * times (layout, cycle breaking, walk counting) can build one of these once,
+ * in parallel, and then run every pass over plain arrays instead of paying
+ * the backing graph's dispatch and lookup costs per edge per pass.
+ *
+ * The snapshot implements the HandleGraph read interface. Node IDs are
+ * preserved, so handles translate to the backing graph through
+ * get_id/get_is_reverse. All topology queries are answered from the arrays;
+ * only the sequence queries (get_sequence and the accessors defaulting to
+ * it) consult the backing graph, so the backing graph must outlive the
+ * snapshot if sequences are queried. Node lengths are cached, so
+ * length-weighted traversals stay in the snapshot.
+ *
+ * The backing graph must not change between building the snapshot and its
+ * last use.
+ */
+class GraphSnapshot : public HandleGraph {
+
+public:
+
+    /// Materialize the given graph's topology, reading degrees and
+    /// adjacencies across the given number of threads (0 means hardware
+    /// concurrency).
+    explicit GraphSnapshot(const HandleGraph* graph, size_t thread_count = 0);
+
+    GraphSnapshot() = default;
+    ~GraphSnapshot() = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // HandleGraph interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    /// Method to check if a node exists by ID
+    bool has_node(nid_t node_id) const;
+
+    /// Look up the handle for the node with the given ID in the given orientation
+    handle_t get_handle(const nid_t& node_id, bool is_reverse = false) const;
+
+    /// Get the ID from a handle
+    nid_t get_id(const handle_t& handle) const;
+
+    /// Get the orientation of a handle
+    bool get_is_reverse(const handle_t& handle) const;
+
+    /// Invert the orientation of a handle (potentially without getting its ID)
+    handle_t flip(const handle_t& handle) const;
+
+    /// Get the length of a node
+    size_t get_length(const handle_t& handle) const;
+
+    /// Get the sequence of a node, presented in the handle's local forward
+    /// orientation. Answered by the backing graph.
+    std::string get_sequence(const handle_t& handle) const;
+
+    /// Return the number of nodes in the graph
+    size_t get_node_count() const;
+
+    /// Return the smallest ID in the graph, or some smaller number if the
+    /// smallest ID is unavailable. Return value is unspecified if the graph is empty.
+    nid_t min_node_id() const;
+
+    /// Return the largest ID in the graph, or some larger number if the
+    /// largest ID is unavailable. Return value is unspecified if the graph is empty.
+    nid_t max_node_id() const;
+
+    /// Get the number of edges on one side of a handle, straight off the
+    /// offset array.
+    size_t get_degree(const handle_t& handle, bool go_left) const;
+
+    /// Append the neighbors on one side of a handle to the given vector with
+    /// one pass over the handle's adjacency run.
+    void get_neighbors(const handle_t& handle, bool go_left, std::vector<handle_t>& out) const;
+
+protected:
+
+    bool follow_edges_impl(const handle_t& handle, bool go_left,
+                           function_ref<bool(const handle_t&)> iteratee) const;
+    bool for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee,
+                              bool parallel = false) const;
+
+private:
+
+    /// the dense index of a node ID
+    size_t index_of(const nid_t& node_id) const;
+
+    /// the adjacency run of one oriented handle: dense index times two, plus
+    /// the orientation
+    size_t slot_of(const handle_t& handle) const;
+
+    /// the backing graph, consulted only for sequences
+    const HandleGraph* backing = nullptr;
+    /// the node ID at each dense index, in ID-sorted order
+    std::vector<nid_t> index_to_id;
+    /// the length of the node at each dense index
+    std::vector<uint64_t> lengths;
+    /// where each oriented handle's rightward neighbors start in adjacency,
+    /// plus the total at the end
+    std::vector<uint64_t> edge_offsets;
+    /// the rightward neighbors of every oriented handle, as snapshot handles
+    std::vector<handle_t> adjacency;
+};
+
+}
+
+#endif
@@ -7,10 +7,12 @@
  
 #include "handlegraph/types.hpp"
 #include "handlegraph/iteratee.hpp"
+#include "handlegraph/packed_sequence.hpp"
 
 #include <functional>
 #include <string>
 #include <iostream>
+#include <vector>
 
 namespace handlegraph {
 
@@ -99,6 +101,14 @@ public:
     /// the number of edges returned, but graph implementations that track this
     /// information more efficiently can override this method.
     virtual size_t get_degree(const handle_t& handle, bool go_left) const;
+
+    /// Append all the handles to next/previous (right/left) nodes to the given
+    /// vector, in one call. The vector is not cleared first, so the caller can
+    /// accumulate into it; callers that reuse one vector across many nodes
+    /// avoid per-neighbor dispatch overhead. The default implementation loops
+    /// over follow_edges, but implementations with contiguous edge storage can
+    /// override it with a bulk copy.
+    virtual void get_neighbors(const handle_t& handle, bool go_left, std::vector<handle_t>& out) const;
     
     /// Returns true if there is an edge that allows traversal from the left
     /// handle to the right handle. By default O(n) in the number of edges
@@ -127,7 +137,39 @@ public:
     /// handle's sequence, the return value is truncated to the sequence's end.
     /// By default O(n) in the size of the handle's sequence, but can be overriden.
     virtual std::string get_subsequence(const handle_t& handle, size_t index, size_t size) const;
-    
+
+    /// Copy a piece of a handle's sequence, in the orientation of the handle,
+    /// into a caller-owned buffer, without allocating. Copies up to length
+    /// bases starting at index, truncated to the end of the sequence, and
+    /// returns the number of bases actually copied. By default falls back on
+    /// get_subsequence, but implementations with directly accessible sequence
+    /// storage can override it to skip the std::string round trip.
+    virtual size_t get_sequence_into(const handle_t& handle, char* buffer, size_t index, size_t length) const;
+
+    /// Copy the full sequences of many handles, each in its handle's
+    /// orientation, into one contiguous caller-owned buffer, concatenated in
+    /// order. The buffer must have room for the total length of the handles'
+    /// sequences. Returns the total number of bases copied. By default loops
+    /// over get_sequence_into.
+    virtual size_t get_sequences_into(const std::vector<handle_t>& handles, char* buffer) const;
+
+    /// Returns true if get_packed_sequence is backed by native 2-bit
+    /// storage, and false if it has to encode the ASCII sequence on the
+    /// fly. Either way the packed result is usable; this just tells
+    /// callers whether staying packed actually skips the ASCII round trip.
+    virtual bool supports_packed_sequence() const;
+
+    /// Get the sequence of a node in 2-bit packed form, in the handle's
+    /// local forward orientation, with non-ACGT bases in the exception
+    /// list. By default packs the result of get_sequence; backends that
+    /// store 2-bit codes should override it (and supports_packed_sequence)
+    /// to hand the codes over directly.
+    virtual PackedSequence get_packed_sequence(const handle_t& handle) const;
+
+    /// Like get_subsequence, but 2-bit packed. Exception offsets are
+    /// relative to the start of the returned subsequence.
+    virtual PackedSequence get_packed_subsequence(const handle_t& handle, size_t index, size_t size) const;
+
     ////////////////////////////////////////////////////////////////////////////
     // Concrete utility methods
     ////////////////////////////////////////////////////////////////////////////
@@ -150,17 +192,32 @@ public:
     /// in parallel (parallel = true), stopping early is best-effort.
     template<typename Iteratee>
     bool for_each_edge(const Iteratee& iteratee, bool parallel = false) const;
-    
+
+    /// Like for_each_edge with parallel = true, but runs on an explicit number
+    /// of threads with dynamic chunking over a snapshot of the graph's
+    /// handles, so iteration load-balances even when a few hub nodes carry
+    /// most of the edges. A thread_count of 0 means use the hardware
+    /// concurrency. Stopping early (by returning false from a bool-returning
+    /// iteratee) is best-effort, as in parallel for_each_edge. The iteratee
+    /// may be called concurrently from multiple threads, on different edges.
+    template<typename Iteratee>
+    bool for_each_edge_parallel(const Iteratee& iteratee, size_t thread_count = 0) const;
+
     ////////////////////////////////////////////////////////////////////////////
     // Backing protected virtual methods that need to be implemented
     ////////////////////////////////////////////////////////////////////////////
     
 protected:
-    
+
+    /// Backing implementation for for_each_edge_parallel. Snapshots the
+    /// graph's handles and farms chunks of them out to worker threads, each of
+    /// which applies the canonical-edge filtering that for_each_edge does.
+    bool for_each_edge_parallel_internal(function_ref<bool(const edge_t&)> iteratee, size_t thread_count) const;
+
     /// Loop over all the handles to next/previous (right/left) nodes. Passes
     /// them to a callback which returns false to stop iterating and true to
     /// continue. Returns true if we finished and false if we stopped early.
-    virtual bool follow_edges_impl(const handle_t& handle, bool go_left, const std::function<bool(const handle_t&)>& iteratee) const = 0;
+    virtual bool follow_edges_impl(const handle_t& handle, bool go_left, function_ref<bool(const handle_t&)> iteratee) const = 0;
     
     /// Loop over all the nodes in the graph in their local forward
     /// orientations, in their internal stored order. Stop if the iteratee
@@ -168,7 +225,7 @@ protected:
     /// after a false return value is on a best-effort basis and iteration
     /// order is not defined. Returns true if we finished and false if we 
     /// stopped early.
-    virtual bool for_each_handle_impl(const std::function<bool(const handle_t&)>& iteratee, bool parallel = false) const = 0;
+    virtual bool for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee, bool parallel = false) const = 0;
     
     
 };
@@ -238,13 +295,13 @@ bool HandleGraph::for_each_handle(const Iteratee& iteratee, bool parallel) const
 template<typename Iteratee>
 bool HandleGraph::for_each_edge(const Iteratee& iteratee, bool parallel) const {
     auto wrapped_iteratee = BoolReturningWrapper<Iteratee>::wrap(iteratee);
-    // (If we pre-cast our lambda to std::function we won't generate a new
-    // template instantiation for it each time we are instantiated.)
-    return for_each_handle((std::function<bool(const handle_t&)>)[&](const handle_t& handle) -> bool {
+    // (If we pre-bind our lambdas to function_refs we won't generate a new
+    // template instantiation for them each time we are instantiated.)
+    return for_each_handle((function_ref<bool(const handle_t&)>)[&](const handle_t& handle) -> bool {
         bool keep_going = true;
         // Filter to edges where this node is lower ID or any rightward
-        // self-loops. 
-        follow_edges(handle, false, (std::function<bool(const handle_t&)>)[&](const handle_t& next) -> bool {
+        // self-loops.
+        follow_edges(handle, false, (function_ref<bool(const handle_t&)>)[&](const handle_t& next) -> bool {
             if (get_id(handle) <= get_id(next)) {
                 keep_going = wrapped_iteratee(edge_handle(handle, next));
             }
@@ -253,7 +310,7 @@ bool HandleGraph::for_each_edge(const Iteratee& iteratee, bool parallel) const {
         if (keep_going) {
             // Filter to edges where this node is lower ID or leftward
             // reversing self-loop.
-            follow_edges(handle, true, (std::function<bool(const handle_t&)>)[&](const handle_t& prev) -> bool {
+            follow_edges(handle, true, (function_ref<bool(const handle_t&)>)[&](const handle_t& prev) -> bool {
                 if (get_id(handle) < get_id(prev) ||
                     (get_id(handle) == get_id(prev) && get_is_reverse(prev))) {
                     keep_going = wrapped_iteratee(edge_handle(prev, handle));
@@ -261,11 +318,16 @@ bool HandleGraph::for_each_edge(const Iteratee& iteratee, bool parallel) const {
                 return keep_going;
             });
         }
-        
+
         return keep_going;
     }, parallel);
 }
 
+template<typename Iteratee>
+bool HandleGraph::for_each_edge_parallel(const Iteratee& iteratee, size_t thread_count) const {
+    return for_each_edge_parallel_internal(BoolReturningWrapper<Iteratee>::wrap(iteratee), thread_count);
+}
+
 
 }
 
@@ -19,11 +19,64 @@
  * a bool-returning iteratee, and expose public non-virtual for_each_whatever
  * templates that manage the wraping of void-returning iteratees.
  */
- 
+
 #include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 namespace handlegraph {
 
+/**
+ * A non-owning reference to a callable, like the proposed std::function_ref:
+ * just a pointer to the callable and a pointer to a function that invokes it.
+ * Unlike std::function, constructing one never allocates, and calling one is
+ * a single indirect call with no virtual dispatch inside.
+ *
+ * The for_each_whatever_impl backing virtuals take their iteratees as these,
+ * so that the public templates can hand a lambda straight through without
+ * materializing a std::function per call.
+ *
+ * The referenced callable must outlive every call, so these are only for
+ * passing down a call stack; they are cheap to copy and meant to be passed by
+ * value.
+ */
+template<typename Signature>
+class function_ref;
+
+template<typename Returns, typename... Args>
+class function_ref<Returns(Args...)> {
+public:
+
+    /// Refer to any callable with a compatible signature. The callable is
+    /// captured by reference and must outlive the function_ref.
+    template<typename Callable,
+             typename std::enable_if<!std::is_same<typename std::decay<Callable>::type,
+                                                   function_ref>::value, int>::type = 0>
+    function_ref(Callable&& callable) noexcept :
+        target(const_cast<void*>(static_cast<const void*>(std::addressof(callable)))),
+        invoker([](void* target, Args... args) -> Returns {
+            return (*static_cast<typename std::remove_reference<Callable>::type*>(target))(std::forward<Args>(args)...);
+        }) {
+        // Nothing to do!
+    }
+
+    function_ref(const function_ref& other) = default;
+    function_ref& operator=(const function_ref& other) = default;
+
+    /// Call the referenced callable.
+    Returns operator()(Args... args) const {
+        return invoker(target, std::forward<Args>(args)...);
+    }
+
+private:
+
+    /// The callable we refer to, with its type erased.
+    void* target;
+    /// Knows how to get the callable's type back and call it.
+    Returns (*invoker)(void*, Args...);
+};
+
 /**
  * Tool to get the return type of a function.
  * See for example <https://stackoverflow.com/a/7943765>
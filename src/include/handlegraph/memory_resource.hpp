@@ -0,0 +1,136 @@
+#ifndef HANDLEGRAPH_MEMORY_RESOURCE_HPP_INCLUDED
+#define HANDLEGRAPH_MEMORY_RESOURCE_HPP_INCLUDED
+
+/** \file memory_resource.hpp
+ * Defines a polymorphic allocation interface that the heavyweight
+ * algorithms accept for their internal transient containers. This is a
+ * C++14 stand-in for std::pmr: long-running callers can hand an
+ * invocation a MonotonicMemoryResource arena so the algorithm's scratch
+ * maps and vectors never touch the global heap, and everything is
+ * returned in O(1) when the arena is released, instead of fragmenting
+ * the heap with large short-lived allocations.
+ */
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace handlegraph {
+
+/**
+ * Abstract source of raw memory. Implementations must tolerate allocate
+ * and deallocate being called concurrently, because algorithms hand the
+ * resource to their worker threads.
+ */
+class MemoryResource {
+public:
+    virtual ~MemoryResource() = default;
+
+    /// Get bytes bytes of memory aligned to alignment, which will not
+    /// exceed alignof(std::max_align_t).
+    virtual void* allocate(size_t bytes, size_t alignment) = 0;
+
+    /// Give back memory obtained from allocate. Arena implementations
+    /// may make this a no-op and reclaim everything at once instead.
+    virtual void deallocate(void* ptr, size_t bytes, size_t alignment) = 0;
+};
+
+/// Get the resource backed by the global operator new and delete, which
+/// is what the algorithms use when the caller doesn't pass one.
+MemoryResource* default_memory_resource();
+
+/**
+ * An arena that hands out memory by bumping a pointer through
+ * geometrically growing blocks, ignores deallocate, and frees every
+ * block in O(1) on release() or destruction. Intended to live for one
+ * algorithm invocation.
+ */
+class MonotonicMemoryResource : public MemoryResource {
+public:
+
+    /// Make an arena whose first block holds initial_block_size bytes;
+    /// later blocks double.
+    explicit MonotonicMemoryResource(size_t initial_block_size = 1 << 20);
+    ~MonotonicMemoryResource();
+
+    // The arena owns its blocks and can't be copied
+    MonotonicMemoryResource(const MonotonicMemoryResource& other) = delete;
+    MonotonicMemoryResource& operator=(const MonotonicMemoryResource& other) = delete;
+
+    void* allocate(size_t bytes, size_t alignment);
+    void deallocate(void* ptr, size_t bytes, size_t alignment);
+
+    /// Free every block at once and start over empty.
+    void release();
+
+private:
+
+    /// Serializes allocation so worker threads can share the arena
+    std::mutex mutex;
+    /// Every block we have gotten from the global heap
+    std::vector<void*> blocks;
+    /// Where the next allocation in the current block starts
+    char* cursor = nullptr;
+    /// How many bytes are left in the current block
+    size_t remaining = 0;
+    /// How big to make the next block
+    size_t next_block_size;
+};
+
+/**
+ * A std-compatible allocator over a MemoryResource, so the algorithms'
+ * internal containers can draw from a caller-supplied arena. A null or
+ * absent resource means the global heap.
+ */
+template<typename T>
+class ResourceAllocator {
+public:
+    using value_type = T;
+
+    ResourceAllocator(MemoryResource* resource = nullptr)
+        : resource(resource != nullptr ? resource : default_memory_resource()) {
+    }
+
+    template<typename U>
+    ResourceAllocator(const ResourceAllocator<U>& other) : resource(other.resource) {
+    }
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(resource->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* allocated, size_t count) {
+        resource->deallocate(allocated, count * sizeof(T), alignof(T));
+    }
+
+    bool operator==(const ResourceAllocator& other) const {
+        return resource == other.resource;
+    }
+
+    bool operator!=(const ResourceAllocator& other) const {
+        return resource != other.resource;
+    }
+
+    /// The backing resource, which we do not own
+    MemoryResource* resource;
+};
+
+// Shorthands for the containers the algorithms actually use
+
+template<typename T>
+using resource_vector = std::vector<T, ResourceAllocator<T>>;
+
+template<typename T>
+using resource_unordered_set = std::unordered_set<T, std::hash<T>, std::equal_to<T>,
+                                                  ResourceAllocator<T>>;
+
+template<typename K, typename V>
+using resource_unordered_map = std::unordered_map<K, V, std::hash<K>, std::equal_to<K>,
+                                                  ResourceAllocator<std::pair<const K, V>>>;
+
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef HANDLEGRAPH_MEMORY_USAGE_HPP_INCLUDED
+#define HANDLEGRAPH_MEMORY_USAGE_HPP_INCLUDED
+
+/** \file
+ * Defines helpers for implementing Serializable::memory_usage(): rough,
+ * err-high sizes for the containers implementations usually hold their data
+ * in. None of these walk pointed-to data except where noted, so compose them
+ * per member and add up.
+ */
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace handlegraph {
+
+/// How much memory a vector occupies, counting its full allocated capacity.
+/// Does not look inside the items; for vectors of strings use the deep
+/// overload below.
+template<typename Item>
+size_t memory_usage_of(const std::vector<Item>& v) {
+    return sizeof(v) + v.capacity() * sizeof(Item);
+}
+
+/// How much memory a string occupies. Short strings that fit in the object
+/// itself don't get charged for a heap allocation.
+inline size_t memory_usage_of(const std::string& s) {
+    size_t heap = (s.capacity() + 1 > sizeof(s)) ? s.capacity() + 1 : 0;
+    return sizeof(s) + heap;
+}
+
+/// How much memory a vector of strings occupies, including each string's own
+/// allocation.
+inline size_t memory_usage_of(const std::vector<std::string>& v) {
+    size_t total = sizeof(v) + (v.capacity() - v.size()) * sizeof(std::string);
+    for (auto& s : v) {
+        total += memory_usage_of(s);
+    }
+    return total;
+}
+
+/// How much memory an unordered_map occupies: a node per element (with a next
+/// pointer and cached hash) plus a pointer per bucket. Does not look inside
+/// keys or values.
+template<typename Key, typename Value, typename Hash>
+size_t memory_usage_of(const std::unordered_map<Key, Value, Hash>& m) {
+    return sizeof(m)
+        + m.size() * (sizeof(std::pair<const Key, Value>) + 2 * sizeof(void*))
+        + m.bucket_count() * sizeof(void*);
+}
+
+/// How much memory an ordered map occupies: a red-black tree node (three
+/// pointers and a color) per element. Does not look inside keys or values.
+template<typename Key, typename Value, typename Compare>
+size_t memory_usage_of(const std::map<Key, Value, Compare>& m) {
+    return sizeof(m) + m.size() * (sizeof(std::pair<const Key, Value>) + 4 * sizeof(void*));
+}
+
+}
+
+#endif
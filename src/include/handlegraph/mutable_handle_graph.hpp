@@ -8,10 +8,23 @@
 #include "handlegraph/handle_graph.hpp"
 
 #include <functional>
+#include <utility>
 #include <vector>
 
 namespace handlegraph {
 
+/**
+ * What an optimize() pass actually did, so callers can tell whether storage
+ * locality is likely to have improved. Fields default to false; backends
+ * that don't track what their optimize() changes report nothing.
+ */
+struct optimize_report_t {
+    /// Were the nodes' storage records rearranged or compacted, changing
+    /// iteration order or locality?
+    bool reordered_storage = false;
+    /// Were node IDs reassigned?
+    bool reassigned_ids = false;
+};
 
 /**
  * This is the interface for a handle graph that supports addition of new graph material.
@@ -29,6 +42,16 @@ public:
     /// The sequence may not be empty.
     /// The ID must be strictly greater than 0.
     virtual handle_t create_handle(const std::string& sequence, const nid_t& id) = 0;
+
+    /// Create a new node from a 2-bit packed sequence and return the handle.
+    /// The sequence may not be empty. The default implementation unpacks to
+    /// ASCII first; backends that store 2-bit codes should override it to
+    /// take the codes as-is.
+    virtual handle_t create_handle(const PackedSequence& sequence);
+
+    /// Create a new node from a 2-bit packed sequence with the given ID,
+    /// which must be strictly greater than 0, then return the handle.
+    virtual handle_t create_handle(const PackedSequence& sequence, const nid_t& id);
     
     /// Create an edge connecting the given handles in the given order and orientations.
     /// Ignores existing edges.
@@ -39,6 +62,27 @@ public:
         create_edge(edge.first, edge.second);
     }
 
+    /// Create a batch of new nodes with the given sequences and return their
+    /// handles, in order. If ids is nonempty, it must be parallel to sequences
+    /// and gives the ID for each new node; otherwise the implementation
+    /// assigns the IDs. No sequence may be empty, and every ID must be
+    /// strictly greater than 0.
+    /// Has a default implementation that loops over create_handle, but
+    /// backends can override it to avoid per-node virtual dispatch.
+    virtual std::vector<handle_t> create_handles(const std::vector<std::string>& sequences,
+                                                 const std::vector<nid_t>& ids = {});
+
+    /// Create a batch of edges connecting the given handles in the given
+    /// orders and orientations. Ignores existing edges.
+    /// Has a default implementation that loops over create_edge, but backends
+    /// can override it to avoid per-edge virtual dispatch.
+    virtual void create_edges(const std::vector<edge_t>& edges);
+
+    /// Hint that approximately this many nodes, edges, and total bases of
+    /// sequence are about to be added, so the backing implementation can
+    /// preallocate. May have no effect.
+    virtual void reserve(size_t nodes, size_t edges, size_t total_bp);
+
     /// Alter the node that the given handle corresponds to so the orientation
     /// indicated by the handle becomes the node's local forward orientation.
     /// Rewrites all edges pointing to the node and the node's sequence to
@@ -48,7 +92,16 @@ public:
     /// Does not update any stored paths. May change the ordering of the underlying
     /// graph.
     virtual handle_t apply_orientation(const handle_t& handle) = 0;
-    
+
+    /// Apply a batch of orientations at once, as if by calling
+    /// apply_orientation on each given handle in turn. The handles must be to
+    /// distinct nodes. Invalidates all handles to the affected nodes, and
+    /// returns new, valid handles to them, parallel to the input.
+    /// Has a default implementation that loops over apply_orientation, but
+    /// backends can override it to rewrite their edge storage in one pass
+    /// instead of once per flipped node.
+    virtual std::vector<handle_t> apply_orientations(const std::vector<handle_t>& handles);
+
     /// Split a handle's underlying node at the given offsets in the handle's
     /// orientation. Returns all of the handles to the parts. Other handles to
     /// the node being split may be invalidated. The split pieces stay in the
@@ -73,12 +126,23 @@ public:
     /// This may invalidate outstanding handles.
     virtual void optimize(bool allow_id_reassignment = true) = 0;
 
+    /// Like optimize(), but report what was actually done. The default
+    /// implementation runs optimize() and claims nothing; backends that
+    /// track their changes should override it so callers can tell whether
+    /// locality actually improved.
+    virtual optimize_report_t optimize_with_report(bool allow_id_reassignment = true);
+
     /// Reorder the graph's internal structure to match that given.
     /// This sets the order that is used for iteration in functions like for_each_handle.
     /// If compact_ids is true, may (but will not necessarily) compact the id space of the graph to match the ordering, from 1->|ordering|.
     /// In other cases, node IDs will be preserved.
     /// This may be a no-op in the case of graph implementations that do not have any mechanism to maintain an ordering.
     /// This may invalidate outstanding handles.
+    /// Implementations should relayout their existing storage rather than
+    /// rebuild the graph into a second copy, so that sorting the largest
+    /// graphs for locality doesn't double peak memory; apply_permutation()
+    /// in handlegraph/permutation.hpp moves rank-indexed storage into a
+    /// target order in place by cycle chasing.
     /// Returns true if node IDs actually were adjusted to match the given order, and false if they remain unchanged.
     virtual bool apply_ordering(const std::vector<handle_t>& order, bool compact_ids = false) = 0;
 
@@ -86,6 +150,46 @@ public:
     /// May have no effect on a backing implementation.
     virtual void set_id_increment(const nid_t& min_id) = 0;
 
+    ////////////////////////////////////////////////////////////////////////////
+    // Concurrent construction
+    ////////////////////////////////////////////////////////////////////////////
+
+    // Nothing else in this interface is thread-safe; by default, parallel
+    // construction needs a lock around every call. Backends can opt in to a
+    // restricted concurrent mode instead. When
+    // supports_concurrent_construction() returns true, the backend promises
+    // that:
+    //
+    //  - lease_id_range() may be called concurrently from any thread, and
+    //    returns ranges that never overlap.
+    //  - create_handle(sequence, id) calls with IDs in disjoint leased
+    //    ranges may proceed concurrently, as may create_edge() calls whose
+    //    endpoints were both created by the calling thread.
+    //  - Edges between nodes created by different threads, and every other
+    //    method, must wait until one thread has called
+    //    seal_concurrent_construction() with no creation calls in flight.
+    //
+    // When it returns false, these methods still work, but only under the
+    // usual single-threaded rules.
+
+    /// Return true if this graph supports the concurrent construction
+    /// contract described above, and false otherwise.
+    virtual bool supports_concurrent_construction() const;
+
+    /// Reserve the next count unused node IDs for the exclusive use of the
+    /// calling thread, and return the inclusive [first, last] range. The
+    /// caller may create nodes with exactly these IDs and no others. The
+    /// default implementation takes IDs from past max_node_id() and
+    /// advances the ID space with set_id_increment(), and is only safe
+    /// single-threaded.
+    virtual std::pair<nid_t, nid_t> lease_id_range(size_t count);
+
+    /// Finish a phase of concurrent construction, making the graph
+    /// consistent for reads and for the rest of this interface. Must be
+    /// called by exactly one thread, with no creation calls still running.
+    /// The default implementation does nothing.
+    virtual void seal_concurrent_construction();
+
     /// Add the given value to all node IDs.
     /// Has a default implementation in terms of reassign_node_ids, but can be
     /// implemented more efficiently in some graphs.
@@ -100,6 +204,12 @@ public:
     /// remain unchanged. The mapping function should not return any ID for
     /// which it would return 0.
     virtual void reassign_node_ids(const std::function<nid_t(const nid_t&)>& get_new_id) = 0;
+
+private:
+
+    /// First ID the default lease_id_range() may hand out next; leased
+    /// ranges aren't visible through max_node_id() until they are used.
+    nid_t next_leased_id = 1;
 };
 
 }
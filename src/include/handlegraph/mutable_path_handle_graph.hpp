@@ -10,6 +10,14 @@
 
 namespace handlegraph {
 
+/// One batched path edit: replace the segment from begin (inclusive) to end
+/// (exclusive) with the given steps, as rewrite_segment would.
+struct segment_rewrite_t {
+    step_handle_t begin;
+    step_handle_t end;
+    std::vector<handle_t> replacement;
+};
+
 /**
  * This is the interface for a handle graph with embedded paths where the paths can be modified.
  * Note that if the *graph* can also be modified, the implementation will also
@@ -29,6 +37,15 @@ public:
     
     /**
      * Destroy the given set of paths. Invalidates handles to all the paths and their steps.
+     *
+     * This is a first-class batch operation, not just a convenience loop:
+     * implementations that keep per-node step occurrence structures should
+     * override it to collect every step of the doomed paths first and then
+     * update each touched structure once (walking the collected steps in
+     * parallel where their internal locking allows), so destroying a large
+     * path set costs one sweep over the removed steps instead of a separate
+     * index update per path. The default implementation destroys the paths
+     * one at a time.
      */
     virtual void destroy_paths(const std::vector<path_handle_t>& paths);
 
@@ -40,7 +57,17 @@ public:
      */
     virtual path_handle_t create_path_handle(const std::string& name,
                                              bool is_circular = false) = 0;
-    
+
+    /**
+     * Create a path with the given name, hinting how many steps it will
+     * eventually hold so the implementation can preallocate its step
+     * storage. The hint may be approximate, and the default implementation
+     * ignores it.
+     */
+    virtual path_handle_t create_path_handle(const std::string& name,
+                                             bool is_circular,
+                                             size_t step_count_hint);
+
     /**
      * Renames a path. Existing path_handle_t's may become invalidated..
      */
@@ -55,7 +82,16 @@ public:
      * must remain valid.
      */
     virtual step_handle_t append_step(const path_handle_t& path, const handle_t& to_append) = 0;
-    
+
+    /**
+     * Append a whole sequence of visits to the given path, as append_step
+     * would one at a time. Handles to prior steps on the path, and to other
+     * paths, must remain valid. The default implementation loops over
+     * append_step; implementations should override it to grow their step
+     * storage once and avoid a virtual dispatch per step.
+     */
+    virtual void append_steps(const path_handle_t& path, const std::vector<handle_t>& to_append);
+
     /**
      * Prepend a visit to a node to the given path. Returns a handle to the new
      * first step on the path which is appended. If the path is cirular, the new
@@ -90,7 +126,26 @@ public:
     virtual std::pair<step_handle_t, step_handle_t> rewrite_segment(const step_handle_t& segment_begin,
                                                                     const step_handle_t& segment_end,
                                                                     const std::vector<handle_t>& new_segment) = 0;
-    
+
+    /**
+     * Apply a batch of segment rewrites to one path. The rewrites must all
+     * be against the given path, sorted from the path's start towards its
+     * end, and non-overlapping, and their step handles must refer to the
+     * path as it is when the call is made. Invalidates step handles to the
+     * rewritten path.
+     *
+     * Implementations should override this to apply the whole batch in a
+     * single left-to-right pass over their step storage, so that applying
+     * any number of edits to a path costs time proportional to the path
+     * length plus the replacement material, rather than one full-path
+     * rewrite per edit. The default implementation loops over
+     * rewrite_segment from the last rewrite to the first, so that the step
+     * handles of the not-yet-applied rewrites stay valid in storage schemes
+     * where a rewrite only disturbs the steps after it.
+     */
+    virtual void rewrite_segments(const path_handle_t& path,
+                                  const std::vector<segment_rewrite_t>& rewrites);
+
     /**
      * Make a path circular or non-circular. If the path is becoming circular, the
      * last step is joined to the first step. If the path is becoming linear, the
@@ -0,0 +1,127 @@
+#ifndef HANDLEGRAPH_NODE_TRANSLATION_HPP_INCLUDED
+#define HANDLEGRAPH_NODE_TRANSLATION_HPP_INCLUDED
+
+/** \file
+ * Defines a compact, serializable translation from the nodes of a
+ * transformed graph back to oriented offsets on the nodes of the graph it
+ * was produced from.
+ */
+
+#include "handlegraph/named_node_back_translation.hpp"
+#include "handlegraph/serializable.hpp"
+#include "handlegraph/types.hpp"
+
+#include <string>
+#include <vector>
+
+namespace handlegraph {
+
+/**
+ * A translation from node IDs in a transformed graph back to oriented
+ * offsets on the nodes of the original graph, as produced by
+ * graph-transforming algorithms like chop, dagify, and split_strands.
+ *
+ * The records live in flat arrays sorted by new node ID: lookups go through
+ * direct indexing when the new IDs are contiguous and binary search
+ * otherwise, so a translation costs a few words per translated node rather
+ * than a hash table entry. New node IDs without a record translate to
+ * themselves.
+ *
+ * Implements Serializable, so a translation can be written next to the
+ * transformed graph and loaded later for coordinate lift-over, and
+ * NamedNodeBackTranslation, so it plugs into consumers of that interface
+ * (the back graph node "names" are the decimal forms of the original
+ * graph's node IDs).
+ */
+class NodeTranslation : public NamedNodeBackTranslation, public Serializable {
+
+public:
+
+    NodeTranslation() = default;
+    ~NodeTranslation() = default;
+
+    ////////////////////////////////////////
+    // Building the translation
+    ////////////////////////////////////////
+
+    /// Record that the given new node represents the segment of the given
+    /// original node that starts at offset_on_forward along the original
+    /// node's forward strand (equivalently, at offset_on_reverse along its
+    /// reverse strand), and that the new node's forward strand reads the
+    /// segment on the original node's reverse strand if is_reverse is set.
+    /// Records may be added in any order; index() must be called after the
+    /// last one before any lookups.
+    void add_translation(const nid_t& new_id, const nid_t& old_id,
+                         size_t offset_on_forward, size_t offset_on_reverse,
+                         bool is_reverse);
+
+    /// Sort the records by new node ID and prepare them for lookup. Must be
+    /// called between the last add_translation and the first lookup.
+    /// Deserialized translations arrive already indexed.
+    void index();
+
+    ////////////////////////////////////////
+    // Lookups
+    ////////////////////////////////////////
+
+    /// Returns the number of translated nodes.
+    size_t size() const;
+
+    /// Returns true if there is a record for the given new node ID.
+    bool has_translation(const nid_t& new_id) const;
+
+    /// Returns the original node ID behind the given new node ID, which is
+    /// the same ID if there is no record for it.
+    nid_t get_old_id(const nid_t& new_id) const;
+
+    /// Returns true if the new node's forward strand reads the original
+    /// node's reverse strand.
+    bool get_old_is_reverse(const nid_t& new_id) const;
+
+    /// Returns the offset along the chosen strand of the original node at
+    /// which the new node's segment starts.
+    size_t get_old_offset(const nid_t& new_id, bool reverse_strand = false) const;
+
+    ////////////////////////////////////////
+    // NamedNodeBackTranslation interface
+    ////////////////////////////////////////
+
+    std::vector<oriented_node_range_t> translate_back(const oriented_node_range_t& range) const;
+
+    std::string get_back_graph_node_name(const nid_t& back_node_id) const;
+
+    ////////////////////////////////////////
+    // Serializable interface
+    ////////////////////////////////////////
+
+    uint32_t get_magic_number() const;
+
+protected:
+
+    void serialize_members(std::ostream& out) const;
+
+    void deserialize_members(std::istream& in);
+
+private:
+
+    /// the position of the record for a new node ID, or a max value sentinel
+    /// if there is none
+    size_t record_of(const nid_t& new_id) const;
+
+    /// the new node IDs, sorted by index()
+    std::vector<nid_t> new_ids;
+    /// the original node ID behind each new node
+    std::vector<nid_t> old_ids;
+    /// where each new node's segment starts on the original forward strand
+    std::vector<uint64_t> offsets_on_forward;
+    /// where each new node's segment starts on the original reverse strand
+    std::vector<uint64_t> offsets_on_reverse;
+    /// does the new node's forward strand read the original reverse strand?
+    std::vector<bool> reads_reverse;
+    /// do the new node IDs form a contiguous range we can index directly?
+    bool dense = false;
+};
+
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef HANDLEGRAPH_PACKED_SEQUENCE_HPP_INCLUDED
+#define HANDLEGRAPH_PACKED_SEQUENCE_HPP_INCLUDED
+
+/** \file packed_sequence.hpp
+ * Defines a 2-bit packed representation of DNA sequences, and the kernels
+ * to convert to and from ASCII. Sequence-heavy code can move packed bases
+ * across the interface boundary at a quarter of the memory traffic of
+ * std::string, and compare them four to a byte.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace handlegraph {
+
+/**
+ * A sequence packed 4 bases to the byte, with A, C, G, and T as codes 0
+ * through 3, the first base in each byte's low bits. Bases that aren't
+ * ACGT (Ns, ambiguity codes, lowercase soft-masking) are carried in a
+ * sorted exception list of (offset, original character) and hold code 0
+ * in the packed bytes, so the packed words of two all-ACGT sequences can
+ * be compared directly.
+ */
+struct PackedSequence {
+    /// The packed codes, in ceil(length / 4) bytes
+    std::vector<uint8_t> codes;
+    /// The number of bases in the sequence
+    size_t length = 0;
+    /// The non-ACGT bases, as (offset, original character), sorted by offset
+    std::vector<std::pair<size_t, char>> exceptions;
+};
+
+/// Pack count ASCII bases into codes, which must have room for
+/// ceil(count / 4) bytes and arrive zeroed. Non-ACGT bases are appended
+/// to exceptions (if it is not null) and packed as code 0. The loop is a
+/// byte-table lookup with no branches on the base values, so the compiler
+/// can vectorize it.
+void pack_dna(const char* sequence, size_t count, uint8_t* codes,
+              std::vector<std::pair<size_t, char>>* exceptions);
+
+/// Unpack count bases of codes into sequence as ASCII ACGT, without
+/// applying any exceptions.
+void unpack_dna(const uint8_t* codes, size_t count, char* sequence);
+
+/// Pack a whole sequence.
+PackedSequence pack_sequence(const std::string& sequence);
+
+/// Unpack a whole sequence, applying its exceptions, reproducing the
+/// original string exactly.
+std::string unpack_sequence(const PackedSequence& packed);
+
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef HANDLEGRAPH_PARALLEL_HPP_INCLUDED
+#define HANDLEGRAPH_PARALLEL_HPP_INCLUDED
+
+/** \file
+ * Defines a shared chunked parallel loop for handle graph implementations and
+ * algorithms.
+ *
+ * Implementations of for_each_handle_impl's parallel mode, and the parallel
+ * algorithms shipped with the library, all need the same thing: run an
+ * iteratee over a range of indexes on several threads, with dynamic load
+ * balancing and a consistent interpretation of the bool-return early-stop
+ * contract. Rather than each backend rolling its own OpenMP or thread code,
+ * they can delegate to this one scheduler.
+ */
+
+#include "handlegraph/iteratee.hpp"
+
+#include <cstddef>
+#include <functional>
+
+namespace handlegraph {
+
+/**
+ * Run iteratee(index) for every index in [0, count), spread over worker
+ * threads that claim small chunks of the range off a shared cursor, so uneven
+ * per-index work still load-balances.
+ *
+ * If the iteratee returns false, iteration stops on a best-effort basis:
+ * other threads stop at their next index, and no thread starts a new chunk.
+ * Returns true if every index was visited and false if iteration stopped
+ * early.
+ *
+ * A thread_count of 0 means use the hardware concurrency; a thread_count of 1
+ * runs the loop inline with no threads spawned. A chunk_size of 0 picks a
+ * chunk size balancing cursor contention against load balance.
+ */
+bool parallel_for_range(size_t count, const std::function<bool(size_t)>& iteratee,
+                        size_t thread_count = 0, size_t chunk_size = 0);
+
+/**
+ * Template version of parallel_for_range that, like the for_each methods on
+ * the graph interfaces, accepts either a bool-returning iteratee (which can
+ * stop early) or a void-returning one.
+ */
+template<typename Iteratee>
+bool parallel_for(size_t count, const Iteratee& iteratee, size_t thread_count = 0, size_t chunk_size = 0) {
+    return parallel_for_range(count, BoolReturningWrapper<Iteratee>::wrap(iteratee), thread_count, chunk_size);
+}
+
+}
+
+#endif
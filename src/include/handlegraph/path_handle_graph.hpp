@@ -8,6 +8,10 @@
 #include "handlegraph/handle_graph.hpp"
 #include "handlegraph/path_metadata.hpp"
 
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace handlegraph {
@@ -20,9 +24,17 @@ class PathForEachSocket;
  */
 class PathHandleGraph : virtual public HandleGraph, virtual public PathMetadata {
 public:
-    
+
     virtual ~PathHandleGraph() = default;
-    
+
+    // Copies and moves are allowed, but the lazily interned path name cache
+    // stays behind; the copy re-interns on first use.
+    PathHandleGraph() = default;
+    PathHandleGraph(const PathHandleGraph& other) {}
+    PathHandleGraph(PathHandleGraph&& other) {}
+    PathHandleGraph& operator=(const PathHandleGraph& other) { return *this; }
+    PathHandleGraph& operator=(PathHandleGraph&& other) { return *this; }
+
     ////////////////////////////////////////////////////////////////////////////
     // Path handle interface that needs to be implemented
     ////////////////////////////////////////////////////////////////////////////
@@ -128,7 +140,7 @@ protected:
     /// If the graph contains compressed haplotype paths and properly
     /// implements for_each_path_of_sense to retrieve them, they should not be
     /// visible here. Only reference or generic named paths should be visible.
-    virtual bool for_each_path_handle_impl(const std::function<bool(const path_handle_t&)>& iteratee) const = 0;
+    virtual bool for_each_path_handle_impl(function_ref<bool(const path_handle_t&)> iteratee) const = 0;
     
     /// Execute a function on each step of a handle in any path. If it
     /// returns false, stop iteration. Returns true if we finished and false if
@@ -138,7 +150,7 @@ protected:
     /// implements for_each_step_of_sense to find them, they should not be
     /// visible here. Only reference or generic named paths should be visible.
     virtual bool for_each_step_on_handle_impl(const handle_t& handle,
-        const std::function<bool(const step_handle_t&)>& iteratee) const = 0;
+        function_ref<bool(const step_handle_t&)> iteratee) const = 0;
 
 public:
 
@@ -154,6 +166,72 @@ public:
     /// Returns true if the given path is empty, and false otherwise
     virtual bool is_empty(const path_handle_t& path_handle) const;
 
+    /// Fill the caller-provided array with up to buffer_size consecutive
+    /// steps of a path, starting with the given step, and also fill in the
+    /// steps' node handles if handles is not null. Stops after delivering
+    /// the path's last step (the step returned by path_back), even in a
+    /// circular path; delivering fewer than buffer_size steps therefore
+    /// means the iteration is done. Returns the number of steps delivered.
+    ///
+    /// The default implementation walks get_next_step and
+    /// get_handle_of_step; backends with contiguous step storage should
+    /// override it with a block copy so that iterating a path costs a
+    /// virtual call per buffer instead of per step.
+    virtual size_t get_steps_in_path(const path_handle_t& path_handle,
+                                     const step_handle_t& from,
+                                     step_handle_t* steps,
+                                     handle_t* handles,
+                                     size_t buffer_size) const;
+
+    /// Returns true if get_step_at is cheap (constant or near-constant
+    /// time), and false if it has to walk the path from the beginning.
+    /// Backends with indexed step storage should override both.
+    virtual bool has_step_random_access() const;
+
+    /// Get the step at the given index along a path, where index 0 is the
+    /// step returned by path_begin. The index must be less than
+    /// get_step_count for the path. The default implementation walks
+    /// forward from path_begin, so it costs O(index) unless overridden.
+    virtual step_handle_t get_step_at(const path_handle_t& path_handle, size_t index) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Interned path names
+    ////////////////////////////////////////////////////////////////////////////
+
+    // A graph's path names are a small fixed set, but get_path_name builds a
+    // fresh string on every call, so code that looks names up per step pays
+    // the allocator billions of times for the same few thousand names. These
+    // methods intern the names once so hot code can hold references and
+    // compare or hash names as ints. The interned view is valid until paths
+    // are created, destroyed, or renamed; mutable backends should call
+    // clear_interned_path_names() when that happens.
+
+    /// Like get_path_name, but returns a reference to a string that stays
+    /// valid, at a stable address, until the graph is destroyed or its paths
+    /// change. The default implementation interns the name in a cache inside
+    /// the graph on first use, thread-safely; backends that already store
+    /// their names as strings can override it to return the stored string
+    /// directly.
+    virtual const std::string& get_path_name_view(const path_handle_t& path_handle) const;
+
+    /// Return a dense integer ID for the path's name, in
+    /// [0, get_path_count()), stable until the graph's paths change. IDs are
+    /// assigned to all paths in iteration order the first time any ID is
+    /// requested.
+    virtual size_t get_path_name_id(const path_handle_t& path_handle) const;
+
+    /// Return the path whose name was interned with the given ID.
+    virtual path_handle_t get_path_handle_for_name_id(size_t name_id) const;
+
+protected:
+
+    /// Throw away all the interned names and IDs, so the next use re-interns
+    /// from the current paths. Mutable implementations must call this when
+    /// paths are created, destroyed, or renamed.
+    void clear_interned_path_names() const;
+
+public:
+
     ////////////////////////////////////////////////////////////////////////////
     // Concrete utility methods
     ////////////////////////////////////////////////////////////////////////////
@@ -170,6 +248,35 @@ public:
     /// true if we finished and false if we stopped early.
     template<typename Iteratee>
     bool for_each_step_in_path(const path_handle_t& path, const Iteratee& iteratee) const;
+
+    /// Loop over all the steps along a path, splitting it into contiguous
+    /// chunks that are processed across the given number of threads (0 means
+    /// use all available). The iteratee must be thread-safe, calls arrive in
+    /// no guaranteed order, and there is no early stopping. When the backend
+    /// has_step_random_access, the chunk boundaries are found by seeking;
+    /// otherwise a single cheap forward walk finds them first, which still
+    /// wins when the per-step work dominates. This is the tool for when one
+    /// huge path is most of the data and per-path parallelism leaves all but
+    /// one thread idle.
+    void for_each_step_in_path_parallel(const path_handle_t& path,
+                                        const std::function<void(const step_handle_t&)>& iteratee,
+                                        size_t thread_count = 0) const;
+
+private:
+
+    /// Fill in the interned ID tables from the current paths. The caller
+    /// must hold intern_mutex.
+    void build_name_ids() const;
+
+    /// Guards the interned path name structures below
+    mutable std::mutex intern_mutex;
+    /// Interned name of each path, at a stable address (the map is
+    /// node-based, so values don't move on rehash)
+    mutable std::unordered_map<uint64_t, std::string> interned_names;
+    /// The paths in interned-ID order, built all at once on first use
+    mutable std::vector<path_handle_t> paths_by_name_id;
+    /// The interned ID of each path
+    mutable std::unordered_map<uint64_t, size_t> name_ids;
 };
 
 ////////////////////////////////////////////////////////////////////////////
@@ -195,22 +302,30 @@ bool PathHandleGraph::for_each_step_in_path(const path_handle_t& path, const Ite
     // We break in the case that the path is empty
     if (get_step_count(path) == 0) return true;
     // Otherwise the path is nonempty so it is safe to try and grab a first step
-    
+
     // Get the value that the step should be in the final iteration
     auto end = path_back(path);
-    
-    // Allow the iteratee to set a bail-out condition
-    bool keep_going = true;
-    for (auto here = path_begin(path); keep_going; here = get_next_step(here)) {
-        // Execute the iteratee on this step
-        keep_going &= wrapped(here);
-        if (here == end) {
-            // Stop, but leave keep_going true so we return True because iteration completed.
-            break;
+
+    // Pull the steps in blocks, so that backends with contiguous step
+    // storage can deliver them without a virtual call per step
+    const size_t buffer_size = 1024;
+    step_handle_t buffer[buffer_size];
+    auto cursor = path_begin(path);
+    while (true) {
+        size_t num_steps = get_steps_in_path(path, cursor, buffer, nullptr, buffer_size);
+        for (size_t i = 0; i < num_steps; i++) {
+            // Execute the iteratee on this step, and allow it to set a
+            // bail-out condition
+            if (!wrapped(buffer[i])) {
+                return false;
+            }
         }
+        if (num_steps < buffer_size || buffer[num_steps - 1] == end) {
+            // The iteration completed
+            return true;
+        }
+        cursor = get_next_step(buffer[num_steps - 1]);
     }
-    
-    return keep_going;
 }
     
 /**
@@ -227,7 +342,15 @@ public:
 
     // Get the end iterator to the final position
     iterator end() const;
-    
+
+    // Get the number of steps in the path
+    size_t size() const;
+
+    // Get an iterator to the step at the given index, which must be less
+    // than size(). Seeking is only cheap if the backing graph
+    // has_step_random_access.
+    iterator at(size_t index) const;
+
     /**
      * Iterator object over path
      */
@@ -10,10 +10,25 @@
 #include <utility>
 #include <string>
 #include <regex>
+#include <mutex>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace handlegraph {
 
+/// All of a path's metadata in one record: what the path is meant to
+/// represent, and the sample, locus, haplotype, phase block, and bounds
+/// associated with it, with the unset fields holding the corresponding
+/// sentinels (PathMetadata::NO_SAMPLE_NAME and so on).
+struct path_metadata_t {
+    PathSense sense;
+    std::string sample;
+    std::string locus;
+    size_t haplotype;
+    size_t phase_block;
+    subrange_t subrange;
+};
+
 /**
  * This is the interface for embedded path and haplotype thread metadata.
  *
@@ -105,7 +120,16 @@ public:
     virtual subrange_t get_subrange(const path_handle_t& handle) const;
     static const subrange_t NO_SUBRANGE;
     static const offset_t NO_END_POSITION;
-    
+
+    /// Get all of a path's metadata in one record. The default
+    /// implementation parses the path name once and memoizes the result, so
+    /// repeated queries against the same path (from any of the accessors
+    /// above, which all go through here) don't re-parse the name; it
+    /// assumes that a path handle's name does not change over the life of
+    /// the object. Implementations that store their metadata in structured
+    /// form should override this to answer from storage.
+    virtual path_metadata_t get_path_metadata(const path_handle_t& handle) const;
+
     ////////////////////////////////////////////////////////////////////////////
     // Tools for converting back and forth with single-string path names
     ////////////////////////////////////////////////////////////////////////////
@@ -210,11 +234,11 @@ protected:
     virtual bool for_each_path_matching_impl(const std::unordered_set<PathSense>* senses,
                                              const std::unordered_set<std::string>* samples,
                                              const std::unordered_set<std::string>* loci,
-                                             const std::function<bool(const path_handle_t&)>& iteratee) const;
-    
+                                             function_ref<bool(const path_handle_t&)> iteratee) const;
+
     /// Loop through all steps on the given handle for paths with the given
     /// sense. Returns false and stops if the iteratee returns false.
-    virtual bool for_each_step_of_sense_impl(const handle_t& visited, const PathSense& sense, const std::function<bool(const step_handle_t&)>& iteratee) const;
+    virtual bool for_each_step_of_sense_impl(const handle_t& visited, const PathSense& sense, function_ref<bool(const step_handle_t&)> iteratee) const;
     
     ////////////////////////////////////////////////////////////////////////////
     // Backing methods that need to be implemented for default implementation
@@ -234,7 +258,7 @@ protected:
     /// If the graph contains compressed haplotype paths and properly
     /// implements for_each_path_of_sense to retrieve them, they should not be
     /// visible here. Only reference or generic named paths should be visible.
-    virtual bool for_each_path_handle_impl(const std::function<bool(const path_handle_t&)>& iteratee) const = 0;
+    virtual bool for_each_path_handle_impl(function_ref<bool(const path_handle_t&)> iteratee) const = 0;
     
     /// Execute a function on each step of a handle in any path. If it
     /// returns false, stop iteration. Returns true if we finished and false if
@@ -244,7 +268,7 @@ protected:
     /// implements for_each_step_of_sense to find them, they should not be
     /// visible here. Only reference or generic named paths should be visible.
     virtual bool for_each_step_on_handle_impl(const handle_t& handle,
-        const std::function<bool(const step_handle_t&)>& iteratee) const = 0;
+        function_ref<bool(const step_handle_t&)> iteratee) const = 0;
     
 private:
     
@@ -267,6 +291,11 @@ private:
     static const char RANGE_START_SEPARATOR;
     static const char RANGE_END_SEPARATOR;
     static const char RANGE_TERMINATOR;
+
+    /// Memoized name parses for the default get_path_metadata
+    mutable std::unordered_map<path_handle_t, path_metadata_t> metadata_cache;
+    /// Guards the cache, since metadata is queried from parallel loops
+    mutable std::mutex metadata_cache_mutex;
 };
 
 ////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,80 @@
+#ifndef HANDLEGRAPH_PATH_METADATA_INDEX_HPP_INCLUDED
+#define HANDLEGRAPH_PATH_METADATA_INDEX_HPP_INCLUDED
+
+/** \file
+ * Defines an index over path metadata for answering path queries by sense,
+ * sample, or locus without scanning every path.
+ */
+
+#include "handlegraph/path_handle_graph.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace handlegraph {
+
+/**
+ * An index from path metadata to paths: one hash bucket of paths per sense,
+ * per sample name, and per locus name, so queries like "all the paths of
+ * this sample" cost one bucket lookup instead of a scan that re-derives
+ * every path's metadata.
+ *
+ * Any PathMetadata implementer can expose the index by keeping one and
+ * overriding for_each_path_matching_impl to delegate to
+ * for_each_path_matching here, which shares that method's signature and
+ * semantics. Other code can hold one next to a graph it queries repeatedly.
+ *
+ * The index is a snapshot: if the graph's paths change, it must be rebuilt.
+ */
+class PathMetadataIndex {
+
+public:
+
+    /// Build the index over all of the given graph's paths, of every sense.
+    explicit PathMetadataIndex(const PathHandleGraph* graph);
+
+    PathMetadataIndex() = default;
+    ~PathMetadataIndex() = default;
+
+    /// Answer a for_each_path_matching query from the buckets: loop through
+    /// the indexed paths matching the given query, with query elements that
+    /// are null matching everything. Returns false and stops if the iteratee
+    /// returns false. The buckets for the most selective non-null query
+    /// element are enumerated and the other criteria checked against the
+    /// indexed metadata, so nothing is re-parsed and non-matching paths are
+    /// never visited when a sample or locus is given.
+    bool for_each_path_matching(const std::unordered_set<PathSense>* senses,
+                                const std::unordered_set<std::string>* samples,
+                                const std::unordered_set<std::string>* loci,
+                                const std::function<bool(const path_handle_t&)>& iteratee) const;
+
+    /// All the indexed paths with the given sense, in the order indexed.
+    const std::vector<path_handle_t>& paths_of_sense(const PathSense& sense) const;
+
+    /// All the indexed paths with the given sample name, in the order indexed.
+    const std::vector<path_handle_t>& paths_of_sample(const std::string& sample) const;
+
+    /// All the indexed paths with the given locus name, in the order indexed.
+    const std::vector<path_handle_t>& paths_of_locus(const std::string& locus) const;
+
+private:
+
+    /// every indexed path, in the order indexed
+    std::vector<path_handle_t> all_paths;
+    /// each indexed path's metadata, so filters don't go back to the graph
+    std::unordered_map<path_handle_t, path_metadata_t> metadata_of;
+    /// the paths of each sense
+    std::unordered_map<PathSense, std::vector<path_handle_t>> by_sense;
+    /// the paths of each sample name
+    std::unordered_map<std::string, std::vector<path_handle_t>> by_sample;
+    /// the paths of each locus name
+    std::unordered_map<std::string, std::vector<path_handle_t>> by_locus;
+
+    /// what we return when a bucket is empty
+    static const std::vector<path_handle_t> NO_PATHS;
+};
+
+}
+
+#endif
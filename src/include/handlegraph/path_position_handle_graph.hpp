@@ -49,8 +49,43 @@ public:
     /// iteration was stopped early, else true
     virtual bool for_each_step_position_on_handle(const handle_t& handle,
                                                   const std::function<bool(const step_handle_t&, const bool&, const size_t&)>& iteratee) const;
-    
-    
+
+    /// Look up the step at each of the given positions along a path, as
+    /// get_step_at_position would, filling the results vector in the order
+    /// of the queries. The default implementation answers the queries one at
+    /// a time, but backends with a positional index should override it for
+    /// sorted batches, which they can answer with a single index walk
+    /// instead of one top-down search per query. Callers should sort their
+    /// positions when they can.
+    virtual void get_steps_at_positions(const path_handle_t& path,
+                                        const std::vector<size_t>& positions,
+                                        std::vector<step_handle_t>& steps) const;
+
+    /// Look up the position of each of the given steps, as
+    /// get_position_of_step would, filling the results vector in the order
+    /// of the queries. The default implementation answers the queries one at
+    /// a time; backends should override it when they can answer a batch
+    /// against their index more cheaply.
+    virtual void get_positions_of_steps(const std::vector<step_handle_t>& steps,
+                                        std::vector<size_t>& positions) const;
+
+    /// Append the sequence of the path interval [start, end), measured in
+    /// bases along the path, to the given string. The end is clamped to the
+    /// path length. The default implementation makes one allocation up
+    /// front and walks the steps spanning the interval, instead of
+    /// concatenating per-node sequence strings.
+    virtual void get_path_sequence(const path_handle_t& path, size_t start, size_t end,
+                                   std::string& out) const;
+
+    /// Extract the sequence of each of the given [start, end) path
+    /// intervals, filling the results vector in the order of the queries.
+    /// The default implementation extracts the intervals one at a time;
+    /// backends with a positional index can override it to share one index
+    /// walk across sorted intervals.
+    virtual void get_path_sequences(const path_handle_t& path,
+                                    const std::vector<std::pair<size_t, size_t>>& intervals,
+                                    std::vector<std::string>& out) const;
+
 };
     
 
@@ -0,0 +1,172 @@
+#ifndef HANDLEGRAPH_PATH_POSITION_OVERLAY_HPP_INCLUDED
+#define HANDLEGRAPH_PATH_POSITION_OVERLAY_HPP_INCLUDED
+
+/** \file
+ * Defines an overlay that adds the PathPositionHandleGraph interface to any
+ * PathHandleGraph.
+ */
+
+#include "handlegraph/path_position_handle_graph.hpp"
+#include "handlegraph/serializable.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace handlegraph {
+
+/**
+ * An overlay that implements PathPositionHandleGraph on top of any
+ * PathHandleGraph by indexing a sample of each path's step positions.
+ *
+ * The index keeps one (step, position) pair out of every sample_rate steps
+ * of each path, so it costs a few words per sampled step rather than an
+ * entry per step. Positional queries binary search the samples and then
+ * walk at most sample_rate steps of the backing path, so they cost
+ * O(log n + sample_rate).
+ *
+ * Implements Serializable, so the index can be built once and cached
+ * between runs. A serialized index is only valid for the backing graph it
+ * was built from: the graph's step handles must come back identical, as
+ * they do when the same serialized graph file is reloaded.
+ *
+ * The backing graph must outlive the overlay, and its paths must not change
+ * while the overlay is in use.
+ */
+class PathPositionOverlay : public PathPositionHandleGraph, public Serializable {
+
+public:
+
+    /// Build the index over the given graph's paths, walking the paths
+    /// across the given number of threads (0 means hardware concurrency)
+    /// and keeping one sampled step out of every sample_rate.
+    PathPositionOverlay(const PathHandleGraph* graph, size_t sample_rate = 64,
+                        size_t thread_count = 0);
+
+    /// Load a previously serialized index over the given graph instead of
+    /// rebuilding it.
+    PathPositionOverlay(const PathHandleGraph* graph, std::istream& in);
+
+    PathPositionOverlay() = default;
+    ~PathPositionOverlay() = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // PathPositionHandleGraph interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    size_t get_path_length(const path_handle_t& path_handle) const;
+
+    size_t get_position_of_step(const step_handle_t& step) const;
+
+    step_handle_t get_step_at_position(const path_handle_t& path,
+                                       const size_t& position) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // HandleGraph interface, delegated to the backing graph
+    ////////////////////////////////////////////////////////////////////////////
+
+    bool has_node(nid_t node_id) const;
+    handle_t get_handle(const nid_t& node_id, bool is_reverse = false) const;
+    nid_t get_id(const handle_t& handle) const;
+    bool get_is_reverse(const handle_t& handle) const;
+    handle_t flip(const handle_t& handle) const;
+    size_t get_length(const handle_t& handle) const;
+    std::string get_sequence(const handle_t& handle) const;
+    size_t get_node_count() const;
+    nid_t min_node_id() const;
+    nid_t max_node_id() const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // PathHandleGraph interface, delegated to the backing graph
+    ////////////////////////////////////////////////////////////////////////////
+
+    size_t get_path_count() const;
+    bool has_path(const std::string& path_name) const;
+    path_handle_t get_path_handle(const std::string& path_name) const;
+    std::string get_path_name(const path_handle_t& path_handle) const;
+    bool get_is_circular(const path_handle_t& path_handle) const;
+    size_t get_step_count(const path_handle_t& path_handle) const;
+    handle_t get_handle_of_step(const step_handle_t& step_handle) const;
+    path_handle_t get_path_handle_of_step(const step_handle_t& step_handle) const;
+    step_handle_t path_begin(const path_handle_t& path_handle) const;
+    step_handle_t path_end(const path_handle_t& path_handle) const;
+    step_handle_t path_back(const path_handle_t& path_handle) const;
+    step_handle_t path_front_end(const path_handle_t& path_handle) const;
+    bool has_next_step(const step_handle_t& step_handle) const;
+    bool has_previous_step(const step_handle_t& step_handle) const;
+    step_handle_t get_next_step(const step_handle_t& step_handle) const;
+    step_handle_t get_previous_step(const step_handle_t& step_handle) const;
+    size_t get_steps_in_path(const path_handle_t& path_handle,
+                             const step_handle_t& from,
+                             step_handle_t* steps,
+                             handle_t* handles,
+                             size_t buffer_size) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // PathMetadata interface, delegated to the backing graph
+    ////////////////////////////////////////////////////////////////////////////
+
+    PathSense get_sense(const path_handle_t& handle) const;
+    std::string get_sample_name(const path_handle_t& handle) const;
+    std::string get_locus_name(const path_handle_t& handle) const;
+    size_t get_haplotype(const path_handle_t& handle) const;
+    size_t get_phase_block(const path_handle_t& handle) const;
+    subrange_t get_subrange(const path_handle_t& handle) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Serializable interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    uint32_t get_magic_number() const;
+
+protected:
+
+    void serialize_members(std::ostream& out) const;
+
+    void deserialize_members(std::istream& in);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Backing iteration methods, delegated to the backing graph
+    ////////////////////////////////////////////////////////////////////////////
+
+    bool follow_edges_impl(const handle_t& handle, bool go_left,
+                           function_ref<bool(const handle_t&)> iteratee) const;
+    bool for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee,
+                              bool parallel = false) const;
+    bool for_each_path_handle_impl(function_ref<bool(const path_handle_t&)> iteratee) const;
+    bool for_each_step_on_handle_impl(const handle_t& handle,
+                                      function_ref<bool(const step_handle_t&)> iteratee) const;
+    bool for_each_path_matching_impl(const std::unordered_set<PathSense>* senses,
+                                     const std::unordered_set<std::string>* samples,
+                                     const std::unordered_set<std::string>* loci,
+                                     function_ref<bool(const path_handle_t&)> iteratee) const;
+    bool for_each_step_of_sense_impl(const handle_t& visited, const PathSense& sense,
+                                     function_ref<bool(const step_handle_t&)> iteratee) const;
+
+private:
+
+    /// Walk the backing graph's paths and fill in the index.
+    void index_paths(size_t thread_count);
+
+    /// The sampled index of one path.
+    struct PathIndex {
+        /// the path's total length in bases
+        size_t path_length = 0;
+        /// the position of every sample_rate-th step, in step order
+        std::vector<size_t> sampled_positions;
+        /// the corresponding steps
+        std::vector<step_handle_t> sampled_steps;
+    };
+
+    /// the graph we're overlaying
+    const PathHandleGraph* graph = nullptr;
+    /// how many steps apart the samples are
+    size_t sample_rate = 64;
+    /// the per-path indexes
+    std::unordered_map<path_handle_t, PathIndex> indexes;
+    /// the position of every sampled step, for inverse lookups
+    std::unordered_map<step_handle_t, size_t> sampled_position;
+};
+
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef HANDLEGRAPH_PERMUTATION_HPP_INCLUDED
+#define HANDLEGRAPH_PERMUTATION_HPP_INCLUDED
+
+/** \file
+ * Defines helpers for applying orderings to rank-indexed storage in place.
+ */
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace handlegraph {
+
+/**
+ * Apply a permutation to rank-indexed storage in place by cycle chasing.
+ *
+ * new_rank[i] gives the rank that the item currently stored at rank i must
+ * move to, and must be a permutation of 0 to new_rank.size() - 1. The storage
+ * itself is moved through the given callback, which must exchange the items
+ * stored at the two given ranks; it is called O(n) times, once per item not
+ * already in place.
+ *
+ * Beyond the permutation vector itself, which is consumed (it is left as the
+ * identity), no additional memory is used, so backends can relayout their
+ * node tables for apply_ordering() without rebuilding them into a second
+ * copy of the graph.
+ */
+void apply_permutation(std::vector<size_t>& new_rank,
+                       const std::function<void(size_t, size_t)>& swap_ranks);
+
+/**
+ * Return the inverse of the given permutation: if permutation[i] is j, then
+ * the result's entry j is i. Useful for turning "the item that should end up
+ * at each rank", as apply_ordering() is given, into "the rank each item
+ * should end up at", as apply_permutation() consumes.
+ */
+std::vector<size_t> invert_permutation(const std::vector<size_t>& permutation);
+
+}
+
+#endif
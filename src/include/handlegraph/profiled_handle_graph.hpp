@@ -0,0 +1,207 @@
+#ifndef HANDLEGRAPH_PROFILED_HANDLE_GRAPH_HPP_INCLUDED
+#define HANDLEGRAPH_PROFILED_HANDLE_GRAPH_HPP_INCLUDED
+
+/** \file
+ * Defines a profiling wrapper that counts and times interface calls against
+ * a backing graph.
+ */
+
+#include "handlegraph/mutable_path_deletable_handle_graph.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace handlegraph {
+
+/**
+ * A pass-through wrapper that counts every interface call it forwards to a
+ * backing graph, along with the cumulative wall-clock time spent in it, so
+ * that when an algorithm is slow on some backend you can see exactly which
+ * primitives it hammers instead of guessing.
+ *
+ * Wrap any HandleGraph; the path and mutation methods work when the backing
+ * graph implements the corresponding interfaces, and throw if it does not.
+ * Each forwarded call costs one extra virtual dispatch plus two clock reads
+ * and two relaxed counter updates. Counters are striped by thread over
+ * padded, separately-aligned blocks, so concurrent readers don't fight over
+ * cachelines.
+ *
+ * For the iteration methods (follow_edges, for_each_handle, and friends) the
+ * recorded time includes the time spent in the caller's iteratee. Times for
+ * the composite defaults a backing graph doesn't override (for_each_edge,
+ * get_degree fallbacks, and so on) show up under the primitives they are
+ * built from.
+ */
+class ProfiledHandleGraph : public MutablePathDeletableHandleGraph {
+
+public:
+
+    /// Wrap the given graph. The wrapper keeps a pointer; the backing graph
+    /// must outlive it.
+    explicit ProfiledHandleGraph(HandleGraph* graph);
+
+    ~ProfiledHandleGraph() = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Profiling interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    /// Write a report to the given stream: one tab-separated line per method
+    /// that was called, with its call count, cumulative nanoseconds, and mean
+    /// nanoseconds per call, summed over all threads.
+    void report(std::ostream& out = std::cerr) const;
+
+    /// Zero all the counters.
+    void reset();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // HandleGraph interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    bool has_node(nid_t node_id) const;
+    handle_t get_handle(const nid_t& node_id, bool is_reverse = false) const;
+    nid_t get_id(const handle_t& handle) const;
+    bool get_is_reverse(const handle_t& handle) const;
+    handle_t flip(const handle_t& handle) const;
+    size_t get_length(const handle_t& handle) const;
+    std::string get_sequence(const handle_t& handle) const;
+    size_t get_node_count() const;
+    nid_t min_node_id() const;
+    nid_t max_node_id() const;
+    size_t get_degree(const handle_t& handle, bool go_left) const;
+    size_t get_edge_count() const;
+    size_t get_total_length() const;
+    char get_base(const handle_t& handle, size_t index) const;
+    std::string get_subsequence(const handle_t& handle, size_t index, size_t size) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // PathHandleGraph interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    size_t get_path_count() const;
+    bool has_path(const std::string& path_name) const;
+    path_handle_t get_path_handle(const std::string& path_name) const;
+    std::string get_path_name(const path_handle_t& path_handle) const;
+    bool get_is_circular(const path_handle_t& path_handle) const;
+    size_t get_step_count(const path_handle_t& path_handle) const;
+    handle_t get_handle_of_step(const step_handle_t& step_handle) const;
+    path_handle_t get_path_handle_of_step(const step_handle_t& step_handle) const;
+    step_handle_t path_begin(const path_handle_t& path_handle) const;
+    step_handle_t path_end(const path_handle_t& path_handle) const;
+    step_handle_t path_back(const path_handle_t& path_handle) const;
+    step_handle_t path_front_end(const path_handle_t& path_handle) const;
+    bool has_next_step(const step_handle_t& step_handle) const;
+    bool has_previous_step(const step_handle_t& step_handle) const;
+    step_handle_t get_next_step(const step_handle_t& step_handle) const;
+    step_handle_t get_previous_step(const step_handle_t& step_handle) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // MutableHandleGraph interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    handle_t create_handle(const std::string& sequence);
+    handle_t create_handle(const std::string& sequence, const nid_t& id);
+    using MutableHandleGraph::create_handle;
+    void create_edge(const handle_t& left, const handle_t& right);
+    using MutableHandleGraph::create_edge;
+    handle_t apply_orientation(const handle_t& handle);
+    std::vector<handle_t> divide_handle(const handle_t& handle, const std::vector<size_t>& offsets);
+    using MutableHandleGraph::divide_handle;
+    void optimize(bool allow_id_reassignment = true);
+    bool apply_ordering(const std::vector<handle_t>& order, bool compact_ids = false);
+    void set_id_increment(const nid_t& min_id);
+    void reassign_node_ids(const std::function<nid_t(const nid_t&)>& get_new_id);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // DeletableHandleGraph interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    void destroy_handle(const handle_t& handle);
+    void destroy_edge(const handle_t& left, const handle_t& right);
+    using DeletableHandleGraph::destroy_edge;
+    void clear();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // MutablePathHandleGraph interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    void destroy_path(const path_handle_t& path_handle);
+    path_handle_t create_path_handle(const std::string& name, bool is_circular = false);
+    using MutablePathHandleGraph::create_path_handle;
+    step_handle_t append_step(const path_handle_t& path, const handle_t& to_append);
+    step_handle_t prepend_step(const path_handle_t& path, const handle_t& to_prepend);
+    std::pair<step_handle_t, step_handle_t> rewrite_segment(const step_handle_t& segment_begin,
+                                                            const step_handle_t& segment_end,
+                                                            const std::vector<handle_t>& new_segment);
+    void set_circularity(const path_handle_t& path, bool circular);
+
+protected:
+
+    bool follow_edges_impl(const handle_t& handle, bool go_left,
+                           function_ref<bool(const handle_t&)> iteratee) const;
+    bool for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee,
+                              bool parallel = false) const;
+    bool for_each_path_handle_impl(function_ref<bool(const path_handle_t&)> iteratee) const;
+    bool for_each_step_on_handle_impl(const handle_t& handle,
+                                      function_ref<bool(const step_handle_t&)> iteratee) const;
+
+private:
+
+    /// Everything we count, one entry per profiled method
+    enum Method : size_t {
+        HAS_NODE, GET_HANDLE, GET_ID, GET_IS_REVERSE, FLIP, GET_LENGTH,
+        GET_SEQUENCE, GET_NODE_COUNT, MIN_NODE_ID, MAX_NODE_ID, GET_DEGREE,
+        GET_EDGE_COUNT, GET_TOTAL_LENGTH, GET_BASE, GET_SUBSEQUENCE,
+        FOLLOW_EDGES, FOR_EACH_HANDLE,
+        GET_PATH_COUNT, HAS_PATH, GET_PATH_HANDLE, GET_PATH_NAME,
+        GET_IS_CIRCULAR, GET_STEP_COUNT, GET_HANDLE_OF_STEP,
+        GET_PATH_HANDLE_OF_STEP, PATH_BEGIN, PATH_END, PATH_BACK,
+        PATH_FRONT_END, HAS_NEXT_STEP, HAS_PREVIOUS_STEP, GET_NEXT_STEP,
+        GET_PREVIOUS_STEP, FOR_EACH_PATH_HANDLE, FOR_EACH_STEP_ON_HANDLE,
+        CREATE_HANDLE, CREATE_EDGE, APPLY_ORIENTATION, DIVIDE_HANDLE,
+        OPTIMIZE, APPLY_ORDERING, SET_ID_INCREMENT, REASSIGN_NODE_IDS,
+        DESTROY_HANDLE, DESTROY_EDGE, CLEAR,
+        DESTROY_PATH, CREATE_PATH_HANDLE, APPEND_STEP, PREPEND_STEP,
+        REWRITE_SEGMENT, SET_CIRCULARITY,
+        NUM_METHODS
+    };
+
+    /// How many counter stripes threads are hashed over. Must be a power of 2.
+    static const size_t COUNTER_STRIPES = 64;
+
+    /// One stripe of counters, padded so consecutive stripes' hot counters
+    /// can't land on the same cacheline. Updates are relaxed; totals are
+    /// exact, and a stripe is only ever shared by threads whose IDs hash
+    /// together.
+    struct CounterStripe {
+        std::atomic<uint64_t> calls[NUM_METHODS];
+        std::atomic<uint64_t> total_ns[NUM_METHODS];
+        char padding[128];
+    };
+
+    /// Scope guard that attributes the enclosing call, and its wall-clock
+    /// time, to one method in the calling thread's stripe.
+    class Record;
+
+    /// the stripe the calling thread's counts land in
+    CounterStripe& stripe_for_thread() const;
+
+    /// the backing graph
+    HandleGraph* backing = nullptr;
+    /// the backing graph's other interfaces, where implemented
+    PathHandleGraph* backing_paths = nullptr;
+    MutableHandleGraph* backing_mutable = nullptr;
+    DeletableHandleGraph* backing_deletable = nullptr;
+    MutablePathHandleGraph* backing_mutable_paths = nullptr;
+
+    /// the counters, indexed by thread hash stripe and then method
+    std::unique_ptr<CounterStripe[]> stripes;
+};
+
+}
+
+#endif
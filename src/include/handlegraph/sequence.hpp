@@ -0,0 +1,38 @@
+#ifndef HANDLEGRAPH_SEQUENCE_HPP_INCLUDED
+#define HANDLEGRAPH_SEQUENCE_HPP_INCLUDED
+
+/** \file sequence.hpp
+ * Defines shared utilities for nucleotide sequences.
+ */
+
+#include <cstddef>
+#include <string>
+
+namespace handlegraph {
+
+/// The complement of each character, as a flat lookup table indexed by the
+/// character's unsigned value. IUPAC ambiguity codes are complemented and
+/// case is preserved; any other character maps to itself.
+extern const char complement_table[256];
+
+/// Complement one nucleotide.
+inline char complement(char base) {
+    return complement_table[(unsigned char) base];
+}
+
+/// Reverse complement length bases from src into dst, which must not
+/// overlap src. The kernel is a single pass through a flat lookup table, so
+/// compilers can unroll it; it is meant to be shared by anything that
+/// flips node sequences rather than each algorithm complementing
+/// byte-by-byte on its own.
+void reverse_complement(const char* src, char* dst, size_t length);
+
+/// Reverse complement a sequence into a new string.
+std::string reverse_complement(const std::string& sequence);
+
+/// Reverse complement a sequence in place.
+void reverse_complement_in_place(std::string& sequence);
+
+}
+
+#endif
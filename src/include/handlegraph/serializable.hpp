@@ -3,11 +3,14 @@
 
 #include <cstdint>
 
-/** \file 
- * Defines an interface for objects that are saveable and loadable. 
+/** \file
+ * Defines an interface for objects that are saveable and loadable.
  */
 
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace handlegraph {
 
@@ -78,7 +81,42 @@ public:
     /// Write the contents of this object to a named file. Makes sure to include
     /// a leading magic number.
     virtual void serialize(const std::string& filename);
-        
+
+    ////////////////////////////////////////
+    // Compressed container support
+    ////////////////////////////////////////
+
+    /// Write the contents of this object to an ostream inside the framed-chunk
+    /// compressed container. The output leads with the container's own magic
+    /// number; the object's magic number and members follow, compressed in
+    /// independent chunks. deserialize() detects the container magic and
+    /// decompresses transparently, so no separate loading call is needed.
+    void serialize_compressed(std::ostream& out) const;
+    /// Write the contents of this object to a named file inside the
+    /// framed-chunk compressed container.
+    void serialize_compressed(const std::string& filename) const;
+
+    ////////////////////////////////////////
+    // Memory usage introspection
+    ////////////////////////////////////////
+
+    /// Report approximately how many bytes of memory this object occupies,
+    /// broken down by named component (for a graph, typically things like
+    /// "sequences", "topology", "paths", and "indexes"). Meant for capacity
+    /// planning before loading something big on a shared machine, so
+    /// estimates should err high rather than low. The helpers in
+    /// memory_usage.hpp size common containers for implementers. The default
+    /// implementation reports nothing.
+    virtual std::vector<std::pair<std::string, size_t>> memory_usage() const;
+
+    /// Report the total across all components of memory_usage().
+    size_t total_memory_usage() const;
+
+    /// Estimate how many bytes serialize() would write, without writing
+    /// anything. The default implementation guesses the serialized form is
+    /// about the size of the object in memory.
+    virtual size_t serialized_size_estimate() const;
+
 };
 
 }
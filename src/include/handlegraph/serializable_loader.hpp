@@ -0,0 +1,48 @@
+#ifndef HANDLEGRAPH_SERIALIZABLE_LOADER_HPP_INCLUDED
+#define HANDLEGRAPH_SERIALIZABLE_LOADER_HPP_INCLUDED
+
+/** \file
+ * Defines a registry of Serializable implementations by magic number, and a
+ * polymorphic open() built on it.
+ */
+
+#include "handlegraph/serializable.hpp"
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace handlegraph {
+
+/// A factory that makes an empty instance of some Serializable implementation,
+/// ready to deserialize into.
+using SerializableFactory = std::function<std::unique_ptr<Serializable>()>;
+
+/// Register a factory for the implementation whose serialized form leads with
+/// the given magic number. Registering the same magic number again replaces
+/// the factory. Thread-safe.
+void register_loader(uint32_t magic_number, SerializableFactory factory);
+
+/// Register a default-constructible Serializable implementation under its own
+/// magic number. Call once per type, at startup or from a static initializer.
+template<typename Implementation>
+void register_loader() {
+    Implementation probe;
+    register_loader(probe.get_magic_number(), []() {
+        return std::unique_ptr<Serializable>(new Implementation());
+    });
+}
+
+/// Sniff the leading magic number of the given file, construct the registered
+/// implementation for it, and load the file into it. Loading goes through the
+/// implementation's own deserialize(filename), so TriviallySerializable types
+/// take their file descriptor fast path instead of streaming. Files in the
+/// framed-chunk compressed container are recognized and sniffed inside the
+/// container. Throws
+/// std::runtime_error if the file can't be read or its magic number has no
+/// registered loader.
+std::unique_ptr<Serializable> open(const std::string& filename);
+
+}
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef HANDLEGRAPH_SHARDED_SERIALIZABLE_HPP_INCLUDED
+#define HANDLEGRAPH_SHARDED_SERIALIZABLE_HPP_INCLUDED
+
+/** \file
+ * Defines an interface for objects whose serialized form splits into
+ * independently written and loaded shards.
+ */
+
+#include "handlegraph/serializable.hpp"
+
+#include <iostream>
+#include <string>
+
+namespace handlegraph {
+
+/**
+ * Interface for objects that can serialize as a set of independent shards,
+ * so saving and loading can use every core instead of streaming through one.
+ *
+ * Implementations describe their serialized form as numbered shards (for a
+ * graph, typically one major member array per shard, or fixed slices of it)
+ * with exactly known sizes. The interface computes each shard's offset and,
+ * on the file descriptor paths, writes the shards concurrently with pwrite
+ * at distinct offsets and loads them concurrently with pread.
+ *
+ * The ordinary stream serialize()/deserialize() inherited from Serializable
+ * keep working and produce byte-identical files: the shard table and the
+ * shards in order. A file written sharded in parallel can be read back
+ * streaming, and vice versa.
+ */
+class ShardedSerializable : public Serializable {
+
+public:
+
+    virtual ~ShardedSerializable() = default;
+
+    ////////////////////////////////////////
+    // These methods should be implemented
+    ////////////////////////////////////////
+
+protected:
+
+    /// Return how many shards the object's serialized form splits into.
+    /// Must not change while a save or load is in progress.
+    virtual size_t get_shard_count() const = 0;
+
+    /// Return exactly how many bytes serialize_shard() will write for the
+    /// given shard.
+    virtual size_t get_shard_size(size_t shard) const = 0;
+
+    /// Write the given shard's bytes to the given stream. Must write exactly
+    /// get_shard_size(shard) bytes. May be called for different shards
+    /// concurrently.
+    virtual void serialize_shard(size_t shard, std::ostream& out) const = 0;
+
+    /// Set the given shard's contents from the given stream, which holds
+    /// exactly the bytes that serialize_shard() wrote for it. May be called
+    /// for different shards concurrently. Can only be called on an empty
+    /// object.
+    virtual void deserialize_shard(size_t shard, std::istream& in) = 0;
+
+public:
+
+    ////////////////////////////////////////
+    // These methods are provided
+    ////////////////////////////////////////
+
+    /// Write the contents of this object to an open file descriptor, writing
+    /// the shards concurrently at their offsets across the given number of
+    /// threads (0 means hardware concurrency). Makes sure to include a
+    /// leading magic number. Assumes the file entirely belongs to this
+    /// object.
+    void serialize_sharded(int fd, size_t thread_count = 0) const;
+
+    /// Write the contents of this object to a named file, writing the shards
+    /// concurrently across the given number of threads (0 means hardware
+    /// concurrency).
+    void serialize_sharded(const std::string& filename, size_t thread_count = 0) const;
+
+    /// Set the contents of this object from an open file descriptor, loading
+    /// the shards concurrently across the given number of threads (0 means
+    /// hardware concurrency). The serialized object must be from the same
+    /// implementation of this interface as is calling deserialize_sharded().
+    /// Can only be called on an empty object.
+    void deserialize_sharded(int fd, size_t thread_count = 0);
+
+    /// Set the contents of this object from a named file, loading the shards
+    /// concurrently across the given number of threads (0 means hardware
+    /// concurrency). Can only be called on an empty object.
+    void deserialize_sharded(const std::string& filename, size_t thread_count = 0);
+
+    /// The shard sizes are declared exactly, so this is not an estimate: it
+    /// is the exact size of the file either serialization path writes.
+    virtual size_t serialized_size_estimate() const;
+
+protected:
+
+    /// Stream plumbing from Serializable, implemented over the shards so the
+    /// stream and file descriptor paths produce the same bytes.
+    virtual void serialize_members(std::ostream& out) const;
+    virtual void deserialize_members(std::istream& in);
+};
+
+}
+
+#endif
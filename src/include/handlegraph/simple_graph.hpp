@@ -0,0 +1,357 @@
+#ifndef HANDLEGRAPH_SIMPLE_GRAPH_HPP_INCLUDED
+#define HANDLEGRAPH_SIMPLE_GRAPH_HPP_INCLUDED
+
+/** \file
+ * Defines an in-library concrete implementation of the full mutable path
+ * handle graph interface stack.
+ */
+
+#include "handlegraph/mutable_path_deletable_handle_graph.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace handlegraph {
+
+/**
+ * A compact, self-contained implementation of MutablePathDeletableHandleGraph,
+ * so that consumers of the interfaces have a concrete graph without pulling
+ * in a heavyweight backend: a correctness oracle to compare implementations
+ * against, and a fast default target for algorithms (like split_strands or
+ * dagify) that need somewhere to build a graph.
+ *
+ * Node sequences are 2-bit packed when they are plain ACGT (with a per-node
+ * fallback for other characters), adjacencies are per-node edge vectors that
+ * optimize() can compact, and paths are doubly-linked step lists in a shared
+ * arena, so appending steps never moves existing ones and step handles stay
+ * valid under the operations that promise it.
+ *
+ * Not thread-safe for writes, like every mutable interface; concurrent reads
+ * are fine.
+ */
+class SimpleGraph : public MutablePathDeletableHandleGraph {
+
+public:
+
+    SimpleGraph() = default;
+    ~SimpleGraph() = default;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // HandleGraph interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    /// Method to check if a node exists by ID
+    bool has_node(nid_t node_id) const;
+
+    /// Look up the handle for the node with the given ID in the given orientation
+    handle_t get_handle(const nid_t& node_id, bool is_reverse = false) const;
+
+    /// Get the ID from a handle
+    nid_t get_id(const handle_t& handle) const;
+
+    /// Get the orientation of a handle
+    bool get_is_reverse(const handle_t& handle) const;
+
+    /// Invert the orientation of a handle (potentially without getting its ID)
+    handle_t flip(const handle_t& handle) const;
+
+    /// Get the length of a node
+    size_t get_length(const handle_t& handle) const;
+
+    /// Get the sequence of a node, presented in the handle's local forward
+    /// orientation.
+    std::string get_sequence(const handle_t& handle) const;
+
+    /// Return the number of nodes in the graph
+    size_t get_node_count() const;
+
+    /// Return the smallest ID in the graph, or some smaller number if the
+    /// smallest ID is unavailable. Return value is unspecified if the graph is empty.
+    nid_t min_node_id() const;
+
+    /// Return the largest ID in the graph, or some larger number if the
+    /// largest ID is unavailable. Return value is unspecified if the graph is empty.
+    nid_t max_node_id() const;
+
+    /// Get the number of edges on one side of a handle without iteration.
+    size_t get_degree(const handle_t& handle, bool go_left) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // MutableHandleGraph interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    // Keep the base class's packed-sequence overloads visible
+    using MutableHandleGraph::create_handle;
+
+    /// Create a new node with the given sequence and return the handle.
+    handle_t create_handle(const std::string& sequence);
+
+    /// Create a new node with the given id and sequence, then return the handle.
+    handle_t create_handle(const std::string& sequence, const nid_t& id);
+
+    /// Create an edge connecting the given handles in the given order and
+    /// orientations. Ignores existing edges.
+    void create_edge(const handle_t& left, const handle_t& right);
+    using MutableHandleGraph::create_edge;
+
+    /// Alter the node that the given handle corresponds to so the orientation
+    /// indicated by the handle becomes the node's local forward orientation.
+    handle_t apply_orientation(const handle_t& handle);
+
+    /// Split a handle's underlying node at the given offsets in the handle's
+    /// orientation. Updates stored paths.
+    std::vector<handle_t> divide_handle(const handle_t& handle, const std::vector<size_t>& offsets);
+    using MutableHandleGraph::divide_handle;
+
+    /// Compact away the storage of deleted nodes, steps, and paths,
+    /// optionally renumbering the node IDs to 1..n in iteration order.
+    void optimize(bool allow_id_reassignment = true);
+
+    /// Like optimize(), but report whether any storage actually moved or any
+    /// IDs actually changed.
+    optimize_report_t optimize_with_report(bool allow_id_reassignment = true);
+
+    /// Reorder the graph's internal structure to match that given, in place:
+    /// the node records are permuted within the existing table by cycle
+    /// chasing, so no second copy of the graph is built.
+    bool apply_ordering(const std::vector<handle_t>& order, bool compact_ids = false);
+
+    /// Hint that subsequently created node IDs should start at the given ID.
+    void set_id_increment(const nid_t& min_id);
+
+    /// Renumber all node IDs by the given function, which must be injective
+    /// on the graph's IDs.
+    void reassign_node_ids(const std::function<nid_t(const nid_t&)>& get_new_id);
+
+    /// Preallocate for this many nodes, edges, and total bases.
+    void reserve(size_t nodes, size_t edges, size_t total_bp);
+
+    ////////////////////////////////////////////////////////////////////////////
+    // DeletableHandleGraph interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    /// Remove the node belonging to the given handle and all of its edges.
+    /// Undefined behavior if the node is on a path.
+    void destroy_handle(const handle_t& handle);
+
+    /// Remove the edge connecting the given handles in the given order and
+    /// orientations.
+    void destroy_edge(const handle_t& left, const handle_t& right);
+    using DeletableHandleGraph::destroy_edge;
+
+    /// Remove all nodes, edges, and paths.
+    void clear();
+
+    ////////////////////////////////////////////////////////////////////////////
+    // PathHandleGraph interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    /// Returns the number of paths stored in the graph
+    size_t get_path_count() const;
+
+    /// Determine if a path name exists and is legal to get a path handle for.
+    bool has_path(const std::string& path_name) const;
+
+    /// Look up the path handle for the given path name.
+    path_handle_t get_path_handle(const std::string& path_name) const;
+
+    /// Look up the name of a path from a handle to it
+    std::string get_path_name(const path_handle_t& path_handle) const;
+
+    /// Look up whether a path is circular
+    bool get_is_circular(const path_handle_t& path_handle) const;
+
+    /// Returns the number of node steps in the path
+    size_t get_step_count(const path_handle_t& path_handle) const;
+
+    /// Get a node handle (node ID and orientation) from a handle to a step on a path
+    handle_t get_handle_of_step(const step_handle_t& step_handle) const;
+
+    /// Returns a handle to the path that a step is on
+    path_handle_t get_path_handle_of_step(const step_handle_t& step_handle) const;
+
+    /// Get a handle to the first step, which will be an arbitrary step in a circular path
+    /// that we consider "first" based on our construction of the path. If the path is empty,
+    /// then the implementation must return the same value as path_end().
+    step_handle_t path_begin(const path_handle_t& path_handle) const;
+
+    /// Get a handle to a fictitious position past the end of a path. This position is
+    /// returned by get_next_step for the final step in a path in a non-circular path.
+    step_handle_t path_end(const path_handle_t& path_handle) const;
+
+    /// Get a handle to the last step, which will be an arbitrary step in a circular path that
+    /// we consider "last" based on our construction of the path. If the path is empty
+    /// then the implementation must return the same value as path_front_end().
+    step_handle_t path_back(const path_handle_t& path_handle) const;
+
+    /// Get a handle to a fictitious position before the beginning of a path. This position is
+    /// return by get_previous_step for the first step in a path in a non-circular path.
+    step_handle_t path_front_end(const path_handle_t& path_handle) const;
+
+    /// Returns true if the step is not the last step in a non-circular path.
+    bool has_next_step(const step_handle_t& step_handle) const;
+
+    /// Returns true if the step is not the first step in a non-circular path.
+    bool has_previous_step(const step_handle_t& step_handle) const;
+
+    /// Returns a handle to the next step on the path.
+    step_handle_t get_next_step(const step_handle_t& step_handle) const;
+
+    /// Returns a handle to the previous step on the path
+    step_handle_t get_previous_step(const step_handle_t& step_handle) const;
+
+    ////////////////////////////////////////////////////////////////////////////
+    // MutablePathHandleGraph interface
+    ////////////////////////////////////////////////////////////////////////////
+
+    /// Destroy the given path. Invalidates handles to the path and its steps.
+    void destroy_path(const path_handle_t& path_handle);
+
+    /// Create a path with the given name.
+    path_handle_t create_path_handle(const std::string& name, bool is_circular = false);
+    using MutablePathHandleGraph::create_path_handle;
+
+    /// Append a visit to a node to the given path.
+    step_handle_t append_step(const path_handle_t& path, const handle_t& to_append);
+
+    /// Prepend a visit to a node to the given path.
+    step_handle_t prepend_step(const path_handle_t& path, const handle_t& to_prepend);
+
+    /// Delete a segment of a path and rewrite it as some other sequence of steps.
+    std::pair<step_handle_t, step_handle_t> rewrite_segment(const step_handle_t& segment_begin,
+                                                            const step_handle_t& segment_end,
+                                                            const std::vector<handle_t>& new_segment);
+
+    /// Make a path circular or non-circular.
+    void set_circularity(const path_handle_t& path, bool circular);
+
+protected:
+
+    ////////////////////////////////////////////////////////////////////////////
+    // Backing iteration methods
+    ////////////////////////////////////////////////////////////////////////////
+
+    bool follow_edges_impl(const handle_t& handle, bool go_left,
+                           function_ref<bool(const handle_t&)> iteratee) const;
+    bool for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee,
+                              bool parallel = false) const;
+    bool for_each_path_handle_impl(function_ref<bool(const path_handle_t&)> iteratee) const;
+    bool for_each_step_on_handle_impl(const handle_t& handle,
+                                      function_ref<bool(const step_handle_t&)> iteratee) const;
+
+private:
+
+    /// One node: its sequence (2-bit packed when possible), its edges, and
+    /// the steps that visit it.
+    struct Node {
+        /// 2-bit base codes, 4 per byte, when the sequence is plain ACGT
+        std::vector<uint8_t> packed;
+        /// the sequence verbatim, when it is not packable
+        std::string overflow;
+        /// length of the sequence in bases
+        uint64_t length = 0;
+        /// whether the sequence lives in packed (true) or overflow (false)
+        bool packable = true;
+        /// whether the node exists (false for tombstones awaiting optimize())
+        bool alive = false;
+        /// the node's ID
+        nid_t id = 0;
+        /// successors of the node's reverse orientation
+        std::vector<handle_t> left_edges;
+        /// successors of the node's forward orientation
+        std::vector<handle_t> right_edges;
+        /// arena slots of the path steps that visit this node
+        std::vector<size_t> step_slots;
+    };
+
+    /// One path step in the shared arena, as a doubly-linked list entry.
+    /// Slots of destroyed steps go on a free list for reuse.
+    struct Step {
+        /// the oriented node the step visits
+        handle_t handle;
+        /// the path the step is on, or -1 for a free slot
+        int64_t path = -1;
+        /// arena slot of the previous step on the path, or -1
+        int64_t prev = -1;
+        /// arena slot of the next step on the path, or -1
+        int64_t next = -1;
+    };
+
+    /// One embedded path: its name, its endpoints in the step arena, and its flags.
+    struct Path {
+        std::string name;
+        bool is_circular = false;
+        /// whether the path exists (false for tombstones, whose indexes are reused)
+        bool alive = false;
+        int64_t head = -1;
+        int64_t tail = -1;
+        size_t step_count = 0;
+    };
+
+    /// the index of the node a handle refers to
+    size_t index_of(const handle_t& handle) const;
+
+    /// the successor list of the given handle: right_edges for forward
+    /// handles, left_edges for reverse ones
+    std::vector<handle_t>& successors_of(const handle_t& handle);
+    const std::vector<handle_t>& successors_of(const handle_t& handle) const;
+
+    /// add a node with the given sequence and ID and return its index
+    size_t add_node(const std::string& sequence, const nid_t& id);
+
+    /// store a sequence into a node, packing it if possible
+    void store_sequence(Node& node, const std::string& sequence);
+
+    /// renumber the node IDs to 1..n in storage order
+    void renumber_ids_dense();
+
+    /// take an arena slot for a new step of the given path at the given node
+    size_t new_step_slot(int64_t path_index, const handle_t& handle);
+
+    /// detach a step's slot from its node and put it on the free list
+    void free_step_slot(size_t slot);
+
+    /// reindex the nodes: new_index maps each old node index to its new one,
+    /// or SIZE_MAX to drop a tombstone. Rewrites every stored handle and
+    /// permutes the node table in place, consuming the map as scratch space.
+    void reindex_nodes(std::vector<size_t> new_index);
+
+    /// make a step handle for the given path index and arena slot (or sentinel)
+    static step_handle_t make_step(int64_t path_index, int64_t slot);
+
+    /// sentinel slot for path_end
+    static const int64_t END_SLOT = -1;
+    /// sentinel slot for path_front_end
+    static const int64_t FRONT_END_SLOT = -2;
+
+    /// the nodes, including tombstones
+    std::vector<Node> nodes;
+    /// where each node ID lives in nodes
+    std::unordered_map<nid_t, size_t> id_to_index;
+    /// the shared step arena
+    std::vector<Step> steps;
+    /// arena slots free for reuse
+    std::vector<size_t> free_step_slots;
+    /// the paths, including tombstones
+    std::vector<Path> paths;
+    /// path indexes free for reuse
+    std::vector<size_t> free_path_indexes;
+    /// where each path name lives in paths
+    std::unordered_map<std::string, size_t> name_to_path;
+    /// how many nodes are alive
+    size_t live_node_count = 0;
+    /// how many paths are alive
+    size_t live_path_count = 0;
+    /// the next ID to assign automatically
+    nid_t next_id = 1;
+    /// lower bound on the IDs in the graph
+    nid_t lowest_id = 0;
+    /// upper bound on the IDs in the graph
+    nid_t highest_id = 0;
+};
+
+}
+
+#endif
@@ -11,7 +11,10 @@
 
 #include "handlegraph/iteratee.hpp"
 
+#include <array>
 #include <functional>
+#include <unordered_map>
+#include <vector>
 
 namespace handlegraph {
 
@@ -153,11 +156,42 @@ public:
      * Return the kind of location at which the given traversal starts.
      */
     virtual endpoint_t starts_at(const net_handle_t& traversal) const = 0;
-    
+
     /**
      * Return the kind of location at which the given traversal ends.
      */
     virtual endpoint_t ends_at(const net_handle_t& traversal) const = 0;
+
+    /**
+     * The kind of net graph item a net handle refers to. The root snarl
+     * reports ROOT rather than SNARL.
+     */
+    enum net_type_t {
+        ROOT,
+        SNARL,
+        CHAIN,
+        NODE,
+        SENTINEL
+    };
+
+    /**
+     * Everything hot loops usually ask about a net handle, decoded in one
+     * call: what it is and where its traversal starts and ends. The start
+     * and end fields are unspecified for sentinels.
+     */
+    struct net_traits_t {
+        net_type_t type;
+        endpoint_t start;
+        endpoint_t end;
+    };
+
+    /**
+     * Decode the given net handle in one call instead of one virtual call
+     * per question. The default implementation asks the individual type and
+     * endpoint methods; implementations with packed handles should override
+     * it to decode the handle once.
+     */
+    virtual net_traits_t get_net_traits(const net_handle_t& net) const;
     
     /**
      * Loop over the child snarls and nodes of a chain, or the child chains of
@@ -231,6 +265,17 @@ public:
     // but ought to be overridden for efficiency.
     ///////////////////////////////////////////////////////////
    
+    /**
+     * Append all the children of the given snarl or chain to the given
+     * vector, in one call, in the same order and orientation for_each_child
+     * would produce them. The vector is not cleared first, so the caller can
+     * accumulate into it; callers that reuse one vector across many parents
+     * avoid per-child dispatch overhead. The default implementation loops
+     * over for_each_child, but implementations with contiguous child storage
+     * can override it with a bulk copy.
+     */
+    virtual void get_children(const net_handle_t& parent, std::vector<net_handle_t>& out) const;
+
     /**
      * Execute a function on each realizable traversal of a child of the given
      * snarl or chain that begins with an internal tip. Traversals that end
@@ -357,6 +402,59 @@ public:
 
 };
 
+/**
+ * A memo for the bound handles of snarls and chains in a SnarlDecomposition.
+ *
+ * get_bound() can be expensive to recompute in some implementations, and
+ * consumers that walk the decomposition ask for the same bounds over and
+ * over. This caches each snarl's or chain's four possible bounds (start/end,
+ * facing in/out) the first time they are asked for, keyed on the canonical
+ * handle so all traversals of the same snarl or chain share one entry.
+ * get_bound() ignores traversal type, so this is safe.
+ *
+ * Not synchronized; give each thread its own cache. The decomposition must
+ * outlive the cache and not change under it.
+ */
+class SnarlBoundCache {
+
+public:
+
+    /// Make a cache over the given decomposition.
+    SnarlBoundCache(const SnarlDecomposition& snarls);
+
+    /// Like SnarlDecomposition::get_bound(), but computed at most once per
+    /// snarl or chain per bound.
+    net_handle_t get_bound(const net_handle_t& parent, bool get_end, bool face_in);
+
+    /// Cached version of SnarlDecomposition::get_start_bound().
+    inline net_handle_t get_start_bound(const net_handle_t& parent) {
+        return get_bound(parent, false, true);
+    }
+
+    /// Cached version of SnarlDecomposition::get_end_bound().
+    inline net_handle_t get_end_bound(const net_handle_t& parent) {
+        return get_bound(parent, true, false);
+    }
+
+    /// Drop everything cached so far.
+    void clear();
+
+private:
+
+    /// The decomposition we memoize
+    const SnarlDecomposition& snarls;
+
+    /// The four bounds of one snarl or chain, with a bit per slot saying
+    /// whether it has been computed yet.
+    struct Entry {
+        std::array<net_handle_t, 4> bounds;
+        unsigned char filled = 0;
+    };
+
+    /// The computed bounds by canonical handle
+    std::unordered_map<net_handle_t, Entry> cache;
+};
+
 
 ////////////////////////////////////////////////////////////////////////////
 // Template Implementations
@@ -0,0 +1,107 @@
+#ifndef HANDLEGRAPH_STEP_POSITION_INDEX_HPP_INCLUDED
+#define HANDLEGRAPH_STEP_POSITION_INDEX_HPP_INCLUDED
+
+/** \file
+ * Defines an index from nodes to the path positions that overlap them.
+ */
+
+#include "handlegraph/path_handle_graph.hpp"
+#include "handlegraph/serializable.hpp"
+
+#include <vector>
+
+namespace handlegraph {
+
+/**
+ * An index answering the inverse of the positional queries: for a node, all
+ * of the (path, offset) pairs that overlap it. The default
+ * for_each_step_position_on_handle has to re-derive each step's position;
+ * this index computes every position once, in one parallel pass over all
+ * the paths, and stores them as runs sorted by path and then by position
+ * under each node, so a query costs one binary search over the node IDs
+ * plus the hits.
+ *
+ * The index is Serializable, so it can be built once per graph release and
+ * loaded thereafter. Paths are recorded by name, not by handle, so a
+ * deserialized index must be pointed back at its graph with attach()
+ * before answering queries. Step handles are deliberately not retained:
+ * they would not survive serialization, and the positions are the point.
+ *
+ * The index is a snapshot: if the graph's paths change, it must be rebuilt.
+ */
+class StepPositionIndex : public Serializable {
+
+public:
+
+    /// Build the index over all of the given graph's paths, walking the
+    /// paths across the given number of threads (0 means hardware
+    /// concurrency). Positions are measured in bases of sequence from the
+    /// start of each path, as get_position_of_step measures them.
+    explicit StepPositionIndex(const PathHandleGraph* graph, size_t thread_count = 0);
+
+    /// Make an empty index, to deserialize into.
+    StepPositionIndex() = default;
+
+    /// Point a deserialized index back at the graph it was built from,
+    /// re-resolving the indexed path names to path handles. Throws if any
+    /// indexed path is missing from the graph.
+    void attach(const PathHandleGraph* graph);
+
+    /// Loop through every path visit overlapping the node of the given
+    /// handle, in order by path and then by position along the path. The
+    /// iteratee gets the path, the position of the visit's start, and
+    /// whether the path traverses the node in reverse. Returns false and
+    /// stops if the iteratee returns false.
+    bool for_each_step_position_on_handle(const handle_t& handle,
+                                          const std::function<bool(const path_handle_t&, const size_t&, const bool&)>& iteratee) const;
+
+    /// As above, but restricted to visits by the given path, found by
+    /// binary search within the node's run.
+    bool for_each_step_position_of_path_on_handle(const handle_t& handle, const path_handle_t& path,
+                                                  const std::function<bool(const size_t&, const bool&)>& iteratee) const;
+
+    /// How many path visits overlap the node of the given handle.
+    size_t get_visit_count(const handle_t& handle) const;
+
+    uint32_t get_magic_number() const;
+
+protected:
+
+    void serialize_members(std::ostream& out) const;
+    void deserialize_members(std::istream& in);
+
+private:
+
+    /// one path's visit to a node
+    struct Visit {
+        /// index of the visiting path in path_names
+        uint64_t path_index;
+        /// position of the visit's start along the path
+        uint64_t position;
+        /// does the path traverse the node in reverse?
+        bool is_reverse;
+    };
+
+    /// the dense rank of a node ID in node_ids; throws if it isn't indexed
+    size_t rank_of(const nid_t& node_id) const;
+
+    /// complain if no graph is attached
+    void check_attached() const;
+
+    /// the graph we answer queries about; not owned and not serialized
+    const PathHandleGraph* graph = nullptr;
+    /// all the graph's node IDs, sorted, defining the rank space
+    std::vector<nid_t> node_ids;
+    /// the names of the indexed paths, in indexing order
+    std::vector<std::string> path_names;
+    /// the handle of each indexed path; resolved by attach(), not serialized
+    std::vector<path_handle_t> path_handles;
+    /// where each node's run of visits starts in visits, plus the total
+    std::vector<uint64_t> first_visit;
+    /// every visit, grouped by node rank and sorted by (path, position)
+    std::vector<Visit> visits;
+};
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef HANDLEGRAPH_STREAMING_GRAPH_BUILDER_HPP_INCLUDED
+#define HANDLEGRAPH_STREAMING_GRAPH_BUILDER_HPP_INCLUDED
+
+/** \file
+ * Defines a bounded-memory accumulator for streaming graph construction.
+ */
+
+#include "handlegraph/mutable_path_mutable_handle_graph.hpp"
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace handlegraph {
+
+/**
+ * An accumulator for building a graph from a stream of records without
+ * holding the stream in memory: nodes, edges, and path steps can be added
+ * in any order, are buffered up to a byte budget, and are spilled to
+ * temporary files as sorted runs when the budget fills. build() replays
+ * everything in sorted order (nodes by ID, then edges, then each path's
+ * steps by rank) by an external merge of the runs, feeding the
+ * destination through the bulk construction methods in batches, so peak
+ * memory is the byte budget plus whatever the destination itself needs,
+ * not the size of the input.
+ *
+ * An import that overflows RAM as a mutable graph can therefore stream
+ * through a builder into a compact destination backend directly, instead
+ * of being assembled in memory first and serialized after.
+ *
+ * The builder is single-use and not thread-safe: add everything, call
+ * build() once, and destroy it. Temporary files go to the given scratch
+ * directory (TMPDIR or /tmp when empty) and are removed by build() or
+ * the destructor.
+ */
+class StreamingGraphBuilder {
+
+public:
+
+    /// Make a builder that buffers up to about buffer_bytes of records per
+    /// record kind before spilling a sorted run to the scratch directory.
+    StreamingGraphBuilder(const std::string& scratch_dir = "",
+                          size_t buffer_bytes = 64 * 1024 * 1024);
+
+    /// Clean up any spilled runs that build() didn't consume.
+    ~StreamingGraphBuilder();
+
+    // The spilled run state can't meaningfully be duplicated.
+    StreamingGraphBuilder(const StreamingGraphBuilder& other) = delete;
+    StreamingGraphBuilder& operator=(const StreamingGraphBuilder& other) = delete;
+
+    /// Add a node with the given ID and sequence.
+    void add_node(const nid_t& node_id, const std::string& sequence);
+
+    /// Add an edge between the given oriented nodes.
+    void add_edge(const nid_t& from_id, bool from_is_reverse,
+                  const nid_t& to_id, bool to_is_reverse);
+
+    /// Declare a path, optionally circular. Paths that only appear in
+    /// add_step calls are created non-circular.
+    void add_path(const std::string& path_name, bool is_circular = false);
+
+    /// Add a visit of the given path to the given oriented node, at the
+    /// given rank along the path. Ranks must be unique per path but may
+    /// arrive in any order; the steps are appended in rank order.
+    void add_step(const std::string& path_name, size_t rank,
+                  const nid_t& node_id, bool is_reverse);
+
+    /// Merge everything accumulated into the given empty graph: nodes in
+    /// ID order, then edges, then the paths with their steps in rank
+    /// order. May only be called once.
+    void build(MutablePathMutableHandleGraph* into);
+
+    /// Same, but for a destination without paths; throws if any paths or
+    /// steps were added.
+    void build(MutableHandleGraph* into);
+
+private:
+
+    struct NodeRecord;
+    struct EdgeRecord;
+    struct StepRecord;
+
+    /// sort and write the given records out as one run file, and forget them
+    template<typename Record>
+    void spill(std::vector<Record>& buffer, std::vector<std::string>& runs);
+
+    /// merge the buffer and the spilled runs, calling the handler on each
+    /// record in sorted order
+    template<typename Record>
+    void merge(std::vector<Record>& buffer, std::vector<std::string>& runs,
+               const std::function<void(const Record&)>& handle_record);
+
+    /// replay the nodes and then the edges into the destination
+    void build_topology(MutableHandleGraph* into);
+
+    /// the dense index of a path name, making it known if it is new
+    size_t path_index(const std::string& path_name);
+
+    /// complain if build() already ran
+    void check_not_built() const;
+
+    /// where the run files go
+    std::string scratch_dir;
+    /// how many buffered bytes a record kind may hold before spilling
+    size_t buffer_bytes;
+    /// has build() run?
+    bool built = false;
+
+    /// the known paths' names, in declaration order
+    std::vector<std::string> path_names;
+    /// each known path's circularity flag
+    std::vector<bool> path_is_circular;
+    /// the dense index of each known path name
+    std::unordered_map<std::string, size_t> path_index_by_name;
+
+    /// the buffered records of each kind, unsorted
+    std::vector<NodeRecord> node_buffer;
+    std::vector<EdgeRecord> edge_buffer;
+    std::vector<StepRecord> step_buffer;
+    /// approximate bytes held by each buffer
+    size_t node_bytes = 0;
+    size_t edge_bytes = 0;
+    size_t step_bytes = 0;
+    /// the spilled runs of each kind, as file names
+    std::vector<std::string> node_runs;
+    std::vector<std::string> edge_runs;
+    std::vector<std::string> step_runs;
+};
+
+}
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef HANDLEGRAPH_SUBGRAPH_VIEW_HPP_INCLUDED
+#define HANDLEGRAPH_SUBGRAPH_VIEW_HPP_INCLUDED
+
+/** \file
+ * Defines a zero-copy filtered view of a backing HandleGraph.
+ */
+
+#include "handlegraph/expanding_overlay_graph.hpp"
+
+#include <functional>
+#include <unordered_set>
+
+namespace handlegraph {
+
+/**
+ * A read-only view of the subgraph induced by a set of a backing graph's
+ * nodes, without copying anything: edges to nodes outside the membership
+ * are filtered out of follow_edges on the fly, and handles are the backing
+ * graph's own handles, so answering a query costs only the backing graph's
+ * queries it forwards. Extracting a region this way costs proportional to
+ * the queries made against it, not to the region's size, unlike copying
+ * the region into a fresh mutable graph.
+ *
+ * Membership can be given as an explicit node set, which answers has_node
+ * in O(1), or as a predicate over node IDs, which defers entirely to the
+ * predicate; a predicate-backed view can be given an O(1) membership set
+ * later with materialize_membership(). Whole-graph queries
+ * (for_each_handle, get_node_count, min/max ID) always cost a scan of the
+ * backing graph, since the view doesn't know its contents any other way.
+ *
+ * The backing graph must outlive the view and must not lose member nodes
+ * while the view is in use; the predicate must be pure and thread-safe.
+ */
+class SubgraphView : public ExpandingOverlayGraph {
+
+public:
+
+    /// Make a view of the subgraph induced by the nodes the given predicate
+    /// accepts. The predicate is consulted on every query until
+    /// materialize_membership() is called.
+    SubgraphView(const HandleGraph* super, const std::function<bool(const nid_t&)>& membership);
+
+    /// Make a view of the subgraph induced by the given nodes. IDs not in
+    /// the backing graph are ignored.
+    SubgraphView(const HandleGraph* super, const std::unordered_set<nid_t>& node_ids);
+
+    /// Replace a membership predicate with an explicit set, by one scan of
+    /// the backing graph, so has_node becomes O(1) and later whole-graph
+    /// queries stop re-running the predicate. No effect if the membership
+    /// is already a set.
+    void materialize_membership();
+
+    //////////////////////////
+    /// HandleGraph interface
+    //////////////////////////
+
+    /// Method to check if a node exists by ID
+    bool has_node(nid_t node_id) const;
+
+    /// Look up the handle for the node with the given ID in the given orientation
+    handle_t get_handle(const nid_t& node_id, bool is_reverse = false) const;
+
+    /// Get the ID from a handle
+    nid_t get_id(const handle_t& handle) const;
+
+    /// Get the orientation of a handle
+    bool get_is_reverse(const handle_t& handle) const;
+
+    /// Invert the orientation of a handle (potentially without getting its ID)
+    handle_t flip(const handle_t& handle) const;
+
+    /// Get the length of a node
+    size_t get_length(const handle_t& handle) const;
+
+    /// Get the sequence of a node, presented in the handle's local forward
+    /// orientation.
+    std::string get_sequence(const handle_t& handle) const;
+
+    /// Loop over all the handles to next/previous (right/left) nodes. Passes
+    /// them to a callback which returns false to stop iterating and true to
+    /// continue. Returns true if we finished and false if we stopped early.
+    bool follow_edges_impl(const handle_t& handle, bool go_left,
+                           function_ref<bool(const handle_t&)> iteratee) const;
+
+    /// Loop over all the nodes in the graph in their local forward
+    /// orientations, in their internal stored order. Stop if the iteratee
+    /// returns false. Can be told to run in parallel, in which case stopping
+    /// after a false return value is on a best-effort basis and iteration
+    /// order is not defined.
+    bool for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee,
+                              bool parallel = false) const;
+
+    /// Return the number of nodes in the graph
+    size_t get_node_count() const;
+
+    /// Return the smallest ID in the graph, or some smaller number if the
+    /// smallest ID is unavailable. Return value is unspecified if the graph is empty.
+    nid_t min_node_id() const;
+
+    /// Return the largest ID in the graph, or some larger number if the
+    /// largest ID is unavailable. Return value is unspecified if the graph is empty.
+    nid_t max_node_id() const;
+
+    ///////////////////////////////////
+    /// ExpandingOverlayGraph interface
+    ///////////////////////////////////
+
+    /// Returns the handle in the underlying graph that corresponds to a
+    /// handle in the overlay, which is the same handle.
+    handle_t get_underlying_handle(const handle_t& handle) const;
+
+private:
+
+    /// Is the node with the given ID a member of the view?
+    bool contains(const nid_t& node_id) const;
+
+    /// the graph we are a view of
+    const HandleGraph* super = nullptr;
+    /// the membership predicate, when membership isn't materialized
+    std::function<bool(const nid_t&)> membership;
+    /// the membership set, when it is
+    std::unordered_set<nid_t> member_ids;
+    /// do we have the set, or just the predicate?
+    bool materialized = false;
+};
+
+}
+
+#endif
@@ -10,6 +10,9 @@
 #include <iostream>
 #include <limits>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
 
 namespace handlegraph {
 
@@ -48,8 +51,73 @@ public:
      * from, if any. Future modifications to the object will not affect the
      * file, although future modifications to the file may still affect the
      * object.
-     */ 
+     */
     virtual void dissociate() = 0;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Page residency control
+    //
+    // A freshly memory-mapped object is backed by the file, so the first
+    // full scan pays a page fault per page and can be several times slower
+    // than later ones. These methods let callers control residency instead
+    // of warming the cache by hand. They all work on whatever mapping
+    // get_mapping() reports, and quietly do nothing for implementations
+    // that don't report one.
+    ///////////////////////////////////////////////////////////////////////////
+
+    /// Ask the kernel to asynchronously page in the whole backing mapping,
+    /// so a following scan faults as little as possible.
+    void prefetch() const;
+
+    /// Ask the kernel to asynchronously page in the given byte range of the
+    /// backing mapping. The range is widened to page boundaries.
+    void prefetch(size_t offset, size_t length) const;
+
+    /// Tell the kernel the backing mapping will be read front to back, so it
+    /// can read ahead aggressively.
+    void advise_sequential() const;
+
+    /// Tell the kernel the backing mapping will be accessed randomly, so it
+    /// doesn't waste IO on readahead.
+    void advise_random() const;
+
+    /// Ask the kernel to back the mapping with transparent huge pages where
+    /// supported, cutting TLB pressure on big objects. Returns false if the
+    /// platform or mapping can't honor the request. Best asked before the
+    /// pages are touched.
+    bool request_hugepages() const;
+
+    /// Return how many bytes of the backing mapping are currently resident
+    /// in memory, or 0 if there is no mapping or the platform can't say.
+    size_t residency() const;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Dirty region tracking
+    //
+    // With a write-back file association, a save after a small edit
+    // shouldn't have to sync the whole mapping. Implementations (or callers
+    // who know what they touched) record modified ranges with mark_dirty(),
+    // and flush_changes() syncs just those pages instead of everything.
+    ///////////////////////////////////////////////////////////////////////////
+
+    /// Record that the given byte range of the object's serialized
+    /// representation has been modified. The range is widened to page
+    /// boundaries and coalesced with ranges already recorded.
+    void mark_dirty(size_t offset, size_t length);
+
+    /// Sync only the recorded dirty ranges of the backing mapping out to the
+    /// associated file, and forget them. If block is false, just schedule the
+    /// writeback instead of waiting for it. Does nothing beyond forgetting
+    /// the ranges if there is no mapping.
+    void flush_changes(bool block = true);
+
+    /// Report the backing mapping as the object's memory usage, when there is
+    /// one. Implementations that know their internal layout should override
+    /// this with a finer breakdown.
+    virtual std::vector<std::pair<std::string, size_t>> memory_usage() const;
+
+    /// The mapping is the serialized form, so its size is an exact estimate.
+    virtual size_t serialized_size_estimate() const;
     
     // New TriviallySerializable feature: IO to file descriptors
     // If you want to do this with a normal Serializable, you will need a
@@ -132,11 +200,41 @@ public:
 
 protected:
 
+    /// Report the start and length of the object's current backing memory
+    /// mapping, so the residency control methods have something to work on.
+    /// Implementations that memory-map their data should override this;
+    /// the default reports no mapping, which makes all the residency
+    /// control methods harmless no-ops.
+    virtual std::pair<const void*, size_t> get_mapping() const;
+
+    /// Forget all recorded dirty ranges without syncing them. Implementations
+    /// should call this when they load or drop a mapping.
+    void clear_dirty();
+
+    /// Helper for implementing a cheap dissociate(): replace the shared
+    /// write-back mapping of the given file region at the given address with
+    /// a private copy-on-write view of the same pages, so only pages modified
+    /// afterwards ever get copied. Changes already made through the shared
+    /// mapping are in the file and stay visible. Also forgets any recorded
+    /// dirty ranges, since there is nothing to write back anymore. Returns
+    /// false if the kernel refuses the remap.
+    bool remap_copy_on_write(void* start, size_t length, int fd, size_t offset = 0);
+
     /// Helper to open a file descriptor with error checking.
     int open_fd(const std::string& filename) const;
-    
+
     /// Helper to close a file descriptor with error checking.
     void close_fd(int fd) const;
+
+private:
+
+    /// Protects dirty_ranges, so threads editing different parts of the
+    /// object can record what they touched concurrently.
+    std::mutex dirty_mutex;
+
+    /// Page-rounded modified ranges of the serialized representation, as
+    /// start offset to past-end offset, kept coalesced and non-overlapping.
+    std::map<size_t, size_t> dirty_ranges;
 };
 
 
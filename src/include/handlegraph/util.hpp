@@ -8,6 +8,7 @@
 #include "handlegraph/types.hpp"
 
 #include <cassert>
+#include <cstddef>
 
 namespace handlegraph {
 
@@ -65,6 +66,59 @@ struct number_bool_packing {
     inline static handle_t toggle_bit(const handle_t& handle) {
         return as_handle(as_integer(handle) ^ 1);
     }
+
+    ////////////////////////////////////////////////////////////////////////
+    // Bulk kernels over whole arrays of handles. Code that materializes
+    // large handle vectors (orderings, component lists) and then converts
+    // them element-wise in iterating loops defeats vectorization; these
+    // plain passes over the integer views compile to straight-line SIMD.
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Extract the packed integers of count handles into numbers.
+    inline static void unpack_numbers(const handle_t* handles, size_t count, uint64_t* numbers) {
+        const uint64_t* in = reinterpret_cast<const uint64_t*>(handles);
+        for (size_t i = 0; i < count; i++) {
+            numbers[i] = in[i] >> 1;
+        }
+    }
+
+    /// Extract the packed bits of count handles into bits, one byte each.
+    inline static void unpack_bits(const handle_t* handles, size_t count, unsigned char* bits) {
+        const uint64_t* in = reinterpret_cast<const uint64_t*>(handles);
+        for (size_t i = 0; i < count; i++) {
+            bits[i] = in[i] & 1;
+        }
+    }
+
+    /// Pack count parallel integers and byte-wide bits into handles. Unlike
+    /// pack(), does not check that the numbers leave the bit free, so they
+    /// must fit in 63 bits.
+    inline static void pack_all(const uint64_t* numbers, const unsigned char* bits, size_t count,
+                                handle_t* handles) {
+        uint64_t* out = reinterpret_cast<uint64_t*>(handles);
+        for (size_t i = 0; i < count; i++) {
+            out[i] = (numbers[i] << 1) | (bits[i] & 1);
+        }
+    }
+
+    /// Toggle the packed bit of count handles in place.
+    inline static void toggle_bits(handle_t* handles, size_t count) {
+        uint64_t* in_place = reinterpret_cast<uint64_t*>(handles);
+        for (size_t i = 0; i < count; i++) {
+            in_place[i] ^= 1;
+        }
+    }
+
+    /// Replace the packed integer of each of count handles with its entry in
+    /// the given translation table, keeping the packed bit. This is the
+    /// inner loop of reordering and renumbering passes.
+    inline static void substitute_numbers(handle_t* handles, size_t count,
+                                          const size_t* new_numbers) {
+        uint64_t* in_place = reinterpret_cast<uint64_t*>(handles);
+        for (size_t i = 0; i < count; i++) {
+            in_place[i] = ((uint64_t) new_numbers[in_place[i] >> 1] << 1) | (in_place[i] & 1);
+        }
+    }
 };
 
 //
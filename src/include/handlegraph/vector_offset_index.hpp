@@ -0,0 +1,81 @@
+#ifndef HANDLEGRAPH_VECTOR_OFFSET_INDEX_HPP_INCLUDED
+#define HANDLEGRAPH_VECTOR_OFFSET_INDEX_HPP_INCLUDED
+
+/** \file
+ * Defines a component that answers VectorizableHandleGraph's offset queries
+ * for any backing graph.
+ */
+
+#include "handlegraph/handle_graph.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace handlegraph {
+
+/**
+ * The rank/offset machinery behind VectorizableHandleGraph, as a reusable
+ * component: a prefix-sum array over the node lengths in rank order, with a
+ * sampled block index that narrows each offset-to-node query to the few
+ * nodes overlapping one block of the sequence vector. Implementers can
+ * build one (the node lengths are read across threads) and delegate
+ * node_vector_offset and node_at_vector_offset to it instead of rolling
+ * their own.
+ *
+ * Nodes are taken in RankedHandleGraph rank order when the backing graph
+ * provides ranks, and in ID-sorted order otherwise. Offsets are 0-based.
+ * The backing graph must not change while the index is in use.
+ */
+class VectorOffsetIndex {
+
+public:
+
+    /// Build the index over the given graph, reading the node lengths
+    /// across the given number of threads (0 means hardware concurrency).
+    explicit VectorOffsetIndex(const HandleGraph* graph, size_t thread_count = 0);
+
+    VectorOffsetIndex() = default;
+    ~VectorOffsetIndex() = default;
+
+    /// Return the start position of the node in the sorted array
+    /// constructed from the concatenation of the node sequences.
+    size_t node_vector_offset(const nid_t& node_id) const;
+
+    /// Return the node overlapping the given offset in the implicit node
+    /// vector. The offset must be less than the total sequence length.
+    nid_t node_at_vector_offset(const size_t& offset) const;
+
+    /// Answer a whole ascending stream of offset queries with one walk
+    /// along the index, filling the results vector in the order of the
+    /// queries. Out-of-order offsets are still answered correctly, at the
+    /// cost of one fresh lookup each.
+    void nodes_at_vector_offsets(const std::vector<size_t>& offsets,
+                                 std::vector<nid_t>& nodes) const;
+
+    /// Return the total length of the indexed sequence.
+    size_t total_length() const;
+
+private:
+
+    /// the dense index of the node containing the given offset
+    size_t index_at_offset(const size_t& offset) const;
+
+    /// the dense index of a node ID
+    size_t index_of(const nid_t& node_id) const;
+
+    /// the backing graph, if it can provide node ranks
+    const RankedHandleGraph* ranked = nullptr;
+    /// the node ID at each dense index
+    std::vector<nid_t> index_to_id;
+    /// the offset at which each node starts, plus the total length
+    std::vector<uint64_t> prefix;
+    /// the dense index of the node containing each block's first offset
+    std::vector<size_t> block_first_index;
+
+    /// how many bases each block of the sampled index covers
+    static const size_t BLOCK_SIZE = 4096;
+};
+
+}
+
+#endif
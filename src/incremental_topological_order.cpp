@@ -0,0 +1,227 @@
+#include "handlegraph/algorithms/incremental_topological_order.hpp"
+
+#include <algorithm>
+
+/** \file incremental_topological_order.cpp
+ * Implements the incremental topological order structure.
+ */
+
+namespace handlegraph {
+namespace algorithms {
+
+using namespace std;
+
+IncrementalTopologicalOrder::IncrementalTopologicalOrder(const HandleGraph* graph) : graph(graph) {
+
+    // get an initial order with Kahn's algorithm over both orientations of
+    // every node
+    unordered_map<handle_t, int64_t> in_degree;
+    in_degree.reserve(2 * graph->get_node_count());
+    vector<handle_t> stack;
+    graph->for_each_handle([&](const handle_t& handle) {
+        for (const handle_t& traversal : {handle, graph->flip(handle)}) {
+            int64_t degree = graph->get_degree(traversal, true);
+            in_degree[traversal] = degree;
+            if (degree == 0) {
+                stack.push_back(traversal);
+            }
+        }
+    });
+
+    position.reserve(in_degree.size());
+    while (!stack.empty()) {
+        handle_t here = stack.back();
+        stack.pop_back();
+
+        position[here] = next_position++;
+
+        graph->follow_edges(here, false, [&](const handle_t& next) {
+            if (--in_degree[next] == 0) {
+                stack.push_back(next);
+            }
+        });
+    }
+
+    // if anything was left unordered, the graph has a directed cycle
+    is_valid = (position.size() == in_degree.size());
+}
+
+bool IncrementalTopologicalOrder::valid() const {
+    return is_valid;
+}
+
+bool IncrementalTopologicalOrder::can_reach(const handle_t& from, const handle_t& to,
+                                            int64_t ceiling) {
+
+    if (from == to) {
+        return true;
+    }
+
+    // DFS rightward, never past the ceiling position; since the order is
+    // topological, anything that could reach `to` lies at or below it
+    unordered_set<handle_t> visited{from};
+    vector<handle_t> stack(1, from);
+    bool found = false;
+    while (!stack.empty() && !found) {
+        handle_t here = stack.back();
+        stack.pop_back();
+
+        graph->follow_edges(here, false, [&](const handle_t& next) {
+            if (next == to) {
+                found = true;
+                return false;
+            }
+            if (position.at(next) <= ceiling && visited.insert(next).second) {
+                stack.push_back(next);
+            }
+            return true;
+        });
+    }
+    return found;
+}
+
+bool IncrementalTopologicalOrder::would_create_cycle(const handle_t& left, const handle_t& right) {
+
+    if (!is_valid) {
+        // no order is being maintained, so we can't certify anything
+        return true;
+    }
+
+    // the new edge would support the arc left -> right and its mirror
+    // flip(right) -> flip(left)
+
+    // a cycle through just one of the arcs needs a path right ->* left (the
+    // mirror arc's condition is the mirror image of the same paths)
+    if (position.at(right) <= position.at(left) &&
+        can_reach(right, left, position.at(left))) {
+        return true;
+    }
+
+    // a cycle through both arcs needs a strand-crossing path from right to
+    // its own flip and one from left's flip back to left
+    handle_t left_flip = graph->flip(left);
+    handle_t right_flip = graph->flip(right);
+    if (position.at(right) <= position.at(right_flip) &&
+        position.at(left_flip) <= position.at(left) &&
+        can_reach(right, right_flip, position.at(right_flip)) &&
+        can_reach(left_flip, left, position.at(left))) {
+        return true;
+    }
+
+    return false;
+}
+
+bool IncrementalTopologicalOrder::insert_arc(const handle_t& from, const handle_t& to) {
+
+    int64_t lower = position.at(to);
+    int64_t upper = position.at(from);
+    if (lower > upper) {
+        // the order already agrees with this arc
+        return true;
+    }
+
+    // the region that must move right: everything reachable from `to` at or
+    // below `from`'s position; reaching `from` itself means the arc closed a
+    // directed cycle
+    vector<handle_t> forward;
+    {
+        unordered_set<handle_t> visited{to};
+        vector<handle_t> stack(1, to);
+        while (!stack.empty()) {
+            handle_t here = stack.back();
+            stack.pop_back();
+
+            if (here == from) {
+                return false;
+            }
+            forward.push_back(here);
+
+            graph->follow_edges(here, false, [&](const handle_t& next) {
+                if (position.at(next) <= upper && visited.insert(next).second) {
+                    stack.push_back(next);
+                }
+            });
+        }
+    }
+
+    // the region that must move left: everything that reaches `from` at or
+    // above `to`'s position
+    vector<handle_t> backward;
+    {
+        unordered_set<handle_t> visited{from};
+        vector<handle_t> stack(1, from);
+        while (!stack.empty()) {
+            handle_t here = stack.back();
+            stack.pop_back();
+
+            backward.push_back(here);
+
+            graph->follow_edges(here, true, [&](const handle_t& prev) {
+                if (position.at(prev) >= lower && visited.insert(prev).second) {
+                    stack.push_back(prev);
+                }
+            });
+        }
+    }
+
+    // splice the two regions into the union of their old positions, keeping
+    // each region's internal order but putting the backward region wholly
+    // before the forward region
+    auto position_less = [&](const handle_t& a, const handle_t& b) {
+        return position.at(a) < position.at(b);
+    };
+    sort(forward.begin(), forward.end(), position_less);
+    sort(backward.begin(), backward.end(), position_less);
+
+    vector<int64_t> slots;
+    slots.reserve(forward.size() + backward.size());
+    for (const handle_t& handle : backward) {
+        slots.push_back(position.at(handle));
+    }
+    for (const handle_t& handle : forward) {
+        slots.push_back(position.at(handle));
+    }
+    sort(slots.begin(), slots.end());
+
+    size_t slot = 0;
+    for (const handle_t& handle : backward) {
+        position[handle] = slots[slot++];
+    }
+    for (const handle_t& handle : forward) {
+        position[handle] = slots[slot++];
+    }
+
+    return true;
+}
+
+bool IncrementalTopologicalOrder::created_edge(const handle_t& left, const handle_t& right) {
+
+    if (!is_valid) {
+        return false;
+    }
+
+    if (!insert_arc(left, right)) {
+        return false;
+    }
+
+    // also repair for the mirror arc, unless the edge is its own mirror
+    handle_t mirror_from = graph->flip(right);
+    handle_t mirror_to = graph->flip(left);
+    if (mirror_from != left || mirror_to != right) {
+        return insert_arc(mirror_from, mirror_to);
+    }
+    return true;
+}
+
+void IncrementalTopologicalOrder::created_handle(const handle_t& handle) {
+    // an edgeless node can go anywhere; put both its traversals at the end
+    position[handle] = next_position++;
+    position[graph->flip(handle)] = next_position++;
+}
+
+void IncrementalTopologicalOrder::destroyed_edge(const handle_t&, const handle_t&) {
+    // removing an edge can't invalidate a topological order
+}
+
+}
+}
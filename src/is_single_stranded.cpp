@@ -1,5 +1,11 @@
 #include "handlegraph/algorithms/is_single_stranded.hpp"
 
+#include "handlegraph/algorithms/weakly_connected_components.hpp"
+#include "handlegraph/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <unordered_map>
 
 namespace handlegraph {
@@ -97,6 +103,138 @@ vector<handle_t> single_stranded_orientation(const HandleGraph* graph) {
 }
 
 
+bool is_single_stranded_parallel(const HandleGraph* graph, size_t thread_count) {
+
+    // snapshot the nodes so we can check them by index
+    vector<handle_t> handles;
+    handles.reserve(graph->get_node_count());
+    graph->for_each_handle([&](const handle_t& handle) {
+        handles.push_back(handle);
+    });
+
+    atomic<bool> single_stranded(true);
+
+    parallel_for(handles.size(), [&](size_t i) -> bool {
+        const handle_t& handle = handles[i];
+        bool ok = true;
+
+        function<bool(const handle_t&)> check_edge = [&](const handle_t& next) {
+            ok = (graph->get_is_reverse(handle) == graph->get_is_reverse(next));
+            return ok;
+        };
+
+        graph->follow_edges(handle, false, check_edge);
+        if (ok) {
+            graph->follow_edges(handle, true, check_edge);
+        }
+
+        if (!ok) {
+            single_stranded.store(false, memory_order_relaxed);
+        }
+        // stop all the threads as soon as anyone finds a reversing edge
+        return single_stranded.load(memory_order_relaxed);
+    }, thread_count);
+
+    return single_stranded.load();
+}
+
+vector<handle_t> single_stranded_orientation_parallel(const HandleGraph* graph, size_t thread_count) {
+
+    // get a dense labeling of the weakly connected components
+    vector<nid_t> index_to_id;
+    vector<uint32_t> component_ids;
+    size_t component_count = weakly_connected_component_ids(graph, index_to_id, component_ids,
+                                                            thread_count);
+
+    // look up a node's dense index the same way the labeling assigned it
+    const RankedHandleGraph* ranked = dynamic_cast<const RankedHandleGraph*>(graph);
+    auto index_of = [&](const nid_t& node_id) -> size_t {
+        if (ranked != nullptr) {
+            // Ranks start at 1.
+            return ranked->id_to_rank(node_id) - 1;
+        }
+        return lower_bound(index_to_id.begin(), index_to_id.end(), node_id) - index_to_id.begin();
+    };
+
+    // group the dense indexes by component with a counting sort
+    vector<size_t> component_start(component_count + 1, 0);
+    for (const uint32_t& component_id : component_ids) {
+        component_start[component_id + 1]++;
+    }
+    for (size_t i = 1; i < component_start.size(); i++) {
+        component_start[i] += component_start[i - 1];
+    }
+    vector<size_t> grouped(index_to_id.size());
+    {
+        vector<size_t> next_slot = component_start;
+        for (size_t i = 0; i < component_ids.size(); i++) {
+            grouped[next_slot[component_ids[i]]++] = i;
+        }
+    }
+
+    // the orientation each node was first reached in: 0 = unreached,
+    // 1 = forward, 2 = reverse; each component is 2-colored by exactly one
+    // task, so a component's entries are private to one thread and the array
+    // doesn't need to be atomic
+    vector<uint8_t> state(index_to_id.size(), 0);
+
+    // set as soon as any component proves contradictory, so everyone can bail out
+    atomic<bool> failed(false);
+
+    parallel_for(component_count, [&](size_t component) -> bool {
+
+        // seed with the component's first node, forward
+        size_t seed = grouped[component_start[component]];
+        state[seed] = 1;
+        vector<handle_t> stack(1, graph->get_handle(index_to_id[seed]));
+
+        bool ok = true;
+
+        function<bool(const handle_t&)> walk_edges = [&](const handle_t& next) {
+            uint8_t reached_as = graph->get_is_reverse(next) ? 2 : 1;
+            uint8_t& recorded = state[index_of(graph->get_id(next))];
+            if (recorded != 0) {
+                // we've been here before, but make sure we're encountering it
+                // in the same orientation
+                ok = (recorded == reached_as);
+            }
+            else {
+                recorded = reached_as;
+                stack.push_back(next);
+            }
+            return ok && !failed.load(memory_order_relaxed);
+        };
+
+        while (!stack.empty() && ok && !failed.load(memory_order_relaxed)) {
+            handle_t here = stack.back();
+            stack.pop_back();
+
+            graph->follow_edges(here, true, walk_edges);
+            if (ok) {
+                graph->follow_edges(here, false, walk_edges);
+            }
+        }
+
+        if (!ok) {
+            failed.store(true, memory_order_relaxed);
+        }
+        return !failed.load(memory_order_relaxed);
+    }, thread_count);
+
+    if (failed.load()) {
+        // there is no consistent orientation; return the empty sentinel
+        return vector<handle_t>();
+    }
+
+    // assemble the orientation in dense index order
+    vector<handle_t> orientation(index_to_id.size());
+    parallel_for(orientation.size(), [&](size_t i) {
+        orientation[i] = graph->get_handle(index_to_id[i], state[i] == 2);
+    }, thread_count);
+
+    return orientation;
+}
+
 unordered_set<nid_t> make_single_stranded(MutableHandleGraph* graph) {
     
     auto orientations = single_stranded_orientation(graph);
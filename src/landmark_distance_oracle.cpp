@@ -0,0 +1,242 @@
+#include "handlegraph/algorithms/landmark_distance_oracle.hpp"
+#include "handlegraph/algorithms/dijkstra.hpp"
+#include "handlegraph/algorithms/find_shortest_paths.hpp"
+
+#include "handlegraph/parallel.hpp"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <stdexcept>
+
+/** \file landmark_distance_oracle.cpp
+ * Implement the landmark (ALT) distance oracle.
+ */
+
+namespace handlegraph {
+namespace algorithms {
+
+const size_t LandmarkDistanceOracle::UNREACHABLE = std::numeric_limits<size_t>::max();
+
+/// Write a 64-bit value in a fixed byte order.
+static void write_64(std::ostream& out, const uint64_t& value) {
+    uint32_t high = htonl((uint32_t)(value >> 32));
+    uint32_t low = htonl((uint32_t)value);
+    out.write((char*)&high, sizeof(high) / sizeof(char));
+    out.write((char*)&low, sizeof(low) / sizeof(char));
+}
+
+/// Read a 64-bit value back out of the fixed byte order.
+static uint64_t read_64(std::istream& in) {
+    uint32_t high = 0;
+    uint32_t low = 0;
+    in.read((char*)&high, sizeof(high) / sizeof(char));
+    in.read((char*)&low, sizeof(low) / sizeof(char));
+    return ((uint64_t)ntohl(high) << 32) | (uint64_t)ntohl(low);
+}
+
+LandmarkDistanceOracle::LandmarkDistanceOracle(const HandleGraph* graph, size_t num_landmarks,
+                                               size_t thread_count) : graph(graph) {
+    if (graph == nullptr) {
+        throw std::runtime_error("error:[LandmarkDistanceOracle] must supply a graph to build over");
+    }
+
+    // Define the rank space
+    node_ids.reserve(graph->get_node_count());
+    graph->for_each_handle([&](const handle_t& handle) {
+        node_ids.push_back(graph->get_id(handle));
+    });
+    std::sort(node_ids.begin(), node_ids.end());
+
+    // Spread the landmarks evenly over the node ID space. Smarter selection
+    // (e.g. farthest-first) would tighten the bounds, but even spread is
+    // cheap and serviceable.
+    num_landmarks = std::min(num_landmarks, node_ids.size());
+    landmark_ids.reserve(num_landmarks);
+    for (size_t i = 0; i < num_landmarks; i++) {
+        landmark_ids.push_back(node_ids[(i * node_ids.size()) / num_landmarks]);
+    }
+
+    // Run the landmark searches in parallel; each fills only its own slots.
+    from_landmark.resize(num_landmarks);
+    to_landmark.resize(num_landmarks);
+    parallel_for(num_landmarks, [&](size_t i) {
+        handle_t landmark = graph->get_handle(landmark_ids[i]);
+
+        std::vector<uint64_t>& from_here = from_landmark[i];
+        from_here.assign(node_ids.size() * 2, UNREACHABLE);
+        for (const auto& reached : find_shortest_paths(graph, landmark, false)) {
+            from_here[rank_of(reached.first)] = reached.second;
+        }
+
+        // Searching leftward from the landmark reaches each handle with the
+        // length of its rightward path into the landmark.
+        std::vector<uint64_t>& to_here = to_landmark[i];
+        to_here.assign(node_ids.size() * 2, UNREACHABLE);
+        for (const auto& reached : find_shortest_paths(graph, landmark, true)) {
+            to_here[rank_of(reached.first)] = reached.second;
+        }
+    }, thread_count);
+}
+
+void LandmarkDistanceOracle::attach(const HandleGraph* g) {
+    if (g == nullptr || g->get_node_count() != node_ids.size()) {
+        throw std::runtime_error("error:[LandmarkDistanceOracle] attached graph does not match "
+                                 "the graph the oracle was built from");
+    }
+    graph = g;
+}
+
+size_t LandmarkDistanceOracle::get_landmark_count() const {
+    return landmark_ids.size();
+}
+
+size_t LandmarkDistanceOracle::rank_of(const handle_t& handle) const {
+    auto found = std::lower_bound(node_ids.begin(), node_ids.end(), graph->get_id(handle));
+    if (found == node_ids.end() || *found != graph->get_id(handle)) {
+        throw std::runtime_error("error:[LandmarkDistanceOracle] queried node "
+                                 + std::to_string(graph->get_id(handle))
+                                 + " is not in the oracle");
+    }
+    return (found - node_ids.begin()) * 2 + (size_t) graph->get_is_reverse(handle);
+}
+
+void LandmarkDistanceOracle::check_attached() const {
+    if (graph == nullptr) {
+        throw std::runtime_error("error:[LandmarkDistanceOracle] no graph attached; "
+                                 "call attach() after deserializing");
+    }
+}
+
+size_t LandmarkDistanceOracle::lower_bound_distance(const handle_t& from, const handle_t& to) const {
+    check_attached();
+    size_t from_rank = rank_of(from);
+    size_t to_rank = rank_of(to);
+    // Distances run from the outgoing side of the start to the incoming side
+    // of the target, so concatenating two legs at a node adds the node's
+    // length; the triangle inequalities pick that up.
+    size_t bound = 0;
+    for (size_t i = 0; i < landmark_ids.size(); i++) {
+        uint64_t l_from = from_landmark[i][from_rank];
+        uint64_t l_to = from_landmark[i][to_rank];
+        if (l_from != UNREACHABLE && l_to != UNREACHABLE) {
+            // d(L,to) <= d(L,from) + len(from) + d(from,to)
+            size_t slack = l_from + graph->get_length(from);
+            if (l_to > slack) {
+                bound = std::max(bound, (size_t)(l_to - slack));
+            }
+        }
+        uint64_t from_l = to_landmark[i][from_rank];
+        uint64_t to_l = to_landmark[i][to_rank];
+        if (from_l != UNREACHABLE && to_l != UNREACHABLE) {
+            // d(from,L) <= d(from,to) + len(to) + d(to,L)
+            size_t slack = to_l + graph->get_length(to);
+            if (from_l > slack) {
+                bound = std::max(bound, (size_t)(from_l - slack));
+            }
+        }
+    }
+    return bound;
+}
+
+size_t LandmarkDistanceOracle::upper_bound_distance(const handle_t& from, const handle_t& to) const {
+    check_attached();
+    size_t from_rank = rank_of(from);
+    size_t to_rank = rank_of(to);
+    size_t bound = UNREACHABLE;
+    for (size_t i = 0; i < landmark_ids.size(); i++) {
+        uint64_t from_l = to_landmark[i][from_rank];
+        uint64_t l_to = from_landmark[i][to_rank];
+        if (from_l != UNREACHABLE && l_to != UNREACHABLE) {
+            // Route through the landmark, crossing the landmark node itself
+            size_t through = from_l + graph->get_length(graph->get_handle(landmark_ids[i])) + l_to;
+            bound = std::min(bound, through);
+        }
+    }
+    return bound;
+}
+
+size_t LandmarkDistanceOracle::distance(const handle_t& from, const handle_t& to) const {
+    check_attached();
+    size_t best_upper = upper_bound_distance(from, to);
+    size_t found_distance = UNREACHABLE;
+    bool found = false;
+
+    dijkstra(graph, from, [&](const handle_t& here, size_t dist) {
+        if (found) {
+            // Already have the answer; prune everything left in the queue
+            return false;
+        }
+        if (here == to) {
+            found = true;
+            found_distance = dist;
+            return false;
+        }
+        if (best_upper != UNREACHABLE) {
+            // The shortest path through here is at least the distance in,
+            // plus this node, plus the landmark lower bound onward; if that
+            // already beats the best upper bound, nothing through here can
+            // win, so cut it out of the search. The start node itself is
+            // not traversed (distances begin at its outgoing side), so its
+            // length doesn't count.
+            size_t through = here == from ? 0 : graph->get_length(here);
+            if (dist + through + lower_bound_distance(here, to) > best_upper) {
+                return false;
+            }
+        }
+        return true;
+    }, false, true);
+
+    return found_distance;
+}
+
+uint32_t LandmarkDistanceOracle::get_magic_number() const {
+    // corresponds to the ASCII characters "ALTO"
+    return 0x414C544Ful;
+}
+
+void LandmarkDistanceOracle::serialize_members(std::ostream& out) const {
+    write_64(out, node_ids.size());
+    for (const nid_t& node_id : node_ids) {
+        write_64(out, node_id);
+    }
+    write_64(out, landmark_ids.size());
+    for (const nid_t& landmark_id : landmark_ids) {
+        write_64(out, landmark_id);
+    }
+    for (size_t i = 0; i < landmark_ids.size(); i++) {
+        for (const uint64_t& distance : from_landmark[i]) {
+            write_64(out, distance);
+        }
+        for (const uint64_t& distance : to_landmark[i]) {
+            write_64(out, distance);
+        }
+    }
+}
+
+void LandmarkDistanceOracle::deserialize_members(std::istream& in) {
+    size_t node_count = read_64(in);
+    node_ids.resize(node_count);
+    for (size_t i = 0; i < node_count; i++) {
+        node_ids[i] = read_64(in);
+    }
+    size_t landmark_count = read_64(in);
+    landmark_ids.resize(landmark_count);
+    for (size_t i = 0; i < landmark_count; i++) {
+        landmark_ids[i] = read_64(in);
+    }
+    from_landmark.resize(landmark_count);
+    to_landmark.resize(landmark_count);
+    for (size_t i = 0; i < landmark_count; i++) {
+        from_landmark[i].resize(node_count * 2);
+        for (uint64_t& distance : from_landmark[i]) {
+            distance = read_64(in);
+        }
+        to_landmark[i].resize(node_count * 2);
+        for (uint64_t& distance : to_landmark[i]) {
+            distance = read_64(in);
+        }
+    }
+}
+
+}
+}
@@ -0,0 +1,84 @@
+#include "handlegraph/memory_resource.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+/** \file memory_resource.cpp
+ * Implement the default and arena memory resources.
+ */
+
+namespace handlegraph {
+
+namespace {
+
+/// The pass-through resource over the global heap
+class NewDeleteMemoryResource : public MemoryResource {
+public:
+    void* allocate(size_t bytes, size_t alignment) {
+        // operator new already returns memory aligned for max_align_t,
+        // which is as much as we promise
+        return ::operator new(bytes);
+    }
+    void deallocate(void* ptr, size_t bytes, size_t alignment) {
+        ::operator delete(ptr);
+    }
+};
+
+}
+
+MemoryResource* default_memory_resource() {
+    static NewDeleteMemoryResource resource;
+    return &resource;
+}
+
+MonotonicMemoryResource::MonotonicMemoryResource(size_t initial_block_size)
+    : next_block_size(initial_block_size > 0 ? initial_block_size : 1) {
+}
+
+MonotonicMemoryResource::~MonotonicMemoryResource() {
+    release();
+}
+
+void* MonotonicMemoryResource::allocate(size_t bytes, size_t alignment) {
+    if (alignment > alignof(std::max_align_t)) {
+        throw std::runtime_error("error:[MonotonicMemoryResource] cannot align to " +
+                                 std::to_string(alignment) + " bytes");
+    }
+    std::lock_guard<std::mutex> guard(mutex);
+    // Bump the cursor up to the alignment
+    size_t padding = (alignment - (uintptr_t) cursor % alignment) % alignment;
+    if (padding + bytes > remaining) {
+        // Start a new block big enough for this allocation at any padding
+        size_t block_size = std::max(next_block_size, bytes + alignment);
+        blocks.push_back(::operator new(block_size));
+        cursor = static_cast<char*>(blocks.back());
+        remaining = block_size;
+        next_block_size *= 2;
+        padding = (alignment - (uintptr_t) cursor % alignment) % alignment;
+    }
+    cursor += padding;
+    remaining -= padding;
+    void* allocated = cursor;
+    cursor += bytes;
+    remaining -= bytes;
+    return allocated;
+}
+
+void MonotonicMemoryResource::deallocate(void* ptr, size_t bytes, size_t alignment) {
+    // Individual deallocation is a no-op; release() takes everything back
+}
+
+void MonotonicMemoryResource::release() {
+    std::lock_guard<std::mutex> guard(mutex);
+    for (void* block : blocks) {
+        ::operator delete(block);
+    }
+    blocks.clear();
+    cursor = nullptr;
+    remaining = 0;
+}
+
+}
@@ -1,11 +1,83 @@
 #include "handlegraph/mutable_handle_graph.hpp"
 
+#include <algorithm>
+
 /** \file mutable_handle_graph.cpp
  * Implement MutableHandleGraph methods
  */
 
 namespace handlegraph {
 
+std::vector<handle_t> MutableHandleGraph::create_handles(const std::vector<std::string>& sequences,
+                                                         const std::vector<nid_t>& ids) {
+    std::vector<handle_t> handles;
+    handles.reserve(sequences.size());
+    if (ids.empty()) {
+        for (const std::string& sequence : sequences) {
+            handles.push_back(create_handle(sequence));
+        }
+    }
+    else {
+        for (size_t i = 0; i < sequences.size(); i++) {
+            handles.push_back(create_handle(sequences[i], ids[i]));
+        }
+    }
+    return handles;
+}
+
+handle_t MutableHandleGraph::create_handle(const PackedSequence& sequence) {
+    return create_handle(unpack_sequence(sequence));
+}
+
+handle_t MutableHandleGraph::create_handle(const PackedSequence& sequence, const nid_t& id) {
+    return create_handle(unpack_sequence(sequence), id);
+}
+
+void MutableHandleGraph::create_edges(const std::vector<edge_t>& edges) {
+    for (const edge_t& edge : edges) {
+        create_edge(edge);
+    }
+}
+
+optimize_report_t MutableHandleGraph::optimize_with_report(bool allow_id_reassignment) {
+    // By default we can't see inside optimize(), so run it and claim nothing
+    optimize(allow_id_reassignment);
+    return optimize_report_t();
+}
+
+void MutableHandleGraph::reserve(size_t nodes, size_t edges, size_t total_bp) {
+    // By default the hint is ignored
+}
+
+std::vector<handle_t> MutableHandleGraph::apply_orientations(const std::vector<handle_t>& handles) {
+    std::vector<handle_t> new_handles;
+    new_handles.reserve(handles.size());
+    for (const handle_t& handle : handles) {
+        new_handles.push_back(apply_orientation(handle));
+    }
+    return new_handles;
+}
+
+bool MutableHandleGraph::supports_concurrent_construction() const {
+    // By default nothing here is safe to call concurrently
+    return false;
+}
+
+std::pair<nid_t, nid_t> MutableHandleGraph::lease_id_range(size_t count) {
+    // Hand out the IDs just past the current ID space and past any earlier
+    // lease, and move the ID space along so automatic assignment can't
+    // collide either. Backends that opt in to concurrent construction must
+    // replace this with an atomic version.
+    nid_t first = std::max(max_node_id() + 1, next_leased_id);
+    next_leased_id = first + count;
+    set_id_increment(first + count);
+    return std::make_pair(first, first + count - 1);
+}
+
+void MutableHandleGraph::seal_concurrent_construction() {
+    // By default there is nothing to seal
+}
+
 void MutableHandleGraph::increment_node_ids(nid_t increment) {
     // Increment IDs by just reassigning IDs and applying the increment as the ID translation
     reassign_node_ids([&](const nid_t& old_id) -> nid_t {
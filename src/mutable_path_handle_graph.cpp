@@ -12,6 +12,20 @@ void MutablePathHandleGraph::destroy_paths(const std::vector<path_handle_t>& pat
     }
 }
 
+path_handle_t MutablePathHandleGraph::create_path_handle(const std::string& name,
+                                                         bool is_circular,
+                                                         size_t step_count_hint) {
+    // by default, there is nothing to preallocate with the hint
+    return create_path_handle(name, is_circular);
+}
+
+void MutablePathHandleGraph::append_steps(const path_handle_t& path,
+                                          const std::vector<handle_t>& to_append) {
+    for (const handle_t& handle : to_append) {
+        append_step(path, handle);
+    }
+}
+
 void MutablePathHandleGraph::pop_front_step(const path_handle_t& path_handle) {
     step_handle_t begin = path_begin(path_handle);
     step_handle_t next = get_next_step(begin);
@@ -24,6 +38,16 @@ void MutablePathHandleGraph::pop_back_step(const path_handle_t& path_handle) {
     rewrite_segment(prev, last, std::vector<handle_t>());
 }
 
+void MutablePathHandleGraph::rewrite_segments(const path_handle_t& path,
+                                              const std::vector<segment_rewrite_t>& rewrites) {
+    // apply the rewrites from the back of the path towards the front, so
+    // the earlier rewrites' step handles stay valid in storage schemes
+    // where a rewrite only disturbs the steps after it
+    for (auto iter = rewrites.rbegin(); iter != rewrites.rend(); ++iter) {
+        rewrite_segment(iter->begin, iter->end, iter->replacement);
+    }
+}
+
 path_handle_t MutablePathHandleGraph::rename_path(const path_handle_t& path_handle,
                                                   const std::string& new_name) {
     if (new_name == get_path_name(path_handle)) {
@@ -0,0 +1,177 @@
+#include "handlegraph/node_translation.hpp"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <limits>
+#include <numeric>
+
+/** \file node_translation.cpp
+ * Implement the NodeTranslation lookup structure
+ */
+
+namespace handlegraph {
+
+/// Write a 64-bit value in a fixed byte order.
+static void write_64(std::ostream& out, const uint64_t& value) {
+    uint32_t high = htonl((uint32_t)(value >> 32));
+    uint32_t low = htonl((uint32_t)value);
+    out.write((char*)&high, sizeof(high) / sizeof(char));
+    out.write((char*)&low, sizeof(low) / sizeof(char));
+}
+
+/// Read a 64-bit value back out of the fixed byte order.
+static uint64_t read_64(std::istream& in) {
+    uint32_t high = 0;
+    uint32_t low = 0;
+    in.read((char*)&high, sizeof(high) / sizeof(char));
+    in.read((char*)&low, sizeof(low) / sizeof(char));
+    return ((uint64_t)ntohl(high) << 32) | (uint64_t)ntohl(low);
+}
+
+void NodeTranslation::add_translation(const nid_t& new_id, const nid_t& old_id,
+                                      size_t offset_on_forward, size_t offset_on_reverse,
+                                      bool is_reverse) {
+    new_ids.push_back(new_id);
+    old_ids.push_back(old_id);
+    offsets_on_forward.push_back(offset_on_forward);
+    offsets_on_reverse.push_back(offset_on_reverse);
+    reads_reverse.push_back(is_reverse);
+}
+
+void NodeTranslation::index() {
+
+    if (!std::is_sorted(new_ids.begin(), new_ids.end())) {
+        // sort the records by new node ID, carrying the other fields along
+        std::vector<size_t> order(new_ids.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](const size_t& a, const size_t& b) {
+            return new_ids[a] < new_ids[b];
+        });
+
+        std::vector<nid_t> sorted_new_ids(new_ids.size());
+        std::vector<nid_t> sorted_old_ids(new_ids.size());
+        std::vector<uint64_t> sorted_offsets_on_forward(new_ids.size());
+        std::vector<uint64_t> sorted_offsets_on_reverse(new_ids.size());
+        std::vector<bool> sorted_reads_reverse(new_ids.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            sorted_new_ids[i] = new_ids[order[i]];
+            sorted_old_ids[i] = old_ids[order[i]];
+            sorted_offsets_on_forward[i] = offsets_on_forward[order[i]];
+            sorted_offsets_on_reverse[i] = offsets_on_reverse[order[i]];
+            sorted_reads_reverse[i] = reads_reverse[order[i]];
+        }
+        new_ids.swap(sorted_new_ids);
+        old_ids.swap(sorted_old_ids);
+        offsets_on_forward.swap(sorted_offsets_on_forward);
+        offsets_on_reverse.swap(sorted_offsets_on_reverse);
+        reads_reverse.swap(sorted_reads_reverse);
+    }
+
+    // if the new IDs are one contiguous range, we can skip the binary search
+    dense = (!new_ids.empty() &&
+             (uint64_t)(new_ids.back() - new_ids.front()) + 1 == new_ids.size());
+}
+
+size_t NodeTranslation::size() const {
+    return new_ids.size();
+}
+
+size_t NodeTranslation::record_of(const nid_t& new_id) const {
+    if (new_ids.empty() || new_id < new_ids.front() || new_id > new_ids.back()) {
+        return std::numeric_limits<size_t>::max();
+    }
+    if (dense) {
+        return new_id - new_ids.front();
+    }
+    auto iter = std::lower_bound(new_ids.begin(), new_ids.end(), new_id);
+    if (iter == new_ids.end() || *iter != new_id) {
+        return std::numeric_limits<size_t>::max();
+    }
+    return iter - new_ids.begin();
+}
+
+bool NodeTranslation::has_translation(const nid_t& new_id) const {
+    return record_of(new_id) != std::numeric_limits<size_t>::max();
+}
+
+nid_t NodeTranslation::get_old_id(const nid_t& new_id) const {
+    size_t i = record_of(new_id);
+    if (i == std::numeric_limits<size_t>::max()) {
+        // untranslated nodes translate to themselves
+        return new_id;
+    }
+    return old_ids[i];
+}
+
+bool NodeTranslation::get_old_is_reverse(const nid_t& new_id) const {
+    size_t i = record_of(new_id);
+    if (i == std::numeric_limits<size_t>::max()) {
+        return false;
+    }
+    return reads_reverse[i];
+}
+
+size_t NodeTranslation::get_old_offset(const nid_t& new_id, bool reverse_strand) const {
+    size_t i = record_of(new_id);
+    if (i == std::numeric_limits<size_t>::max()) {
+        return 0;
+    }
+    return reverse_strand ? offsets_on_reverse[i] : offsets_on_forward[i];
+}
+
+std::vector<oriented_node_range_t> NodeTranslation::translate_back(const oriented_node_range_t& range) const {
+    size_t i = record_of(std::get<0>(range));
+    if (i == std::numeric_limits<size_t>::max()) {
+        // untranslated nodes translate to themselves
+        return {range};
+    }
+    // reading the new node on this strand reads the original node's segment
+    // on this strand of the original node
+    bool old_strand = (std::get<1>(range) != reads_reverse[i]);
+    // and the segment starts this far along that strand
+    size_t old_offset = old_strand ? offsets_on_reverse[i] : offsets_on_forward[i];
+    return {oriented_node_range_t(old_ids[i], old_strand,
+                                  old_offset + std::get<2>(range), std::get<3>(range))};
+}
+
+std::string NodeTranslation::get_back_graph_node_name(const nid_t& back_node_id) const {
+    return std::to_string(back_node_id);
+}
+
+uint32_t NodeTranslation::get_magic_number() const {
+    // corresponds to the ASCII characters "NTRN"
+    return 0x4E54524Eul;
+}
+
+void NodeTranslation::serialize_members(std::ostream& out) const {
+    write_64(out, new_ids.size());
+    for (size_t i = 0; i < new_ids.size(); i++) {
+        write_64(out, new_ids[i]);
+        write_64(out, old_ids[i]);
+        write_64(out, offsets_on_forward[i]);
+        write_64(out, offsets_on_reverse[i]);
+        char is_reverse = reads_reverse[i];
+        out.write(&is_reverse, 1);
+    }
+}
+
+void NodeTranslation::deserialize_members(std::istream& in) {
+    size_t count = read_64(in);
+    new_ids.reserve(count);
+    old_ids.reserve(count);
+    offsets_on_forward.reserve(count);
+    offsets_on_reverse.reserve(count);
+    reads_reverse.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        nid_t new_id = read_64(in);
+        nid_t old_id = read_64(in);
+        uint64_t offset_on_forward = read_64(in);
+        uint64_t offset_on_reverse = read_64(in);
+        char is_reverse = 0;
+        in.read(&is_reverse, 1);
+        add_translation(new_id, old_id, offset_on_forward, offset_on_reverse, is_reverse);
+    }
+    index();
+}
+
+}
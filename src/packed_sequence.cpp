@@ -0,0 +1,71 @@
+#include "handlegraph/packed_sequence.hpp"
+
+/** \file packed_sequence.cpp
+ * Implement the 2-bit DNA packing kernels.
+ */
+
+namespace handlegraph {
+
+/// Code for each byte value, or -1 for bases that go in the exception list
+static const int8_t DNA_CODE[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1,  0, -1,  1, -1, -1, -1,  2, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1,  3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+/// ASCII base for each code
+static const char DNA_CHAR[4] = {'A', 'C', 'G', 'T'};
+
+void pack_dna(const char* sequence, size_t count, uint8_t* codes,
+              std::vector<std::pair<size_t, char>>* exceptions) {
+    for (size_t i = 0; i < count; i++) {
+        int8_t code = DNA_CODE[(uint8_t) sequence[i]];
+        if (code < 0) {
+            if (exceptions != nullptr) {
+                exceptions->emplace_back(i, sequence[i]);
+            }
+            code = 0;
+        }
+        codes[i >> 2] |= (uint8_t) code << ((i & 3) * 2);
+    }
+}
+
+void unpack_dna(const uint8_t* codes, size_t count, char* sequence) {
+    // A plain shift-mask-lookup per base; the compiler can unroll and
+    // vectorize this 4 bases to the input byte.
+    for (size_t i = 0; i < count; i++) {
+        sequence[i] = DNA_CHAR[(codes[i >> 2] >> ((i & 3) * 2)) & 3];
+    }
+}
+
+PackedSequence pack_sequence(const std::string& sequence) {
+    PackedSequence packed;
+    packed.length = sequence.size();
+    packed.codes.resize((sequence.size() + 3) / 4, 0);
+    pack_dna(sequence.data(), sequence.size(), packed.codes.data(), &packed.exceptions);
+    return packed;
+}
+
+std::string unpack_sequence(const PackedSequence& packed) {
+    std::string sequence(packed.length, '\0');
+    unpack_dna(packed.codes.data(), packed.length, &sequence[0]);
+    for (const auto& exception : packed.exceptions) {
+        sequence[exception.first] = exception.second;
+    }
+    return sequence;
+}
+
+}
@@ -0,0 +1,69 @@
+#include "handlegraph/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/** \file parallel.cpp
+ * Implement the shared chunked parallel loop.
+ */
+
+namespace handlegraph {
+
+bool parallel_for_range(size_t count, const std::function<bool(size_t)>& iteratee,
+                        size_t thread_count, size_t chunk_size) {
+
+    if (thread_count == 0) {
+        thread_count = std::thread::hardware_concurrency();
+        if (thread_count == 0) {
+            // The implementation can't tell us, so just be serial.
+            thread_count = 1;
+        }
+    }
+
+    if (chunk_size == 0) {
+        // Keep chunks small enough that uneven stragglers get spread out, but
+        // big enough to amortize the cursor contention.
+        chunk_size = std::max<size_t>(1, count / (thread_count * 64));
+    }
+
+    // Threads claim chunks of the range off this shared cursor.
+    std::atomic<size_t> cursor(0);
+    // Set when any thread's iteratee asks to stop; other threads notice at
+    // their next index, making early stop best-effort.
+    std::atomic<bool> keep_going(true);
+
+    auto work = [&]() {
+        while (keep_going.load(std::memory_order_relaxed)) {
+            size_t begin = cursor.fetch_add(chunk_size);
+            if (begin >= count) {
+                break;
+            }
+            size_t end = std::min(begin + chunk_size, count);
+            for (size_t i = begin; i < end && keep_going.load(std::memory_order_relaxed); i++) {
+                if (!iteratee(i)) {
+                    keep_going.store(false, std::memory_order_relaxed);
+                }
+            }
+        }
+    };
+
+    if (thread_count == 1) {
+        // No point in spawning anything.
+        work();
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(thread_count);
+        for (size_t i = 0; i < thread_count; i++) {
+            workers.emplace_back(work);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    return keep_going.load();
+}
+
+}
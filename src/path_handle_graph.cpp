@@ -1,5 +1,10 @@
 #include "handlegraph/path_handle_graph.hpp"
+#include "handlegraph/parallel.hpp"
+#include "handlegraph/util.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
 /** \file path_handle_graph.cpp
@@ -36,7 +41,174 @@ bool PathHandleGraph::is_empty(const path_handle_t& path_handle) const {
     // But some implementations may have an expensive length query and a cheaper emptiness one
     return get_step_count(path_handle) == 0;
 }
-    
+
+size_t PathHandleGraph::get_steps_in_path(const path_handle_t& path_handle,
+                                          const step_handle_t& from,
+                                          step_handle_t* steps,
+                                          handle_t* handles,
+                                          size_t buffer_size) const {
+    // By default, walk the steps one at a time. Backends with contiguous
+    // step storage should override this with a block copy.
+    step_handle_t end = path_back(path_handle);
+    step_handle_t here = from;
+    size_t num_filled = 0;
+    while (num_filled < buffer_size) {
+        steps[num_filled] = here;
+        if (handles != nullptr) {
+            handles[num_filled] = get_handle_of_step(here);
+        }
+        ++num_filled;
+        if (here == end) {
+            // We just delivered the last step of the iteration
+            break;
+        }
+        here = get_next_step(here);
+    }
+    return num_filled;
+}
+
+bool PathHandleGraph::has_step_random_access() const {
+    // By default, seeking means walking
+    return false;
+}
+
+step_handle_t PathHandleGraph::get_step_at(const path_handle_t& path_handle, size_t index) const {
+    if (index >= get_step_count(path_handle)) {
+        throw std::runtime_error("error:[PathHandleGraph] step index " + std::to_string(index) +
+                                 " is past the end of the path");
+    }
+    step_handle_t here = path_begin(path_handle);
+    for (size_t i = 0; i < index; i++) {
+        here = get_next_step(here);
+    }
+    return here;
+}
+
+void PathHandleGraph::for_each_step_in_path_parallel(const path_handle_t& path,
+                                                     const std::function<void(const step_handle_t&)>& iteratee,
+                                                     size_t thread_count) const {
+    size_t count = get_step_count(path);
+    if (count == 0) {
+        return;
+    }
+    size_t threads = thread_count != 0 ? thread_count : std::thread::hardware_concurrency();
+    if (threads == 0) {
+        threads = 1;
+    }
+    // Cut the path into a few chunks per thread, so uneven per-step work
+    // still balances out
+    size_t items_per_chunk = std::max<size_t>(1, (count + threads * 4 - 1) / (threads * 4));
+    size_t num_chunks = (count + items_per_chunk - 1) / items_per_chunk;
+    if (threads == 1 || num_chunks < 2) {
+        // Not enough work to be worth splitting up
+        for_each_step_in_path(path, [&](const step_handle_t& step) {
+            iteratee(step);
+        });
+        return;
+    }
+
+    const size_t buffer_size = 1024;
+
+    // Find where each chunk starts
+    std::vector<step_handle_t> chunk_starts;
+    chunk_starts.reserve(num_chunks);
+    if (has_step_random_access()) {
+        for (size_t chunk = 0; chunk < num_chunks; chunk++) {
+            chunk_starts.push_back(get_step_at(path, chunk * items_per_chunk));
+        }
+    }
+    else {
+        // One forward walk over the whole path, touching only the step
+        // topology, to mark off the boundaries
+        step_handle_t buffer[buffer_size];
+        step_handle_t cursor = path_begin(path);
+        size_t index = 0;
+        while (index < count) {
+            size_t num_steps = get_steps_in_path(path, cursor, buffer, nullptr,
+                                                 std::min(buffer_size, count - index));
+            for (size_t i = 0; i < num_steps; i++, index++) {
+                if (index % items_per_chunk == 0) {
+                    chunk_starts.push_back(buffer[i]);
+                }
+            }
+            if (index < count) {
+                cursor = get_next_step(buffer[num_steps - 1]);
+            }
+        }
+    }
+
+    // Then work the chunks in parallel
+    parallel_for(num_chunks, [&](size_t chunk) {
+        size_t todo = std::min(items_per_chunk, count - chunk * items_per_chunk);
+        step_handle_t buffer[buffer_size];
+        step_handle_t cursor = chunk_starts[chunk];
+        while (todo > 0) {
+            size_t num_steps = get_steps_in_path(path, cursor, buffer, nullptr,
+                                                 std::min(buffer_size, todo));
+            for (size_t i = 0; i < num_steps; i++) {
+                iteratee(buffer[i]);
+            }
+            todo -= num_steps;
+            if (todo > 0) {
+                cursor = get_next_step(buffer[num_steps - 1]);
+            }
+        }
+    }, thread_count);
+}
+
+const std::string& PathHandleGraph::get_path_name_view(const path_handle_t& path_handle) const {
+    std::lock_guard<std::mutex> guard(intern_mutex);
+    auto found = interned_names.find(as_integer(path_handle));
+    if (found == interned_names.end()) {
+        // Intern the name; the map's values stay at stable addresses, so the
+        // reference outlives the lock
+        found = interned_names.emplace(as_integer(path_handle), get_path_name(path_handle)).first;
+    }
+    return found->second;
+}
+
+void PathHandleGraph::build_name_ids() const {
+    // Must hold intern_mutex. Assign all the IDs at once, in iteration
+    // order, so they don't depend on the query order.
+    paths_by_name_id.reserve(get_path_count());
+    for_each_path_handle([&](const path_handle_t& path) {
+        name_ids[as_integer(path)] = paths_by_name_id.size();
+        paths_by_name_id.push_back(path);
+    });
+}
+
+size_t PathHandleGraph::get_path_name_id(const path_handle_t& path_handle) const {
+    std::lock_guard<std::mutex> guard(intern_mutex);
+    if (paths_by_name_id.empty()) {
+        build_name_ids();
+    }
+    auto found = name_ids.find(as_integer(path_handle));
+    if (found == name_ids.end()) {
+        throw std::runtime_error("error:[PathHandleGraph] path has no interned name ID; "
+                                 "were paths modified without clear_interned_path_names()?");
+    }
+    return found->second;
+}
+
+path_handle_t PathHandleGraph::get_path_handle_for_name_id(size_t name_id) const {
+    std::lock_guard<std::mutex> guard(intern_mutex);
+    if (paths_by_name_id.empty()) {
+        build_name_ids();
+    }
+    if (name_id >= paths_by_name_id.size()) {
+        throw std::runtime_error("error:[PathHandleGraph] no path with interned name ID " +
+                                 std::to_string(name_id));
+    }
+    return paths_by_name_id[name_id];
+}
+
+void PathHandleGraph::clear_interned_path_names() const {
+    std::lock_guard<std::mutex> guard(intern_mutex);
+    interned_names.clear();
+    paths_by_name_id.clear();
+    name_ids.clear();
+}
+
 PathForEachSocket PathHandleGraph::scan_path(const path_handle_t& path) const {
     return PathForEachSocket(this, path);
 }
@@ -53,6 +225,16 @@ PathForEachSocket::iterator PathForEachSocket::end() const {
     // we will end on the beginning step in circular paths
     return iterator(graph->get_is_circular(path) ? graph->path_begin(path) : graph->path_end(path), false, graph);
 }
+
+size_t PathForEachSocket::size() const {
+    return graph->get_step_count(path);
+}
+
+PathForEachSocket::iterator PathForEachSocket::at(size_t index) const {
+    // only the iterator at the very first step needs the circularity hack
+    return iterator(graph->get_step_at(path, index),
+                    index == 0 && graph->get_is_circular(path) && !graph->is_empty(path), graph);
+}
     
 PathForEachSocket::iterator::iterator(const step_handle_t& step, bool force_unequal,
                                       const PathHandleGraph* graph) : step(step), force_unequal(force_unequal), graph(graph) {
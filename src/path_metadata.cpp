@@ -49,27 +49,47 @@ const char PathMetadata::RANGE_TERMINATOR = ']';
 
 
 PathSense PathMetadata::get_sense(const path_handle_t& handle) const {
-    return PathMetadata::parse_sense(get_path_name(handle));
+    return get_path_metadata(handle).sense;
 }
 
 std::string PathMetadata::get_sample_name(const path_handle_t& handle) const {
-    return PathMetadata::parse_sample_name(get_path_name(handle));
+    return get_path_metadata(handle).sample;
 }
 
 std::string PathMetadata::get_locus_name(const path_handle_t& handle) const {
-    return PathMetadata::parse_locus_name(get_path_name(handle));
+    return get_path_metadata(handle).locus;
 }
 
 size_t PathMetadata::get_haplotype(const path_handle_t& handle) const {
-    return PathMetadata::parse_haplotype(get_path_name(handle));
+    return get_path_metadata(handle).haplotype;
 }
 
 size_t PathMetadata::get_phase_block(const path_handle_t& handle) const {
-    return PathMetadata::parse_phase_block(get_path_name(handle));
+    return get_path_metadata(handle).phase_block;
 }
 
 subrange_t PathMetadata::get_subrange(const path_handle_t& handle) const {
-    return PathMetadata::parse_subrange(get_path_name(handle));
+    return get_path_metadata(handle).subrange;
+}
+
+path_metadata_t PathMetadata::get_path_metadata(const path_handle_t& handle) const {
+    {
+        // check the memoized parses first
+        std::lock_guard<std::mutex> guard(metadata_cache_mutex);
+        auto iter = metadata_cache.find(handle);
+        if (iter != metadata_cache.end()) {
+            return iter->second;
+        }
+    }
+
+    // parse outside the lock, so one slow parse doesn't hold up other threads
+    path_metadata_t metadata;
+    parse_path_name(get_path_name(handle), metadata.sense, metadata.sample, metadata.locus,
+                    metadata.haplotype, metadata.phase_block, metadata.subrange);
+
+    std::lock_guard<std::mutex> guard(metadata_cache_mutex);
+    metadata_cache.emplace(handle, metadata);
+    return metadata;
 }
 
 PathSense PathMetadata::parse_sense(const std::string& path_name) {
@@ -339,7 +359,7 @@ std::string PathMetadata::create_path_name(const PathSense& sense,
 bool PathMetadata::for_each_path_matching_impl(const std::unordered_set<PathSense>* senses,
                                                const std::unordered_set<std::string>* samples,
                                                const std::unordered_set<std::string>* loci,
-                                               const std::function<bool(const path_handle_t&)>& iteratee) const {
+                                               function_ref<bool(const path_handle_t&)> iteratee) const {
     return for_each_path_handle_impl([&](const path_handle_t& handle) {
         if (senses && !senses->count(get_sense(handle))) {
             // Wrong sense
@@ -358,7 +378,7 @@ bool PathMetadata::for_each_path_matching_impl(const std::unordered_set<PathSens
     });
 }
     
-bool PathMetadata::for_each_step_of_sense_impl(const handle_t& visited, const PathSense& sense, const std::function<bool(const step_handle_t&)>& iteratee) const {
+bool PathMetadata::for_each_step_of_sense_impl(const handle_t& visited, const PathSense& sense, function_ref<bool(const step_handle_t&)> iteratee) const {
     return for_each_step_on_handle_impl(visited, [&](const step_handle_t& handle) {
         if (get_sense(get_path_handle_of_step(handle)) != sense) {
             // Skip this non-matching path's step
@@ -0,0 +1,91 @@
+#include "handlegraph/path_metadata_index.hpp"
+
+/** \file path_metadata_index.cpp
+ * Implement the PathMetadataIndex buckets
+ */
+
+namespace handlegraph {
+
+const std::vector<path_handle_t> PathMetadataIndex::NO_PATHS;
+
+PathMetadataIndex::PathMetadataIndex(const PathHandleGraph* graph) {
+    // visit the paths of every sense, so compressed haplotype paths that are
+    // hidden from plain path iteration get indexed too
+    for (auto& sense : {PathSense::REFERENCE, PathSense::GENERIC, PathSense::HAPLOTYPE}) {
+        graph->for_each_path_of_sense(sense, [&](const path_handle_t& path_handle) {
+            path_metadata_t metadata = graph->get_path_metadata(path_handle);
+            all_paths.push_back(path_handle);
+            by_sense[metadata.sense].push_back(path_handle);
+            by_sample[metadata.sample].push_back(path_handle);
+            by_locus[metadata.locus].push_back(path_handle);
+            metadata_of.emplace(path_handle, std::move(metadata));
+        });
+    }
+}
+
+bool PathMetadataIndex::for_each_path_matching(const std::unordered_set<PathSense>* senses,
+                                               const std::unordered_set<std::string>* samples,
+                                               const std::unordered_set<std::string>* loci,
+                                               const std::function<bool(const path_handle_t&)>& iteratee) const {
+
+    // check the criteria the bucket choice doesn't already guarantee
+    auto matches = [&](const path_handle_t& path_handle) {
+        const auto& metadata = metadata_of.at(path_handle);
+        return ((!senses || senses->count(metadata.sense)) &&
+                (!samples || samples->count(metadata.sample)) &&
+                (!loci || loci->count(metadata.locus)));
+    };
+
+    auto emit_bucket = [&](const std::vector<path_handle_t>& bucket) {
+        for (const path_handle_t& path_handle : bucket) {
+            if (matches(path_handle) && !iteratee(path_handle)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // enumerate the buckets of the most selective non-null query element
+    if (samples) {
+        for (const std::string& sample : *samples) {
+            if (!emit_bucket(paths_of_sample(sample))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (loci) {
+        for (const std::string& locus : *loci) {
+            if (!emit_bucket(paths_of_locus(locus))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (senses) {
+        for (const PathSense& sense : *senses) {
+            if (!emit_bucket(paths_of_sense(sense))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return emit_bucket(all_paths);
+}
+
+const std::vector<path_handle_t>& PathMetadataIndex::paths_of_sense(const PathSense& sense) const {
+    auto iter = by_sense.find(sense);
+    return iter != by_sense.end() ? iter->second : NO_PATHS;
+}
+
+const std::vector<path_handle_t>& PathMetadataIndex::paths_of_sample(const std::string& sample) const {
+    auto iter = by_sample.find(sample);
+    return iter != by_sample.end() ? iter->second : NO_PATHS;
+}
+
+const std::vector<path_handle_t>& PathMetadataIndex::paths_of_locus(const std::string& locus) const {
+    auto iter = by_locus.find(locus);
+    return iter != by_locus.end() ? iter->second : NO_PATHS;
+}
+
+}
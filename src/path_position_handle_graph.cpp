@@ -1,5 +1,6 @@
 #include "handlegraph/path_position_handle_graph.hpp"
 
+#include <algorithm>
 #include <vector>
 
 /** \file path_position_handle_graph.cpp
@@ -14,7 +15,62 @@ bool PathPositionHandleGraph::for_each_step_position_on_handle(const handle_t& h
         return iteratee(step, get_is_reverse(get_handle_of_step(step)) != get_is_reverse(handle), get_position_of_step(step));
     });
 }
-    
+
+void PathPositionHandleGraph::get_steps_at_positions(const path_handle_t& path,
+                                                     const std::vector<size_t>& positions,
+                                                     std::vector<step_handle_t>& steps) const {
+    // By default, answer the queries one at a time
+    steps.clear();
+    steps.reserve(positions.size());
+    for (const size_t& position : positions) {
+        steps.push_back(get_step_at_position(path, position));
+    }
+}
+
+void PathPositionHandleGraph::get_positions_of_steps(const std::vector<step_handle_t>& steps,
+                                                     std::vector<size_t>& positions) const {
+    // By default, answer the queries one at a time
+    positions.clear();
+    positions.reserve(steps.size());
+    for (const step_handle_t& step : steps) {
+        positions.push_back(get_position_of_step(step));
+    }
+}
+
+void PathPositionHandleGraph::get_path_sequence(const path_handle_t& path, size_t start, size_t end,
+                                                std::string& out) const {
+    end = std::min(end, get_path_length(path));
+    if (start >= end) {
+        return;
+    }
+    // Pay for the whole interval once instead of an allocation per step
+    out.reserve(out.size() + (end - start));
+
+    step_handle_t step = get_step_at_position(path, start);
+    // Where we are within the first step's node
+    size_t offset = start - get_position_of_step(step);
+    size_t remaining = end - start;
+    while (remaining > 0) {
+        handle_t handle = get_handle_of_step(step);
+        size_t take = std::min(get_length(handle) - offset, remaining);
+        out.append(get_subsequence(handle, offset, take));
+        offset = 0;
+        remaining -= take;
+        step = get_next_step(step);
+    }
+}
+
+void PathPositionHandleGraph::get_path_sequences(const path_handle_t& path,
+                                                 const std::vector<std::pair<size_t, size_t>>& intervals,
+                                                 std::vector<std::string>& out) const {
+    // By default, extract the intervals one at a time
+    out.clear();
+    out.resize(intervals.size());
+    for (size_t i = 0; i < intervals.size(); i++) {
+        get_path_sequence(path, intervals[i].first, intervals[i].second, out[i]);
+    }
+}
+
 }
 
 
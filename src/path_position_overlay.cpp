@@ -0,0 +1,331 @@
+#include "handlegraph/path_position_overlay.hpp"
+
+#include "handlegraph/parallel.hpp"
+
+#include <algorithm>
+#include <arpa/inet.h>
+
+/** \file path_position_overlay.cpp
+ * Implement the PathPositionOverlay index
+ */
+
+namespace handlegraph {
+
+/// Write a 64-bit value in a fixed byte order.
+static void write_64(std::ostream& out, const uint64_t& value) {
+    uint32_t high = htonl((uint32_t)(value >> 32));
+    uint32_t low = htonl((uint32_t)value);
+    out.write((char*)&high, sizeof(high) / sizeof(char));
+    out.write((char*)&low, sizeof(low) / sizeof(char));
+}
+
+/// Read a 64-bit value back out of the fixed byte order.
+static uint64_t read_64(std::istream& in) {
+    uint32_t high = 0;
+    uint32_t low = 0;
+    in.read((char*)&high, sizeof(high) / sizeof(char));
+    in.read((char*)&low, sizeof(low) / sizeof(char));
+    return ((uint64_t)ntohl(high) << 32) | (uint64_t)ntohl(low);
+}
+
+PathPositionOverlay::PathPositionOverlay(const PathHandleGraph* graph, size_t sample_rate,
+                                         size_t thread_count)
+    : graph(graph), sample_rate(std::max<size_t>(1, sample_rate)) {
+    index_paths(thread_count);
+}
+
+PathPositionOverlay::PathPositionOverlay(const PathHandleGraph* graph, std::istream& in)
+    : graph(graph) {
+    deserialize(in);
+}
+
+void PathPositionOverlay::index_paths(size_t thread_count) {
+
+    // snapshot the paths of every sense
+    std::vector<path_handle_t> paths;
+    for (auto& sense : {PathSense::REFERENCE, PathSense::GENERIC, PathSense::HAPLOTYPE}) {
+        graph->for_each_path_of_sense(sense, [&](const path_handle_t& path_handle) {
+            paths.push_back(path_handle);
+        });
+    }
+
+    // walk the paths across threads; the indexes of distinct paths don't
+    // interact, and this phase only reads the backing graph
+    std::vector<PathIndex> path_indexes(paths.size());
+    parallel_for(paths.size(), [&](size_t i) {
+        auto& index = path_indexes[i];
+        size_t rank = 0;
+        graph->for_each_step_in_path(paths[i], [&](const step_handle_t& step) {
+            if (rank % sample_rate == 0) {
+                index.sampled_positions.push_back(index.path_length);
+                index.sampled_steps.push_back(step);
+            }
+            index.path_length += graph->get_length(graph->get_handle_of_step(step));
+            ++rank;
+        });
+    }, thread_count);
+
+    // merge into the lookup structures
+    for (size_t i = 0; i < paths.size(); i++) {
+        auto& index = path_indexes[i];
+        for (size_t j = 0; j < index.sampled_steps.size(); j++) {
+            sampled_position[index.sampled_steps[j]] = index.sampled_positions[j];
+        }
+        indexes[paths[i]] = std::move(index);
+    }
+}
+
+size_t PathPositionOverlay::get_path_length(const path_handle_t& path_handle) const {
+    return indexes.at(path_handle).path_length;
+}
+
+size_t PathPositionOverlay::get_position_of_step(const step_handle_t& step) const {
+    // walk backward to the nearest sampled step, which is at most
+    // sample_rate - 1 steps away, accumulating the length walked over
+    step_handle_t here = step;
+    size_t offset = 0;
+    auto iter = sampled_position.find(here);
+    while (iter == sampled_position.end()) {
+        here = graph->get_previous_step(here);
+        offset += graph->get_length(graph->get_handle_of_step(here));
+        iter = sampled_position.find(here);
+    }
+    return iter->second + offset;
+}
+
+step_handle_t PathPositionOverlay::get_step_at_position(const path_handle_t& path,
+                                                        const size_t& position) const {
+    const auto& index = indexes.at(path);
+    if (position >= index.path_length) {
+        return graph->path_end(path);
+    }
+
+    // binary search for the last sample at or before the position
+    size_t i = std::upper_bound(index.sampled_positions.begin(), index.sampled_positions.end(),
+                                position) - index.sampled_positions.begin() - 1;
+
+    // walk forward to the step that covers the position, which is at most
+    // sample_rate - 1 steps away
+    step_handle_t here = index.sampled_steps[i];
+    size_t here_position = index.sampled_positions[i];
+    size_t length = graph->get_length(graph->get_handle_of_step(here));
+    while (here_position + length <= position) {
+        here_position += length;
+        here = graph->get_next_step(here);
+        length = graph->get_length(graph->get_handle_of_step(here));
+    }
+    return here;
+}
+
+bool PathPositionOverlay::has_node(nid_t node_id) const {
+    return graph->has_node(node_id);
+}
+
+handle_t PathPositionOverlay::get_handle(const nid_t& node_id, bool is_reverse) const {
+    return graph->get_handle(node_id, is_reverse);
+}
+
+nid_t PathPositionOverlay::get_id(const handle_t& handle) const {
+    return graph->get_id(handle);
+}
+
+bool PathPositionOverlay::get_is_reverse(const handle_t& handle) const {
+    return graph->get_is_reverse(handle);
+}
+
+handle_t PathPositionOverlay::flip(const handle_t& handle) const {
+    return graph->flip(handle);
+}
+
+size_t PathPositionOverlay::get_length(const handle_t& handle) const {
+    return graph->get_length(handle);
+}
+
+std::string PathPositionOverlay::get_sequence(const handle_t& handle) const {
+    return graph->get_sequence(handle);
+}
+
+size_t PathPositionOverlay::get_node_count() const {
+    return graph->get_node_count();
+}
+
+nid_t PathPositionOverlay::min_node_id() const {
+    return graph->min_node_id();
+}
+
+nid_t PathPositionOverlay::max_node_id() const {
+    return graph->max_node_id();
+}
+
+size_t PathPositionOverlay::get_path_count() const {
+    return graph->get_path_count();
+}
+
+bool PathPositionOverlay::has_path(const std::string& path_name) const {
+    return graph->has_path(path_name);
+}
+
+path_handle_t PathPositionOverlay::get_path_handle(const std::string& path_name) const {
+    return graph->get_path_handle(path_name);
+}
+
+std::string PathPositionOverlay::get_path_name(const path_handle_t& path_handle) const {
+    return graph->get_path_name(path_handle);
+}
+
+bool PathPositionOverlay::get_is_circular(const path_handle_t& path_handle) const {
+    return graph->get_is_circular(path_handle);
+}
+
+size_t PathPositionOverlay::get_step_count(const path_handle_t& path_handle) const {
+    return graph->get_step_count(path_handle);
+}
+
+handle_t PathPositionOverlay::get_handle_of_step(const step_handle_t& step_handle) const {
+    return graph->get_handle_of_step(step_handle);
+}
+
+path_handle_t PathPositionOverlay::get_path_handle_of_step(const step_handle_t& step_handle) const {
+    return graph->get_path_handle_of_step(step_handle);
+}
+
+step_handle_t PathPositionOverlay::path_begin(const path_handle_t& path_handle) const {
+    return graph->path_begin(path_handle);
+}
+
+step_handle_t PathPositionOverlay::path_end(const path_handle_t& path_handle) const {
+    return graph->path_end(path_handle);
+}
+
+step_handle_t PathPositionOverlay::path_back(const path_handle_t& path_handle) const {
+    return graph->path_back(path_handle);
+}
+
+step_handle_t PathPositionOverlay::path_front_end(const path_handle_t& path_handle) const {
+    return graph->path_front_end(path_handle);
+}
+
+bool PathPositionOverlay::has_next_step(const step_handle_t& step_handle) const {
+    return graph->has_next_step(step_handle);
+}
+
+bool PathPositionOverlay::has_previous_step(const step_handle_t& step_handle) const {
+    return graph->has_previous_step(step_handle);
+}
+
+step_handle_t PathPositionOverlay::get_next_step(const step_handle_t& step_handle) const {
+    return graph->get_next_step(step_handle);
+}
+
+step_handle_t PathPositionOverlay::get_previous_step(const step_handle_t& step_handle) const {
+    return graph->get_previous_step(step_handle);
+}
+
+size_t PathPositionOverlay::get_steps_in_path(const path_handle_t& path_handle,
+                                              const step_handle_t& from,
+                                              step_handle_t* steps,
+                                              handle_t* handles,
+                                              size_t buffer_size) const {
+    return graph->get_steps_in_path(path_handle, from, steps, handles, buffer_size);
+}
+
+PathSense PathPositionOverlay::get_sense(const path_handle_t& handle) const {
+    return graph->get_sense(handle);
+}
+
+std::string PathPositionOverlay::get_sample_name(const path_handle_t& handle) const {
+    return graph->get_sample_name(handle);
+}
+
+std::string PathPositionOverlay::get_locus_name(const path_handle_t& handle) const {
+    return graph->get_locus_name(handle);
+}
+
+size_t PathPositionOverlay::get_haplotype(const path_handle_t& handle) const {
+    return graph->get_haplotype(handle);
+}
+
+size_t PathPositionOverlay::get_phase_block(const path_handle_t& handle) const {
+    return graph->get_phase_block(handle);
+}
+
+subrange_t PathPositionOverlay::get_subrange(const path_handle_t& handle) const {
+    return graph->get_subrange(handle);
+}
+
+bool PathPositionOverlay::follow_edges_impl(const handle_t& handle, bool go_left,
+                                            function_ref<bool(const handle_t&)> iteratee) const {
+    return graph->follow_edges(handle, go_left, iteratee);
+}
+
+bool PathPositionOverlay::for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee,
+                                               bool parallel) const {
+    return graph->for_each_handle(iteratee, parallel);
+}
+
+bool PathPositionOverlay::for_each_path_handle_impl(function_ref<bool(const path_handle_t&)> iteratee) const {
+    return graph->for_each_path_handle(iteratee);
+}
+
+bool PathPositionOverlay::for_each_step_on_handle_impl(const handle_t& handle,
+                                                       function_ref<bool(const step_handle_t&)> iteratee) const {
+    return graph->for_each_step_on_handle(handle, iteratee);
+}
+
+bool PathPositionOverlay::for_each_path_matching_impl(const std::unordered_set<PathSense>* senses,
+                                                      const std::unordered_set<std::string>* samples,
+                                                      const std::unordered_set<std::string>* loci,
+                                                      function_ref<bool(const path_handle_t&)> iteratee) const {
+    return graph->for_each_path_matching(senses, samples, loci, iteratee);
+}
+
+bool PathPositionOverlay::for_each_step_of_sense_impl(const handle_t& visited, const PathSense& sense,
+                                                      function_ref<bool(const step_handle_t&)> iteratee) const {
+    return graph->for_each_step_of_sense(visited, sense, iteratee);
+}
+
+uint32_t PathPositionOverlay::get_magic_number() const {
+    // corresponds to the ASCII characters "PPOI"
+    return 0x50504F49ul;
+}
+
+void PathPositionOverlay::serialize_members(std::ostream& out) const {
+    write_64(out, sample_rate);
+    write_64(out, indexes.size());
+    for (const auto& path_index : indexes) {
+        // identify the path by name, since path handles are opaque
+        std::string name = graph->get_path_name(path_index.first);
+        write_64(out, name.size());
+        out.write(name.c_str(), name.size());
+        const auto& index = path_index.second;
+        write_64(out, index.path_length);
+        write_64(out, index.sampled_steps.size());
+        for (size_t i = 0; i < index.sampled_steps.size(); i++) {
+            write_64(out, index.sampled_positions[i]);
+            out.write(index.sampled_steps[i].data, sizeof(index.sampled_steps[i].data));
+        }
+    }
+}
+
+void PathPositionOverlay::deserialize_members(std::istream& in) {
+    sample_rate = read_64(in);
+    size_t path_count = read_64(in);
+    for (size_t i = 0; i < path_count; i++) {
+        std::string name(read_64(in), '\0');
+        in.read(&name[0], name.size());
+        auto& index = indexes[graph->get_path_handle(name)];
+        index.path_length = read_64(in);
+        size_t num_samples = read_64(in);
+        index.sampled_positions.reserve(num_samples);
+        index.sampled_steps.reserve(num_samples);
+        for (size_t j = 0; j < num_samples; j++) {
+            index.sampled_positions.push_back(read_64(in));
+            step_handle_t step;
+            in.read(step.data, sizeof(step.data));
+            index.sampled_steps.push_back(step);
+            sampled_position[step] = index.sampled_positions.back();
+        }
+    }
+}
+
+}
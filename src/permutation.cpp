@@ -0,0 +1,33 @@
+#include "handlegraph/permutation.hpp"
+
+#include <utility>
+
+/** \file permutation.cpp
+ * Implement the in-place permutation helpers.
+ */
+
+namespace handlegraph {
+
+void apply_permutation(std::vector<size_t>& new_rank,
+                       const std::function<void(size_t, size_t)>& swap_ranks) {
+    for (size_t i = 0; i < new_rank.size(); i++) {
+        // Chase the cycle through rank i: keep sending the item sitting here
+        // to where it belongs until the item that belongs here arrives. Each
+        // swap parks one item for good, so the whole pass does O(n) swaps.
+        while (new_rank[i] != i) {
+            size_t destination = new_rank[i];
+            swap_ranks(i, destination);
+            std::swap(new_rank[i], new_rank[destination]);
+        }
+    }
+}
+
+std::vector<size_t> invert_permutation(const std::vector<size_t>& permutation) {
+    std::vector<size_t> inverse(permutation.size());
+    for (size_t i = 0; i < permutation.size(); i++) {
+        inverse[permutation[i]] = i;
+    }
+    return inverse;
+}
+
+}
@@ -0,0 +1,71 @@
+#include "handlegraph/algorithms/prefetch.hpp"
+#include "handlegraph/trivially_serializable.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/** \file prefetch.cpp
+ * Implement the prefetching iteration driver.
+ */
+
+namespace handlegraph {
+namespace algorithms {
+
+/// How many bytes of readahead to request from the kernel per call
+static const size_t PREFETCH_CHUNK_BYTES = 8 * 1024 * 1024;
+
+/// How long the helper thread naps when it is far enough ahead
+static const std::chrono::milliseconds PREFETCH_POLL_INTERVAL(1);
+
+bool for_each_handle_prefetching(const HandleGraph* graph,
+                                 const std::function<bool(const handle_t&)>& iteratee,
+                                 size_t readahead_bytes) {
+
+    const TriviallySerializable* mapped = dynamic_cast<const TriviallySerializable*>(graph);
+    size_t total_bytes = mapped != nullptr ? mapped->serialized_size_estimate() : 0;
+    size_t node_count = graph->get_node_count();
+
+    if (total_bytes == 0 || node_count == 0 || readahead_bytes == 0) {
+        // Nothing to read ahead of; just scan.
+        return graph->for_each_handle(iteratee);
+    }
+
+    // How many handles the iteratee has consumed, which is the only
+    // progress signal we have
+    std::atomic<size_t> delivered(0);
+    std::atomic<bool> done(false);
+
+    std::thread helper([&]() {
+        size_t next_offset = 0;
+        while (!done.load() && next_offset < total_bytes) {
+            // Estimate the scan's byte position from its handle progress
+            size_t estimated = (size_t) ((double) total_bytes * (double) delivered.load()
+                                         / (double) node_count);
+            size_t target = std::min(total_bytes, estimated + readahead_bytes);
+            if (next_offset < target) {
+                size_t chunk = std::min(PREFETCH_CHUNK_BYTES, target - next_offset);
+                mapped->prefetch(next_offset, chunk);
+                next_offset += chunk;
+            }
+            else {
+                // Far enough ahead; let the iteratee catch up
+                std::this_thread::sleep_for(PREFETCH_POLL_INTERVAL);
+            }
+        }
+    });
+
+    bool finished = graph->for_each_handle([&](const handle_t& handle) {
+        bool keep_going = iteratee(handle);
+        delivered.fetch_add(1, std::memory_order_relaxed);
+        return keep_going;
+    });
+
+    done.store(true);
+    helper.join();
+    return finished;
+}
+
+}
+}
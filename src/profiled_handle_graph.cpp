@@ -0,0 +1,402 @@
+#include "handlegraph/profiled_handle_graph.hpp"
+
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+/** \file profiled_handle_graph.cpp
+ * Implement the call-counting profiling wrapper
+ */
+
+namespace handlegraph {
+
+namespace {
+
+/// the report name of each profiled method, in Method order
+const char* const method_names[] = {
+    "has_node", "get_handle", "get_id", "get_is_reverse", "flip", "get_length",
+    "get_sequence", "get_node_count", "min_node_id", "max_node_id", "get_degree",
+    "get_edge_count", "get_total_length", "get_base", "get_subsequence",
+    "follow_edges", "for_each_handle",
+    "get_path_count", "has_path", "get_path_handle", "get_path_name",
+    "get_is_circular", "get_step_count", "get_handle_of_step",
+    "get_path_handle_of_step", "path_begin", "path_end", "path_back",
+    "path_front_end", "has_next_step", "has_previous_step", "get_next_step",
+    "get_previous_step", "for_each_path_handle", "for_each_step_on_handle",
+    "create_handle", "create_edge", "apply_orientation", "divide_handle",
+    "optimize", "apply_ordering", "set_id_increment", "reassign_node_ids",
+    "destroy_handle", "destroy_edge", "clear",
+    "destroy_path", "create_path_handle", "append_step", "prepend_step",
+    "rewrite_segment", "set_circularity"
+};
+
+/// complain usefully when a call needs an interface the backing graph lacks
+template<typename Interface>
+Interface& require(Interface* interface_ptr, const char* method) {
+    if (interface_ptr == nullptr) {
+        throw std::runtime_error("error:[ProfiledHandleGraph] backing graph does not support " +
+                                 std::string(method));
+    }
+    return *interface_ptr;
+}
+
+}
+
+/// Scope guard that attributes the enclosing call, and its wall-clock time,
+/// to one method in the calling thread's stripe.
+class ProfiledHandleGraph::Record {
+public:
+    Record(const ProfiledHandleGraph* graph, Method method)
+        : stripe(graph->stripe_for_thread()), method(method),
+          start(std::chrono::steady_clock::now()) {
+        // nothing to do
+    }
+
+    ~Record() {
+        auto stop = std::chrono::steady_clock::now();
+        stripe.calls[method].fetch_add(1, std::memory_order_relaxed);
+        stripe.total_ns[method].fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count(),
+            std::memory_order_relaxed);
+    }
+
+private:
+    CounterStripe& stripe;
+    Method method;
+    std::chrono::steady_clock::time_point start;
+};
+
+ProfiledHandleGraph::ProfiledHandleGraph(HandleGraph* graph)
+    : backing(graph),
+      backing_paths(dynamic_cast<PathHandleGraph*>(graph)),
+      backing_mutable(dynamic_cast<MutableHandleGraph*>(graph)),
+      backing_deletable(dynamic_cast<DeletableHandleGraph*>(graph)),
+      backing_mutable_paths(dynamic_cast<MutablePathHandleGraph*>(graph)),
+      stripes(new CounterStripe[COUNTER_STRIPES]()) {
+    // nothing to do
+}
+
+ProfiledHandleGraph::CounterStripe& ProfiledHandleGraph::stripe_for_thread() const {
+    size_t stripe = std::hash<std::thread::id>()(std::this_thread::get_id()) & (COUNTER_STRIPES - 1);
+    return stripes[stripe];
+}
+
+void ProfiledHandleGraph::report(std::ostream& out) const {
+    out << "method\tcalls\ttotal_ns\tns_per_call" << std::endl;
+    for (size_t method = 0; method < NUM_METHODS; method++) {
+        uint64_t calls = 0;
+        uint64_t total_ns = 0;
+        for (size_t stripe = 0; stripe < COUNTER_STRIPES; stripe++) {
+            calls += stripes[stripe].calls[method].load(std::memory_order_relaxed);
+            total_ns += stripes[stripe].total_ns[method].load(std::memory_order_relaxed);
+        }
+        if (calls > 0) {
+            out << method_names[method] << '\t' << calls << '\t' << total_ns << '\t'
+                << ((double) total_ns / calls) << std::endl;
+        }
+    }
+}
+
+void ProfiledHandleGraph::reset() {
+    for (size_t stripe = 0; stripe < COUNTER_STRIPES; stripe++) {
+        for (size_t method = 0; method < NUM_METHODS; method++) {
+            stripes[stripe].calls[method].store(0, std::memory_order_relaxed);
+            stripes[stripe].total_ns[method].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// HandleGraph interface
+////////////////////////////////////////////////////////////////////////////
+
+bool ProfiledHandleGraph::has_node(nid_t node_id) const {
+    Record record(this, HAS_NODE);
+    return backing->has_node(node_id);
+}
+
+handle_t ProfiledHandleGraph::get_handle(const nid_t& node_id, bool is_reverse) const {
+    Record record(this, GET_HANDLE);
+    return backing->get_handle(node_id, is_reverse);
+}
+
+nid_t ProfiledHandleGraph::get_id(const handle_t& handle) const {
+    Record record(this, GET_ID);
+    return backing->get_id(handle);
+}
+
+bool ProfiledHandleGraph::get_is_reverse(const handle_t& handle) const {
+    Record record(this, GET_IS_REVERSE);
+    return backing->get_is_reverse(handle);
+}
+
+handle_t ProfiledHandleGraph::flip(const handle_t& handle) const {
+    Record record(this, FLIP);
+    return backing->flip(handle);
+}
+
+size_t ProfiledHandleGraph::get_length(const handle_t& handle) const {
+    Record record(this, GET_LENGTH);
+    return backing->get_length(handle);
+}
+
+std::string ProfiledHandleGraph::get_sequence(const handle_t& handle) const {
+    Record record(this, GET_SEQUENCE);
+    return backing->get_sequence(handle);
+}
+
+size_t ProfiledHandleGraph::get_node_count() const {
+    Record record(this, GET_NODE_COUNT);
+    return backing->get_node_count();
+}
+
+nid_t ProfiledHandleGraph::min_node_id() const {
+    Record record(this, MIN_NODE_ID);
+    return backing->min_node_id();
+}
+
+nid_t ProfiledHandleGraph::max_node_id() const {
+    Record record(this, MAX_NODE_ID);
+    return backing->max_node_id();
+}
+
+size_t ProfiledHandleGraph::get_degree(const handle_t& handle, bool go_left) const {
+    Record record(this, GET_DEGREE);
+    return backing->get_degree(handle, go_left);
+}
+
+size_t ProfiledHandleGraph::get_edge_count() const {
+    Record record(this, GET_EDGE_COUNT);
+    return backing->get_edge_count();
+}
+
+size_t ProfiledHandleGraph::get_total_length() const {
+    Record record(this, GET_TOTAL_LENGTH);
+    return backing->get_total_length();
+}
+
+char ProfiledHandleGraph::get_base(const handle_t& handle, size_t index) const {
+    Record record(this, GET_BASE);
+    return backing->get_base(handle, index);
+}
+
+std::string ProfiledHandleGraph::get_subsequence(const handle_t& handle, size_t index, size_t size) const {
+    Record record(this, GET_SUBSEQUENCE);
+    return backing->get_subsequence(handle, index, size);
+}
+
+bool ProfiledHandleGraph::follow_edges_impl(const handle_t& handle, bool go_left,
+                                            function_ref<bool(const handle_t&)> iteratee) const {
+    Record record(this, FOLLOW_EDGES);
+    return backing->follow_edges(handle, go_left, iteratee);
+}
+
+bool ProfiledHandleGraph::for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee,
+                                               bool parallel) const {
+    Record record(this, FOR_EACH_HANDLE);
+    return backing->for_each_handle(iteratee, parallel);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// PathHandleGraph interface
+////////////////////////////////////////////////////////////////////////////
+
+size_t ProfiledHandleGraph::get_path_count() const {
+    Record record(this, GET_PATH_COUNT);
+    return require(backing_paths, "get_path_count").get_path_count();
+}
+
+bool ProfiledHandleGraph::has_path(const std::string& path_name) const {
+    Record record(this, HAS_PATH);
+    return require(backing_paths, "has_path").has_path(path_name);
+}
+
+path_handle_t ProfiledHandleGraph::get_path_handle(const std::string& path_name) const {
+    Record record(this, GET_PATH_HANDLE);
+    return require(backing_paths, "get_path_handle").get_path_handle(path_name);
+}
+
+std::string ProfiledHandleGraph::get_path_name(const path_handle_t& path_handle) const {
+    Record record(this, GET_PATH_NAME);
+    return require(backing_paths, "get_path_name").get_path_name(path_handle);
+}
+
+bool ProfiledHandleGraph::get_is_circular(const path_handle_t& path_handle) const {
+    Record record(this, GET_IS_CIRCULAR);
+    return require(backing_paths, "get_is_circular").get_is_circular(path_handle);
+}
+
+size_t ProfiledHandleGraph::get_step_count(const path_handle_t& path_handle) const {
+    Record record(this, GET_STEP_COUNT);
+    return require(backing_paths, "get_step_count").get_step_count(path_handle);
+}
+
+handle_t ProfiledHandleGraph::get_handle_of_step(const step_handle_t& step_handle) const {
+    Record record(this, GET_HANDLE_OF_STEP);
+    return require(backing_paths, "get_handle_of_step").get_handle_of_step(step_handle);
+}
+
+path_handle_t ProfiledHandleGraph::get_path_handle_of_step(const step_handle_t& step_handle) const {
+    Record record(this, GET_PATH_HANDLE_OF_STEP);
+    return require(backing_paths, "get_path_handle_of_step").get_path_handle_of_step(step_handle);
+}
+
+step_handle_t ProfiledHandleGraph::path_begin(const path_handle_t& path_handle) const {
+    Record record(this, PATH_BEGIN);
+    return require(backing_paths, "path_begin").path_begin(path_handle);
+}
+
+step_handle_t ProfiledHandleGraph::path_end(const path_handle_t& path_handle) const {
+    Record record(this, PATH_END);
+    return require(backing_paths, "path_end").path_end(path_handle);
+}
+
+step_handle_t ProfiledHandleGraph::path_back(const path_handle_t& path_handle) const {
+    Record record(this, PATH_BACK);
+    return require(backing_paths, "path_back").path_back(path_handle);
+}
+
+step_handle_t ProfiledHandleGraph::path_front_end(const path_handle_t& path_handle) const {
+    Record record(this, PATH_FRONT_END);
+    return require(backing_paths, "path_front_end").path_front_end(path_handle);
+}
+
+bool ProfiledHandleGraph::has_next_step(const step_handle_t& step_handle) const {
+    Record record(this, HAS_NEXT_STEP);
+    return require(backing_paths, "has_next_step").has_next_step(step_handle);
+}
+
+bool ProfiledHandleGraph::has_previous_step(const step_handle_t& step_handle) const {
+    Record record(this, HAS_PREVIOUS_STEP);
+    return require(backing_paths, "has_previous_step").has_previous_step(step_handle);
+}
+
+step_handle_t ProfiledHandleGraph::get_next_step(const step_handle_t& step_handle) const {
+    Record record(this, GET_NEXT_STEP);
+    return require(backing_paths, "get_next_step").get_next_step(step_handle);
+}
+
+step_handle_t ProfiledHandleGraph::get_previous_step(const step_handle_t& step_handle) const {
+    Record record(this, GET_PREVIOUS_STEP);
+    return require(backing_paths, "get_previous_step").get_previous_step(step_handle);
+}
+
+bool ProfiledHandleGraph::for_each_path_handle_impl(function_ref<bool(const path_handle_t&)> iteratee) const {
+    Record record(this, FOR_EACH_PATH_HANDLE);
+    return require(backing_paths, "for_each_path_handle").for_each_path_handle(iteratee);
+}
+
+bool ProfiledHandleGraph::for_each_step_on_handle_impl(const handle_t& handle,
+                                                       function_ref<bool(const step_handle_t&)> iteratee) const {
+    Record record(this, FOR_EACH_STEP_ON_HANDLE);
+    return require(backing_paths, "for_each_step_on_handle").for_each_step_on_handle(handle, iteratee);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// MutableHandleGraph interface
+////////////////////////////////////////////////////////////////////////////
+
+handle_t ProfiledHandleGraph::create_handle(const std::string& sequence) {
+    Record record(this, CREATE_HANDLE);
+    return require(backing_mutable, "create_handle").create_handle(sequence);
+}
+
+handle_t ProfiledHandleGraph::create_handle(const std::string& sequence, const nid_t& id) {
+    Record record(this, CREATE_HANDLE);
+    return require(backing_mutable, "create_handle").create_handle(sequence, id);
+}
+
+void ProfiledHandleGraph::create_edge(const handle_t& left, const handle_t& right) {
+    Record record(this, CREATE_EDGE);
+    require(backing_mutable, "create_edge").create_edge(left, right);
+}
+
+handle_t ProfiledHandleGraph::apply_orientation(const handle_t& handle) {
+    Record record(this, APPLY_ORIENTATION);
+    return require(backing_mutable, "apply_orientation").apply_orientation(handle);
+}
+
+std::vector<handle_t> ProfiledHandleGraph::divide_handle(const handle_t& handle,
+                                                         const std::vector<size_t>& offsets) {
+    Record record(this, DIVIDE_HANDLE);
+    return require(backing_mutable, "divide_handle").divide_handle(handle, offsets);
+}
+
+void ProfiledHandleGraph::optimize(bool allow_id_reassignment) {
+    Record record(this, OPTIMIZE);
+    require(backing_mutable, "optimize").optimize(allow_id_reassignment);
+}
+
+bool ProfiledHandleGraph::apply_ordering(const std::vector<handle_t>& order, bool compact_ids) {
+    Record record(this, APPLY_ORDERING);
+    return require(backing_mutable, "apply_ordering").apply_ordering(order, compact_ids);
+}
+
+void ProfiledHandleGraph::set_id_increment(const nid_t& min_id) {
+    Record record(this, SET_ID_INCREMENT);
+    require(backing_mutable, "set_id_increment").set_id_increment(min_id);
+}
+
+void ProfiledHandleGraph::reassign_node_ids(const std::function<nid_t(const nid_t&)>& get_new_id) {
+    Record record(this, REASSIGN_NODE_IDS);
+    require(backing_mutable, "reassign_node_ids").reassign_node_ids(get_new_id);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// DeletableHandleGraph interface
+////////////////////////////////////////////////////////////////////////////
+
+void ProfiledHandleGraph::destroy_handle(const handle_t& handle) {
+    Record record(this, DESTROY_HANDLE);
+    require(backing_deletable, "destroy_handle").destroy_handle(handle);
+}
+
+void ProfiledHandleGraph::destroy_edge(const handle_t& left, const handle_t& right) {
+    Record record(this, DESTROY_EDGE);
+    require(backing_deletable, "destroy_edge").destroy_edge(left, right);
+}
+
+void ProfiledHandleGraph::clear() {
+    Record record(this, CLEAR);
+    require(backing_deletable, "clear").clear();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// MutablePathHandleGraph interface
+////////////////////////////////////////////////////////////////////////////
+
+void ProfiledHandleGraph::destroy_path(const path_handle_t& path_handle) {
+    Record record(this, DESTROY_PATH);
+    require(backing_mutable_paths, "destroy_path").destroy_path(path_handle);
+}
+
+path_handle_t ProfiledHandleGraph::create_path_handle(const std::string& name, bool is_circular) {
+    Record record(this, CREATE_PATH_HANDLE);
+    return require(backing_mutable_paths, "create_path_handle").create_path_handle(name, is_circular);
+}
+
+step_handle_t ProfiledHandleGraph::append_step(const path_handle_t& path, const handle_t& to_append) {
+    Record record(this, APPEND_STEP);
+    return require(backing_mutable_paths, "append_step").append_step(path, to_append);
+}
+
+step_handle_t ProfiledHandleGraph::prepend_step(const path_handle_t& path, const handle_t& to_prepend) {
+    Record record(this, PREPEND_STEP);
+    return require(backing_mutable_paths, "prepend_step").prepend_step(path, to_prepend);
+}
+
+std::pair<step_handle_t, step_handle_t> ProfiledHandleGraph::rewrite_segment(
+    const step_handle_t& segment_begin, const step_handle_t& segment_end,
+    const std::vector<handle_t>& new_segment) {
+    Record record(this, REWRITE_SEGMENT);
+    return require(backing_mutable_paths, "rewrite_segment").rewrite_segment(segment_begin, segment_end,
+                                                                             new_segment);
+}
+
+void ProfiledHandleGraph::set_circularity(const path_handle_t& path, bool circular) {
+    Record record(this, SET_CIRCULARITY);
+    require(backing_mutable_paths, "set_circularity").set_circularity(path, circular);
+}
+
+}
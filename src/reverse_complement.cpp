@@ -1,6 +1,9 @@
 #include "handlegraph/algorithms/reverse_complement.hpp"
 
+#include "handlegraph/sequence.hpp"
+
 #include <unordered_map>
+#include <vector>
 
 namespace handlegraph {
 namespace algorithms {
@@ -14,9 +17,10 @@ void reverse_complement_graph(const HandleGraph* source, MutableHandleGraph* int
         exit(1);
     }
     
-    // make the nodes in reverse orientation
+    // make the nodes in reverse orientation, flipping the sequences with the
+    // shared kernel rather than asking the backend for the reverse strand
     source->for_each_handle([&](const handle_t& handle) {
-        into->create_handle(source->get_sequence(source->flip(handle)),
+        into->create_handle(reverse_complement(source->get_sequence(handle)),
                             source->get_id(handle));
     });
     
@@ -32,5 +36,21 @@ void reverse_complement_graph(const HandleGraph* source, MutableHandleGraph* int
         return true;
     });
 }
+
+void reverse_complement_graph_in_place(MutableHandleGraph* graph) {
+
+    // snapshot the nodes, since applying orientations invalidates handles
+    vector<handle_t> handles;
+    handles.reserve(graph->get_node_count());
+    graph->for_each_handle([&](const handle_t& handle) {
+        handles.push_back(handle);
+    });
+
+    // make the reverse orientation of each node its forward orientation; the
+    // backend rewrites the edges to match
+    for (const handle_t& handle : handles) {
+        graph->apply_orientation(graph->flip(handle));
+    }
+}
 }
 }
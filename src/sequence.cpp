@@ -0,0 +1,80 @@
+#include "handlegraph/sequence.hpp"
+
+/** \file sequence.cpp
+ * Implement the shared sequence utilities.
+ */
+
+namespace handlegraph {
+
+// Build the complement table: identity everywhere except the IUPAC codes.
+static constexpr char make_complement_entry(unsigned char c) {
+    return c == 'A' ? 'T' : c == 'a' ? 't' :
+           c == 'C' ? 'G' : c == 'c' ? 'g' :
+           c == 'G' ? 'C' : c == 'g' ? 'c' :
+           c == 'T' ? 'A' : c == 't' ? 'a' :
+           c == 'U' ? 'A' : c == 'u' ? 'a' :
+           c == 'R' ? 'Y' : c == 'r' ? 'y' :
+           c == 'Y' ? 'R' : c == 'y' ? 'r' :
+           c == 'K' ? 'M' : c == 'k' ? 'm' :
+           c == 'M' ? 'K' : c == 'm' ? 'k' :
+           c == 'B' ? 'V' : c == 'b' ? 'v' :
+           c == 'D' ? 'H' : c == 'd' ? 'h' :
+           c == 'H' ? 'D' : c == 'h' ? 'd' :
+           c == 'V' ? 'B' : c == 'v' ? 'b' :
+           (char) c;
+}
+
+#define HANDLEGRAPH_COMPLEMENT_16(base) \
+    make_complement_entry(base), make_complement_entry(base + 1), \
+    make_complement_entry(base + 2), make_complement_entry(base + 3), \
+    make_complement_entry(base + 4), make_complement_entry(base + 5), \
+    make_complement_entry(base + 6), make_complement_entry(base + 7), \
+    make_complement_entry(base + 8), make_complement_entry(base + 9), \
+    make_complement_entry(base + 10), make_complement_entry(base + 11), \
+    make_complement_entry(base + 12), make_complement_entry(base + 13), \
+    make_complement_entry(base + 14), make_complement_entry(base + 15)
+
+const char complement_table[256] = {
+    HANDLEGRAPH_COMPLEMENT_16(0),   HANDLEGRAPH_COMPLEMENT_16(16),
+    HANDLEGRAPH_COMPLEMENT_16(32),  HANDLEGRAPH_COMPLEMENT_16(48),
+    HANDLEGRAPH_COMPLEMENT_16(64),  HANDLEGRAPH_COMPLEMENT_16(80),
+    HANDLEGRAPH_COMPLEMENT_16(96),  HANDLEGRAPH_COMPLEMENT_16(112),
+    HANDLEGRAPH_COMPLEMENT_16(128), HANDLEGRAPH_COMPLEMENT_16(144),
+    HANDLEGRAPH_COMPLEMENT_16(160), HANDLEGRAPH_COMPLEMENT_16(176),
+    HANDLEGRAPH_COMPLEMENT_16(192), HANDLEGRAPH_COMPLEMENT_16(208),
+    HANDLEGRAPH_COMPLEMENT_16(224), HANDLEGRAPH_COMPLEMENT_16(240)
+};
+
+#undef HANDLEGRAPH_COMPLEMENT_16
+
+void reverse_complement(const char* src, char* dst, size_t length) {
+    // read the source backwards in one forward pass over the destination, so
+    // the loop stays trivially unrollable
+    for (size_t i = 0; i < length; i++) {
+        dst[i] = complement_table[(unsigned char) src[length - 1 - i]];
+    }
+}
+
+std::string reverse_complement(const std::string& sequence) {
+    std::string rev_comp(sequence.size(), '\0');
+    reverse_complement(sequence.data(), &rev_comp[0], sequence.size());
+    return rev_comp;
+}
+
+void reverse_complement_in_place(std::string& sequence) {
+    size_t i = 0;
+    size_t j = sequence.size();
+    while (i + 1 < j) {
+        j--;
+        char tmp = complement_table[(unsigned char) sequence[i]];
+        sequence[i] = complement_table[(unsigned char) sequence[j]];
+        sequence[j] = tmp;
+        i++;
+    }
+    if (i < j) {
+        // complement the middle base of an odd-length sequence
+        sequence[i] = complement_table[(unsigned char) sequence[i]];
+    }
+}
+
+}
@@ -1,4 +1,5 @@
 #include "handlegraph/serializable.hpp"
+#include "handlegraph/compressed_serialization.hpp"
 
 #include <fstream>
 #include <arpa/inet.h>
@@ -38,6 +39,13 @@ void Serializable::deserialize(std::istream& in) {
     in.read(magic_bytes, 4);
     
     uint32_t magic_number = ntohl(*((uint32_t*) magic_bytes));
+    if (magic_number == COMPRESSED_CONTAINER_MAGIC) {
+        // This is the compressed container; the object itself, with its own
+        // magic number, is framed and compressed inside it.
+        CompressedIstream decompressed(in);
+        deserialize(decompressed);
+        return;
+    }
     if (magic_number != get_magic_number()) {
         // They don't look right for what we are loading.
         // This could be an old file, or we could have been given the wrong kind of thing to load.
@@ -63,6 +71,38 @@ void Serializable::deserialize(const std::string& filename) {
     deserialize(in);
 }
 
+void Serializable::serialize_compressed(std::ostream& out) const {
+    uint32_t magic_number = htonl(COMPRESSED_CONTAINER_MAGIC);
+    out.write((char*) &magic_number, sizeof(magic_number) / sizeof(char));
+    CompressedOstream compressed(out);
+    serialize(compressed);
+    compressed.finish();
+}
+
+void Serializable::serialize_compressed(const std::string& filename) const {
+    std::ofstream out(filename);
+    serialize_compressed(out);
+}
+
+std::vector<std::pair<std::string, size_t>> Serializable::memory_usage() const {
+    // By default we don't know anything about our own composition
+    return {};
+}
+
+size_t Serializable::total_memory_usage() const {
+    size_t total = 0;
+    for (auto& component : memory_usage()) {
+        total += component.second;
+    }
+    return total;
+}
+
+size_t Serializable::serialized_size_estimate() const {
+    // Without better information, assume the serialized form is about the
+    // size of the object, plus the magic number.
+    return sizeof(uint32_t) + total_memory_usage();
+}
+
 }
 
 
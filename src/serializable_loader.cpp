@@ -0,0 +1,94 @@
+#include "handlegraph/serializable_loader.hpp"
+#include "handlegraph/compressed_serialization.hpp"
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <arpa/inet.h>
+
+/** \file serializable_loader.cpp
+ * Implement the magic number loader registry
+ */
+
+namespace handlegraph {
+
+namespace {
+
+/// Protects the registry. Function-local so registration from static
+/// initializers works regardless of initialization order.
+std::mutex& registry_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+/// The registered factories by magic number.
+std::unordered_map<uint32_t, SerializableFactory>& registry() {
+    static std::unordered_map<uint32_t, SerializableFactory> factories;
+    return factories;
+}
+
+}
+
+void register_loader(uint32_t magic_number, SerializableFactory factory) {
+    std::lock_guard<std::mutex> guard(registry_mutex());
+    registry()[magic_number] = std::move(factory);
+}
+
+std::unique_ptr<Serializable> open(const std::string& filename) {
+    // sniff the leading magic number
+    char magic_bytes[4];
+    {
+        std::ifstream in(filename);
+        if (!in) {
+            throw std::runtime_error("error:[handlegraph::open] could not read " + filename);
+        }
+        in.read(magic_bytes, 4);
+        if (!in) {
+            throw std::runtime_error("error:[handlegraph::open] " + filename +
+                                     " is too short to hold a magic number");
+        }
+    }
+    uint32_t magic_number = ntohl(*((uint32_t*) magic_bytes));
+    if (magic_number == COMPRESSED_CONTAINER_MAGIC) {
+        // the object's own magic number is compressed inside the container;
+        // sniff it out of the first chunk
+        std::ifstream in(filename);
+        in.seekg(sizeof(magic_bytes));
+        CompressedIstream decompressed(in);
+        decompressed.read(magic_bytes, 4);
+        if (!decompressed) {
+            throw std::runtime_error("error:[handlegraph::open] compressed container in " + filename +
+                                     " is too short to hold a magic number");
+        }
+        magic_number = ntohl(*((uint32_t*) magic_bytes));
+    }
+
+    SerializableFactory factory;
+    {
+        std::lock_guard<std::mutex> guard(registry_mutex());
+        auto found = registry().find(magic_number);
+        if (found == registry().end()) {
+            // report the magic both ways since they are usually ASCII tags
+            std::stringstream message;
+            message << "error:[handlegraph::open] no loader registered for magic number 0x"
+                    << std::hex << magic_number << " (\"";
+            for (char magic_byte : magic_bytes) {
+                message << (isprint(magic_byte) ? magic_byte : '.');
+            }
+            message << "\") leading " << filename;
+            throw std::runtime_error(message.str());
+        }
+        factory = found->second;
+    }
+
+    std::unique_ptr<Serializable> loaded = factory();
+    // the implementation's own file deserialization picks the best path: a
+    // TriviallySerializable will go through its file descriptor mapping
+    // instead of streaming a copy
+    loaded->deserialize(filename);
+    return loaded;
+}
+
+}
@@ -0,0 +1,351 @@
+#include "handlegraph/sharded_serializable.hpp"
+
+#include "handlegraph/parallel.hpp"
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+/** \file sharded_serializable.cpp
+ * Implement the parallel sharded serialization paths
+ */
+
+namespace handlegraph {
+
+namespace {
+
+/// How much data the shard streams buffer between pwrite/pread calls
+const size_t IO_BUFFER_SIZE = 1024 * 1024;
+
+/// Bang on pwrite until everything is written. Returns false and fills in
+/// message on failure.
+bool pwrite_all(int fd, const char* start, size_t length, uint64_t offset, std::string& message) {
+    size_t written = 0;
+    while (written != length) {
+        auto result = ::pwrite(fd, start + written, length - written, offset + written);
+        if (result == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            message = std::string("Could not write: ") + ::strerror(errno);
+            return false;
+        }
+        written += result;
+    }
+    return true;
+}
+
+/// Bang on pread until everything is read. Returns false and fills in
+/// message on failure or early EOF.
+bool pread_all(int fd, char* start, size_t length, uint64_t offset, std::string& message) {
+    size_t seen = 0;
+    while (seen != length) {
+        auto result = ::pread(fd, start + seen, length - seen, offset + seen);
+        if (result == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            message = std::string("Could not read: ") + ::strerror(errno);
+            return false;
+        }
+        if (result == 0) {
+            message = "Could not read: unexpected end of file";
+            return false;
+        }
+        seen += result;
+    }
+    return true;
+}
+
+/// An output streambuf that lands its bytes in a file descriptor with pwrite
+/// at a fixed base offset, so several can write one file concurrently.
+/// Failures set an error message and make the owning stream go bad instead
+/// of throwing out of the streambuf.
+class PwriteBuf : public std::streambuf {
+
+public:
+
+    PwriteBuf(int fd, uint64_t offset) : fd(fd), offset(offset), buffer(IO_BUFFER_SIZE) {
+        setp(buffer.data(), buffer.data() + buffer.size());
+    }
+
+    /// total bytes pushed to the file so far (after a flush)
+    uint64_t bytes_written = 0;
+    /// what went wrong, if anything
+    std::string error_message;
+
+protected:
+
+    int overflow(int c) {
+        if (!flush_buffer()) {
+            return traits_type::eof();
+        }
+        if (c != traits_type::eof()) {
+            return sputc(c);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    int sync() {
+        return flush_buffer() ? 0 : -1;
+    }
+
+private:
+
+    bool flush_buffer() {
+        size_t have = pptr() - pbase();
+        if (have != 0) {
+            if (!pwrite_all(fd, pbase(), have, offset, error_message)) {
+                return false;
+            }
+            offset += have;
+            bytes_written += have;
+            setp(buffer.data(), buffer.data() + buffer.size());
+        }
+        return true;
+    }
+
+    int fd;
+    uint64_t offset;
+    std::vector<char> buffer;
+};
+
+/// An input streambuf over one shard's window of a file descriptor, filled
+/// with pread so several can read one file concurrently. Hits EOF at the end
+/// of the window; failures set an error message.
+class PreadBuf : public std::streambuf {
+
+public:
+
+    PreadBuf(int fd, uint64_t offset, uint64_t size)
+        : fd(fd), cursor(offset), end(offset + size), buffer(IO_BUFFER_SIZE) {
+        // nothing buffered until the first read
+    }
+
+    /// what went wrong, if anything
+    std::string error_message;
+
+protected:
+
+    int underflow() {
+        if (gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
+        if (cursor == end) {
+            return traits_type::eof();
+        }
+        size_t to_read = std::min<uint64_t>(buffer.size(), end - cursor);
+        if (!pread_all(fd, buffer.data(), to_read, cursor, error_message)) {
+            return traits_type::eof();
+        }
+        cursor += to_read;
+        setg(buffer.data(), buffer.data(), buffer.data() + to_read);
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+
+    int fd;
+    uint64_t cursor;
+    uint64_t end;
+    std::vector<char> buffer;
+};
+
+/// Remember the first of possibly many concurrent failures.
+class FirstError {
+
+public:
+
+    void record(const std::string& message) {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (!failed) {
+            failed = true;
+            first_message = message;
+        }
+    }
+
+    /// throw if anything was recorded
+    void check() const {
+        if (failed) {
+            throw std::runtime_error(first_message);
+        }
+    }
+
+private:
+
+    std::mutex mutex;
+    bool failed = false;
+    std::string first_message;
+};
+
+}
+
+void ShardedSerializable::serialize_sharded(int fd, size_t thread_count) const {
+    size_t shard_count = get_shard_count();
+
+    // lay the file out: magic, shard count, shard sizes, then the shards
+    std::vector<uint64_t> sizes(shard_count);
+    for (size_t i = 0; i < shard_count; i++) {
+        sizes[i] = get_shard_size(i);
+    }
+    std::vector<char> header(sizeof(uint32_t) + sizeof(uint64_t) * (1 + shard_count));
+    uint32_t magic_number = htonl(get_magic_number());
+    memcpy(header.data(), &magic_number, sizeof(magic_number));
+    uint64_t shard_count_word = shard_count;
+    memcpy(header.data() + sizeof(uint32_t), &shard_count_word, sizeof(shard_count_word));
+    memcpy(header.data() + sizeof(uint32_t) + sizeof(uint64_t), sizes.data(),
+           sizeof(uint64_t) * shard_count);
+
+    std::vector<uint64_t> offsets(shard_count);
+    uint64_t cursor = header.size();
+    for (size_t i = 0; i < shard_count; i++) {
+        offsets[i] = cursor;
+        cursor += sizes[i];
+    }
+
+    // claim exactly the right length, dropping any longer old contents
+    if (::ftruncate(fd, cursor) != 0) {
+        throw std::runtime_error(std::string("Could not size file: ") + ::strerror(errno));
+    }
+
+    std::string header_problem;
+    if (!pwrite_all(fd, header.data(), header.size(), 0, header_problem)) {
+        throw std::runtime_error(header_problem);
+    }
+
+    // write the shards concurrently at their distinct offsets
+    FirstError errors;
+    parallel_for(shard_count, [&](size_t shard) {
+        try {
+            PwriteBuf buf(fd, offsets[shard]);
+            std::ostream out(&buf);
+            serialize_shard(shard, out);
+            out.flush();
+            if (!out || !buf.error_message.empty()) {
+                errors.record(buf.error_message.empty() ?
+                              "Could not write shard " + std::to_string(shard) : buf.error_message);
+            }
+            else if (buf.bytes_written != sizes[shard]) {
+                errors.record("Shard " + std::to_string(shard) + " wrote " +
+                              std::to_string(buf.bytes_written) + " bytes but declared " +
+                              std::to_string(sizes[shard]));
+            }
+        }
+        catch (std::exception& e) {
+            errors.record(e.what());
+        }
+    }, thread_count);
+    errors.check();
+}
+
+void ShardedSerializable::deserialize_sharded(int fd, size_t thread_count) {
+    // read back the layout
+    char magic_bytes[4];
+    std::string header_problem;
+    if (!pread_all(fd, magic_bytes, sizeof(magic_bytes), 0, header_problem)) {
+        throw std::runtime_error(header_problem);
+    }
+    uint32_t magic_number = ntohl(*((uint32_t*) magic_bytes));
+    if (magic_number != get_magic_number()) {
+        throw std::runtime_error("Serialized object does not match the type being loaded into");
+    }
+    uint64_t shard_count;
+    if (!pread_all(fd, (char*) &shard_count, sizeof(shard_count), sizeof(magic_bytes), header_problem)) {
+        throw std::runtime_error(header_problem);
+    }
+    std::vector<uint64_t> sizes(shard_count);
+    if (!pread_all(fd, (char*) sizes.data(), sizeof(uint64_t) * shard_count,
+                   sizeof(magic_bytes) + sizeof(shard_count), header_problem)) {
+        throw std::runtime_error(header_problem);
+    }
+    std::vector<uint64_t> offsets(shard_count);
+    uint64_t cursor = sizeof(magic_bytes) + sizeof(uint64_t) * (1 + shard_count);
+    for (size_t i = 0; i < shard_count; i++) {
+        offsets[i] = cursor;
+        cursor += sizes[i];
+    }
+
+    // load the shards concurrently from their windows
+    FirstError errors;
+    parallel_for(shard_count, [&](size_t shard) {
+        try {
+            PreadBuf buf(fd, offsets[shard], sizes[shard]);
+            std::istream in(&buf);
+            deserialize_shard(shard, in);
+            if (in.bad() || !buf.error_message.empty()) {
+                errors.record(buf.error_message.empty() ?
+                              "Could not read shard " + std::to_string(shard) : buf.error_message);
+            }
+        }
+        catch (std::exception& e) {
+            errors.record(e.what());
+        }
+    }, thread_count);
+    errors.check();
+}
+
+void ShardedSerializable::serialize_sharded(const std::string& filename, size_t thread_count) const {
+    int fd = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd == -1) {
+        throw std::runtime_error("Could not save to file " + filename + ": " + ::strerror(errno));
+    }
+    serialize_sharded(fd, thread_count);
+    if (::close(fd) != 0) {
+        throw std::runtime_error(std::string("Could not close FD: ") + ::strerror(errno));
+    }
+}
+
+void ShardedSerializable::deserialize_sharded(const std::string& filename, size_t thread_count) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error("Could not load from file " + filename + ": " + ::strerror(errno));
+    }
+    deserialize_sharded(fd, thread_count);
+    if (::close(fd) != 0) {
+        throw std::runtime_error(std::string("Could not close FD: ") + ::strerror(errno));
+    }
+}
+
+size_t ShardedSerializable::serialized_size_estimate() const {
+    size_t shard_count = get_shard_count();
+    // magic number, shard count, shard size table, then the shards
+    size_t total = sizeof(uint32_t) + sizeof(uint64_t) * (1 + shard_count);
+    for (size_t i = 0; i < shard_count; i++) {
+        total += get_shard_size(i);
+    }
+    return total;
+}
+
+void ShardedSerializable::serialize_members(std::ostream& out) const {
+    // same bytes as the file descriptor path writes after the magic number
+    uint64_t shard_count = get_shard_count();
+    out.write((char*) &shard_count, sizeof(shard_count));
+    std::vector<uint64_t> sizes(shard_count);
+    for (size_t i = 0; i < shard_count; i++) {
+        sizes[i] = get_shard_size(i);
+    }
+    out.write((char*) sizes.data(), sizeof(uint64_t) * shard_count);
+    for (size_t i = 0; i < shard_count; i++) {
+        serialize_shard(i, out);
+    }
+}
+
+void ShardedSerializable::deserialize_members(std::istream& in) {
+    uint64_t shard_count;
+    in.read((char*) &shard_count, sizeof(shard_count));
+    std::vector<uint64_t> sizes(shard_count);
+    in.read((char*) sizes.data(), sizeof(uint64_t) * shard_count);
+    for (size_t i = 0; i < shard_count; i++) {
+        deserialize_shard(i, in);
+    }
+}
+
+}
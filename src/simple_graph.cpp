@@ -0,0 +1,912 @@
+#include "handlegraph/simple_graph.hpp"
+
+#include "handlegraph/parallel.hpp"
+#include "handlegraph/permutation.hpp"
+#include "handlegraph/util.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <unordered_set>
+
+/** \file simple_graph.cpp
+ * Implement the in-library concrete mutable path handle graph
+ */
+
+namespace handlegraph {
+
+namespace {
+
+/// the 2-bit code for a base, or -1 if the base can't be packed
+inline int base_code(char base) {
+    switch (base) {
+        case 'A': case 'a': return 0;
+        case 'C': case 'c': return 1;
+        case 'G': case 'g': return 2;
+        case 'T': case 't': return 3;
+        default: return -1;
+    }
+}
+
+/// the base for a 2-bit code
+const char code_to_base[4] = {'A', 'C', 'G', 'T'};
+
+/// the complement of a base, leaving unrecognized characters alone
+inline char complement_base(char base) {
+    switch (base) {
+        case 'A': return 'T';
+        case 'a': return 't';
+        case 'C': return 'G';
+        case 'c': return 'g';
+        case 'G': return 'C';
+        case 'g': return 'c';
+        case 'T': return 'A';
+        case 't': return 'a';
+        default: return base;
+    }
+}
+
+/// the reverse complement of a sequence
+std::string reverse_complement(const std::string& sequence) {
+    std::string rc(sequence.size(), '\0');
+    for (size_t i = 0; i < sequence.size(); i++) {
+        rc[i] = complement_base(sequence[sequence.size() - 1 - i]);
+    }
+    return rc;
+}
+
+/// remove the first occurrence of a handle from an edge list
+inline void remove_first(std::vector<handle_t>& edge_list, const handle_t& handle) {
+    auto found = std::find(edge_list.begin(), edge_list.end(), handle);
+    if (found != edge_list.end()) {
+        edge_list.erase(found);
+    }
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////
+// HandleGraph interface
+////////////////////////////////////////////////////////////////////////////
+
+bool SimpleGraph::has_node(nid_t node_id) const {
+    return id_to_index.count(node_id);
+}
+
+handle_t SimpleGraph::get_handle(const nid_t& node_id, bool is_reverse) const {
+    return number_bool_packing::pack(id_to_index.at(node_id), is_reverse);
+}
+
+nid_t SimpleGraph::get_id(const handle_t& handle) const {
+    return nodes[index_of(handle)].id;
+}
+
+bool SimpleGraph::get_is_reverse(const handle_t& handle) const {
+    return number_bool_packing::unpack_bit(handle);
+}
+
+handle_t SimpleGraph::flip(const handle_t& handle) const {
+    return number_bool_packing::toggle_bit(handle);
+}
+
+size_t SimpleGraph::get_length(const handle_t& handle) const {
+    return nodes[index_of(handle)].length;
+}
+
+std::string SimpleGraph::get_sequence(const handle_t& handle) const {
+    const Node& node = nodes[index_of(handle)];
+    std::string sequence;
+    if (node.packable) {
+        sequence.resize(node.length);
+        for (size_t i = 0; i < node.length; i++) {
+            sequence[i] = code_to_base[(node.packed[i / 4] >> (2 * (i % 4))) & 3];
+        }
+    }
+    else {
+        sequence = node.overflow;
+    }
+    if (get_is_reverse(handle)) {
+        sequence = reverse_complement(sequence);
+    }
+    return sequence;
+}
+
+size_t SimpleGraph::get_node_count() const {
+    return live_node_count;
+}
+
+nid_t SimpleGraph::min_node_id() const {
+    return lowest_id;
+}
+
+nid_t SimpleGraph::max_node_id() const {
+    return highest_id;
+}
+
+size_t SimpleGraph::get_degree(const handle_t& handle, bool go_left) const {
+    return successors_of(go_left ? flip(handle) : handle).size();
+}
+
+bool SimpleGraph::follow_edges_impl(const handle_t& handle, bool go_left,
+                                    function_ref<bool(const handle_t&)> iteratee) const {
+    // the left-side neighbors of a handle are the flipped successors of its flip
+    for (const handle_t& next : successors_of(go_left ? flip(handle) : handle)) {
+        if (!iteratee(go_left ? flip(next) : next)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SimpleGraph::for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee,
+                                       bool parallel) const {
+    if (parallel) {
+        return parallel_for(nodes.size(), [&](size_t i) {
+            if (!nodes[i].alive) {
+                return true;
+            }
+            return iteratee(number_bool_packing::pack(i, false));
+        });
+    }
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i].alive && !iteratee(number_bool_packing::pack(i, false))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// MutableHandleGraph interface
+////////////////////////////////////////////////////////////////////////////
+
+handle_t SimpleGraph::create_handle(const std::string& sequence) {
+    return number_bool_packing::pack(add_node(sequence, next_id), false);
+}
+
+handle_t SimpleGraph::create_handle(const std::string& sequence, const nid_t& id) {
+    if (id_to_index.count(id)) {
+        throw std::runtime_error("error:[SimpleGraph] node ID " + std::to_string(id) +
+                                 " is already in the graph");
+    }
+    return number_bool_packing::pack(add_node(sequence, id), false);
+}
+
+void SimpleGraph::create_edge(const handle_t& left, const handle_t& right) {
+    std::vector<handle_t>& from_list = successors_of(left);
+    if (std::find(from_list.begin(), from_list.end(), right) != from_list.end()) {
+        // the edge is already here
+        return;
+    }
+    from_list.push_back(right);
+    if (right != flip(left)) {
+        // the reciprocal record lives in a different list; a reversing
+        // self-loop's two records would coincide, so it gets only one
+        successors_of(flip(right)).push_back(flip(left));
+    }
+}
+
+handle_t SimpleGraph::apply_orientation(const handle_t& handle) {
+    if (!get_is_reverse(handle)) {
+        // nothing to do
+        return handle;
+    }
+    size_t index = index_of(handle);
+    handle_t fwd = number_bool_packing::pack(index, false);
+
+    // turn the stored sequence around
+    std::string sequence = get_sequence(fwd);
+    store_sequence(nodes[index], reverse_complement(sequence));
+
+    // flip every stored reference to this node, in its neighbors' lists and
+    // its own (for self-loops)
+    std::unordered_set<size_t> holders{index};
+    for (const handle_t& entry : nodes[index].left_edges) {
+        holders.insert(index_of(entry));
+    }
+    for (const handle_t& entry : nodes[index].right_edges) {
+        holders.insert(index_of(entry));
+    }
+    for (size_t holder : holders) {
+        for (std::vector<handle_t>* edge_list : {&nodes[holder].left_edges, &nodes[holder].right_edges}) {
+            for (handle_t& entry : *edge_list) {
+                if (index_of(entry) == index) {
+                    entry = flip(entry);
+                }
+            }
+        }
+    }
+    // the old reverse's successors are the new forward's
+    std::swap(nodes[index].left_edges, nodes[index].right_edges);
+
+    // as documented, stored paths are not updated
+    return fwd;
+}
+
+std::vector<handle_t> SimpleGraph::divide_handle(const handle_t& handle, const std::vector<size_t>& offsets) {
+    size_t index = index_of(handle);
+    bool is_rev = get_is_reverse(handle);
+    size_t length = nodes[index].length;
+    std::string forward_seq = get_sequence(number_bool_packing::pack(index, false));
+
+    // translate the cut points onto the forward strand
+    std::vector<size_t> cuts;
+    cuts.reserve(offsets.size());
+    for (const size_t& offset : offsets) {
+        size_t cut = is_rev ? length - offset : offset;
+        if (cut > 0 && cut < length) {
+            cuts.push_back(cut);
+        }
+    }
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+    cuts.push_back(length);
+
+    // make the pieces, in forward order with fresh IDs
+    std::vector<size_t> piece_indexes;
+    piece_indexes.reserve(cuts.size());
+    size_t piece_start = 0;
+    for (const size_t& cut : cuts) {
+        piece_indexes.push_back(add_node(forward_seq.substr(piece_start, cut - piece_start), next_id));
+        piece_start = cut;
+    }
+    size_t piece_count = piece_indexes.size();
+
+    handle_t old_fwd = number_bool_packing::pack(index, false);
+    handle_t old_rev = number_bool_packing::pack(index, true);
+    // an edge into the old forward now enters the first piece; an edge into
+    // the old reverse now enters the last piece. The two records of any edge
+    // both rewrite consistently under this rule.
+    handle_t first_fwd = number_bool_packing::pack(piece_indexes.front(), false);
+    handle_t last_rev = number_bool_packing::pack(piece_indexes.back(), true);
+
+    std::unordered_set<size_t> holders{index};
+    for (const handle_t& entry : nodes[index].left_edges) {
+        holders.insert(index_of(entry));
+    }
+    for (const handle_t& entry : nodes[index].right_edges) {
+        holders.insert(index_of(entry));
+    }
+    for (size_t holder : holders) {
+        for (std::vector<handle_t>* edge_list : {&nodes[holder].left_edges, &nodes[holder].right_edges}) {
+            for (handle_t& entry : *edge_list) {
+                if (entry == old_fwd) {
+                    entry = first_fwd;
+                }
+                else if (entry == old_rev) {
+                    entry = last_rev;
+                }
+            }
+        }
+    }
+    // the old endpoint edges move onto the end pieces, and the pieces chain up
+    nodes[piece_indexes.front()].left_edges = std::move(nodes[index].left_edges);
+    nodes[piece_indexes.back()].right_edges = std::move(nodes[index].right_edges);
+    nodes[index].left_edges.clear();
+    nodes[index].right_edges.clear();
+    for (size_t i = 0; i + 1 < piece_count; i++) {
+        create_edge(number_bool_packing::pack(piece_indexes[i], false),
+                    number_bool_packing::pack(piece_indexes[i + 1], false));
+    }
+
+    // splice the pieces into every path step on the old node, keeping the
+    // step's slot for its first piece so surrounding steps stay linked
+    std::vector<size_t> old_slots = nodes[index].step_slots;
+    for (const size_t& slot : old_slots) {
+        bool step_rev = get_is_reverse(steps[slot].handle);
+        // the pieces in the step's orientation and path order
+        auto piece_in_path = [&](size_t i) {
+            return step_rev ? number_bool_packing::pack(piece_indexes[piece_count - 1 - i], true)
+                            : number_bool_packing::pack(piece_indexes[i], false);
+        };
+        int64_t path_index = steps[slot].path;
+        int64_t old_next = steps[slot].next;
+        steps[slot].handle = piece_in_path(0);
+        nodes[index_of(steps[slot].handle)].step_slots.push_back(slot);
+        int64_t prev_slot = slot;
+        for (size_t i = 1; i < piece_count; i++) {
+            size_t new_slot = new_step_slot(path_index, piece_in_path(i));
+            steps[new_slot].prev = prev_slot;
+            steps[prev_slot].next = new_slot;
+            prev_slot = new_slot;
+        }
+        steps[prev_slot].next = old_next;
+        if (old_next != -1) {
+            steps[old_next].prev = prev_slot;
+        }
+        Path& path = paths[path_index];
+        if (path.tail == (int64_t) slot) {
+            path.tail = prev_slot;
+        }
+        path.step_count += piece_count - 1;
+    }
+
+    // retire the old node
+    id_to_index.erase(nodes[index].id);
+    nodes[index] = Node();
+    live_node_count--;
+
+    // hand back the pieces in the orientation we were asked in
+    std::vector<handle_t> to_return;
+    to_return.reserve(piece_count);
+    for (size_t i = 0; i < piece_count; i++) {
+        to_return.push_back(is_rev ? number_bool_packing::pack(piece_indexes[piece_count - 1 - i], true)
+                                   : number_bool_packing::pack(piece_indexes[i], false));
+    }
+    return to_return;
+}
+
+void SimpleGraph::optimize(bool allow_id_reassignment) {
+    // squeeze out the node tombstones
+    std::vector<size_t> new_index(nodes.size(), std::numeric_limits<size_t>::max());
+    size_t next_index = 0;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i].alive) {
+            new_index[i] = next_index++;
+        }
+    }
+    reindex_nodes(std::move(new_index));
+
+    if (allow_id_reassignment) {
+        renumber_ids_dense();
+    }
+
+    // give back the node table's and the edge lists' slack
+    nodes.shrink_to_fit();
+    for (Node& node : nodes) {
+        node.left_edges.shrink_to_fit();
+        node.right_edges.shrink_to_fit();
+        node.step_slots.shrink_to_fit();
+    }
+}
+
+optimize_report_t SimpleGraph::optimize_with_report(bool allow_id_reassignment) {
+    optimize_report_t report;
+    // records only move if there are tombstones to squeeze out
+    report.reordered_storage = live_node_count != nodes.size();
+    if (allow_id_reassignment) {
+        // compaction keeps the live nodes' relative order, so renumbering
+        // changes something iff the IDs aren't already 1..n in that order
+        nid_t next = 1;
+        for (const Node& node : nodes) {
+            if (node.alive && node.id != next++) {
+                report.reassigned_ids = true;
+                break;
+            }
+        }
+    }
+    optimize(allow_id_reassignment);
+    return report;
+}
+
+bool SimpleGraph::apply_ordering(const std::vector<handle_t>& order, bool compact_ids) {
+    std::vector<size_t> new_index(nodes.size(), std::numeric_limits<size_t>::max());
+    for (size_t i = 0; i < order.size(); i++) {
+        new_index[index_of(order[i])] = i;
+    }
+    reindex_nodes(std::move(new_index));
+    if (compact_ids) {
+        renumber_ids_dense();
+    }
+    return true;
+}
+
+void SimpleGraph::set_id_increment(const nid_t& min_id) {
+    next_id = std::max(next_id, min_id);
+}
+
+void SimpleGraph::reassign_node_ids(const std::function<nid_t(const nid_t&)>& get_new_id) {
+    id_to_index.clear();
+    next_id = 1;
+    lowest_id = 0;
+    highest_id = 0;
+    size_t seen = 0;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (!nodes[i].alive) {
+            continue;
+        }
+        nodes[i].id = get_new_id(nodes[i].id);
+        id_to_index[nodes[i].id] = i;
+        if (seen++ == 0) {
+            lowest_id = highest_id = nodes[i].id;
+        }
+        else {
+            lowest_id = std::min(lowest_id, nodes[i].id);
+            highest_id = std::max(highest_id, nodes[i].id);
+        }
+        next_id = std::max(next_id, nodes[i].id + 1);
+    }
+}
+
+void SimpleGraph::reserve(size_t node_count, size_t edge_count, size_t total_bp) {
+    // edges and bases are stored per node, so only the node tables can be
+    // preallocated
+    nodes.reserve(nodes.size() + node_count);
+    id_to_index.reserve(id_to_index.size() + node_count);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// DeletableHandleGraph interface
+////////////////////////////////////////////////////////////////////////////
+
+void SimpleGraph::destroy_handle(const handle_t& handle) {
+    size_t index = index_of(handle);
+
+    // drop the records pointing back at this node from its neighbors
+    std::unordered_set<size_t> holders;
+    for (const handle_t& entry : nodes[index].left_edges) {
+        holders.insert(index_of(entry));
+    }
+    for (const handle_t& entry : nodes[index].right_edges) {
+        holders.insert(index_of(entry));
+    }
+    for (size_t holder : holders) {
+        if (holder == index) {
+            continue;
+        }
+        for (std::vector<handle_t>* edge_list : {&nodes[holder].left_edges, &nodes[holder].right_edges}) {
+            edge_list->erase(std::remove_if(edge_list->begin(), edge_list->end(), [&](const handle_t& entry) {
+                return index_of(entry) == index;
+            }), edge_list->end());
+        }
+    }
+
+    id_to_index.erase(nodes[index].id);
+    nodes[index] = Node();
+    live_node_count--;
+}
+
+void SimpleGraph::destroy_edge(const handle_t& left, const handle_t& right) {
+    remove_first(successors_of(left), right);
+    if (right != flip(left)) {
+        remove_first(successors_of(flip(right)), flip(left));
+    }
+}
+
+void SimpleGraph::clear() {
+    nodes.clear();
+    id_to_index.clear();
+    steps.clear();
+    free_step_slots.clear();
+    paths.clear();
+    free_path_indexes.clear();
+    name_to_path.clear();
+    live_node_count = 0;
+    live_path_count = 0;
+    next_id = 1;
+    lowest_id = 0;
+    highest_id = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// PathHandleGraph interface
+////////////////////////////////////////////////////////////////////////////
+
+size_t SimpleGraph::get_path_count() const {
+    return live_path_count;
+}
+
+bool SimpleGraph::has_path(const std::string& path_name) const {
+    return name_to_path.count(path_name);
+}
+
+path_handle_t SimpleGraph::get_path_handle(const std::string& path_name) const {
+    uint64_t index = name_to_path.at(path_name);
+    return as_path_handle(index);
+}
+
+std::string SimpleGraph::get_path_name(const path_handle_t& path_handle) const {
+    return paths[as_integer(path_handle)].name;
+}
+
+bool SimpleGraph::get_is_circular(const path_handle_t& path_handle) const {
+    return paths[as_integer(path_handle)].is_circular;
+}
+
+size_t SimpleGraph::get_step_count(const path_handle_t& path_handle) const {
+    return paths[as_integer(path_handle)].step_count;
+}
+
+handle_t SimpleGraph::get_handle_of_step(const step_handle_t& step_handle) const {
+    return steps[as_integers(step_handle)[1]].handle;
+}
+
+path_handle_t SimpleGraph::get_path_handle_of_step(const step_handle_t& step_handle) const {
+    uint64_t index = as_integers(step_handle)[0];
+    return as_path_handle(index);
+}
+
+step_handle_t SimpleGraph::path_begin(const path_handle_t& path_handle) const {
+    // an empty path's head of -1 is the path_end sentinel, as required
+    return make_step(as_integer(path_handle), paths[as_integer(path_handle)].head);
+}
+
+step_handle_t SimpleGraph::path_end(const path_handle_t& path_handle) const {
+    return make_step(as_integer(path_handle), END_SLOT);
+}
+
+step_handle_t SimpleGraph::path_back(const path_handle_t& path_handle) const {
+    const Path& path = paths[as_integer(path_handle)];
+    return make_step(as_integer(path_handle), path.tail == -1 ? FRONT_END_SLOT : path.tail);
+}
+
+step_handle_t SimpleGraph::path_front_end(const path_handle_t& path_handle) const {
+    return make_step(as_integer(path_handle), FRONT_END_SLOT);
+}
+
+bool SimpleGraph::has_next_step(const step_handle_t& step_handle) const {
+    int64_t slot = as_integers(step_handle)[1];
+    if (slot < 0) {
+        return false;
+    }
+    const Step& step = steps[slot];
+    return step.next != -1 || paths[step.path].is_circular;
+}
+
+bool SimpleGraph::has_previous_step(const step_handle_t& step_handle) const {
+    int64_t slot = as_integers(step_handle)[1];
+    if (slot < 0) {
+        return false;
+    }
+    const Step& step = steps[slot];
+    return step.prev != -1 || paths[step.path].is_circular;
+}
+
+step_handle_t SimpleGraph::get_next_step(const step_handle_t& step_handle) const {
+    int64_t path_index = as_integers(step_handle)[0];
+    int64_t slot = as_integers(step_handle)[1];
+    if (slot == FRONT_END_SLOT) {
+        return make_step(path_index, paths[path_index].head);
+    }
+    if (slot == END_SLOT) {
+        return step_handle;
+    }
+    const Step& step = steps[slot];
+    if (step.next != -1) {
+        return make_step(path_index, step.next);
+    }
+    if (paths[path_index].is_circular) {
+        return make_step(path_index, paths[path_index].head);
+    }
+    return make_step(path_index, END_SLOT);
+}
+
+step_handle_t SimpleGraph::get_previous_step(const step_handle_t& step_handle) const {
+    int64_t path_index = as_integers(step_handle)[0];
+    int64_t slot = as_integers(step_handle)[1];
+    if (slot == END_SLOT) {
+        const Path& path = paths[path_index];
+        return make_step(path_index, path.tail == -1 ? FRONT_END_SLOT : path.tail);
+    }
+    if (slot == FRONT_END_SLOT) {
+        return step_handle;
+    }
+    const Step& step = steps[slot];
+    if (step.prev != -1) {
+        return make_step(path_index, step.prev);
+    }
+    if (paths[path_index].is_circular) {
+        return make_step(path_index, paths[path_index].tail);
+    }
+    return make_step(path_index, FRONT_END_SLOT);
+}
+
+bool SimpleGraph::for_each_path_handle_impl(function_ref<bool(const path_handle_t&)> iteratee) const {
+    for (uint64_t i = 0; i < paths.size(); i++) {
+        if (paths[i].alive && !iteratee(as_path_handle(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SimpleGraph::for_each_step_on_handle_impl(const handle_t& handle,
+                                               function_ref<bool(const step_handle_t&)> iteratee) const {
+    for (const size_t& slot : nodes[index_of(handle)].step_slots) {
+        if (!iteratee(make_step(steps[slot].path, slot))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// MutablePathHandleGraph interface
+////////////////////////////////////////////////////////////////////////////
+
+void SimpleGraph::destroy_path(const path_handle_t& path_handle) {
+    size_t path_index = as_integer(path_handle);
+    Path& path = paths[path_index];
+    int64_t slot = path.head;
+    while (slot != -1) {
+        int64_t next_slot = steps[slot].next;
+        free_step_slot(slot);
+        slot = next_slot;
+    }
+    name_to_path.erase(path.name);
+    path = Path();
+    free_path_indexes.push_back(path_index);
+    live_path_count--;
+    clear_interned_path_names();
+}
+
+path_handle_t SimpleGraph::create_path_handle(const std::string& name, bool is_circular) {
+    if (name_to_path.count(name)) {
+        throw std::runtime_error("error:[SimpleGraph] path " + name + " is already in the graph");
+    }
+    uint64_t path_index;
+    if (!free_path_indexes.empty()) {
+        path_index = free_path_indexes.back();
+        free_path_indexes.pop_back();
+    }
+    else {
+        path_index = paths.size();
+        paths.emplace_back();
+    }
+    Path& path = paths[path_index];
+    path.name = name;
+    path.is_circular = is_circular;
+    path.alive = true;
+    name_to_path[name] = path_index;
+    live_path_count++;
+    clear_interned_path_names();
+    return as_path_handle(path_index);
+}
+
+step_handle_t SimpleGraph::append_step(const path_handle_t& path_handle, const handle_t& to_append) {
+    int64_t path_index = as_integer(path_handle);
+    size_t slot = new_step_slot(path_index, to_append);
+    Path& path = paths[path_index];
+    steps[slot].prev = path.tail;
+    if (path.tail != -1) {
+        steps[path.tail].next = slot;
+    }
+    else {
+        path.head = slot;
+    }
+    path.tail = slot;
+    path.step_count++;
+    return make_step(path_index, slot);
+}
+
+step_handle_t SimpleGraph::prepend_step(const path_handle_t& path_handle, const handle_t& to_prepend) {
+    int64_t path_index = as_integer(path_handle);
+    size_t slot = new_step_slot(path_index, to_prepend);
+    Path& path = paths[path_index];
+    steps[slot].next = path.head;
+    if (path.head != -1) {
+        steps[path.head].prev = slot;
+    }
+    else {
+        path.tail = slot;
+    }
+    path.head = slot;
+    path.step_count++;
+    return make_step(path_index, slot);
+}
+
+std::pair<step_handle_t, step_handle_t> SimpleGraph::rewrite_segment(const step_handle_t& segment_begin,
+                                                                     const step_handle_t& segment_end,
+                                                                     const std::vector<handle_t>& new_segment) {
+    int64_t path_index = as_integers(segment_begin)[0];
+    Path& path = paths[path_index];
+
+    int64_t first = as_integers(segment_begin)[1];
+    int64_t after = as_integers(segment_end)[1];
+    if (after < 0) {
+        after = -1;
+    }
+
+    // the step the new segment will hang off of on the left
+    int64_t before;
+    if (first >= 0) {
+        before = steps[first].prev;
+    }
+    else if (first == END_SLOT) {
+        before = path.tail;
+    }
+    else {
+        before = -1;
+    }
+
+    // take out the old segment
+    int64_t slot = first >= 0 ? first : -1;
+    while (slot != -1 && slot != after) {
+        int64_t next_slot = steps[slot].next;
+        free_step_slot(slot);
+        path.step_count--;
+        slot = next_slot;
+    }
+
+    // thread in the new one
+    int64_t prev_slot = before;
+    int64_t first_new = -1;
+    for (const handle_t& handle : new_segment) {
+        size_t new_slot = new_step_slot(path_index, handle);
+        steps[new_slot].prev = prev_slot;
+        if (prev_slot != -1) {
+            steps[prev_slot].next = new_slot;
+        }
+        else {
+            path.head = new_slot;
+        }
+        if (first_new == -1) {
+            first_new = new_slot;
+        }
+        prev_slot = new_slot;
+        path.step_count++;
+    }
+    if (prev_slot != -1) {
+        steps[prev_slot].next = after;
+    }
+    else {
+        path.head = after;
+    }
+    if (after != -1) {
+        steps[after].prev = prev_slot;
+    }
+    else {
+        path.tail = prev_slot;
+    }
+
+    int64_t past_last = after == -1 ? END_SLOT : after;
+    step_handle_t front = make_step(path_index, first_new != -1 ? first_new : past_last);
+    return std::make_pair(front, make_step(path_index, past_last));
+}
+
+void SimpleGraph::set_circularity(const path_handle_t& path_handle, bool circular) {
+    paths[as_integer(path_handle)].is_circular = circular;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Internals
+////////////////////////////////////////////////////////////////////////////
+
+size_t SimpleGraph::index_of(const handle_t& handle) const {
+    return number_bool_packing::unpack_number(handle);
+}
+
+std::vector<handle_t>& SimpleGraph::successors_of(const handle_t& handle) {
+    Node& node = nodes[index_of(handle)];
+    return number_bool_packing::unpack_bit(handle) ? node.left_edges : node.right_edges;
+}
+
+const std::vector<handle_t>& SimpleGraph::successors_of(const handle_t& handle) const {
+    const Node& node = nodes[index_of(handle)];
+    return number_bool_packing::unpack_bit(handle) ? node.left_edges : node.right_edges;
+}
+
+void SimpleGraph::store_sequence(Node& node, const std::string& sequence) {
+    node.length = sequence.size();
+    node.packable = true;
+    node.overflow.clear();
+    node.packed.assign((sequence.size() + 3) / 4, 0);
+    for (size_t i = 0; i < sequence.size(); i++) {
+        int code = base_code(sequence[i]);
+        if (code < 0) {
+            // not plain ACGT; keep it verbatim instead
+            node.packable = false;
+            node.packed.clear();
+            node.overflow = sequence;
+            break;
+        }
+        node.packed[i / 4] |= code << (2 * (i % 4));
+    }
+}
+
+size_t SimpleGraph::add_node(const std::string& sequence, const nid_t& id) {
+    size_t index = nodes.size();
+    nodes.emplace_back();
+    Node& node = nodes.back();
+    node.alive = true;
+    node.id = id;
+    store_sequence(node, sequence);
+    id_to_index[id] = index;
+    if (live_node_count++ == 0) {
+        lowest_id = highest_id = id;
+    }
+    else {
+        lowest_id = std::min(lowest_id, id);
+        highest_id = std::max(highest_id, id);
+    }
+    next_id = std::max(next_id, id + 1);
+    return index;
+}
+
+size_t SimpleGraph::new_step_slot(int64_t path_index, const handle_t& handle) {
+    size_t slot;
+    if (!free_step_slots.empty()) {
+        slot = free_step_slots.back();
+        free_step_slots.pop_back();
+        steps[slot] = Step();
+    }
+    else {
+        slot = steps.size();
+        steps.emplace_back();
+    }
+    steps[slot].handle = handle;
+    steps[slot].path = path_index;
+    nodes[index_of(handle)].step_slots.push_back(slot);
+    return slot;
+}
+
+void SimpleGraph::free_step_slot(size_t slot) {
+    std::vector<size_t>& occurrences = nodes[index_of(steps[slot].handle)].step_slots;
+    auto found = std::find(occurrences.begin(), occurrences.end(), slot);
+    if (found != occurrences.end()) {
+        occurrences.erase(found);
+    }
+    steps[slot].path = -1;
+    free_step_slots.push_back(slot);
+}
+
+void SimpleGraph::reindex_nodes(std::vector<size_t> new_index) {
+    // rewrite every stored handle to use the new indexes, before the records
+    // themselves move (the map is old index to new, so order doesn't matter)
+    for (Node& node : nodes) {
+        if (!node.alive) {
+            continue;
+        }
+        for (std::vector<handle_t>* edge_list : {&node.left_edges, &node.right_edges}) {
+            number_bool_packing::substitute_numbers(edge_list->data(), edge_list->size(),
+                                                    new_index.data());
+        }
+    }
+    for (Step& step : steps) {
+        if (step.path != -1) {
+            step.handle = number_bool_packing::pack(new_index[number_bool_packing::unpack_number(step.handle)],
+                                                    number_bool_packing::unpack_bit(step.handle));
+        }
+    }
+    for (auto& record : id_to_index) {
+        record.second = new_index[record.second];
+    }
+
+    if (live_node_count < nodes.size()) {
+        // park the tombstones in the leftover slots past the live nodes, so
+        // the map becomes a full permutation we can chase
+        std::vector<bool> used(nodes.size(), false);
+        for (size_t destination : new_index) {
+            if (destination != std::numeric_limits<size_t>::max()) {
+                used[destination] = true;
+            }
+        }
+        size_t next_free = 0;
+        for (size_t& destination : new_index) {
+            if (destination == std::numeric_limits<size_t>::max()) {
+                while (used[next_free]) {
+                    next_free++;
+                }
+                destination = next_free;
+                used[next_free] = true;
+            }
+        }
+    }
+
+    // move the node records into their new slots in place; the only extra
+    // memory is the map itself, not a second node table
+    apply_permutation(new_index, [&](size_t a, size_t b) {
+        std::swap(nodes[a], nodes[b]);
+    });
+    nodes.resize(live_node_count);
+}
+
+void SimpleGraph::renumber_ids_dense() {
+    id_to_index.clear();
+    for (size_t i = 0; i < nodes.size(); i++) {
+        nodes[i].id = i + 1;
+        id_to_index[i + 1] = i;
+    }
+    next_id = nodes.size() + 1;
+    lowest_id = nodes.empty() ? 0 : 1;
+    highest_id = nodes.size();
+}
+
+step_handle_t SimpleGraph::make_step(int64_t path_index, int64_t slot) {
+    step_handle_t step;
+    as_integers(step)[0] = path_index;
+    as_integers(step)[1] = slot;
+    return step;
+}
+
+}
@@ -8,6 +8,23 @@
 
 namespace handlegraph {
 
+SnarlDecomposition::net_traits_t SnarlDecomposition::get_net_traits(const net_handle_t& net) const {
+    net_traits_t traits;
+    if (is_sentinel(net)) {
+        // Sentinels don't have meaningful traversal endpoints
+        traits.type = SENTINEL;
+        traits.start = START;
+        traits.end = END;
+        return traits;
+    }
+    traits.type = is_root(net) ? ROOT :
+                  is_snarl(net) ? SNARL :
+                  is_chain(net) ? CHAIN : NODE;
+    traits.start = starts_at(net);
+    traits.end = ends_at(net);
+    return traits;
+}
+
 bool SnarlDecomposition::for_each_tippy_child_impl(const net_handle_t& parent, const std::function<bool(const net_handle_t&)>& iteratee) const {
     // This default implementation just scans for tips.
     // Should be overridden by one that knows where the tips, if any, are.
@@ -27,6 +44,14 @@ bool SnarlDecomposition::for_each_tippy_child_impl(const net_handle_t& parent, c
     return true;
 }
 
+void SnarlDecomposition::get_children(const net_handle_t& parent, std::vector<net_handle_t>& out) const {
+    // This default implementation just collects from the one-at-a-time loop.
+    // Should be overridden by one that can copy its child storage in bulk.
+    for_each_child(parent, [&](const net_handle_t& child) {
+        out.push_back(child);
+    });
+}
+
 bool SnarlDecomposition::for_each_traversal_start_impl(const net_handle_t& traversal, const std::function<bool(const net_handle_t&)>& iteratee) const {
     switch (starts_at(traversal)) {
     case START:
@@ -65,6 +90,26 @@ bool SnarlDecomposition::for_each_traversal_end_impl(const net_handle_t& travers
     return true;
 }
 
+SnarlBoundCache::SnarlBoundCache(const SnarlDecomposition& snarls) : snarls(snarls) {
+    // Nothing to do!
+}
+
+net_handle_t SnarlBoundCache::get_bound(const net_handle_t& parent, bool get_end, bool face_in) {
+    // All traversals of the same snarl or chain share one entry
+    auto& entry = cache[snarls.canonical(parent)];
+    size_t slot = (get_end ? 2 : 0) + (face_in ? 1 : 0);
+    if (!(entry.filled & (1 << slot))) {
+        // First time anyone asked for this bound
+        entry.bounds[slot] = snarls.get_bound(parent, get_end, face_in);
+        entry.filled |= (1 << slot);
+    }
+    return entry.bounds[slot];
+}
+
+void SnarlBoundCache::clear() {
+    cache.clear();
+}
+
 }
 
 
@@ -1,5 +1,8 @@
 #include "handlegraph/algorithms/split_strands.hpp"
 
+#include "handlegraph/sequence.hpp"
+
+#include <functional>
 #include <unordered_set>
 
 namespace handlegraph {
@@ -7,18 +10,19 @@ namespace algorithms {
 
 using namespace std;
 
-unordered_map<handle_t, handle_t> split_strands(const HandleGraph* source, MutableHandleGraph* into) {
-    
+/// Core of the strand split: fills 'into' and reports each new node along
+/// with the oriented traversal of 'source' that its forward strand
+/// represents.
+static void split_strands_internal(const HandleGraph* source, MutableHandleGraph* into,
+                                   const function<void(const handle_t&, const handle_t&)>& record_translation) {
+
     if (into->get_node_count()) {
         cerr << "error:[algorithms] attempted to create strand-splitted graph in a non-empty graph" << endl;
         exit(1);
     }
-    
+
     size_t source_nodes = source->get_node_count();
-    
-    unordered_map<handle_t, handle_t> node_translation;
-    node_translation.reserve(2 * source_nodes);
-    
+
     unordered_map<handle_t, handle_t> forward_node;
     forward_node.reserve(source_nodes);
     unordered_map<handle_t, handle_t> reverse_node;
@@ -28,16 +32,18 @@ unordered_map<handle_t, handle_t> split_strands(const HandleGraph* source, Mutab
     edges.reserve(3 * source_nodes); // Assumes 1.5 edges/node.
     
     source->for_each_handle([&](const handle_t& handle) {
-        // create and record forward and reverse versions of each node
-        handle_t fwd_handle = into->create_handle(source->get_sequence(handle));
-        handle_t rev_handle = into->create_handle(source->get_sequence(source->flip(handle)));
+        // create and record forward and reverse versions of each node, using
+        // the shared kernel for the reverse strand's sequence
+        string sequence = source->get_sequence(handle);
+        handle_t fwd_handle = into->create_handle(sequence);
+        handle_t rev_handle = into->create_handle(reverse_complement(sequence));
         
         forward_node[handle] = fwd_handle;
         reverse_node[handle] = rev_handle;
-        
-        node_translation[fwd_handle] = handle;
-        node_translation[rev_handle] = source->flip(handle);
-        
+
+        record_translation(fwd_handle, handle);
+        record_translation(rev_handle, source->flip(handle));
+
         // collect all the edges
         source->follow_edges(handle, true, [&](const handle_t& prev) {
             edges.insert(source->edge_handle(prev, handle));
@@ -62,8 +68,116 @@ unordered_map<handle_t, handle_t> split_strands(const HandleGraph* source, Mutab
         into->create_edge(fwd_prev, fwd_next);
         into->create_edge(rev_prev, rev_next);
     }
-    
+}
+
+unordered_map<handle_t, handle_t> split_strands(const HandleGraph* source, MutableHandleGraph* into) {
+
+    unordered_map<handle_t, handle_t> node_translation;
+    node_translation.reserve(2 * source->get_node_count());
+    split_strands_internal(source, into, [&](const handle_t& new_handle, const handle_t& old_handle) {
+        node_translation[new_handle] = old_handle;
+    });
     return node_translation;
 }
+
+NodeTranslation split_strands_and_translate(const HandleGraph* source, MutableHandleGraph* into) {
+
+    // every new node is a whole copy of one strand of an original node
+    NodeTranslation translation;
+    split_strands_internal(source, into, [&](const handle_t& new_handle, const handle_t& old_handle) {
+        translation.add_translation(into->get_id(new_handle), source->get_id(old_handle),
+                                    0, 0, source->get_is_reverse(old_handle));
+    });
+    translation.index();
+    return translation;
+}
+
+vector<strand_split_record_t> split_strands_in_place(DeletableHandleGraph* graph) {
+
+    // assign every node a canonical orientation by traversal, first visit wins
+    // (cf. single_stranded_orientation, except that conflicts are allowed here
+    // and get resolved later by duplication)
+    unordered_map<nid_t, bool> canonical_reverse;
+    canonical_reverse.reserve(graph->get_node_count());
+    graph->for_each_handle([&](const handle_t& handle) {
+        if (canonical_reverse.count(graph->get_id(handle))) {
+            return;
+        }
+
+        // DFS from this seed, recording the orientation we first reach each node in
+        vector<handle_t> stack(1, handle);
+        canonical_reverse[graph->get_id(handle)] = graph->get_is_reverse(handle);
+
+        function<void(const handle_t&)> walk_edges = [&](const handle_t& next) {
+            if (!canonical_reverse.count(graph->get_id(next))) {
+                canonical_reverse[graph->get_id(next)] = graph->get_is_reverse(next);
+                stack.push_back(next);
+            }
+        };
+
+        while (!stack.empty()) {
+            handle_t here = stack.back();
+            stack.pop_back();
+
+            graph->follow_edges(here, true, walk_edges);
+            graph->follow_edges(here, false, walk_edges);
+        }
+    });
+
+    // snapshot the edges before we start rewriting them
+    vector<edge_t> edges;
+    graph->for_each_edge([&](const edge_t& edge) {
+        edges.push_back(edge);
+    });
+
+    // the return value
+    vector<strand_split_record_t> translation;
+
+    // the reverse complement copies of the nodes we've had to duplicate
+    unordered_map<nid_t, handle_t> rev_comp_copy;
+
+    // get the handle that stands in for an oriented traversal of a node: the node
+    // itself if the orientation is canonical, and otherwise a reverse complement
+    // copy, created on demand
+    auto mapped_handle = [&](const handle_t& handle) {
+        if (graph->get_is_reverse(handle) == canonical_reverse[graph->get_id(handle)]) {
+            // this is the canonical orientation, the node stands in for itself
+            return handle;
+        }
+        auto iter = rev_comp_copy.find(graph->get_id(handle));
+        if (iter == rev_comp_copy.end()) {
+            // this node is visited in both orientations, so it needs a copy of
+            // its anti-canonical strand
+            handle_t copy = graph->create_handle(graph->get_sequence(handle));
+            iter = rev_comp_copy.emplace(graph->get_id(handle), copy).first;
+            translation.emplace_back(copy, handle);
+        }
+        return iter->second;
+    };
+
+    // move each strand-inconsistent edge onto the copies
+    for (const edge_t& edge : edges) {
+        handle_t new_first = mapped_handle(edge.first);
+        handle_t new_second = mapped_handle(edge.second);
+        if (new_first != edge.first || new_second != edge.second) {
+            graph->destroy_edge(edge.first, edge.second);
+            graph->create_edge(new_first, new_second);
+        }
+    }
+
+    // now every edge attaches to nodes in their canonical orientation, so flipping
+    // the nodes whose canonical orientation is reverse leaves everything forward
+    for (const auto& oriented : canonical_reverse) {
+        if (oriented.second) {
+            handle_t original = graph->get_handle(oriented.first, true);
+            handle_t flipped = graph->apply_orientation(original);
+            // the flipped node's forward orientation is the original's reverse,
+            // and its ID may have changed
+            translation.emplace_back(flipped, original);
+        }
+    }
+
+    return translation;
+}
 }
 }
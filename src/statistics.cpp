@@ -0,0 +1,258 @@
+#include "handlegraph/algorithms/statistics.hpp"
+
+#include "handlegraph/algorithms/weakly_connected_components.hpp"
+#include "handlegraph/parallel.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <unordered_set>
+
+/** \file statistics.cpp
+ * Implement the single-pass graph statistics engine.
+ */
+
+namespace handlegraph {
+namespace algorithms {
+
+/// the power-of-two bucket a value falls in (bucket 0 holds 0 and 1)
+static size_t log2_bucket(size_t value) {
+    size_t bucket = 0;
+    while (value >> (bucket + 1) != 0) {
+        bucket++;
+    }
+    return bucket;
+}
+
+/// count one value into a histogram, growing it as needed
+static void bump(std::vector<size_t>& histogram, size_t entry) {
+    if (histogram.size() <= entry) {
+        histogram.resize(entry + 1, 0);
+    }
+    histogram[entry]++;
+}
+
+/// add each entry of one histogram into another, growing it as needed
+static void merge_histogram(std::vector<size_t>& into, const std::vector<size_t>& from) {
+    if (into.size() < from.size()) {
+        into.resize(from.size(), 0);
+    }
+    for (size_t i = 0; i < from.size(); i++) {
+        into[i] += from[i];
+    }
+}
+
+/// one worker's private accumulator for the node and edge pass
+struct TopologySketch {
+    size_t total_node_length = 0;
+    size_t min_node_length = std::numeric_limits<size_t>::max();
+    size_t max_node_length = 0;
+    size_t edge_count = 0;
+    std::vector<size_t> length_histogram;
+    std::vector<size_t> degree_histogram;
+};
+
+/// one worker's private accumulator for the path pass
+struct PathSketch {
+    size_t step_count = 0;
+    size_t total_path_length = 0;
+    std::unordered_set<nid_t> visited;
+};
+
+/// how many sketches (and stripes) to use for the given thread count
+static size_t stripe_count(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::thread::hardware_concurrency();
+    }
+    return std::max<size_t>(thread_count, 1);
+}
+
+graph_statistics_t collect_statistics(const HandleGraph* graph, const statistics_config_t& config,
+                                      size_t thread_count, ControlToken* token) {
+    graph_statistics_t report;
+    size_t stripes = stripe_count(thread_count);
+
+    // Snapshot the handles so the stripes are independent index ranges.
+    if (token != nullptr) {
+        token->begin_phase("snapshotting nodes", graph->get_node_count());
+    }
+    std::vector<handle_t> handles;
+    handles.reserve(graph->get_node_count());
+    graph->for_each_handle([&](const handle_t& handle) {
+        handles.push_back(handle);
+        if (token != nullptr) {
+            token->advance();
+            if (handles.size() % ControlToken::CHECK_INTERVAL == 0) {
+                token->check();
+            }
+        }
+    });
+    report.node_count = handles.size();
+
+    // The one pass: each worker accumulates its stripe of the snapshot into
+    // its own sketch, touching each node's length and edges exactly once.
+    if (token != nullptr) {
+        token->begin_phase("scanning topology", handles.size());
+    }
+    std::vector<TopologySketch> sketches(stripes);
+    parallel_for(stripes, [&](size_t stripe) {
+        TopologySketch& sketch = sketches[stripe];
+        size_t begin = stripe * handles.size() / stripes;
+        size_t end = (stripe + 1) * handles.size() / stripes;
+        for (size_t i = begin; i < end; i++) {
+            if (token != nullptr && token->is_cancelled()) {
+                // Don't throw across the worker threads; the check after the
+                // parallel loop surfaces the cancellation.
+                return;
+            }
+            handle_t handle = graph->forward(handles[i]);
+
+            size_t length = graph->get_length(handle);
+            sketch.total_node_length += length;
+            sketch.min_node_length = std::min(sketch.min_node_length, length);
+            sketch.max_node_length = std::max(sketch.max_node_length, length);
+            if (config.node_length_histogram) {
+                bump(sketch.length_histogram, log2_bucket(length));
+            }
+
+            // Count the attachments on both sides for the degree, and count
+            // each edge from exactly one of its sides, with the same
+            // canonical-edge rule as for_each_edge.
+            size_t degree = 0;
+            graph->follow_edges(handle, false, [&](const handle_t& next) {
+                degree++;
+                if (graph->get_id(handle) <= graph->get_id(next)) {
+                    sketch.edge_count++;
+                }
+            });
+            graph->follow_edges(handle, true, [&](const handle_t& prev) {
+                degree++;
+                if (graph->get_id(handle) < graph->get_id(prev) ||
+                    (graph->get_id(handle) == graph->get_id(prev) && graph->get_is_reverse(prev))) {
+                    sketch.edge_count++;
+                }
+            });
+            if (config.degree_histogram) {
+                bump(sketch.degree_histogram, degree);
+            }
+
+            if (token != nullptr) {
+                token->advance();
+            }
+        }
+    }, stripes, 1);
+    if (token != nullptr) {
+        token->check();
+    }
+
+    // Merge the sketches into the report.
+    size_t min_length = std::numeric_limits<size_t>::max();
+    for (const TopologySketch& sketch : sketches) {
+        report.total_node_length += sketch.total_node_length;
+        min_length = std::min(min_length, sketch.min_node_length);
+        report.max_node_length = std::max(report.max_node_length, sketch.max_node_length);
+        report.edge_count += sketch.edge_count;
+        merge_histogram(report.node_length_log2_histogram, sketch.length_histogram);
+        merge_histogram(report.degree_histogram, sketch.degree_histogram);
+    }
+    report.min_node_length = report.node_count == 0 ? 0 : min_length;
+
+    if (config.component_summary) {
+        // Reuse the concurrent union-find labeling; summarizing the labels
+        // costs one sweep of a few words per node.
+        if (token != nullptr) {
+            token->begin_phase("labeling components");
+        }
+        std::vector<nid_t> index_to_id;
+        std::vector<uint32_t> component_ids;
+        report.component_count = weakly_connected_component_ids(graph, index_to_id, component_ids,
+                                                                thread_count);
+        std::vector<size_t> sizes(report.component_count, 0);
+        for (uint32_t label : component_ids) {
+            sizes[label]++;
+        }
+        for (size_t size : sizes) {
+            report.largest_component_node_count = std::max(report.largest_component_node_count, size);
+            bump(report.component_size_log2_histogram, log2_bucket(size));
+        }
+        if (token != nullptr) {
+            token->check();
+        }
+    }
+
+    return report;
+}
+
+graph_statistics_t collect_statistics(const PathHandleGraph* graph, const statistics_config_t& config,
+                                      size_t thread_count, ControlToken* token) {
+    graph_statistics_t report = collect_statistics(static_cast<const HandleGraph*>(graph),
+                                                   config, thread_count, token);
+    if (!config.path_coverage) {
+        return report;
+    }
+    size_t stripes = stripe_count(thread_count);
+
+    if (token != nullptr) {
+        token->begin_phase("snapshotting paths", graph->get_path_count());
+    }
+    std::vector<path_handle_t> paths;
+    paths.reserve(graph->get_path_count());
+    graph->for_each_path_handle([&](const path_handle_t& path) {
+        paths.push_back(path);
+        if (token != nullptr) {
+            token->advance();
+        }
+    });
+    report.path_count = paths.size();
+
+    // One parallel pass over the paths, a stripe of paths per sketch.
+    if (token != nullptr) {
+        token->begin_phase("scanning paths", paths.size());
+    }
+    std::vector<PathSketch> sketches(stripes);
+    parallel_for(stripes, [&](size_t stripe) {
+        PathSketch& sketch = sketches[stripe];
+        size_t begin = stripe * paths.size() / stripes;
+        size_t end = (stripe + 1) * paths.size() / stripes;
+        for (size_t i = begin; i < end; i++) {
+            if (token != nullptr && token->is_cancelled()) {
+                return;
+            }
+            graph->for_each_step_in_path(paths[i], [&](const step_handle_t& step) {
+                handle_t handle = graph->get_handle_of_step(step);
+                sketch.step_count++;
+                sketch.total_path_length += graph->get_length(handle);
+                sketch.visited.insert(graph->get_id(handle));
+            });
+            if (token != nullptr) {
+                token->advance();
+            }
+        }
+    }, stripes, 1);
+    if (token != nullptr) {
+        token->check();
+    }
+
+    // Merge, folding the smaller visited sets into the largest one.
+    PathSketch* merged = &sketches.front();
+    for (PathSketch& sketch : sketches) {
+        if (sketch.visited.size() > merged->visited.size()) {
+            merged = &sketch;
+        }
+    }
+    for (PathSketch& sketch : sketches) {
+        report.step_count += sketch.step_count;
+        report.total_path_length += sketch.total_path_length;
+        if (&sketch != merged) {
+            merged->visited.insert(sketch.visited.begin(), sketch.visited.end());
+        }
+    }
+    report.nodes_on_paths = merged->visited.size();
+    report.mean_path_depth = report.total_node_length == 0 ?
+        0 : (double) report.total_path_length / report.total_node_length;
+
+    return report;
+}
+
+}
+}
@@ -0,0 +1,219 @@
+#include "handlegraph/step_position_index.hpp"
+
+#include "handlegraph/parallel.hpp"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <stdexcept>
+
+/** \file step_position_index.cpp
+ * Implement the node-to-path-position index.
+ */
+
+namespace handlegraph {
+
+/// Write a 64-bit value in a fixed byte order.
+static void write_64(std::ostream& out, const uint64_t& value) {
+    uint32_t high = htonl((uint32_t)(value >> 32));
+    uint32_t low = htonl((uint32_t)value);
+    out.write((char*)&high, sizeof(high) / sizeof(char));
+    out.write((char*)&low, sizeof(low) / sizeof(char));
+}
+
+/// Read a 64-bit value back out of the fixed byte order.
+static uint64_t read_64(std::istream& in) {
+    uint32_t high = 0;
+    uint32_t low = 0;
+    in.read((char*)&high, sizeof(high) / sizeof(char));
+    in.read((char*)&low, sizeof(low) / sizeof(char));
+    return ((uint64_t)ntohl(high) << 32) | (uint64_t)ntohl(low);
+}
+
+StepPositionIndex::StepPositionIndex(const PathHandleGraph* graph, size_t thread_count) : graph(graph) {
+    if (graph == nullptr) {
+        throw std::runtime_error("error:[StepPositionIndex] must supply a graph to build over");
+    }
+
+    // Define the rank space
+    node_ids.reserve(graph->get_node_count());
+    graph->for_each_handle([&](const handle_t& handle) {
+        node_ids.push_back(graph->get_id(handle));
+    });
+    std::sort(node_ids.begin(), node_ids.end());
+
+    // Collect the paths in iteration order
+    path_names.reserve(graph->get_path_count());
+    path_handles.reserve(graph->get_path_count());
+    graph->for_each_path_handle([&](const path_handle_t& path) {
+        path_names.push_back(graph->get_path_name(path));
+        path_handles.push_back(path);
+    });
+
+    // Walk the paths in parallel; each fills only its own bucket, keyed by
+    // node rank, with positions in path order.
+    std::vector<std::vector<std::pair<size_t, Visit>>> visits_of_path(path_handles.size());
+    parallel_for(path_handles.size(), [&](size_t i) {
+        std::vector<std::pair<size_t, Visit>>& here = visits_of_path[i];
+        uint64_t position = 0;
+        graph->for_each_step_in_path(path_handles[i], [&](const step_handle_t& step) {
+            handle_t handle = graph->get_handle_of_step(step);
+            here.emplace_back(rank_of(graph->get_id(handle)),
+                              Visit({i, position, graph->get_is_reverse(handle)}));
+            position += graph->get_length(handle);
+        });
+    }, thread_count);
+
+    // Count each node's visits and lay the runs out end to end.
+    first_visit.assign(node_ids.size() + 1, 0);
+    for (const auto& path_visits : visits_of_path) {
+        for (const auto& visit : path_visits) {
+            first_visit[visit.first + 1]++;
+        }
+    }
+    for (size_t i = 1; i < first_visit.size(); i++) {
+        first_visit[i] += first_visit[i - 1];
+    }
+
+    // Fill the runs. Taking the paths in indexing order, and each path's
+    // visits in position order, leaves every run sorted by (path, position)
+    // without a sorting pass.
+    visits.resize(first_visit.back());
+    std::vector<uint64_t> cursor(first_visit.begin(), first_visit.end() - 1);
+    for (const auto& path_visits : visits_of_path) {
+        for (const auto& visit : path_visits) {
+            visits[cursor[visit.first]++] = visit.second;
+        }
+    }
+}
+
+void StepPositionIndex::attach(const PathHandleGraph* g) {
+    if (g == nullptr) {
+        throw std::runtime_error("error:[StepPositionIndex] must supply a graph to attach to");
+    }
+    std::vector<path_handle_t> resolved;
+    resolved.reserve(path_names.size());
+    for (const std::string& name : path_names) {
+        if (!g->has_path(name)) {
+            throw std::runtime_error("error:[StepPositionIndex] attached graph is missing indexed path "
+                                     + name);
+        }
+        resolved.push_back(g->get_path_handle(name));
+    }
+    path_handles = std::move(resolved);
+    graph = g;
+}
+
+bool StepPositionIndex::for_each_step_position_on_handle(const handle_t& handle,
+                                                         const std::function<bool(const path_handle_t&, const size_t&, const bool&)>& iteratee) const {
+    check_attached();
+    size_t rank = rank_of(graph->get_id(handle));
+    for (size_t i = first_visit[rank]; i < first_visit[rank + 1]; i++) {
+        const Visit& visit = visits[i];
+        if (!iteratee(path_handles[visit.path_index], visit.position, visit.is_reverse)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StepPositionIndex::for_each_step_position_of_path_on_handle(const handle_t& handle, const path_handle_t& path,
+                                                                 const std::function<bool(const size_t&, const bool&)>& iteratee) const {
+    check_attached();
+    // Find the path's dense index; the runs are sorted by it.
+    auto found = std::find(path_handles.begin(), path_handles.end(), path);
+    if (found == path_handles.end()) {
+        throw std::runtime_error("error:[StepPositionIndex] queried path is not in the index");
+    }
+    uint64_t path_index = found - path_handles.begin();
+
+    size_t rank = rank_of(graph->get_id(handle));
+    auto begin = visits.begin() + first_visit[rank];
+    auto end = visits.begin() + first_visit[rank + 1];
+    // Binary search to the start of the path's sub-run
+    auto cursor = std::lower_bound(begin, end, path_index, [](const Visit& visit, const uint64_t& query) {
+        return visit.path_index < query;
+    });
+    for (; cursor != end && cursor->path_index == path_index; ++cursor) {
+        if (!iteratee(cursor->position, cursor->is_reverse)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t StepPositionIndex::get_visit_count(const handle_t& handle) const {
+    check_attached();
+    size_t rank = rank_of(graph->get_id(handle));
+    return first_visit[rank + 1] - first_visit[rank];
+}
+
+size_t StepPositionIndex::rank_of(const nid_t& node_id) const {
+    auto found = std::lower_bound(node_ids.begin(), node_ids.end(), node_id);
+    if (found == node_ids.end() || *found != node_id) {
+        throw std::runtime_error("error:[StepPositionIndex] queried node " + std::to_string(node_id)
+                                 + " is not in the index");
+    }
+    return found - node_ids.begin();
+}
+
+void StepPositionIndex::check_attached() const {
+    if (graph == nullptr) {
+        throw std::runtime_error("error:[StepPositionIndex] no graph attached; "
+                                 "call attach() after deserializing");
+    }
+}
+
+uint32_t StepPositionIndex::get_magic_number() const {
+    // corresponds to the ASCII characters "SPIX"
+    return 0x53504958ul;
+}
+
+void StepPositionIndex::serialize_members(std::ostream& out) const {
+    write_64(out, node_ids.size());
+    for (const nid_t& node_id : node_ids) {
+        write_64(out, node_id);
+    }
+    write_64(out, path_names.size());
+    for (const std::string& name : path_names) {
+        write_64(out, name.size());
+        out.write(name.c_str(), name.size());
+    }
+    for (const uint64_t& offset : first_visit) {
+        write_64(out, offset);
+    }
+    for (const Visit& visit : visits) {
+        // Tuck the orientation bit under the path index
+        write_64(out, (visit.path_index << 1) | (uint64_t)visit.is_reverse);
+        write_64(out, visit.position);
+    }
+}
+
+void StepPositionIndex::deserialize_members(std::istream& in) {
+    graph = nullptr;
+    size_t node_count = read_64(in);
+    node_ids.resize(node_count);
+    for (size_t i = 0; i < node_count; i++) {
+        node_ids[i] = read_64(in);
+    }
+    size_t path_count = read_64(in);
+    path_names.resize(path_count);
+    for (size_t i = 0; i < path_count; i++) {
+        size_t length = read_64(in);
+        path_names[i].resize(length);
+        in.read(&path_names[i][0], length);
+    }
+    path_handles.clear();
+    first_visit.resize(node_count + 1);
+    for (uint64_t& offset : first_visit) {
+        offset = read_64(in);
+    }
+    visits.resize(first_visit.back());
+    for (Visit& visit : visits) {
+        uint64_t packed = read_64(in);
+        visit.path_index = packed >> 1;
+        visit.is_reverse = packed & 1;
+        visit.position = read_64(in);
+    }
+}
+
+}
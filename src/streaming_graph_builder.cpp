@@ -0,0 +1,348 @@
+#include "handlegraph/streaming_graph_builder.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <queue>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include <unistd.h>
+
+/** \file streaming_graph_builder.cpp
+ * Implement the bounded-memory streaming graph builder.
+ */
+
+namespace handlegraph {
+
+/// How many records to hand the destination's bulk methods at a time.
+static const size_t BUILD_BATCH_SIZE = 4096;
+
+/// A buffered or spilled node: its ID and sequence, ordered by ID.
+struct StreamingGraphBuilder::NodeRecord {
+    nid_t node_id;
+    std::string sequence;
+
+    bool operator<(const NodeRecord& other) const {
+        return node_id < other.node_id;
+    }
+
+    size_t bytes() const {
+        return sizeof(NodeRecord) + sequence.size();
+    }
+
+    void write(std::ostream& out) const {
+        out.write((const char*) &node_id, sizeof(node_id));
+        uint64_t length = sequence.size();
+        out.write((const char*) &length, sizeof(length));
+        out.write(sequence.data(), length);
+    }
+
+    static bool read(std::istream& in, NodeRecord& record) {
+        if (!in.read((char*) &record.node_id, sizeof(record.node_id))) {
+            return false;
+        }
+        uint64_t length = 0;
+        in.read((char*) &length, sizeof(length));
+        record.sequence.resize(length);
+        in.read(&record.sequence[0], length);
+        return (bool) in;
+    }
+};
+
+/// A buffered or spilled edge between oriented nodes, ordered by its
+/// endpoints.
+struct StreamingGraphBuilder::EdgeRecord {
+    nid_t from_id;
+    nid_t to_id;
+    uint8_t from_is_reverse;
+    uint8_t to_is_reverse;
+
+    bool operator<(const EdgeRecord& other) const {
+        return std::tie(from_id, from_is_reverse, to_id, to_is_reverse) <
+               std::tie(other.from_id, other.from_is_reverse, other.to_id, other.to_is_reverse);
+    }
+
+    size_t bytes() const {
+        return sizeof(EdgeRecord);
+    }
+
+    void write(std::ostream& out) const {
+        out.write((const char*) this, sizeof(EdgeRecord));
+    }
+
+    static bool read(std::istream& in, EdgeRecord& record) {
+        return (bool) in.read((char*) &record, sizeof(EdgeRecord));
+    }
+};
+
+/// A buffered or spilled path visit, ordered by path and then rank.
+struct StreamingGraphBuilder::StepRecord {
+    uint64_t path;
+    uint64_t rank;
+    nid_t node_id;
+    uint8_t is_reverse;
+
+    bool operator<(const StepRecord& other) const {
+        return std::tie(path, rank) < std::tie(other.path, other.rank);
+    }
+
+    size_t bytes() const {
+        return sizeof(StepRecord);
+    }
+
+    void write(std::ostream& out) const {
+        out.write((const char*) this, sizeof(StepRecord));
+    }
+
+    static bool read(std::istream& in, StepRecord& record) {
+        return (bool) in.read((char*) &record, sizeof(StepRecord));
+    }
+};
+
+StreamingGraphBuilder::StreamingGraphBuilder(const std::string& scratch_dir,
+                                             size_t buffer_bytes) :
+    scratch_dir(scratch_dir), buffer_bytes(buffer_bytes) {
+
+    if (this->scratch_dir.empty()) {
+        const char* tmpdir = getenv("TMPDIR");
+        this->scratch_dir = (tmpdir != nullptr && *tmpdir != '\0') ? tmpdir : "/tmp";
+    }
+}
+
+StreamingGraphBuilder::~StreamingGraphBuilder() {
+    for (auto* runs : {&node_runs, &edge_runs, &step_runs}) {
+        for (const std::string& run : *runs) {
+            std::remove(run.c_str());
+        }
+    }
+}
+
+template<typename Record>
+void StreamingGraphBuilder::spill(std::vector<Record>& buffer, std::vector<std::string>& runs) {
+    std::sort(buffer.begin(), buffer.end());
+
+    // Claim a fresh file in the scratch directory
+    std::string name = scratch_dir + "/handlegraph_build_XXXXXX";
+    int fd = mkstemp(&name[0]);
+    if (fd == -1) {
+        throw std::runtime_error("error:[StreamingGraphBuilder] could not create a run file in "
+                                 + scratch_dir);
+    }
+    close(fd);
+
+    std::ofstream out(name, std::ios::binary | std::ios::trunc);
+    for (const Record& record : buffer) {
+        record.write(out);
+    }
+    if (!out) {
+        throw std::runtime_error("error:[StreamingGraphBuilder] could not write run file " + name);
+    }
+    out.close();
+    runs.push_back(name);
+
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+template<typename Record>
+void StreamingGraphBuilder::merge(std::vector<Record>& buffer, std::vector<std::string>& runs,
+                                  const std::function<void(const Record&)>& handle_record) {
+    // The in-memory leftovers act as one more sorted run.
+    std::sort(buffer.begin(), buffer.end());
+
+    std::vector<std::ifstream> run_files;
+    run_files.reserve(runs.size());
+    for (const std::string& run : runs) {
+        run_files.emplace_back(run, std::ios::binary);
+        if (!run_files.back()) {
+            throw std::runtime_error("error:[StreamingGraphBuilder] could not reopen run file " + run);
+        }
+    }
+
+    // A k-way merge over the run files plus the buffer: a min-heap of each
+    // source's current record. Source index runs.size() is the buffer.
+    size_t buffer_cursor = 0;
+    using HeapEntry = std::pair<Record, size_t>;
+    auto heap_order = [](const HeapEntry& a, const HeapEntry& b) {
+        // priority_queue is a max-heap; invert to pop the smallest record
+        return b.first < a.first;
+    };
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, decltype(heap_order)> heap(heap_order);
+
+    for (size_t i = 0; i < run_files.size(); i++) {
+        Record record;
+        if (Record::read(run_files[i], record)) {
+            heap.emplace(std::move(record), i);
+        }
+    }
+    if (buffer_cursor < buffer.size()) {
+        heap.emplace(buffer[buffer_cursor++], run_files.size());
+    }
+
+    while (!heap.empty()) {
+        HeapEntry top = heap.top();
+        heap.pop();
+        handle_record(top.first);
+
+        // Refill from the source the record came from
+        if (top.second < run_files.size()) {
+            Record record;
+            if (Record::read(run_files[top.second], record)) {
+                heap.emplace(std::move(record), top.second);
+            }
+        } else if (buffer_cursor < buffer.size()) {
+            heap.emplace(buffer[buffer_cursor++], run_files.size());
+        }
+    }
+
+    // Everything is delivered; drop the sources.
+    run_files.clear();
+    for (const std::string& run : runs) {
+        std::remove(run.c_str());
+    }
+    runs.clear();
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+size_t StreamingGraphBuilder::path_index(const std::string& path_name) {
+    auto found = path_index_by_name.find(path_name);
+    if (found != path_index_by_name.end()) {
+        return found->second;
+    }
+    path_names.push_back(path_name);
+    path_is_circular.push_back(false);
+    path_index_by_name[path_name] = path_names.size() - 1;
+    return path_names.size() - 1;
+}
+
+void StreamingGraphBuilder::check_not_built() const {
+    if (built) {
+        throw std::runtime_error("error:[StreamingGraphBuilder] builder has already built its graph");
+    }
+}
+
+void StreamingGraphBuilder::add_node(const nid_t& node_id, const std::string& sequence) {
+    check_not_built();
+    node_buffer.push_back({node_id, sequence});
+    node_bytes += node_buffer.back().bytes();
+    if (node_bytes >= buffer_bytes) {
+        spill(node_buffer, node_runs);
+        node_bytes = 0;
+    }
+}
+
+void StreamingGraphBuilder::add_edge(const nid_t& from_id, bool from_is_reverse,
+                                     const nid_t& to_id, bool to_is_reverse) {
+    check_not_built();
+    edge_buffer.push_back({from_id, to_id, (uint8_t) from_is_reverse, (uint8_t) to_is_reverse});
+    edge_bytes += edge_buffer.back().bytes();
+    if (edge_bytes >= buffer_bytes) {
+        spill(edge_buffer, edge_runs);
+        edge_bytes = 0;
+    }
+}
+
+void StreamingGraphBuilder::add_path(const std::string& path_name, bool is_circular) {
+    check_not_built();
+    path_is_circular[path_index(path_name)] = is_circular;
+}
+
+void StreamingGraphBuilder::add_step(const std::string& path_name, size_t rank,
+                                     const nid_t& node_id, bool is_reverse) {
+    check_not_built();
+    step_buffer.push_back({path_index(path_name), rank, node_id, (uint8_t) is_reverse});
+    step_bytes += step_buffer.back().bytes();
+    if (step_bytes >= buffer_bytes) {
+        spill(step_buffer, step_runs);
+        step_bytes = 0;
+    }
+}
+
+void StreamingGraphBuilder::build(MutableHandleGraph* into) {
+    check_not_built();
+    if (into == nullptr) {
+        throw std::runtime_error("error:[StreamingGraphBuilder] must supply a graph to build into");
+    }
+    if (!path_names.empty() || !step_buffer.empty() || !step_runs.empty()) {
+        throw std::runtime_error("error:[StreamingGraphBuilder] paths were added, but the "
+                                 "destination graph cannot hold paths");
+    }
+    build_topology(into);
+    built = true;
+}
+
+void StreamingGraphBuilder::build_topology(MutableHandleGraph* into) {
+    // Replay the nodes in ID order, a bulk batch at a time
+    std::vector<std::string> batch_sequences;
+    std::vector<nid_t> batch_ids;
+    merge<NodeRecord>(node_buffer, node_runs, [&](const NodeRecord& record) {
+        batch_ids.push_back(record.node_id);
+        batch_sequences.push_back(record.sequence);
+        if (batch_ids.size() >= BUILD_BATCH_SIZE) {
+            into->create_handles(batch_sequences, batch_ids);
+            batch_sequences.clear();
+            batch_ids.clear();
+        }
+    });
+    if (!batch_ids.empty()) {
+        into->create_handles(batch_sequences, batch_ids);
+    }
+
+    // Then the edges, against the now-existing nodes
+    std::vector<edge_t> batch_edges;
+    merge<EdgeRecord>(edge_buffer, edge_runs, [&](const EdgeRecord& record) {
+        batch_edges.emplace_back(into->get_handle(record.from_id, record.from_is_reverse),
+                                 into->get_handle(record.to_id, record.to_is_reverse));
+        if (batch_edges.size() >= BUILD_BATCH_SIZE) {
+            into->create_edges(batch_edges);
+            batch_edges.clear();
+        }
+    });
+    if (!batch_edges.empty()) {
+        into->create_edges(batch_edges);
+    }
+}
+
+void StreamingGraphBuilder::build(MutablePathMutableHandleGraph* into) {
+    check_not_built();
+    if (into == nullptr) {
+        throw std::runtime_error("error:[StreamingGraphBuilder] must supply a graph to build into");
+    }
+
+    build_topology(into);
+
+    // Make the paths in declaration order
+    std::vector<path_handle_t> paths;
+    paths.reserve(path_names.size());
+    for (size_t i = 0; i < path_names.size(); i++) {
+        paths.push_back(into->create_path_handle(path_names[i], path_is_circular[i]));
+    }
+
+    // Replay the steps in (path, rank) order, appending each path's visits
+    // a batch at a time
+    std::vector<handle_t> batch_steps;
+    size_t batch_path = 0;
+    merge<StepRecord>(step_buffer, step_runs, [&](const StepRecord& record) {
+        if (record.path != batch_path && !batch_steps.empty()) {
+            into->append_steps(paths[batch_path], batch_steps);
+            batch_steps.clear();
+        }
+        batch_path = record.path;
+        batch_steps.push_back(into->get_handle(record.node_id, record.is_reverse));
+        if (batch_steps.size() >= BUILD_BATCH_SIZE) {
+            into->append_steps(paths[batch_path], batch_steps);
+            batch_steps.clear();
+        }
+    });
+    if (!batch_steps.empty()) {
+        into->append_steps(paths[batch_path], batch_steps);
+    }
+
+    built = true;
+}
+
+}
@@ -2,6 +2,8 @@
 
 #include "handlegraph/algorithms/strongly_connected_components.hpp"
 
+#include <algorithm>
+#include <limits>
 #include <unordered_map>
 #include <deque>
 //#define debug
@@ -31,32 +33,48 @@ using namespace std;
 // node in a component if either orientation is in it. But bear in mind that
 // both orientations of a node might not actually be in the same strongly
 // connected component in a bidirected graph, so now the components may overlap.
+void SCCState::reset() {
+    roots.clear();
+    discover_idx.clear();
+    stack.clear();
+    on_stack.clear();
+    already_used.clear();
+}
+
 vector<unordered_set<nid_t>> strongly_connected_components(const HandleGraph* handle_graph) {
-    
+    // Nobody wants to reuse the scratch state, so make a throwaway one.
+    SCCState state;
+    return strongly_connected_components(handle_graph, state);
+}
+
+vector<unordered_set<nid_t>> strongly_connected_components(const HandleGraph* handle_graph, SCCState& state) {
+
 #ifdef debug
     cerr << "Computing strongly connected components" << endl;
 #endif
-    
+
     // What node visit step are we on?
     int64_t index = 0;
+    // Make sure the reusable bookkeeping is empty, but keep its capacity.
+    state.reset();
     // What's the search root from which a node was reached?
-    unordered_map<handle_t, handle_t> roots;
+    auto& roots = state.roots;
     // At what index step was each node discovered?
-    unordered_map<handle_t, int64_t> discover_idx;
+    auto& discover_idx = state.discover_idx;
     // We need our own copy of the DFS stack
-    vector<handle_t> stack;
+    auto& stack = state.stack;
     // And our own set of nodes already on the stack
-    unordered_set<handle_t> on_stack;
+    auto& on_stack = state.on_stack;
     // What components did we find? Because of the way strongly connected
     // components generalizes, both orientations of a node always end up in the
     // same component.
     vector<unordered_set<nid_t>> components;
-    
+
     // A single node ID from each component we've already added, which we use
     // to deduplicate the results
     // TODO: why do we produce duplicate components in the first place?
-    unordered_set<nid_t> already_used;
-    
+    auto& already_used = state.already_used;
+
     handlegraph::algorithms::internal::dfs(*handle_graph,
         [&](const handle_t& trav) {
         // When a NodeTraversal is first visited
@@ -150,5 +168,76 @@ vector<unordered_set<nid_t>> strongly_connected_components(const HandleGraph* ha
     return components;
 }
 
+SCCCondensation strongly_connected_components_condensation(const HandleGraph* g) {
+    SCCState state;
+    return strongly_connected_components_condensation(g, state);
+}
+
+SCCCondensation strongly_connected_components_condensation(const HandleGraph* g, SCCState& state) {
+    SCCCondensation result;
+    result.components = strongly_connected_components(g, state);
+
+    // Invert the components into a node-to-component lookup.
+    for (size_t c = 0; c < result.components.size(); c++) {
+        for (auto& node_id : result.components[c]) {
+            // emplace keeps the first component if a node is in several
+            result.component_of.emplace(node_id, c);
+        }
+    }
+
+    // Collect the distinct cross-component traversals in one pass over the
+    // handles in both orientations.
+    vector<unordered_set<size_t>> successor_sets(result.components.size());
+    g->for_each_handle([&](const handle_t& handle) {
+        size_t from = result.component_of.at(g->get_id(handle));
+        auto scan = [&](const handle_t& oriented) {
+            g->follow_edges(oriented, false, [&](const handle_t& next) {
+                size_t to = result.component_of.at(g->get_id(next));
+                if (from != to) {
+                    successor_sets[from].insert(to);
+                }
+            });
+        };
+        scan(handle);
+        scan(g->flip(handle));
+    });
+
+    // Flatten into sorted successor lists.
+    result.successors.resize(successor_sets.size());
+    for (size_t c = 0; c < successor_sets.size(); c++) {
+        result.successors[c].assign(successor_sets[c].begin(), successor_sets[c].end());
+        sort(result.successors[c].begin(), result.successors[c].end());
+    }
+
+    return result;
+}
+
+size_t strongly_connected_component_ids(const HandleGraph* g, vector<nid_t>& index_to_id,
+                                        vector<uint32_t>& component_ids) {
+    // Work out the dense ID-sorted indexing.
+    index_to_id.clear();
+    index_to_id.reserve(g->get_node_count());
+    g->for_each_handle([&](const handle_t& handle) {
+        index_to_id.push_back(g->get_id(handle));
+    });
+    sort(index_to_id.begin(), index_to_id.end());
+
+    // Flatten the set-per-component result into a label per node. We keep the
+    // first label a node gets, since components can overlap in bidirected
+    // graphs.
+    auto components = strongly_connected_components(g);
+    const uint32_t unset = numeric_limits<uint32_t>::max();
+    component_ids.assign(index_to_id.size(), unset);
+    for (size_t c = 0; c < components.size(); c++) {
+        for (auto& node_id : components[c]) {
+            size_t index = lower_bound(index_to_id.begin(), index_to_id.end(), node_id) - index_to_id.begin();
+            if (component_ids[index] == unset) {
+                component_ids[index] = c;
+            }
+        }
+    }
+    return components.size();
+}
+
 }
 }
@@ -0,0 +1,134 @@
+#include "handlegraph/subgraph_view.hpp"
+
+#include <stdexcept>
+#include <string>
+
+/** \file subgraph_view.cpp
+ * Implement the zero-copy filtered subgraph view.
+ */
+
+namespace handlegraph {
+
+SubgraphView::SubgraphView(const HandleGraph* super,
+                           const std::function<bool(const nid_t&)>& membership) :
+    super(super), membership(membership) {
+    if (super == nullptr) {
+        throw std::runtime_error("error:[SubgraphView] must supply a graph to view");
+    }
+}
+
+SubgraphView::SubgraphView(const HandleGraph* super,
+                           const std::unordered_set<nid_t>& node_ids) :
+    super(super), materialized(true) {
+    if (super == nullptr) {
+        throw std::runtime_error("error:[SubgraphView] must supply a graph to view");
+    }
+    member_ids.reserve(node_ids.size());
+    for (const nid_t& node_id : node_ids) {
+        if (super->has_node(node_id)) {
+            member_ids.insert(node_id);
+        }
+    }
+}
+
+void SubgraphView::materialize_membership() {
+    if (materialized) {
+        return;
+    }
+    super->for_each_handle([&](const handle_t& handle) {
+        nid_t node_id = super->get_id(handle);
+        if (membership(node_id)) {
+            member_ids.insert(node_id);
+        }
+    });
+    materialized = true;
+    membership = nullptr;
+}
+
+bool SubgraphView::contains(const nid_t& node_id) const {
+    return materialized ? (bool) member_ids.count(node_id) : membership(node_id);
+}
+
+bool SubgraphView::has_node(nid_t node_id) const {
+    return super->has_node(node_id) && contains(node_id);
+}
+
+handle_t SubgraphView::get_handle(const nid_t& node_id, bool is_reverse) const {
+    if (!contains(node_id)) {
+        throw std::runtime_error("error:[SubgraphView] view does not contain node with ID "
+                                 + std::to_string(node_id));
+    }
+    return super->get_handle(node_id, is_reverse);
+}
+
+nid_t SubgraphView::get_id(const handle_t& handle) const {
+    return super->get_id(handle);
+}
+
+bool SubgraphView::get_is_reverse(const handle_t& handle) const {
+    return super->get_is_reverse(handle);
+}
+
+handle_t SubgraphView::flip(const handle_t& handle) const {
+    return super->flip(handle);
+}
+
+size_t SubgraphView::get_length(const handle_t& handle) const {
+    return super->get_length(handle);
+}
+
+std::string SubgraphView::get_sequence(const handle_t& handle) const {
+    return super->get_sequence(handle);
+}
+
+bool SubgraphView::follow_edges_impl(const handle_t& handle, bool go_left,
+                                     function_ref<bool(const handle_t&)> iteratee) const {
+    // Only offer edges whose far ends are also in the view
+    bool keep_going = true;
+    super->follow_edges(handle, go_left, [&](const handle_t& next) {
+        if (contains(super->get_id(next))) {
+            keep_going = iteratee(next);
+        }
+        return keep_going;
+    });
+    return keep_going;
+}
+
+bool SubgraphView::for_each_handle_impl(function_ref<bool(const handle_t&)> iteratee,
+                                        bool parallel) const {
+    // Scan the backing graph and keep the members
+    return super->for_each_handle([&](const handle_t& handle) {
+        if (!contains(super->get_id(handle))) {
+            return true;
+        }
+        return (bool) iteratee(handle);
+    }, parallel);
+}
+
+size_t SubgraphView::get_node_count() const {
+    if (materialized) {
+        return member_ids.size();
+    }
+    size_t count = 0;
+    super->for_each_handle([&](const handle_t& handle) {
+        if (contains(super->get_id(handle))) {
+            count++;
+        }
+    });
+    return count;
+}
+
+nid_t SubgraphView::min_node_id() const {
+    // The backing graph's bound is a valid (if loose) bound for the view.
+    return super->min_node_id();
+}
+
+nid_t SubgraphView::max_node_id() const {
+    return super->max_node_id();
+}
+
+handle_t SubgraphView::get_underlying_handle(const handle_t& handle) const {
+    return handle;
+}
+
+}
@@ -1,10 +1,15 @@
 #include <unordered_map>
 #include <map>
 #include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 
 #include "handlegraph/algorithms/topological_sort.hpp"
+#include "handlegraph/algorithms/static/topological_sort.hpp"
 
 #include "handlegraph/algorithms/find_tips.hpp"
+#include "handlegraph/parallel.hpp"
 
 namespace handlegraph {
 namespace algorithms {
@@ -12,201 +17,10 @@ namespace algorithms {
 using namespace std;
 
 vector<handle_t> topological_order(const HandleGraph* g) {
-    
-    // Make a vector to hold the ordered and oriented nodes.
-    vector<handle_t> sorted;
-    sorted.reserve(g->get_node_count());
-    
-    // Instead of actually removing edges, we add them to this set of masked edges.
-    unordered_set<pair<handle_t, handle_t>> masked_edges;
-    
-    // This (s) is our set of oriented nodes.
-    // using a map instead of a set ensures a stable sort across different systems
-    map<nid_t, handle_t> s;
-
-    // We find the head and tails, if there are any
-    vector<handle_t> heads{head_nodes(g)};
-    // No need to fetch the tails since we don't use them
-
-    
-    // Maps from node ID to first orientation we suggested for it.
-    map<nid_t, handle_t> seeds;
-    
-    
-    for(handle_t& head : heads) {
-        // Dump all the heads into the oriented set, rather than having them as
-        // seeds. We will only go for cycle-breaking seeds when we run out of
-        // heads. This is bad for contiguity/ordering consistency in cyclic
-        // graphs and reversing graphs, but makes sure we work out to just
-        // topological sort on DAGs. It mimics the effect we used to get when we
-        // joined all the head nodes to a new root head node and seeded that. We
-        // ignore tails since we only orient right from nodes we pick.
-        s[g->get_id(head)] = head;
-    }
-
-    // We will use an ordered map handles by ID for nodes we have not visited
-    // yet. This ensures a consistent sort order across systems.
-    map<nid_t, handle_t> unvisited;
-    g->for_each_handle([&](const handle_t& found) {
-        if (!s.count(g->get_id(found))) {
-            // Only nodes that aren't yet in s are unvisited.
-            // Nodes in s are visited but just need to be added tot he ordering.
-            unvisited.emplace(g->get_id(found), found);
-        }
-    });
-
-    while(!unvisited.empty() || !s.empty()) {
-
-        // Put something in s. First go through seeds until we can find one
-        // that's not already oriented.
-        while(s.empty() && !seeds.empty()) {
-            // Look at the first seed
-            auto first_seed = (*seeds.begin()).second;
-
-            if(unvisited.count(g->get_id(first_seed))) {
-                // We have an unvisited seed. Use it
-#ifdef debug
-                cerr << "Starting from seed " << g->get_id(first_seed) << " orientation " << g->get_is_reverse(first_seed) << endl;
-#endif
-
-                s[g->get_id(first_seed)] = first_seed;
-                unvisited.erase(g->get_id(first_seed));
-            }
-            // Whether we used the seed or not, don't keep it around
-            seeds.erase(seeds.begin());
-        }
-
-        if(s.empty()) {
-            // If we couldn't find a seed, just grab any old node.
-            // Since map order is stable across systems, we can take the first node by id and put it locally forward.
-#ifdef debug
-            cerr << "Starting from arbitrary node " << unvisited.begin()->first << " locally forward" << endl;
-#endif
-
-            s[unvisited.begin()->first] = unvisited.begin()->second;
-            unvisited.erase(unvisited.begin()->first);
-        }
-
-        while (!s.empty()) {
-            // Grab an oriented node
-            auto n = s.begin()->second;
-            s.erase(g->get_id(n));
-            // Emit it
-            sorted.push_back(n);
-#ifdef debug
-            cerr << "Using oriented node " << g->get_id(n) << " orientation " << g->get_is_reverse(n) << endl;
-#endif
-
-            // See if it has an edge from its start to the start of some node
-            // where both were picked as places to break into cycles. A
-            // reversing self loop on a cycle entry point is a special case of
-            // this.
-            g->follow_edges(n, true, [&](const handle_t& prev_node) {
-                if(!unvisited.count(g->get_id(prev_node))) {
-                    // Look at the edge
-                    auto edge = g->edge_handle(prev_node, n);
-                    if (masked_edges.count(edge)) {
-                        // We removed this edge, so skip it.
-                        return;
-                    }
-                    
-#ifdef debug
-                    cerr << "\tHas left-side edge to cycle entry point " << g->get_id(prev_node)
-                         << " orientation " << g->get_is_reverse(prev_node) << endl;
-#endif
-
-                    // Mask the edge
-                    masked_edges.insert(edge);
-                    
-#ifdef debug
-                    cerr << "\t\tEdge: " << g->get_id(edge.first) << " " << g->get_is_reverse(edge.first)
-                        << " -> " << g->get_id(edge.second) << " " << g->get_is_reverse(edge.second) << endl;
-#endif
-                }
-            });
-
-            // All other connections and self loops are handled by looking off the right side.
-
-            // See what all comes next, minus deleted edges.
-            g->follow_edges(n, false, [&](const handle_t& next_node) {
-
-                // Look at the edge
-                auto edge = g->edge_handle(n, next_node);
-                if (masked_edges.count(edge)) {
-                    // We removed this edge, so skip it.
-                    return;
-                }
-
-#ifdef debug
-                cerr << "\tHas edge to " << g->get_id(next_node) << " orientation " << g->get_is_reverse(next_node) << endl;
-#endif
-
-                // Mask the edge connecting these nodes in this order and
-                // relative orientation, so we can't traverse it again
-
-#ifdef debug
-                cerr << "\t\tEdge: " << g->get_id(edge.first) << " " << g->get_is_reverse(edge.first)
-                    << " -> " << g->get_id(edge.second) << " " << g->get_is_reverse(edge.second) << endl;
-#endif
-
-                // Mask the edge
-                masked_edges.insert(edge);
-
-                if(unvisited.count(g->get_id(next_node))) {
-                    // We haven't already started here as an arbitrary cycle entry point
-
-#ifdef debug
-                    cerr << "\t\tAnd node hasn't been visited yet" << endl;
-#endif
-
-                    bool unmasked_incoming_edge = false;
-                    g->follow_edges(next_node, true, [&](const handle_t& prev_node) {
-                        // Get a handle for each incoming edge
-                        auto prev_edge = g->edge_handle(prev_node, next_node);
-                        
-                        if (!masked_edges.count(prev_edge)) {
-                            // We found such an edghe and can stop looking
-                            unmasked_incoming_edge = true;
-                            return false;
-                        }
-                        // Otherwise check all the edges on the left of this handle
-                        return true;
-                    });
-
-                    if(!unmasked_incoming_edge) {
-
-#ifdef debug
-                        cerr << "\t\t\tIs last incoming edge" << endl;
-#endif
-                        // Keep this orientation and put it here
-                        s[g->get_id(next_node)] = next_node;
-                        // Remember that we've visited and oriented this node, so we
-                        // don't need to use it as a seed.
-                        unvisited.erase(g->get_id(next_node));
-
-                    } else if(!seeds.count(g->get_id(next_node))) {
-                        // We came to this node in this orientation; when we need a
-                        // new node and orientation to start from (i.e. an entry
-                        // point to the node's cycle), we might as well pick this
-                        // one.
-                        // Only take it if we don't already know of an orientation for this node.
-                        seeds[g->get_id(next_node)] = next_node;
-
-#ifdef debug
-                        cerr << "\t\t\tSuggests seed " << g->get_id(next_node) << " orientation " << g->get_is_reverse(next_node) << endl;
-#endif
-                    }
-                } else {
-#ifdef debug
-                    cerr << "\t\tAnd node was already visited (to break a cycle)" << endl;
-#endif
-                }
-            });
-        }
-    }
-
-    // Send away our sorted ordering.
-    return sorted;
+    // The logic lives in the graph-type-templated version; instantiating it
+    // over the abstract interface gives the classic virtual-dispatch entry
+    // point.
+    return topological_order<HandleGraph>(g);
 }
     
 vector<handle_t> lazy_topological_order_internal(const HandleGraph* g, bool lazier) {
@@ -250,18 +64,23 @@ vector<handle_t> lazy_topological_order_internal(const HandleGraph* g, bool lazi
     // the return value
     vector<handle_t> order;
     order.reserve(g->get_node_count());
-    
+
+    // one reusable neighbor buffer so we pay one virtual call per node
+    vector<handle_t> nexts;
+
     while (!stack.empty()) {
         // get a head node off the queue
         handle_t here = stack.back();
         stack.pop_back();
-        
+
         // add it to the topological order
         order.push_back(here);
-        
+
         // remove its outgoing edges
-        g->follow_edges(here, false, [&](const handle_t& next) {
-            
+        nexts.clear();
+        g->get_neighbors(here, false, nexts);
+        for (auto& next : nexts) {
+
             auto iter = inward_degree.find(next);
             // we should never be able to reach the opposite orientation of a node
             assert(iter != inward_degree.end());
@@ -271,7 +90,7 @@ vector<handle_t> lazy_topological_order_internal(const HandleGraph* g, bool lazi
                 // after removing this edge, the node is now a head, add it to the queue
                 stack.push_back(next);
             }
-        });
+        }
     }
     
     if (order.size() != g->get_node_count()) {
@@ -283,6 +102,89 @@ vector<handle_t> lazy_topological_order_internal(const HandleGraph* g, bool lazi
 }
     
     
+vector<handle_t> parallel_topological_order(const HandleGraph* g, size_t thread_count) {
+
+    // Snapshot the handles in their locally forward orientations and give
+    // them dense indexes.
+    vector<handle_t> handles;
+    handles.reserve(g->get_node_count());
+    g->for_each_handle([&](const handle_t& handle) {
+        handles.push_back(handle);
+    });
+    unordered_map<handle_t, size_t> index;
+    index.reserve(handles.size());
+    for (size_t i = 0; i < handles.size(); i++) {
+        index[handles[i]] = i;
+    }
+
+    // Count the incoming edges of every node concurrently.
+    unique_ptr<atomic<uint64_t>[]> in_degree(new atomic<uint64_t>[handles.size()]);
+    parallel_for(handles.size(), [&](size_t i) {
+        in_degree[i].store(g->get_degree(handles[i], true), memory_order_relaxed);
+    }, thread_count);
+
+    // Set if we ever reach a node in an orientation we didn't index, which
+    // means the locally forward orientation isn't single stranded.
+    atomic<bool> orientable(true);
+
+    // Start from the heads.
+    vector<size_t> frontier;
+    for (size_t i = 0; i < handles.size(); i++) {
+        if (in_degree[i].load(memory_order_relaxed) == 0) {
+            frontier.push_back(i);
+        }
+    }
+
+    vector<handle_t> order;
+    order.reserve(handles.size());
+
+    // Per-frontier-slot output buckets, so expansion needs no locks and the
+    // next frontier can be assembled in a deterministic order.
+    vector<vector<size_t>> produced;
+
+    while (!frontier.empty() && orientable.load(memory_order_relaxed)) {
+        // Everything in the frontier is safe to emit.
+        for (auto& i : frontier) {
+            order.push_back(handles[i]);
+        }
+
+        produced.assign(frontier.size(), {});
+        parallel_for(frontier.size(), [&](size_t f) {
+            vector<handle_t> nexts;
+            g->get_neighbors(handles[frontier[f]], false, nexts);
+            for (auto& next : nexts) {
+                auto found = index.find(next);
+                if (found == index.end()) {
+                    // We walked onto the other strand of a node.
+                    orientable.store(false, memory_order_relaxed);
+                    return;
+                }
+                // Implicitly remove the edge; whoever removes the last one
+                // owns the node.
+                if (in_degree[found->second].fetch_sub(1, memory_order_relaxed) == 1) {
+                    produced[f].push_back(found->second);
+                }
+            }
+        }, thread_count);
+
+        // Assemble the next frontier deterministically: bucket order follows
+        // this frontier's order, and we sort so ties don't depend on it.
+        frontier.clear();
+        for (auto& bucket : produced) {
+            frontier.insert(frontier.end(), bucket.begin(), bucket.end());
+        }
+        sort(frontier.begin(), frontier.end());
+    }
+
+    if (!orientable.load() || order.size() != handles.size()) {
+        // Reversing edges or a cycle; use the machine-independent sort that
+        // handles anything.
+        return topological_order(g);
+    }
+
+    return order;
+}
+
 vector<handle_t> lazy_topological_order(const HandleGraph* g) {
     return lazy_topological_order_internal(g, false);
 }
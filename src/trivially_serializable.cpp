@@ -3,12 +3,16 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <errno.h>
 #include <string.h>
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <sstream>
+#include <vector>
 
 
 /** \file trivially_serializable.cpp
@@ -81,6 +85,210 @@ void TriviallySerializable::deserialize(std::istream& in) {
     }
 }
 
+namespace {
+
+/// Widen [start, start + length) to page boundaries, since the memory advice
+/// syscalls all want page-aligned addresses. Returns false if there is
+/// nothing to advise about.
+bool page_align(const void* start, size_t length, void*& page_start, size_t& page_length) {
+    if (start == nullptr || length == 0) {
+        return false;
+    }
+    size_t page = (size_t) ::sysconf(_SC_PAGESIZE);
+    uintptr_t begin = (uintptr_t) start;
+    uintptr_t end = begin + length;
+    begin -= begin % page;
+    page_start = (void*) begin;
+    page_length = end - begin;
+    return true;
+}
+
+}
+
+std::pair<const void*, size_t> TriviallySerializable::get_mapping() const {
+    // By default we don't know about any mapping, so the residency control
+    // methods have nothing to do.
+    return std::make_pair(nullptr, (size_t) 0);
+}
+
+void TriviallySerializable::prefetch() const {
+    // Prefetch everything we have mapped
+    prefetch(0, get_mapping().second);
+}
+
+void TriviallySerializable::prefetch(size_t offset, size_t length) const {
+    auto mapping = get_mapping();
+    if (offset >= mapping.second) {
+        // The range starts past the mapping
+        return;
+    }
+    // Clip the range to the mapping
+    length = std::min(length, mapping.second - offset);
+    void* page_start;
+    size_t page_length;
+    if (page_align((const char*) mapping.first + offset, length, page_start, page_length)) {
+        // Readahead is best-effort, so there is nothing useful to do if the
+        // kernel declines.
+        ::madvise(page_start, page_length, MADV_WILLNEED);
+    }
+}
+
+void TriviallySerializable::advise_sequential() const {
+    auto mapping = get_mapping();
+    void* page_start;
+    size_t page_length;
+    if (page_align(mapping.first, mapping.second, page_start, page_length)) {
+        ::madvise(page_start, page_length, MADV_SEQUENTIAL);
+    }
+}
+
+void TriviallySerializable::advise_random() const {
+    auto mapping = get_mapping();
+    void* page_start;
+    size_t page_length;
+    if (page_align(mapping.first, mapping.second, page_start, page_length)) {
+        ::madvise(page_start, page_length, MADV_RANDOM);
+    }
+}
+
+bool TriviallySerializable::request_hugepages() const {
+#ifdef MADV_HUGEPAGE
+    auto mapping = get_mapping();
+    void* page_start;
+    size_t page_length;
+    if (!page_align(mapping.first, mapping.second, page_start, page_length)) {
+        return false;
+    }
+    return ::madvise(page_start, page_length, MADV_HUGEPAGE) == 0;
+#else
+    // The platform has no transparent hugepage advice
+    return false;
+#endif
+}
+
+size_t TriviallySerializable::residency() const {
+    auto mapping = get_mapping();
+    void* page_start;
+    size_t page_length;
+    if (!page_align(mapping.first, mapping.second, page_start, page_length)) {
+        return 0;
+    }
+    size_t page = (size_t) ::sysconf(_SC_PAGESIZE);
+    size_t pages = (page_length + page - 1) / page;
+    // mincore fills in one flag byte per page, with the low bit meaning resident
+    std::vector<unsigned char> flags(pages);
+#ifdef __APPLE__
+    if (::mincore(page_start, page_length, (char*) flags.data()) != 0) {
+#else
+    if (::mincore(page_start, page_length, flags.data()) != 0) {
+#endif
+        return 0;
+    }
+    size_t resident_pages = 0;
+    for (auto& flag : flags) {
+        resident_pages += flag & 1;
+    }
+    // Don't count the widening to page boundaries as resident object bytes
+    return std::min(resident_pages * page, mapping.second);
+}
+
+void TriviallySerializable::mark_dirty(size_t offset, size_t length) {
+    if (length == 0) {
+        return;
+    }
+    // Work in whole pages, since that is the granularity msync can sync at
+    size_t page = (size_t) ::sysconf(_SC_PAGESIZE);
+    size_t begin = offset - offset % page;
+    size_t end = ((offset + length + page - 1) / page) * page;
+
+    std::lock_guard<std::mutex> guard(dirty_mutex);
+    // Find the first recorded range that could touch ours
+    auto it = dirty_ranges.upper_bound(begin);
+    if (it != dirty_ranges.begin()) {
+        auto before = it;
+        --before;
+        if (before->second >= begin) {
+            it = before;
+        }
+    }
+    // Swallow every range we overlap or abut, growing to cover it
+    while (it != dirty_ranges.end() && it->first <= end) {
+        begin = std::min(begin, it->first);
+        end = std::max(end, it->second);
+        it = dirty_ranges.erase(it);
+    }
+    dirty_ranges[begin] = end;
+}
+
+void TriviallySerializable::flush_changes(bool block) {
+    std::map<size_t, size_t> to_flush;
+    {
+        // Claim the recorded ranges
+        std::lock_guard<std::mutex> guard(dirty_mutex);
+        to_flush.swap(dirty_ranges);
+    }
+
+    auto mapping = get_mapping();
+    if (mapping.first == nullptr) {
+        // Nothing is mapped, so there is nothing to write back
+        return;
+    }
+
+    for (auto& range : to_flush) {
+        // Clip each range to the mapping. The offsets are already
+        // page-rounded, and the mapping itself starts on a page.
+        size_t begin = std::min(range.first, mapping.second);
+        size_t end = std::min(range.second, mapping.second);
+        if (begin == end) {
+            continue;
+        }
+        if (::msync((void*)((const char*) mapping.first + begin), end - begin,
+                    block ? MS_SYNC : MS_ASYNC) != 0) {
+            auto problem = errno;
+            std::stringstream ss;
+            ss << "Could not flush changes: " << ::strerror(problem);
+            throw std::runtime_error(ss.str());
+        }
+    }
+}
+
+std::vector<std::pair<std::string, size_t>> TriviallySerializable::memory_usage() const {
+    auto mapping = get_mapping();
+    if (mapping.first == nullptr) {
+        // We don't know where our data is
+        return Serializable::memory_usage();
+    }
+    return {{"mapping", mapping.second}};
+}
+
+size_t TriviallySerializable::serialized_size_estimate() const {
+    auto mapping = get_mapping();
+    if (mapping.first == nullptr) {
+        return Serializable::serialized_size_estimate();
+    }
+    // The mapping already is the serialized bytes, magic number included
+    return mapping.second;
+}
+
+void TriviallySerializable::clear_dirty() {
+    std::lock_guard<std::mutex> guard(dirty_mutex);
+    dirty_ranges.clear();
+}
+
+bool TriviallySerializable::remap_copy_on_write(void* start, size_t length, int fd, size_t offset) {
+    // Drop a private copy-on-write view of the same file pages on top of the
+    // shared mapping. Nothing gets copied until a page is actually modified,
+    // so this is much cheaper than duplicating the whole object.
+    void* result = ::mmap(start, length, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_FIXED, fd, offset);
+    if (result == MAP_FAILED) {
+        return false;
+    }
+    // With no write-back link left, recorded dirty ranges are meaningless
+    clear_dirty();
+    return true;
+}
+
 // To let the const and non-const filename serialization implementations share
 // code, we have some helpers
 
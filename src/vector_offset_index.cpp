@@ -0,0 +1,125 @@
+#include "handlegraph/vector_offset_index.hpp"
+
+#include "handlegraph/parallel.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+/** \file vector_offset_index.cpp
+ * Implement the VectorOffsetIndex prefix-sum machinery
+ */
+
+namespace handlegraph {
+
+const size_t VectorOffsetIndex::BLOCK_SIZE;
+
+VectorOffsetIndex::VectorOffsetIndex(const HandleGraph* graph, size_t thread_count)
+    : ranked(dynamic_cast<const RankedHandleGraph*>(graph)) {
+
+    size_t node_count = graph->get_node_count();
+
+    // lay the nodes out in rank order, or ID-sorted order without ranks
+    index_to_id.resize(node_count);
+    if (ranked != nullptr) {
+        parallel_for(node_count, [&](size_t i) {
+            // ranks start at 1
+            index_to_id[i] = ranked->rank_to_id(i + 1);
+        }, thread_count);
+    }
+    else {
+        index_to_id.clear();
+        index_to_id.reserve(node_count);
+        graph->for_each_handle([&](const handle_t& handle) {
+            index_to_id.push_back(graph->get_id(handle));
+        });
+        std::sort(index_to_id.begin(), index_to_id.end());
+    }
+
+    // read the node lengths across threads
+    std::vector<uint64_t> lengths(node_count);
+    parallel_for(node_count, [&](size_t i) {
+        lengths[i] = graph->get_length(graph->get_handle(index_to_id[i]));
+    }, thread_count);
+
+    // sum them into each node's start offset, with the total at the end
+    prefix.resize(node_count + 1);
+    prefix[0] = 0;
+    for (size_t i = 0; i < node_count; i++) {
+        prefix[i + 1] = prefix[i] + lengths[i];
+    }
+
+    // sample the node containing each block's first offset, so queries only
+    // binary search within one block's worth of nodes
+    block_first_index.resize(prefix.back() / BLOCK_SIZE + 1, 0);
+    size_t node_index = 0;
+    for (size_t block = 0; block < block_first_index.size(); block++) {
+        size_t block_offset = block * BLOCK_SIZE;
+        while (node_index + 1 < node_count && prefix[node_index + 1] <= block_offset) {
+            node_index++;
+        }
+        block_first_index[block] = node_index;
+    }
+}
+
+size_t VectorOffsetIndex::index_of(const nid_t& node_id) const {
+    if (ranked != nullptr) {
+        // ranks start at 1
+        return ranked->id_to_rank(node_id) - 1;
+    }
+    return std::lower_bound(index_to_id.begin(), index_to_id.end(), node_id) - index_to_id.begin();
+}
+
+size_t VectorOffsetIndex::index_at_offset(const size_t& offset) const {
+    if (offset >= prefix.back()) {
+        throw std::runtime_error("error:[VectorOffsetIndex] queried offset " + std::to_string(offset) +
+                                 " in a sequence vector of length " + std::to_string(prefix.back()));
+    }
+    // the sampled index bounds the nodes that can overlap this block
+    size_t block = offset / BLOCK_SIZE;
+    size_t low = block_first_index[block];
+    size_t high = (block + 1 < block_first_index.size() ? block_first_index[block + 1]
+                                                        : index_to_id.size() - 1);
+    // the node is the last one starting at or before the offset
+    return std::upper_bound(prefix.begin() + low, prefix.begin() + high + 1, offset) - prefix.begin() - 1;
+}
+
+size_t VectorOffsetIndex::node_vector_offset(const nid_t& node_id) const {
+    return prefix[index_of(node_id)];
+}
+
+nid_t VectorOffsetIndex::node_at_vector_offset(const size_t& offset) const {
+    return index_to_id[index_at_offset(offset)];
+}
+
+void VectorOffsetIndex::nodes_at_vector_offsets(const std::vector<size_t>& offsets,
+                                                std::vector<nid_t>& nodes) const {
+    nodes.clear();
+    nodes.reserve(offsets.size());
+
+    bool walking = false;
+    size_t here = 0;
+    for (const size_t& offset : offsets) {
+        if (!walking || offset < prefix[here]) {
+            // start (or restart, for an out-of-order query) with a search
+            here = index_at_offset(offset);
+            walking = true;
+        }
+        else {
+            if (offset >= prefix.back()) {
+                throw std::runtime_error("error:[VectorOffsetIndex] queried offset " + std::to_string(offset) +
+                                         " in a sequence vector of length " + std::to_string(prefix.back()));
+            }
+            // continue the walk forward from the previous query's node
+            while (prefix[here + 1] <= offset) {
+                here++;
+            }
+        }
+        nodes.push_back(index_to_id[here]);
+    }
+}
+
+size_t VectorOffsetIndex::total_length() const {
+    return prefix.empty() ? 0 : prefix.back();
+}
+
+}
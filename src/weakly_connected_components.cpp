@@ -1,62 +1,206 @@
 #include "handlegraph/algorithms/weakly_connected_components.hpp"
+#include "handlegraph/algorithms/static/weakly_connected_components.hpp"
+
+#include "handlegraph/parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
 
 namespace handlegraph {
 namespace algorithms {
 
 using namespace std;
 
-vector<unordered_set<nid_t>> weakly_connected_components(const HandleGraph* graph) {
-    vector<unordered_set<nid_t>> to_return;
-    
-    // This only holds locally forward handles
-    unordered_set<handle_t> traversed;
-    
+namespace {
+
+/**
+ * Shared engine for the parallel component algorithms: assign every node a
+ * dense index, run a concurrent union-find over the edges, and produce a
+ * dense component labeling.
+ *
+ * Fills in index_to_id with the node ID at each dense index (rank order for
+ * RankedHandleGraphs, ID-sorted order otherwise) and labels with a component
+ * number per dense index. Component numbers are assigned in order of each
+ * component's first dense index, so they are deterministic. Returns the
+ * number of components.
+ */
+size_t concurrent_union_find_components(const HandleGraph* graph, size_t thread_count,
+                                        vector<nid_t>& index_to_id, vector<uint32_t>& labels,
+                                        MemoryResource* resource) {
+
+    // Work out a dense indexing of the nodes.
+    index_to_id.clear();
+    index_to_id.reserve(graph->get_node_count());
     graph->for_each_handle([&](const handle_t& handle) {
-        
-        // Only think about it in the forward orientation
-        auto forward = graph->forward(handle);
-        
-        if (traversed.count(forward)) {
-            // Already have this node, so don't start a search from it.
-            return;
+        index_to_id.push_back(graph->get_id(handle));
+    });
+
+    const RankedHandleGraph* ranked = dynamic_cast<const RankedHandleGraph*>(graph);
+    if (ranked != nullptr) {
+        // Ranks are already dense; order the indexes by rank so lookups are O(1).
+        sort(index_to_id.begin(), index_to_id.end(), [&](const nid_t& a, const nid_t& b) {
+            return ranked->id_to_rank(a) < ranked->id_to_rank(b);
+        });
+    } else {
+        // Fall back on ID-sorted order and binary search for lookups.
+        sort(index_to_id.begin(), index_to_id.end());
+    }
+
+    auto index_of = [&](const nid_t& node_id) -> size_t {
+        if (ranked != nullptr) {
+            // Ranks start at 1.
+            return ranked->id_to_rank(node_id) - 1;
         }
-        
-        // The stack only holds locally forward handles
-        vector<handle_t> stack{forward};
-        to_return.emplace_back();
-        while (!stack.empty()) {
-            handle_t here = stack.back();
-            stack.pop_back();
-            
-            traversed.insert(here);
-            to_return.back().insert(graph->get_id(here));
-            
-            // We have a function to handle all connected handles
-            auto handle_other = [&](const handle_t& other) {
-                // Again, make it forward
-                auto other_forward = graph->forward(other);
-                
-                if (!traversed.count(other_forward)) {
-                    stack.push_back(other_forward);
-                }
-            };
-            
-            // Look at edges in both directions
-            graph->follow_edges(here, false, handle_other);
-            graph->follow_edges(here, true, handle_other);
-            
+        return lower_bound(index_to_id.begin(), index_to_id.end(), node_id) - index_to_id.begin();
+    };
+
+    size_t count = index_to_id.size();
+
+    // Each node starts as its own set. We can't put atomics in a resizable
+    // vector, so allocate the parent array directly, from the caller's
+    // resource if there is one.
+    ResourceAllocator<atomic<size_t>> parent_alloc(resource);
+    atomic<size_t>* parent = parent_alloc.allocate(count);
+    parallel_for(count, [&](size_t i) {
+        new (&parent[i]) atomic<size_t>(i);
+    }, thread_count);
+
+    // Lock-free find with path halving.
+    auto find = [&](size_t x) -> size_t {
+        while (true) {
+            size_t p = parent[x].load(memory_order_relaxed);
+            if (p == x) {
+                return x;
+            }
+            size_t gp = parent[p].load(memory_order_relaxed);
+            if (p == gp) {
+                return p;
+            }
+            // Shortcut to the grandparent. Losing the race is fine; we retry.
+            parent[x].compare_exchange_weak(p, gp, memory_order_relaxed);
+            x = gp;
         }
-    });
+    };
+
+    // Lock-free union by smaller root index, so roots are the minimum dense
+    // index in their component.
+    auto unite = [&](size_t a, size_t b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) {
+                return;
+            }
+            if (a < b) {
+                swap(a, b);
+            }
+            size_t expected = a;
+            if (parent[a].compare_exchange_weak(expected, b, memory_order_relaxed)) {
+                return;
+            }
+        }
+    };
+
+    // Union across every edge, in parallel. Membership is orientation-independent.
+    graph->for_each_edge_parallel([&](const edge_t& edge) {
+        unite(index_of(graph->get_id(edge.first)), index_of(graph->get_id(edge.second)));
+    }, thread_count);
+
+    // Number the components by first dense index, so output is deterministic
+    // no matter how the unions interleaved.
+    labels.assign(count, 0);
+    size_t next_label = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (find(i) == i) {
+            labels[i] = next_label++;
+        }
+    }
+    parallel_for(count, [&](size_t i) {
+        labels[i] = labels[find(i)];
+    }, thread_count);
+
+    // Atomics are trivially destructible, so just give the memory back
+    parent_alloc.deallocate(parent, count);
+
+    return next_label;
+}
+
+}
+
+vector<unordered_set<nid_t>> weakly_connected_components(const HandleGraph* graph) {
+    // The logic lives in the graph-type-templated version; instantiating it
+    // over the abstract interface gives the classic virtual-dispatch entry
+    // point.
+    return weakly_connected_components<HandleGraph>(graph);
+}
+
+vector<unordered_set<nid_t>> weakly_connected_components_parallel(const HandleGraph* graph, size_t thread_count,
+                                                                  MemoryResource* resource) {
+    vector<nid_t> index_to_id;
+    vector<uint32_t> labels;
+    size_t component_count = concurrent_union_find_components(graph, thread_count, index_to_id, labels, resource);
+
+    // Expand the dense labeling back into the classic set-per-component form.
+    vector<unordered_set<nid_t>> to_return(component_count);
+    for (size_t i = 0; i < labels.size(); i++) {
+        to_return[labels[i]].insert(index_to_id[i]);
+    }
     return to_return;
 }
 
-vector<pair<unordered_set<nid_t>, vector<handle_t>>> weakly_connected_components_with_tips(const HandleGraph* graph) {
+size_t weakly_connected_component_ids(const HandleGraph* graph, vector<nid_t>& index_to_id,
+                                      vector<uint32_t>& component_ids, size_t thread_count,
+                                      MemoryResource* resource) {
+    return concurrent_union_find_components(graph, thread_count, index_to_id, component_ids, resource);
+}
+
+bool for_each_weakly_connected_component(const HandleGraph* graph,
+                                         const function<bool(const vector<nid_t>&)>& iteratee,
+                                         size_t thread_count,
+                                         MemoryResource* resource) {
+    vector<nid_t> index_to_id;
+    vector<uint32_t> labels;
+    size_t component_count = concurrent_union_find_components(graph, thread_count, index_to_id, labels, resource);
+
+    // Bucket the node IDs by component with a counting sort, so we can emit
+    // each component as one contiguous run.
+    resource_vector<size_t> offsets(component_count + 1, 0, ResourceAllocator<size_t>(resource));
+    for (auto& label : labels) {
+        offsets[label + 1]++;
+    }
+    for (size_t i = 1; i < offsets.size(); i++) {
+        offsets[i] += offsets[i - 1];
+    }
+    resource_vector<nid_t> grouped(index_to_id.size(), 0, ResourceAllocator<nid_t>(resource));
+    {
+        resource_vector<size_t> cursor(offsets.begin(), offsets.end() - 1,
+                                       ResourceAllocator<size_t>(resource));
+        for (size_t i = 0; i < labels.size(); i++) {
+            grouped[cursor[labels[i]]++] = index_to_id[i];
+        }
+    }
+
+    // Hand out the components one at a time through a reused buffer.
+    vector<nid_t> component;
+    for (size_t c = 0; c < component_count; c++) {
+        component.assign(grouped.begin() + offsets[c], grouped.begin() + offsets[c + 1]);
+        if (!iteratee(component)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+vector<pair<unordered_set<nid_t>, vector<handle_t>>> weakly_connected_components_with_tips(const HandleGraph* graph,
+                                                                                           MemoryResource* resource) {
     // TODO: deduplicate with above
-    
+
     vector<pair<unordered_set<nid_t>, vector<handle_t>>> to_return;
-    
+
     // This only holds locally forward handles
-    unordered_set<handle_t> traversed;
+    resource_unordered_set<handle_t> traversed{ResourceAllocator<handle_t>(resource)};
     
     graph->for_each_handle([&](const handle_t& handle) {
         
@@ -69,7 +213,8 @@ vector<pair<unordered_set<nid_t>, vector<handle_t>>> weakly_connected_components
         }
         
         // The stack only holds locally forward handles
-        vector<handle_t> stack{forward};
+        resource_vector<handle_t> stack{ResourceAllocator<handle_t>(resource)};
+        stack.push_back(forward);
         to_return.emplace_back();
         while (!stack.empty()) {
             handle_t here = stack.back();
@@ -113,11 +258,11 @@ vector<pair<unordered_set<nid_t>, vector<handle_t>>> weakly_connected_components
     return to_return;
 }
 
-bool is_weakly_connected(const HandleGraph* graph) {
-    
+bool is_weakly_connected(const HandleGraph* graph, MemoryResource* resource) {
+
     // init a queue with an arbitrary node
-    vector<handle_t> stack;
-    unordered_set<handle_t> enqueued;
+    resource_vector<handle_t> stack{ResourceAllocator<handle_t>(resource)};
+    resource_unordered_set<handle_t> enqueued{ResourceAllocator<handle_t>(resource)};
     graph->for_each_handle([&](const handle_t& handle) {
         stack.push_back(handle);
         enqueued.insert(handle);